@@ -57,6 +57,8 @@ static uint32_t adxl355_accel_array_conv(struct adxl355_dev *dev,
 		uint8_t *raw_array);
 static int64_t adxl355_accel_conv(struct adxl355_dev *dev, uint32_t raw_accel);
 static int64_t adxl355_temp_conv(uint16_t raw_temp);
+static bool adxl355_fifo_parse_entry(struct adxl355_dev *dev, uint8_t *entry);
+static void adxl355_fifo_irq_handler(void *ctx, uint32_t event, void *extra);
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -67,6 +69,8 @@ static int64_t adxl355_temp_conv(uint16_t raw_temp);
  * @param dev          - The device structure.
  * @param base_address - Address of the base register.
  * @param size         - The number of bytes to be read and returned in read_data.
+ *                       Without i2c transfer support, I2C reads are split in
+ *                       ADXL355_I2C_CHUNK_LEN transfers.
  * @param read_data    - The read data buffer
  *
  * @return ret         - Result of the reading procedure.
@@ -74,6 +78,12 @@ static int64_t adxl355_temp_conv(uint16_t raw_temp);
 int adxl355_read_device_data(struct adxl355_dev *dev, uint8_t base_address,
 			     uint16_t size, uint8_t *read_data)
 {
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buff = &base_address, .bytes_number = 1 },
+		{ .buff = read_data, .bytes_number = size, .flags = NO_OS_I2C_M_RD }
+	};
+	uint16_t chunk_len = size;
+	uint16_t len;
 	int ret;
 
 	if (dev->comm_type == ADXL355_SPI_COMM) {
@@ -82,14 +92,31 @@ int adxl355_read_device_data(struct adxl355_dev *dev, uint8_t base_address,
 					       1 + size);
 		for (uint16_t idx = 0; idx < size; idx++)
 			read_data[idx] = dev->comm_buff[idx+1];
-	} else {
-		ret = no_os_i2c_write(dev->com_desc.i2c_desc, &base_address, 1, 0);
+
+		return ret;
+	}
+
+	if (!dev->com_desc.i2c_desc->platform_ops->i2c_ops_transfer)
+		chunk_len = ADXL355_I2C_CHUNK_LEN;
+
+	do {
+		len = no_os_min(size, chunk_len);
+		msgs[1].buff = read_data;
+		msgs[1].bytes_number = len;
+
+		ret = no_os_i2c_transfer(dev->com_desc.i2c_desc, msgs,
+					 NO_OS_ARRAY_SIZE(msgs));
 		if (ret)
 			return ret;
-		ret = no_os_i2c_read(dev->com_desc.i2c_desc, read_data, size, 1);
-	}
 
-	return ret;
+		read_data += len;
+		size -= len;
+		/* The FIFO is read from the same address */
+		if (base_address != ADXL355_ADDR(ADXL355_FIFO_DATA))
+			base_address += len;
+	} while (size);
+
+	return 0;
 }
 
 /***************************************************************************//**
@@ -192,6 +219,9 @@ int adxl355_init(struct adxl355_dev **device,
 	// Default activity count value
 	dev->act_cnt = GET_ADXL355_RESET_VAL(ADXL355_ACT_CNT);
 
+	// Count a misaligned first FIFO entry as a resync
+	dev->fifo_synced = true;
+
 	*device = dev;
 
 	return ret;
@@ -218,6 +248,12 @@ int adxl355_remove(struct adxl355_dev *dev)
 {
 	int ret;
 
+	if (dev->fifo_ring) {
+		ret = adxl355_fifo_stream_remove(dev);
+		if (ret)
+			return ret;
+	}
+
 	if (dev->comm_type == ADXL355_SPI_COMM)
 		ret = no_os_spi_remove(dev->com_desc.spi_desc);
 	else
@@ -660,10 +696,12 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value)
 }
 
 /***************************************************************************//**
- * @brief Reads fifo data and returns the raw values.
+ * @brief Reads fifo data and returns the raw values. The entries are aligned
+ *        on the x-axis marker and a frame split between two reads is
+ *        completed by the next call, so at most 32 frames are returned.
  *
  * @param dev          - The device structure.
- * @param fifo_entries - The number of fifo entries.
+ * @param fifo_entries - The number of returned entries, 3 per frame.
  * @param raw_x        - Raw x-axis data.
  * @param raw_y        - Raw y-axis data.
  * @param raw_z        - Raw z-axis data.
@@ -673,31 +711,41 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value)
 int adxl355_get_raw_fifo_data (struct adxl355_dev *dev, uint8_t *fifo_entries,
 			       uint32_t *raw_x, uint32_t *raw_y, uint32_t *raw_z)
 {
+	uint8_t nb_entries;
+	uint8_t nb_frames = 0;
+	uint8_t *entry;
 	int ret;
 
-	ret = adxl355_get_nb_of_fifo_entries(dev, fifo_entries);
+	ret = adxl355_get_nb_of_fifo_entries(dev, &nb_entries);
 	if (ret)
 		return ret;
 
-	if (*fifo_entries > 0) {
-
-		ret = adxl355_read_device_data(dev, ADXL355_ADDR(ADXL355_FIFO_DATA),
-					       *fifo_entries * 3, dev->comm_buff);
+	nb_entries = no_os_min(nb_entries, ADXL355_FIFO_MAX_ENTRIES);
+	if (nb_entries > 0) {
+		ret = adxl355_read_device_data(dev,
+					       ADXL355_ADDR(ADXL355_FIFO_DATA),
+					       nb_entries *
+					       ADXL355_FIFO_ENTRY_LEN,
+					       dev->comm_buff);
 		if (ret)
 			return ret;
 
-		for (uint16_t idx = 0; idx < *fifo_entries * 3; idx = idx + 9) {
-			if (((dev->comm_buff[idx+2] & 1) == 1)
-			    && ((dev->comm_buff[idx+2] & 2) == 0)) {
-				// This is x-axis
-				// Process data
-				raw_x[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx]);
-				raw_y[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx+3]);
-				raw_z[idx/9] = adxl355_accel_array_conv(dev, &dev->comm_buff[idx+6]);
-			}
+		for (uint8_t idx = 0; idx < nb_entries; idx++) {
+			entry = &dev->comm_buff[idx * ADXL355_FIFO_ENTRY_LEN];
+			if (entry[2] & ADXL355_FIFO_EMPTY_MSK)
+				break;
+			if (!adxl355_fifo_parse_entry(dev, entry))
+				continue;
+
+			raw_x[nb_frames] = dev->fifo_part[0];
+			raw_y[nb_frames] = dev->fifo_part[1];
+			raw_z[nb_frames] = dev->fifo_part[2];
+			nb_frames++;
 		}
 	}
 
+	*fifo_entries = nb_frames * ADXL355_FIFO_ENTRY_LEN;
+
 	return ret;
 }
 
@@ -846,6 +894,417 @@ int adxl355_set_int_pol(struct adxl355_dev *dev, enum adxl355_int_pol int_pol)
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Sets up the interrupt driven FIFO drain engine: the watermark
+ *        interrupt is mapped on the given pin, active high, and each rising
+ *        edge moves the FIFO content into a ring of timestamped frames.
+ *
+ * @param dev   - The device structure.
+ * @param param - The drain engine parameters.
+ *
+ * @return ret  - Result of the configuration procedure.
+*******************************************************************************/
+int adxl355_fifo_stream_init(struct adxl355_dev *dev,
+			     struct adxl355_fifo_stream_init_param *param)
+{
+	struct no_os_callback_desc irq_cb = {
+		.callback = adxl355_fifo_irq_handler,
+		.ctx = dev,
+		.config = param ? param->irq_config : NULL,
+	};
+	union adxl355_int_mask int_conf = { .value = 0 };
+	int ret;
+
+	if (!dev || !param || !param->watermark ||
+	    param->watermark > ADXL355_FIFO_MAX_FRAMES)
+		return -EINVAL;
+
+	if (dev->fifo_ring)
+		return -EBUSY;
+
+#ifndef ADXL355_TIMER_SUPPORT
+	/* The timer API is only linked in when the build asks for it */
+	if (param->timer)
+		return -ENOSYS;
+#endif
+
+	ret = no_os_ring_init(&dev->fifo_ring,
+			      sizeof(struct adxl355_fifo_frame),
+			      param->nb_frames, NO_OS_RING_SPSC);
+	if (ret)
+		return ret;
+
+	ret = adxl355_set_fifo_samples(dev, param->watermark *
+				       ADXL355_FIFO_ENTRY_LEN);
+	if (ret)
+		goto error_ring;
+
+	if (param->int_pin == ADXL355_INT1)
+		int_conf.fields.FULL_EN1 = 1;
+	else
+		int_conf.fields.FULL_EN2 = 1;
+
+	ret = adxl355_config_int_pins(dev, int_conf);
+	if (ret)
+		goto error_ring;
+
+	ret = adxl355_set_int_pol(dev, ADXL355_INT_ACTIVE_HIGH);
+	if (ret)
+		goto error_ring;
+
+	if (param->irq_ctrl) {
+		ret = no_os_irq_trigger_level_set(param->irq_ctrl,
+						  param->irq_id,
+						  NO_OS_IRQ_EDGE_RISING);
+		if (ret)
+			goto error_ring;
+
+		ret = no_os_irq_register_callback(param->irq_ctrl,
+						  param->irq_id, &irq_cb);
+		if (ret)
+			goto error_ring;
+	}
+
+	dev->irq_ctrl = param->irq_ctrl;
+	dev->irq_id = param->irq_id;
+	dev->timer = param->timer;
+
+	return 0;
+error_ring:
+	no_os_ring_remove(dev->fifo_ring);
+	dev->fifo_ring = NULL;
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Free the resources allocated by adxl355_fifo_stream_init().
+ *
+ * @param dev  - The device structure.
+ *
+ * @return ret - Result of the remove procedure.
+*******************************************************************************/
+int adxl355_fifo_stream_remove(struct adxl355_dev *dev)
+{
+	int ret;
+
+	if (!dev || !dev->fifo_ring)
+		return -EINVAL;
+
+	if (dev->irq_ctrl) {
+		ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+
+		ret = no_os_irq_unregister(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+	}
+
+	ret = no_os_ring_remove(dev->fifo_ring);
+	if (ret)
+		return ret;
+
+	dev->fifo_ring = NULL;
+	dev->irq_ctrl = NULL;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Drains the FIFO with the watermark interrupt masked, then unmasks it.
+ *        The interrupt handler runs the same drain and shares comm_buff and
+ *        the ring, so the two never run at the same time. A watermark
+ *        reached before unmasking raises no edge, so the level is checked
+ *        again and the FIFO drained until it is below the watermark.
+ *        Also recovers a stream stalled by a missed edge.
+ *
+ * @param dev  - The device structure.
+ *
+ * @return ret - Result of the rearm procedure.
+*******************************************************************************/
+int adxl355_fifo_stream_rearm(struct adxl355_dev *dev)
+{
+	uint8_t reg = ADXL355_ADDR(ADXL355_FIFO_ENTRIES);
+	uint8_t nb_entries;
+	int ret;
+
+	if (!dev || !dev->fifo_ring)
+		return -EINVAL;
+
+	if (!dev->irq_ctrl)
+		return adxl355_fifo_drain(dev);
+
+	while (true) {
+		ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+
+		ret = adxl355_fifo_drain(dev);
+		if (ret)
+			return ret;
+
+		ret = no_os_irq_enable(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+
+		// Checked masked too, the handler may run since the unmask
+		ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+
+		ret = adxl355_read_device_data(dev, reg, 1, &nb_entries);
+		if (ret)
+			return ret;
+
+		if (nb_entries < dev->fifo_samples)
+			return no_os_irq_enable(dev->irq_ctrl, dev->irq_id);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Starts draining the FIFO on watermark interrupts. The counters and
+ *        the frame alignment are reset, the frames still in the ring are
+ *        kept.
+ *
+ * @param dev  - The device structure.
+ *
+ * @return ret - Result of the start procedure.
+*******************************************************************************/
+int adxl355_fifo_stream_start(struct adxl355_dev *dev)
+{
+	int ret;
+
+	if (!dev || !dev->fifo_ring)
+		return -EINVAL;
+
+	if (dev->irq_ctrl) {
+		ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_id);
+		if (ret)
+			return ret;
+	}
+
+	memset(&dev->fifo_stats, 0, sizeof(dev->fifo_stats));
+	dev->fifo_part_len = 0;
+	dev->fifo_synced = true;
+	dev->fifo_time = 0;
+
+	if (!dev->irq_ctrl)
+		return 0;
+
+	return adxl355_fifo_stream_rearm(dev);
+}
+
+/***************************************************************************//**
+ * @brief Stops draining the FIFO on watermark interrupts.
+ *
+ * @param dev  - The device structure.
+ *
+ * @return ret - Result of the stop procedure.
+*******************************************************************************/
+int adxl355_fifo_stream_stop(struct adxl355_dev *dev)
+{
+	if (!dev || !dev->fifo_ring)
+		return -EINVAL;
+
+	if (!dev->irq_ctrl)
+		return 0;
+
+	return no_os_irq_disable(dev->irq_ctrl, dev->irq_id);
+}
+
+/***************************************************************************//**
+ * @brief Moves all the FIFO entries into the ring, reading each time the
+ *        status, the number of entries and then the entries in one burst.
+ *        The FIFO is drained until it is below the watermark, so that the
+ *        next watermark raises a new edge. Frames are aligned on the x-axis
+ *        marker and a frame split between two drains is carried over.
+ *
+ * @param dev  - The device structure.
+ *
+ * @return ret - Result of the drain procedure.
+*******************************************************************************/
+int adxl355_fifo_drain(struct adxl355_dev *dev)
+{
+	union adxl355_sts_reg_flags status;
+	struct adxl355_fifo_frame frame;
+	uint64_t period, back, now = 0;
+	uint8_t regs[2];
+	uint8_t nb_entries;
+	uint8_t *entry;
+	int ret;
+
+	if (!dev || !dev->fifo_ring)
+		return -EINVAL;
+
+	period = (uint64_t)ADXL355_ODR_4000HZ_PERIOD_NS << dev->odr_lpf;
+
+	do {
+		/* STATUS and FIFO_ENTRIES are adjacent */
+		ret = adxl355_read_device_data(dev,
+					       ADXL355_ADDR(ADXL355_STATUS),
+					       sizeof(regs), regs);
+		if (ret)
+			return ret;
+
+		status.value = regs[0];
+		if (status.fields.FIFO_OVR)
+			dev->fifo_stats.fifo_overflows++;
+
+		nb_entries = no_os_min(regs[1], ADXL355_FIFO_MAX_ENTRIES);
+		if (!nb_entries)
+			return 0;
+
+#ifdef ADXL355_TIMER_SUPPORT
+		if (dev->timer) {
+			ret = no_os_timer_get_elapsed_time_nsec(dev->timer,
+								&now);
+			if (ret)
+				return ret;
+		}
+#endif
+
+		ret = adxl355_read_device_data(dev,
+					       ADXL355_ADDR(ADXL355_FIFO_DATA),
+					       nb_entries *
+					       ADXL355_FIFO_ENTRY_LEN,
+					       dev->comm_buff);
+		if (ret)
+			return ret;
+
+		for (uint8_t idx = 0; idx < nb_entries; idx++) {
+			entry = &dev->comm_buff[idx * ADXL355_FIFO_ENTRY_LEN];
+			if (entry[2] & ADXL355_FIFO_EMPTY_MSK)
+				break;
+			if (!adxl355_fifo_parse_entry(dev, entry))
+				continue;
+
+			if (dev->timer) {
+				/* The last entry is as old as the burst */
+				back = (nb_entries - 1 - idx) /
+				       ADXL355_FIFO_ENTRY_LEN * period;
+				frame.timestamp = now > back ? now - back : 0;
+			} else {
+				frame.timestamp = dev->fifo_time;
+				dev->fifo_time += period;
+			}
+			frame.raw_x = dev->fifo_part[0];
+			frame.raw_y = dev->fifo_part[1];
+			frame.raw_z = dev->fifo_part[2];
+
+			if (no_os_ring_push(dev->fifo_ring, &frame))
+				dev->fifo_stats.ring_overflows++;
+			else
+				dev->fifo_stats.frames++;
+		}
+	} while (nb_entries >= dev->fifo_samples);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Reads drained frames from the ring, without waiting for new ones.
+ *
+ * @param dev       - The device structure.
+ * @param frames    - Where to store the frames.
+ * @param nb_frames - Maximum number of frames.
+ * @param nb_read   - Number of frames read.
+ *
+ * @return ret      - Result of the reading procedure.
+*******************************************************************************/
+int adxl355_fifo_read_frames(struct adxl355_dev *dev,
+			     struct adxl355_fifo_frame *frames,
+			     uint32_t nb_frames, uint32_t *nb_read)
+{
+	uint32_t i;
+
+	if (!dev || !dev->fifo_ring || !frames || !nb_read)
+		return -EINVAL;
+
+	for (i = 0; i < nb_frames; i++)
+		if (no_os_ring_pop(dev->fifo_ring, &frames[i]))
+			break;
+
+	*nb_read = i;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Reads the counters of the FIFO drain engine.
+ *
+ * @param dev   - The device structure.
+ * @param stats - Where to store the counters.
+ *
+ * @return ret  - Result of the reading procedure.
+*******************************************************************************/
+int adxl355_fifo_get_stats(struct adxl355_dev *dev,
+			   struct adxl355_fifo_stats *stats)
+{
+	if (!dev || !stats)
+		return -EINVAL;
+
+	*stats = dev->fifo_stats;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Adds a FIFO entry to the frame being assembled in dev->fifo_part.
+ *        A frame cut short by an x-axis marker and the entries preceding the
+ *        next marker are dropped and counted.
+ *
+ * @param dev   - The device structure.
+ * @param entry - The FIFO entry.
+ *
+ * @return ret  - true if the entry completed a frame.
+*******************************************************************************/
+static bool adxl355_fifo_parse_entry(struct adxl355_dev *dev, uint8_t *entry)
+{
+	uint32_t raw_accel = adxl355_accel_array_conv(dev, entry);
+
+	if (entry[2] & ADXL355_FIFO_X_MARKER_MSK) {
+		if (dev->fifo_part_len) {
+			dev->fifo_stats.resyncs++;
+			dev->fifo_stats.dropped_entries += dev->fifo_part_len;
+		}
+		dev->fifo_part[0] = raw_accel;
+		dev->fifo_part_len = 1;
+		dev->fifo_synced = true;
+
+		return false;
+	}
+
+	if (!dev->fifo_part_len) {
+		// y or z-axis without x-axis: wait for the next marker
+		if (dev->fifo_synced)
+			dev->fifo_stats.resyncs++;
+		dev->fifo_synced = false;
+		dev->fifo_stats.dropped_entries++;
+
+		return false;
+	}
+
+	dev->fifo_part[dev->fifo_part_len++] = raw_accel;
+	if (dev->fifo_part_len < NO_OS_ARRAY_SIZE(dev->fifo_part))
+		return false;
+
+	dev->fifo_part_len = 0;
+
+	return true;
+}
+
+/***************************************************************************//**
+ * @brief Watermark interrupt handler.
+ *
+ * @param ctx   - The device structure.
+ * @param event - Unused.
+ * @param extra - Unused.
+*******************************************************************************/
+static void adxl355_fifo_irq_handler(void *ctx, uint32_t event, void *extra)
+{
+	adxl355_fifo_drain(ctx);
+}
+
 /***************************************************************************//**
  * @brief Converts array of raw acceleration to uint32 data raw acceleration
  *
@@ -43,10 +43,14 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include "no_os_util.h"
 #include "no_os_i2c.h"
 #include "no_os_spi.h"
+#include "no_os_irq.h"
+#include "no_os_timer.h"
+#include "no_os_ring.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -126,6 +130,22 @@
 #define ADXL355_HPF_FIELD_MSK      NO_OS_GENMASK( 6,  4)
 #define ADXL355_INT_POL_FIELD_MSK  NO_OS_BIT(6)
 
+/* FIFO entries: 3 bytes per axis, flags in the last byte */
+#define ADXL355_FIFO_ENTRY_LEN     3
+#define ADXL355_FIFO_MAX_ENTRIES   96
+#define ADXL355_FIFO_MAX_FRAMES    32
+#define ADXL355_FIFO_X_MARKER_MSK  NO_OS_BIT(0)
+#define ADXL355_FIFO_EMPTY_MSK     NO_OS_BIT(1)
+
+/*
+ * I2C reads without i2c transfer support are split in chunks of at most
+ * 255 bytes, keeping the FIFO entries whole
+ */
+#define ADXL355_I2C_CHUNK_LEN      255
+
+/* Sample period at ADXL355_ODR_4000HZ, doubled by each lower ODR setting */
+#define ADXL355_ODR_4000HZ_PERIOD_NS  250000
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -180,6 +200,11 @@ enum adxl355_int_pol {
 	ADXL355_INT_ACTIVE_HIGH = 1
 };
 
+enum adxl355_int_pin {
+	ADXL355_INT1,
+	ADXL355_INT2
+};
+
 union adxl355_comm_init_param {
 	/** I2C Initialization structure. */
 	no_os_i2c_init_param i2c_init;
@@ -245,6 +270,67 @@ struct adxl355_frac_repr {
 	int32_t fractional;
 } ;
 
+/**
+ * @struct adxl355_fifo_frame
+ * @brief One xyz sample drained from the FIFO.
+ */
+struct adxl355_fifo_frame {
+	/** Sampling time in ns, see adxl355_fifo_stream_init_param.timer */
+	uint64_t timestamp;
+	/** Raw x-axis data */
+	uint32_t raw_x;
+	/** Raw y-axis data */
+	uint32_t raw_y;
+	/** Raw z-axis data */
+	uint32_t raw_z;
+};
+
+/**
+ * @struct adxl355_fifo_stream_init_param
+ * @brief Parameters of the interrupt driven FIFO drain engine.
+ */
+struct adxl355_fifo_stream_init_param {
+	/**
+	 * Interrupt controller of the pin wired to the watermark interrupt.
+	 * NULL if adxl355_fifo_drain() is polled by the application.
+	 */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt ID of the pin */
+	uint32_t irq_id;
+	/** Platform specific callback configuration, see no_os_callback_desc */
+	void *irq_config;
+	/** Device pin signalling the watermark */
+	enum adxl355_int_pin int_pin;
+	/** Watermark in frames, 1 to 32 */
+	uint8_t watermark;
+	/** Number of frames the ring can hold, must be a power of 2 */
+	uint32_t nb_frames;
+	/**
+	 * Running timer the frames are timestamped with. If NULL, the
+	 * timestamps count sample periods since adxl355_fifo_stream_start().
+	 * Needs a build with ADXL355_TIMER_SUPPORT and a platform implementing
+	 * no_os_timer_get_elapsed_time_nsec().
+	 */
+	struct no_os_timer_desc *timer;
+};
+
+/**
+ * @struct adxl355_fifo_stats
+ * @brief Counters of the FIFO drain engine.
+ */
+struct adxl355_fifo_stats {
+	/** Frames pushed into the ring */
+	uint32_t frames;
+	/** Device FIFO overflows: samples were lost before a drain */
+	uint32_t fifo_overflows;
+	/** Frames dropped because the ring was full */
+	uint32_t ring_overflows;
+	/** Times the frame alignment was lost and found again */
+	uint32_t resyncs;
+	/** Entries discarded while resynchronizing */
+	uint32_t dropped_entries;
+};
+
 union adxl355_comm_desc {
 	/** I2C Descriptor */
 	no_os_i2c_desc *i2c_desc;
@@ -273,11 +359,31 @@ struct adxl355_dev {
 	uint8_t act_cnt;
 	uint16_t act_thr;
 	uint8_t comm_buff[289];
+	/** Frames drained from the FIFO, see adxl355_fifo_stream_init() */
+	struct no_os_ring *fifo_ring;
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	uint32_t irq_id;
+	struct no_os_timer_desc *timer;
+	/** Timestamp of the next frame when there is no timer */
+	uint64_t fifo_time;
+	/** Axes of the frame being assembled, carried over between drains */
+	uint32_t fifo_part[3];
+	uint8_t fifo_part_len;
+	bool fifo_synced;
+	struct adxl355_fifo_stats fifo_stats;
 };
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
+/*! Reads from the device. */
+int adxl355_read_device_data(struct adxl355_dev *dev, uint8_t base_address,
+			     uint16_t size, uint8_t *read_data);
+
+/*! Writes to the device. */
+int adxl355_write_device_data(struct adxl355_dev *dev, uint8_t base_address,
+			      uint16_t size, uint8_t *write_data);
+
 /*! Init. the comm. peripheral and checks if the ADXL355 part is present. */
 int adxl355_init(struct adxl355_dev **device,
 		 struct adxl355_init_param init_param);
@@ -363,4 +469,32 @@ int adxl355_config_int_pins(struct adxl355_dev *dev,
 /*! Configures the interrupt polarity. */
 int adxl355_set_int_pol(struct adxl355_dev *dev, enum adxl355_int_pol int_pol);
 
+/*! Sets up the interrupt driven FIFO drain engine. */
+int adxl355_fifo_stream_init(struct adxl355_dev *dev,
+			     struct adxl355_fifo_stream_init_param *param);
+
+/*! Free the resources allocated by adxl355_fifo_stream_init(). */
+int adxl355_fifo_stream_remove(struct adxl355_dev *dev);
+
+/*! Starts draining the FIFO on watermark interrupts. */
+int adxl355_fifo_stream_start(struct adxl355_dev *dev);
+
+/*! Drains the FIFO with the watermark interrupt masked, then unmasks it. */
+int adxl355_fifo_stream_rearm(struct adxl355_dev *dev);
+
+/*! Stops draining the FIFO on watermark interrupts. */
+int adxl355_fifo_stream_stop(struct adxl355_dev *dev);
+
+/*! Moves all the FIFO entries into the ring. */
+int adxl355_fifo_drain(struct adxl355_dev *dev);
+
+/*! Reads drained frames from the ring. */
+int adxl355_fifo_read_frames(struct adxl355_dev *dev,
+			     struct adxl355_fifo_frame *frames,
+			     uint32_t nb_frames, uint32_t *nb_read);
+
+/*! Reads the counters of the FIFO drain engine. */
+int adxl355_fifo_get_stats(struct adxl355_dev *dev,
+			   struct adxl355_fifo_stats *stats);
+
 #endif /* __ADXL355_H__ */
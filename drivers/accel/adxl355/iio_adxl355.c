@@ -0,0 +1,366 @@
+/***************************************************************************//**
+ *   @file   iio_adxl355.c
+ *   @brief  Implementation of the ADXL355 IIO driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "iio_types.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "adxl355.h"
+#include "iio.h"
+#include "no_os_util.h"
+#include "no_os_error.h"
+
+/* Scale at +/- 2g, in nano m/s^2 per LSB, see ADXL355_ACC_SCALE_FACTOR_MUL */
+#define ADXL355_IIO_SCALE_NANO	38245
+
+/* Output data rates in mHz, indexed by enum adxl355_odr_lpf */
+static const uint32_t adxl355_iio_odr_mhz[] = {
+	[ADXL355_ODR_4000HZ] = 4000000,
+	[ADXL355_ODR_2000HZ] = 2000000,
+	[ADXL355_ODR_1000HZ] = 1000000,
+	[ADXL355_ODR_500HZ] = 500000,
+	[ADXL355_ODR_250HZ] = 250000,
+	[ADXL355_ODR_125HZ] = 125000,
+	[ADXL355_ODR_62_5HZ] = 62500,
+	[ADXL355_ODR_31_25HZ] = 31250,
+	[ADXL355_ODR_15_625HZ] = 15625,
+	[ADXL355_ODR_7_813HZ] = 7813,
+	[ADXL355_ODR_3_906HZ] = 3906,
+};
+
+static int get_adxl355_iio_ch_raw(void *device, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel,
+				  intptr_t priv)
+{
+	uint32_t raw[3];
+	int32_t data;
+	int ret;
+
+	ret = adxl355_get_raw_xyz((struct adxl355_dev *)device, &raw[0],
+				  &raw[1], &raw[2]);
+	if (ret)
+		return ret;
+
+	// 20-bit two's complement
+	data = raw[channel->ch_num];
+	if (data & NO_OS_BIT(19))
+		data |= ADXL355_NEG_ACC_MSK;
+
+	return snprintf(buf, len, "%"PRIi32"", data);
+}
+
+static int get_adxl355_iio_ch_scale(void *device, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct adxl355_dev *dev = device;
+
+	// The scale doubles with each range
+	return snprintf(buf, len, "0.%09"PRIu32"",
+			(uint32_t)ADXL355_IIO_SCALE_NANO << (dev->range - 1));
+}
+
+static int get_adxl355_iio_odr(void *device, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel,
+			       intptr_t priv)
+{
+	struct adxl355_dev *dev = device;
+	uint32_t odr = adxl355_iio_odr_mhz[dev->odr_lpf];
+
+	return snprintf(buf, len, "%"PRIu32".%03"PRIu32"", odr / 1000,
+			odr % 1000);
+}
+
+static int set_adxl355_iio_odr(void *device, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel,
+			       intptr_t priv)
+{
+	uint32_t odr = (uint32_t)(strtof(buf, NULL) * 1000 + 0.5);
+	uint8_t i;
+	int ret;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(adxl355_iio_odr_mhz); i++)
+		if (adxl355_iio_odr_mhz[i] == odr) {
+			ret = adxl355_set_odr_lpf(device,
+						  (enum adxl355_odr_lpf)i);
+			if (ret)
+				return ret;
+
+			return len;
+		}
+
+	return -EINVAL;
+}
+
+static int get_adxl355_iio_odr_available(void *device, char *buf,
+					 uint32_t len,
+					 const struct iio_ch_info *channel,
+					 intptr_t priv)
+{
+	uint32_t odr;
+	int ret = 0;
+	uint8_t i;
+
+	buf[0] = '\0';
+	for (i = 0; i < NO_OS_ARRAY_SIZE(adxl355_iio_odr_mhz); i++) {
+		odr = adxl355_iio_odr_mhz[i];
+		ret += snprintf(buf + ret, len - ret, "%s%"PRIu32".%03"PRIu32"",
+				i ? " " : "", odr / 1000, odr % 1000);
+		if ((uint32_t)ret >= len)
+			return -EINVAL;
+	}
+
+	return ret;
+}
+
+static int32_t adxl355_iio_reg_read(void *device, uint32_t reg,
+				    uint32_t *readval)
+{
+	uint8_t data;
+	int ret;
+
+	ret = adxl355_read_device_data(device, ADXL355_ADDR(reg), 1, &data);
+	if (ret)
+		return ret;
+
+	*readval = data;
+
+	return 0;
+}
+
+static int32_t adxl355_iio_reg_write(void *device, uint32_t reg,
+				     uint32_t writeval)
+{
+	uint8_t data = writeval;
+
+	return adxl355_write_device_data(device, ADXL355_ADDR(reg), 1, &data);
+}
+
+static int32_t adxl355_iio_pre_enable(void *device, uint32_t mask)
+{
+	return adxl355_fifo_stream_start(device);
+}
+
+static int32_t adxl355_iio_post_disable(void *device)
+{
+	return adxl355_fifo_stream_stop(device);
+}
+
+/**
+ * @brief Get a drained frame without waiting. When the ring is empty, the FIFO
+ * is drained with the interrupt masked, which also recovers a stream stalled
+ * by a missed watermark edge.
+ * @param dev - The device structure.
+ * @param frame - Where to store the frame.
+ * @return 0 in case of success, -EAGAIN if no frame is available yet or
+ *	   negative value otherwise.
+ */
+static int adxl355_iio_read_frame(struct adxl355_dev *dev,
+				  struct adxl355_fifo_frame *frame)
+{
+	uint32_t nb_read;
+	int ret;
+
+	ret = adxl355_fifo_read_frames(dev, frame, 1, &nb_read);
+	if (ret || nb_read)
+		return ret;
+
+	ret = adxl355_fifo_stream_rearm(dev);
+	if (ret)
+		return ret;
+
+	ret = adxl355_fifo_read_frames(dev, frame, 1, &nb_read);
+	if (ret)
+		return ret;
+
+	return nb_read ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Fill a block of the iio buffer with drained frames, keeping the
+ * active channels only. It doesn't wait for frames: the scans available are
+ * pushed to the buffer and -EAGAIN is returned until a block is complete, so
+ * iiod can serve the other clients and call it again.
+ * @param dev_data - Device instance and iio buffer
+ * @return 0 in case of success, -EAGAIN if the block is not complete yet or
+ *	   negative value otherwise.
+ */
+static int32_t adxl355_iio_submit(struct iio_device_data *dev_data)
+{
+	struct adxl355_dev *dev = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	struct adxl355_fifo_frame frame;
+	uint8_t scan[sizeof(frame)];
+	uint32_t used;
+	uint8_t *p;
+	int32_t ret;
+
+	ret = no_os_cb_size(buffer->buf, &used);
+	if (ret)
+		return ret;
+
+	while (used < buffer->block_size) {
+		ret = adxl355_iio_read_frame(dev, &frame);
+		if (ret)
+			return ret;
+
+		p = scan;
+		if (buffer->active_mask & NO_OS_BIT(0)) {
+			memcpy(p, &frame.raw_x, sizeof(frame.raw_x));
+			p += sizeof(frame.raw_x);
+		}
+		if (buffer->active_mask & NO_OS_BIT(1)) {
+			memcpy(p, &frame.raw_y, sizeof(frame.raw_y));
+			p += sizeof(frame.raw_y);
+		}
+		if (buffer->active_mask & NO_OS_BIT(2)) {
+			memcpy(p, &frame.raw_z, sizeof(frame.raw_z));
+			p += sizeof(frame.raw_z);
+		}
+		if (buffer->active_mask & NO_OS_BIT(3)) {
+			memcpy(p, &frame.timestamp, sizeof(frame.timestamp));
+			p += sizeof(frame.timestamp);
+		}
+
+		ret = iio_buffer_push_scan(buffer, scan);
+		if (ret)
+			return ret;
+
+		used += buffer->bytes_per_scan;
+	}
+
+	return 0;
+}
+
+static struct iio_attribute adxl355_iio_accel_attrs[] = {
+	{
+		.name = "raw",
+		.show = get_adxl355_iio_ch_raw,
+		.store = NULL
+	},
+	{
+		.name = "scale",
+		.show = get_adxl355_iio_ch_scale,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute adxl355_iio_dev_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.show = get_adxl355_iio_odr,
+		.store = set_adxl355_iio_odr
+	},
+	{
+		.name = "sampling_frequency_available",
+		.show = get_adxl355_iio_odr_available,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type scan_type_accel = {
+	.sign = 's',
+	.realbits = 20,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct scan_type scan_type_timestamp = {
+	.sign = 's',
+	.realbits = 64,
+	.storagebits = 64,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct iio_channel adxl355_iio_channels[] = {
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = 0,
+		.modified = 1,
+		.channel2 = IIO_MOD_X,
+		.scan_index = 0,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl355_iio_accel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = 1,
+		.modified = 1,
+		.channel2 = IIO_MOD_Y,
+		.scan_index = 1,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl355_iio_accel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = 2,
+		.modified = 1,
+		.channel2 = IIO_MOD_Z,
+		.scan_index = 2,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl355_iio_accel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_TIMESTAMP,
+		.scan_index = 3,
+		.scan_type = &scan_type_timestamp,
+		.attributes = NULL,
+		.ch_out = false,
+	}
+};
+
+struct iio_device adxl355_iio_descriptor = {
+	.num_ch = NO_OS_ARRAY_SIZE(adxl355_iio_channels),
+	.channels = adxl355_iio_channels,
+	.attributes = adxl355_iio_dev_attrs,
+	.debug_attributes = NULL,
+	.buffer_attributes = NULL,
+	.pre_enable = adxl355_iio_pre_enable,
+	.post_disable = adxl355_iio_post_disable,
+	.submit = adxl355_iio_submit,
+	.debug_reg_read = adxl355_iio_reg_read,
+	.debug_reg_write = adxl355_iio_reg_write
+};
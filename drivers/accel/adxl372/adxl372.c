@@ -44,6 +44,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <errno.h>
 #include "adxl372.h"
 
 /******************************************************************************/
@@ -529,6 +530,7 @@ int32_t adxl372_configure_fifo(struct adxl372_dev *dev,
 	dev->fifo_config.fifo_format = format;
 	dev->fifo_config.fifo_mode = mode;
 	dev->fifo_config.fifo_samples = fifo_samples;
+	dev->fifo_part_len = 0;
 
 	return ret;
 }
@@ -581,7 +583,8 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 }
 
 /**
- * Get the data stored in FIFO.
+ * Get the data stored in FIFO. The samples are read straight into the
+ * caller array, then decoded in place.
  * @param dev - The device structure.
  * @param samples - pointer to the raw data stored in the ADXL372_FIFO_DATA
  * @param cnt - How many samples should be retrieved from the FIFO DATA reg
@@ -591,12 +594,12 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  struct adxl372_xyz_accel_data *samples,
 				  uint16_t cnt)
 {
-	uint8_t buf[1024];
+	uint16_t *data = (uint16_t *)samples;
+	uint8_t *buf = (uint8_t *)samples;
 	uint16_t i;
 	int32_t ret;
 
-
-	if (cnt > 512)
+	if (cnt > ADXL372_FIFO_MAX_SAMPLES)
 		return -1;
 	/*
 	 * The FIFO can hold up to 512 samples.
@@ -609,16 +612,298 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < cnt * 2; i += 6) {
-		samples->x = ((buf[i] << 4) | (buf[i+1] >> 4));
-		samples->y = ((buf[i+2] << 4) | (buf[i+3] >> 4));
-		samples->z = ((buf[i+4] << 4) | (buf[i+5] >> 4));
-		samples++;
-	}
+	/* Each decoded sample takes the place of its 2 bytes */
+	for (i = 0; i < cnt; i++)
+		data[i] = (buf[i * 2] << 4) | (buf[i * 2 + 1] >> 4);
 
 	return ret;
 }
 
+/**
+ * Get the number of samples in each set of a FIFO format.
+ * @param format - FIFO Format.
+ * @return 3 for the xyz formats, 2 for two axes and 1 for a single axis.
+ */
+uint8_t adxl372_fifo_set_len(enum adxl372_fifo_format format)
+{
+	static const uint8_t set_len[] = {
+		[ADXL372_XYZ_FIFO] = 3,
+		[ADXL372_X_FIFO] = 1,
+		[ADXL372_Y_FIFO] = 1,
+		[ADXL372_XY_FIFO] = 2,
+		[ADXL372_Z_FIFO] = 1,
+		[ADXL372_XZ_FIFO] = 2,
+		[ADXL372_YZ_FIFO] = 2,
+		[ADXL372_XYZ_PEAK_FIFO] = 3,
+	};
+
+	return set_len[format];
+}
+
+/**
+ * Decode FIFO samples in place: each 2 bytes big endian sample becomes a sign
+ * extended int16_t. With several axes per set, the sets are aligned on the
+ * series start indicator of their first sample: a set cut short and the
+ * samples preceding the next indicator are dropped. The start of a set cut by
+ * the end of the samples is kept in the device for the next read.
+ * @param dev - The device structure.
+ * @param samples - The start of a set from the previous read, decoded,
+ *		    followed by the samples as read from ADXL372_FIFO_DATA.
+ * @param part_len - Number of samples from the previous read.
+ * @param cnt - Number of samples, including the ones from the previous read.
+ * @return Number of decoded samples, a multiple of the set length.
+ */
+static uint32_t adxl372_fifo_decode(struct adxl372_dev *dev,
+				    int16_t *samples,
+				    uint8_t part_len,
+				    uint32_t cnt)
+{
+	uint8_t set_len = adxl372_fifo_set_len(dev->fifo_config.fifo_format);
+	uint8_t *buf = (uint8_t *)samples;
+	struct adxl372_fifo_stats *stats = &dev->fifo_stats;
+	bool synced = true;
+	uint32_t i, nb = part_len;
+	uint16_t raw;
+	uint8_t pos = part_len;
+
+	/* nb <= i, a sample is read before its place is overwritten */
+	for (i = part_len; i < cnt; i++) {
+		raw = no_os_get_unaligned_be16(&buf[i * 2]);
+
+		if (set_len > 1) {
+			if ((raw & ADXL372_FIFO_SERIES_START_MSK) && pos) {
+				stats->resyncs++;
+				stats->dropped_samples += pos;
+				nb -= pos;
+				pos = 0;
+			}
+			if (!(raw & ADXL372_FIFO_SERIES_START_MSK) && !pos) {
+				if (synced)
+					stats->resyncs++;
+				synced = false;
+				stats->dropped_samples++;
+				continue;
+			}
+			synced = true;
+		}
+
+		samples[nb++] = (int16_t)(raw & 0xFFF0) / 16;
+		if (++pos == set_len)
+			pos = 0;
+	}
+
+	nb -= pos;
+	memcpy(dev->fifo_part, &samples[nb], pos * sizeof(*samples));
+	dev->fifo_part_len = pos;
+	stats->sets += nb / set_len;
+
+	return nb;
+}
+
+/**
+ * Read whole sets of samples from the FIFO straight into a buffer, then
+ * decode them in place. While the FIFO is being written, a set is left in it.
+ * @param dev - The device structure.
+ * @param samples - Where to store the samples.
+ * @param nb_samples - Maximum number of samples.
+ * @param nb_read - Number of samples read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adxl372_fifo_read_chunk(struct adxl372_dev *dev,
+				       int16_t *samples,
+				       uint32_t nb_samples,
+				       uint32_t *nb_read)
+{
+	uint8_t set_len = adxl372_fifo_set_len(dev->fifo_config.fifo_format);
+	uint8_t part_len = dev->fifo_part_len;
+	uint8_t status1, status2;
+	uint16_t entries;
+	bool filling;
+	uint32_t cnt;
+	int32_t ret;
+
+	*nb_read = 0;
+
+	ret = adxl372_get_status(dev, &status1, &status2, &entries);
+	if (ret)
+		return ret;
+
+	if (ADXL372_STATUS_1_FIFO_OVR(status1))
+		dev->fifo_stats.fifo_overflows++;
+
+	/*
+	 * When reading data from multiple axes from the FIFO, to ensure that
+	 * data is not overwritten and stored out of order, at least one sample
+	 * set must be left in the FIFO after every read. This is not needed
+	 * once a triggered or oldest saved FIFO is full.
+	 */
+	filling = dev->fifo_config.fifo_mode == ADXL372_FIFO_STREAMED ||
+		  !ADXL372_STATUS_1_FIFO_FULL(status1);
+	if (set_len > 1 && filling)
+		entries = entries > set_len ? entries - set_len : 0;
+
+	if (nb_samples <= part_len)
+		return 0;
+
+	/* Whole sets, counting the start of the one cut by the last read */
+	cnt = no_os_min((uint32_t)entries, nb_samples - part_len) + part_len;
+	cnt -= cnt % set_len;
+	if (cnt <= part_len)
+		return 0;
+
+	ret = adxl372_read_reg_multiple(dev, ADXL372_FIFO_DATA,
+					(uint8_t *)&samples[part_len],
+					(cnt - part_len) * 2);
+	if (ret)
+		return ret;
+
+	memcpy(samples, dev->fifo_part, part_len * sizeof(*samples));
+	*nb_read = adxl372_fifo_decode(dev, samples, part_len, cnt);
+
+	return 0;
+}
+
+/**
+ * Drain the FIFO into a buffer of any size, in chunks of up to 512 samples.
+ * The samples are read straight into the buffer and decoded in place, in
+ * sets of adxl372_fifo_set_len() samples following the FIFO format. Returns
+ * when the buffer is full or when the FIFO has no more complete set.
+ * @param dev - The device structure.
+ * @param samples - Where to store the samples.
+ * @param nb_samples - Maximum number of samples.
+ * @param nb_read - Number of samples read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_read(struct adxl372_dev *dev,
+			  int16_t *samples,
+			  uint32_t nb_samples,
+			  uint32_t *nb_read)
+{
+	uint32_t cnt;
+	int32_t ret;
+
+	if (!dev || !samples || !nb_read)
+		return -EINVAL;
+
+	*nb_read = 0;
+	do {
+		ret = adxl372_fifo_read_chunk(dev, samples + *nb_read,
+					      nb_samples - *nb_read, &cnt);
+		if (ret)
+			return ret;
+
+		*nb_read += cnt;
+	} while (cnt && *nb_read < nb_samples);
+
+	return 0;
+}
+
+/**
+ * Drain the FIFO into a ring, without copying: the samples are read into the
+ * reserved elements and decoded in place. Can be called from the FIFO_FULL or
+ * FIFO_RDY interrupt handler. When the ring is full the samples stay in the
+ * FIFO.
+ * @param dev - The device structure.
+ * @param ring - A NO_OS_RING_SPSC ring of adxl372_fifo_set_len() * 2 bytes
+ *		 elements.
+ * @param nb_sets - Number of sets written into the ring.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_read_ring(struct adxl372_dev *dev,
+			       struct no_os_ring *ring,
+			       uint32_t *nb_sets)
+{
+	uint8_t set_len;
+	struct no_os_ring_span span;
+	uint32_t max_sets, cnt;
+	int32_t ret;
+
+	if (!dev || !ring || !nb_sets)
+		return -EINVAL;
+
+	set_len = adxl372_fifo_set_len(dev->fifo_config.fifo_format);
+	max_sets = ADXL372_FIFO_MAX_SAMPLES / set_len;
+	*nb_sets = 0;
+	do {
+		ret = no_os_ring_reserve_write(ring, max_sets, &span);
+		if (ret == -EAGAIN)
+			return 0;
+		if (ret)
+			return ret;
+
+		ret = adxl372_fifo_read_chunk(dev, span.buff,
+					      span.nb_elems * set_len, &cnt);
+		if (ret)
+			return ret;
+
+		span.nb_elems = cnt / set_len;
+		ret = no_os_ring_commit_write(ring, &span);
+		if (ret)
+			return ret;
+
+		*nb_sets += span.nb_elems;
+	} while (span.nb_elems);
+
+	return 0;
+}
+
+/**
+ * Get the counters of the FIFO streaming reads.
+ * @param dev - The device structure.
+ * @param stats - Where to store the counters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_get_stats(struct adxl372_dev *dev,
+			       struct adxl372_fifo_stats *stats)
+{
+	if (!dev || !stats)
+		return -EINVAL;
+
+	*stats = dev->fifo_stats;
+
+	return 0;
+}
+
+/**
+ * Arm the instant-on impact capture. The device waits in instant-on mode
+ * until the instant-on threshold is crossed, then measures and the FIFO,
+ * in triggered mode, keeps pre_trigger_samples samples before the activity
+ * event and fills up after it. Once FIFO_FULL is set, the capture is read
+ * with adxl372_fifo_read() and this function is called again to re-arm.
+ * @param dev - The device structure.
+ * @param config - The capture configuration.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_impact_capture_arm(struct adxl372_dev *dev,
+				   struct adxl372_impact_config *config)
+{
+	int32_t ret;
+
+	if (!dev || !config)
+		return -EINVAL;
+
+	ret = adxl372_set_op_mode(dev, ADXL372_STANDBY);
+	if (ret < 0)
+		return ret;
+
+	ret = adxl372_set_instant_on_th(dev, config->th_mode);
+	if (ret < 0)
+		return ret;
+
+	ret = adxl372_set_activity_threshold(dev, ADXL372_ACTIVITY,
+					     config->act_thresh, false, true);
+	if (ret < 0)
+		return ret;
+
+	ret = adxl372_configure_fifo(dev, ADXL372_FIFO_TRIGGERED,
+				     config->fifo_format,
+				     config->pre_trigger_samples);
+	if (ret < 0)
+		return ret;
+
+	return adxl372_set_op_mode(dev, ADXL372_INSTANT_ON);
+}
+
 /**
  * Retrieve the highest magnitude (x, y, z) sample recorded since the last
  * read of the MAXPEAK registers
@@ -708,6 +993,8 @@ int32_t adxl372_init(struct adxl372_dev **device,
 		goto error;
 
 	dev->comm_type = init_param.comm_type;
+	memset(&dev->fifo_stats, 0, sizeof(dev->fifo_stats));
+	dev->fifo_part_len = 0;
 	if (dev->comm_type == SPI) {
 		/* SPI */
 		ret = no_os_spi_init(&dev->spi_desc, &init_param.spi_init);
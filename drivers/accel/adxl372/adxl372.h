@@ -44,11 +44,13 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_util.h"
 #include "no_os_delay.h"
 #include "no_os_gpio.h"
 #include "no_os_i2c.h"
 #include "no_os_spi.h"
+#include "no_os_ring.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -161,6 +163,20 @@
 #define ADXL372_FIFO_CTL_SAMPLES_MSK		NO_OS_BIT(0)
 #define ADXL372_FIFO_CTL_SAMPLES_MODE(x)	(((x) > 0xFF) ? 1 : 0)
 
+/* ADXL372_FIFO_DATA */
+#define ADXL372_FIFO_MAX_SAMPLES		512
+#define ADXL372_FIFO_MAX_SET_LEN		3
+#define ADXL372_FIFO_SERIES_START_MSK		NO_OS_BIT(0)
+
+/* Multibyte SPI reads without spi transfer support are split in chunks */
+#define ADXL372_SPI_CHUNK_LEN			64
+
+/*
+ * Multibyte I2C reads without i2c transfer support are split in chunks of at
+ * most 255 bytes, keeping the 2 bytes FIFO entries whole
+ */
+#define ADXL372_I2C_CHUNK_LEN			254
+
 /* ADXL372_STATUS_1 */
 #define ADXL372_STATUS_1_DATA_RDY(x)		(((x) >> 0) & 0x1)
 #define ADXL372_STATUS_1_FIFO_RDY(x)		(((x) >> 1) & 0x1)
@@ -341,6 +357,38 @@ struct adxl372_xyz_accel_data {
 	uint16_t z;
 } ;
 
+/**
+ * @struct adxl372_fifo_stats
+ * @brief Counters of the FIFO streaming reads.
+ */
+struct adxl372_fifo_stats {
+	/** Sample sets read */
+	uint32_t sets;
+	/** FIFO overflows: samples were lost between two reads */
+	uint32_t fifo_overflows;
+	/** Times the set alignment was lost and found again */
+	uint32_t resyncs;
+	/** Samples discarded while resynchronizing */
+	uint32_t dropped_samples;
+};
+
+/**
+ * @struct adxl372_impact_config
+ * @brief Instant-on impact capture: the device sleeps until the instant-on
+ * threshold is crossed, then the FIFO keeps the samples around the activity
+ * event.
+ */
+struct adxl372_impact_config {
+	/** Instant-on wake up threshold */
+	enum adxl372_instant_on_th_mode	th_mode;
+	/** Activity threshold triggering the FIFO */
+	uint16_t			act_thresh;
+	/** ADXL372_XYZ_FIFO or ADXL372_XYZ_PEAK_FIFO, or single axes */
+	enum adxl372_fifo_format	fifo_format;
+	/** Samples kept before the activity event, up to 512 */
+	uint16_t			pre_trigger_samples;
+};
+
 struct adxl372_irq_config {
 	bool data_rdy;
 	bool fifo_rdy;
@@ -384,6 +432,10 @@ struct adxl372_dev {
 	enum adxl372_instant_on_th_mode	th_mode;
 	struct adxl372_fifo_config	fifo_config;
 	enum adxl372_comm_type		comm_type;
+	struct adxl372_fifo_stats	fifo_stats;
+	/* Start of a set cut by the end of a FIFO read, already decoded */
+	int16_t				fifo_part[ADXL372_FIFO_MAX_SET_LEN - 1];
+	uint8_t				fifo_part_len;
 };
 
 struct adxl372_init_param {
@@ -480,6 +532,18 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 				struct adxl372_xyz_accel_data *fifo_data,
 				uint16_t *fifo_entries);
+uint8_t adxl372_fifo_set_len(enum adxl372_fifo_format format);
+int32_t adxl372_fifo_read(struct adxl372_dev *dev,
+			  int16_t *samples,
+			  uint32_t nb_samples,
+			  uint32_t *nb_read);
+int32_t adxl372_fifo_read_ring(struct adxl372_dev *dev,
+			       struct no_os_ring *ring,
+			       uint32_t *nb_sets);
+int32_t adxl372_fifo_get_stats(struct adxl372_dev *dev,
+			       struct adxl372_fifo_stats *stats);
+int32_t adxl372_impact_capture_arm(struct adxl372_dev *dev,
+				   struct adxl372_impact_config *config);
 int32_t adxl372_get_highest_peak_data(struct adxl372_dev *dev,
 				      struct adxl372_xyz_accel_data *max_peak);
 int32_t adxl372_get_accel_data(struct adxl372_dev *dev,
@@ -54,22 +54,12 @@ int32_t adxl372_i2c_reg_read(struct adxl372_dev *dev,
 			     uint8_t reg_addr,
 			     uint8_t *reg_data)
 {
-	uint8_t data;
-	int32_t ret;
-
-	data = reg_addr;
-
-	ret = no_os_i2c_write(dev->i2c_desc, &data, 1, 0);
-	if (ret < 0)
-		return ret;
-
-	ret = no_os_i2c_read(dev->i2c_desc, &data, 1, 0);
-	if (ret < 0)
-		return ret;
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buff = &reg_addr, .bytes_number = 1 },
+		{ .buff = reg_data, .bytes_number = 1, .flags = NO_OS_I2C_M_RD }
+	};
 
-	*reg_data = data;
-
-	return ret;
+	return no_os_i2c_transfer(dev->i2c_desc, msgs, NO_OS_ARRAY_SIZE(msgs));
 }
 
 /**
@@ -93,7 +83,9 @@ int32_t adxl372_i2c_reg_write(struct adxl372_dev *dev,
 
 /**
  * Multibyte read from device. A register read begins with the address
- * and autoincrements for each aditional byte in the transfer.
+ * and autoincrements for each aditional byte in the transfer, except for
+ * ADXL372_FIFO_DATA which is read repeatedly. Without i2c transfer support
+ * the read is split in ADXL372_I2C_CHUNK_LEN transfers.
  * @param dev - The device structure.
  * @param reg_addr - The register address.
  * @param reg_data - The register data.
@@ -105,24 +97,32 @@ int32_t adxl372_i2c_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[512];
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buff = &reg_addr, .bytes_number = 1 },
+		{ .buff = reg_data, .bytes_number = count, .flags = NO_OS_I2C_M_RD }
+	};
+	uint16_t chunk_len = count;
+	uint16_t len;
 	int32_t ret;
 
-	if (count > 512)
-		return -1;
-
-	buf[0] = reg_addr;
-	memset(&buf[1], 0x00, count - 1);
+	if (!dev->i2c_desc->platform_ops->i2c_ops_transfer)
+		chunk_len = ADXL372_I2C_CHUNK_LEN;
 
-	ret = no_os_i2c_write(dev->i2c_desc, buf, 1, 0);
-	if (ret < 0)
-		return ret;
+	while (count) {
+		len = no_os_min(count, chunk_len);
+		msgs[1].buff = reg_data;
+		msgs[1].bytes_number = len;
 
-	ret = no_os_i2c_read(dev->i2c_desc, buf, count, 0);
-	if (ret < 0)
-		return ret;
+		ret = no_os_i2c_transfer(dev->i2c_desc, msgs,
+					 NO_OS_ARRAY_SIZE(msgs));
+		if (ret)
+			return ret;
 
-	memcpy(reg_data, buf, count);
+		reg_data += len;
+		count -= len;
+		if (reg_addr != ADXL372_FIFO_DATA)
+			reg_addr += len;
+	}
 
-	return ret;
+	return 0;
 }
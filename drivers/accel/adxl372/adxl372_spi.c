@@ -90,7 +90,10 @@ int32_t adxl372_spi_reg_write(struct adxl372_dev *dev,
 
 /**
  * Multibyte read from device. A register read begins with the address
- * and autoincrements for each aditional byte in the transfer.
+ * and autoincrements for each aditional byte in the transfer, except for
+ * ADXL372_FIFO_DATA which is read repeatedly. The data is received straight
+ * into reg_data when the platform supports spi transfers. Otherwise it goes
+ * through a small buffer, one ADXL372_SPI_CHUNK_LEN transfer at a time.
  * @param dev - The device structure.
  * @param reg_addr - The register address.
  * @param reg_data - The register data.
@@ -102,20 +105,35 @@ int32_t adxl372_spi_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[513];
+	uint8_t buf[ADXL372_SPI_CHUNK_LEN + 1];
+	uint8_t cmd = ADXL372_REG_READ(reg_addr);
+	struct no_os_spi_msg msgs[2] = {
+		{ .tx_buff = &cmd, .rx_buff = NULL, .bytes_number = 1 },
+		{ .rx_buff = reg_data, .bytes_number = count, .cs_change = 1 }
+	};
+	uint16_t len;
 	int32_t ret;
 
-	if (count > 512)
-		return -1;
+	if (dev->spi_desc->platform_ops->transfer)
+		return no_os_spi_transfer(dev->spi_desc, msgs,
+					  NO_OS_ARRAY_SIZE(msgs));
 
-	buf[0] = ADXL372_REG_READ(reg_addr);
-	memset(&buf[1], 0x00, count);
+	while (count) {
+		len = no_os_min(count, ADXL372_SPI_CHUNK_LEN);
 
-	ret = no_os_spi_write_and_read(dev->spi_desc, buf, count + 1);
-	if (ret < 0)
-		return ret;
+		buf[0] = ADXL372_REG_READ(reg_addr);
+		memset(&buf[1], 0x00, len);
 
-	memcpy(reg_data, &buf[1], count);
+		ret = no_os_spi_write_and_read(dev->spi_desc, buf, len + 1);
+		if (ret < 0)
+			return ret;
 
-	return ret;
+		memcpy(reg_data, &buf[1], len);
+		reg_data += len;
+		count -= len;
+		if (reg_addr != ADXL372_FIFO_DATA)
+			reg_addr += len;
+	}
+
+	return 0;
 }
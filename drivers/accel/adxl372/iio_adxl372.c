@@ -0,0 +1,304 @@
+/***************************************************************************//**
+ *   @file   iio_adxl372.c
+ *   @brief  Implementation of the ADXL372 IIO driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "iio_types.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "adxl372.h"
+#include "iio.h"
+#include "no_os_util.h"
+#include "no_os_error.h"
+#include "no_os_delay.h"
+
+/* Output data rate of ADXL372_ODR_400HZ, doubled by each higher setting */
+#define ADXL372_IIO_ODR_400HZ	400
+
+/*
+ * Time allowed for the FIFO to get a new sample. Samples arrive every 2.5 ms
+ * at the lowest output data rate, none arrive while the device is not
+ * measuring, e.g. after adxl372_impact_capture_arm().
+ */
+#define ADXL372_IIO_FIFO_TIMEOUT_MS	1000
+
+static int get_adxl372_iio_ch_raw(void *device, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel,
+				  intptr_t priv)
+{
+	struct adxl372_dev *dev = device;
+	uint8_t reg = ADXL372_X_DATA_H + channel->ch_num * 2;
+	uint8_t data[2];
+	int16_t raw;
+	int32_t ret;
+
+	// Last sample of the axis, without waiting for a new one
+	ret = dev->reg_read_multiple(dev, reg, data, NO_OS_ARRAY_SIZE(data));
+	if (ret)
+		return ret;
+
+	raw = (int16_t)(no_os_get_unaligned_be16(data) & 0xFFF0) / 16;
+
+	return snprintf(buf, len, "%d", raw);
+}
+
+static int get_adxl372_iio_ch_scale(void *device, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	// 100 mg/LSB = 0.980665 m/s^2
+	return snprintf(buf, len, "0.980665");
+}
+
+static int get_adxl372_iio_odr(void *device, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel,
+			       intptr_t priv)
+{
+	struct adxl372_dev *dev = device;
+
+	return snprintf(buf, len, "%d", ADXL372_IIO_ODR_400HZ << dev->odr);
+}
+
+static int set_adxl372_iio_odr(void *device, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel,
+			       intptr_t priv)
+{
+	int odr = strtol(buf, NULL, 10);
+	int32_t ret;
+	uint8_t i;
+
+	for (i = ADXL372_ODR_400HZ; i <= ADXL372_ODR_6400HZ; i++)
+		if ((ADXL372_IIO_ODR_400HZ << i) == odr) {
+			ret = adxl372_set_odr(device, (enum adxl372_odr)i);
+			if (ret)
+				return ret;
+
+			return len;
+		}
+
+	return -EINVAL;
+}
+
+static int get_adxl372_iio_odr_available(void *device, char *buf,
+					 uint32_t len,
+					 const struct iio_ch_info *channel,
+					 intptr_t priv)
+{
+	return snprintf(buf, len, "400 800 1600 3200 6400");
+}
+
+static int32_t adxl372_iio_reg_read(void *device, uint32_t reg,
+				    uint32_t *readval)
+{
+	struct adxl372_dev *dev = device;
+	uint8_t data;
+	int32_t ret;
+
+	ret = dev->reg_read(dev, reg, &data);
+	if (ret)
+		return ret;
+
+	*readval = data;
+
+	return 0;
+}
+
+static int32_t adxl372_iio_reg_write(void *device, uint32_t reg,
+				     uint32_t writeval)
+{
+	struct adxl372_dev *dev = device;
+
+	return dev->reg_write(dev, reg, writeval);
+}
+
+/**
+ * @brief Stream the active axes only: the FIFO formats X, Y, XY, Z, XZ and YZ
+ * match the masks of the channels they hold, xyz is ADXL372_XYZ_FIFO.
+ * @param device - The device structure.
+ * @param mask - Active channels.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t adxl372_iio_pre_enable(void *device, uint32_t mask)
+{
+	struct adxl372_dev *dev = device;
+	enum adxl372_fifo_format format;
+	int32_t ret;
+
+	mask &= NO_OS_GENMASK(2, 0);
+	format = (mask == NO_OS_GENMASK(2, 0)) ? ADXL372_XYZ_FIFO : mask;
+
+	ret = adxl372_configure_fifo(dev, ADXL372_FIFO_STREAMED, format,
+				     dev->fifo_config.fifo_samples);
+	if (ret)
+		return ret;
+
+	return adxl372_set_op_mode(dev, ADXL372_FULL_BW_MEASUREMENT);
+}
+
+static int32_t adxl372_iio_post_disable(void *device)
+{
+	struct adxl372_dev *dev = device;
+
+	return adxl372_configure_fifo(dev, ADXL372_FIFO_BYPASSED,
+				      ADXL372_XYZ_FIFO,
+				      dev->fifo_config.fifo_samples);
+}
+
+/**
+ * @brief Fill a block of the iio buffer from the FIFO, decoding the samples
+ * in place.
+ * @param dev_data - Device instance and iio buffer
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t adxl372_iio_submit(struct iio_device_data *dev_data)
+{
+	struct adxl372_dev *dev = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t timeout = ADXL372_IIO_FIFO_TIMEOUT_MS;
+	uint32_t nb_samples, nb_read, i;
+	int16_t *samples;
+	void *block;
+	int32_t ret;
+
+	ret = iio_buffer_get_block(buffer, &block);
+	if (ret)
+		return ret;
+
+	samples = block;
+	nb_samples = buffer->block_size / sizeof(*samples);
+	for (i = 0; i < nb_samples; i += nb_read) {
+		ret = adxl372_fifo_read(dev, samples + i, nb_samples - i,
+					&nb_read);
+		if (ret)
+			return ret;
+
+		if (nb_read) {
+			timeout = ADXL372_IIO_FIFO_TIMEOUT_MS;
+			continue;
+		}
+
+		if (!timeout--)
+			return -ETIMEDOUT;
+
+		no_os_mdelay(1);
+	}
+
+	return iio_buffer_block_done(buffer);
+}
+
+static struct iio_attribute adxl372_iio_accel_attrs[] = {
+	{
+		.name = "raw",
+		.show = get_adxl372_iio_ch_raw,
+		.store = NULL
+	},
+	{
+		.name = "scale",
+		.show = get_adxl372_iio_ch_scale,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute adxl372_iio_dev_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.show = get_adxl372_iio_odr,
+		.store = set_adxl372_iio_odr
+	},
+	{
+		.name = "sampling_frequency_available",
+		.show = get_adxl372_iio_odr_available,
+		.store = NULL
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type scan_type_accel = {
+	.sign = 's',
+	.realbits = 12,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct iio_channel adxl372_iio_channels[] = {
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = ADXL372_X_AXIS,
+		.modified = 1,
+		.channel2 = IIO_MOD_X,
+		.scan_index = 0,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl372_iio_accel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = ADXL372_Y_AXIS,
+		.modified = 1,
+		.channel2 = IIO_MOD_Y,
+		.scan_index = 1,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl372_iio_accel_attrs,
+		.ch_out = false,
+	},
+	{
+		.ch_type = IIO_ACCEL,
+		.channel = ADXL372_Z_AXIS,
+		.modified = 1,
+		.channel2 = IIO_MOD_Z,
+		.scan_index = 2,
+		.scan_type = &scan_type_accel,
+		.attributes = adxl372_iio_accel_attrs,
+		.ch_out = false,
+	}
+};
+
+struct iio_device adxl372_iio_descriptor = {
+	.num_ch = NO_OS_ARRAY_SIZE(adxl372_iio_channels),
+	.channels = adxl372_iio_channels,
+	.attributes = adxl372_iio_dev_attrs,
+	.debug_attributes = NULL,
+	.buffer_attributes = NULL,
+	.pre_enable = adxl372_iio_pre_enable,
+	.post_disable = adxl372_iio_post_disable,
+	.submit = adxl372_iio_submit,
+	.debug_reg_read = adxl372_iio_reg_read,
+	.debug_reg_write = adxl372_iio_reg_write
+};
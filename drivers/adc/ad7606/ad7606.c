@@ -50,6 +50,7 @@
 #include "no_os_error.h"
 #include "no_os_util.h"
 #include "no_os_crc.h"
+#include "no_os_unpack.h"
 
 struct ad7606_chip_info {
 	uint8_t num_channels;
@@ -354,52 +355,6 @@ int32_t ad7606_spi_write_mask(struct ad7606_dev *dev,
 	return ad7606_spi_reg_write(dev, addr, reg_data);
 }
 
-/* Internal function to copy the content of a buffer in 18-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy18b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 9)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 9) {
-		j = 4 * (i / 9);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 10) | ((uint32_t)psrc[i+1] << 2)
-			    | ((uint32_t)psrc[i+2] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+2] & 0x3f) << 12) | ((uint32_t)psrc[i+3] << 4)
-			    | ((uint32_t)psrc[i+4] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+4] & 0x0f) << 14) | ((uint32_t)psrc[i+5] << 6)
-			    | ((uint32_t)psrc[i+6] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+6] & 0x03) << 16) | ((uint32_t)psrc[i+7] << 8)
-			    | ((uint32_t)psrc[i+8] >> 0);
-	}
-	return 0;
-}
-
-/* Internal function to copy the content of a buffer in 26-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy26b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 13)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 13) {
-		j = 4 * (i / 13);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 18) | ((uint32_t)psrc[i+1] << 10)
-			    | ((uint32_t)psrc[i+2] << 2) | ((uint32_t)psrc[i+3] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+3] & 0x3f) << 20) | ((uint32_t)psrc[i+4] << 12)
-			    | ((uint32_t)psrc[i+5] << 4) | ((uint32_t)psrc[i+6] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+6] & 0x0f) << 22) | ((uint32_t)psrc[i+7] << 14)
-			    | ((uint32_t)psrc[i+8] << 6) | ((uint32_t)psrc[i+9] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+9] & 0x03) << 24) | ((uint32_t)psrc[i+10] << 16)
-			    | ((uint32_t)psrc[i+11] << 8) | ((uint32_t)psrc[i+12] >> 0);
-	}
-	return 0;
-}
-
 /***************************************************************************//**
  * @brief Toggle the CONVST pin to start a conversion.
  *
@@ -459,12 +414,15 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 {
 	uint32_t sz;
-	int32_t ret, i;
+	int32_t ret;
 	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
 	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
 
+	if (bits != 16 && bits != 18)
+		return -ENOTSUP;
+
 	sz = nchannels * (bits + sbits);
 
 	/* Number of bits to read, corresponds to SCLK cycles in transfer.
@@ -486,42 +444,26 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 	if (ret < 0)
 		return ret;
 
-	if (dev->digital_diag_enable.int_crc_err_en) {
-		sz -= 2;
-		crc = no_os_crc16(ad7606_crc16, dev->data, sz, 0);
-		icrc = ((uint16_t)dev->data[sz] << 8) |
-		       dev->data[sz+1];
-		if (icrc != crc)
-			return -EBADMSG;
-	}
+	/* Each channel is a (bits + sbits) wide field, the status byte, when
+	 * enabled, ends up in the low byte of the channel data. */
+	if (!dev->digital_diag_enable.int_crc_err_en)
+		return no_os_unpack_be(dev->data, nchannels, bits + sbits, 0,
+				       data);
+
+	/* Check the CRC while unpacking, in a single pass over the frame. */
+	sz -= 2;
+	crc = 0;
+	ret = no_os_unpack_be_crc16(dev->data, nchannels, bits + sbits, 0,
+				    data, ad7606_crc16, &crc);
+	if (ret < 0)
+		return ret;
 
-	switch(bits) {
-	case 18:
-		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
-		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
-	case 16:
-		for(i = 0; i < nchannels; i++) {
-			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
-			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
-			}
-		}
-		break;
-	default:
-		ret = -ENOTSUP;
-		break;
-	};
+	icrc = ((uint16_t)dev->data[sz] << 8) |
+	       dev->data[sz+1];
+	if (icrc != crc)
+		return -EBADMSG;
 
-	return ret;
+	return 0;
 }
 
 /***************************************************************************//**
@@ -41,6 +41,7 @@
 #include "no_os_gpio.h"
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_util.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -182,3 +183,238 @@ int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 	else
 		return 0;
 }
+
+/**
+ * @brief Remove the single GPIO descriptors of a group handled without
+ * platform group ops.
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_gpio_group_remove_gpios(struct no_os_gpio_group_desc *desc)
+{
+	int32_t ret = 0;
+	int32_t err;
+	uint32_t i;
+
+	for (i = 0; i < desc->num_gpios; i++) {
+		err = no_os_gpio_remove(desc->gpios[i]);
+		if (err)
+			ret = err;
+	}
+
+	free(desc->gpios);
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Obtain a descriptor for a group of GPIOs.
+ *
+ * Platforms implementing the group ops handle all the GPIOs of the group in a
+ * single operation. For the other platforms each GPIO of the group gets its
+ * own descriptor and the group operations are done one GPIO at a time.
+ * @param desc - The GPIO group descriptor.
+ * @param param - GPIO group initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param)
+{
+	struct no_os_gpio_group_desc *descriptor;
+	struct no_os_gpio_init_param gpio_param;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !param || !param->numbers || !param->platform_ops ||
+	    !param->num_gpios || param->num_gpios > NO_OS_GPIO_GROUP_MAX)
+		return -EINVAL;
+
+	if (param->platform_ops->gpio_ops_group_get) {
+		ret = param->platform_ops->gpio_ops_group_get(desc, param);
+		if (ret)
+			return ret;
+
+		(*desc)->platform_ops = param->platform_ops;
+
+		return 0;
+	}
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->gpios = calloc(param->num_gpios, sizeof(*descriptor->gpios));
+	if (!descriptor->gpios) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	descriptor->platform_ops = param->platform_ops;
+
+	gpio_param.pull = param->pull;
+	gpio_param.platform_ops = param->platform_ops;
+	gpio_param.extra = param->extra;
+	for (i = 0; i < param->num_gpios; i++) {
+		gpio_param.number = param->numbers[i];
+		ret = no_os_gpio_get(&descriptor->gpios[i], &gpio_param);
+		if (ret) {
+			no_os_gpio_group_remove_gpios(descriptor);
+			return ret;
+		}
+		descriptor->num_gpios++;
+	}
+
+	*desc = descriptor;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_gpio_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_remove(struct no_os_gpio_group_desc *desc)
+{
+	if (!desc)
+		return 0;
+
+	if (desc->gpios)
+		return no_os_gpio_group_remove_gpios(desc);
+
+	return desc->platform_ops->gpio_ops_group_remove(desc);
+}
+
+/**
+ * @brief Enable the input direction of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to configure, bit i selects the i-th GPIO.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_direction_input(struct no_os_gpio_group_desc *desc,
+		uint32_t mask)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return 0;
+
+	if (!desc->gpios)
+		return desc->platform_ops->
+		       gpio_ops_group_direction_input(desc, mask);
+
+	for (i = 0; i < desc->num_gpios; i++) {
+		if (!(mask & NO_OS_BIT(i)))
+			continue;
+		ret = no_os_gpio_direction_input(desc->gpios[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Enable the output direction of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to configure, bit i selects the i-th GPIO.
+ * @param values - The initial output values, bit i is the i-th GPIO value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t mask, uint32_t values)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return 0;
+
+	if (!desc->gpios)
+		return desc->platform_ops->
+		       gpio_ops_group_direction_output(desc, mask, values);
+
+	for (i = 0; i < desc->num_gpios; i++) {
+		if (!(mask & NO_OS_BIT(i)))
+			continue;
+		ret = no_os_gpio_direction_output(desc->gpios[i],
+						  !!(values & NO_OS_BIT(i)));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Set the values of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to set, bit i selects the i-th GPIO.
+ * @param values - The values, bit i is the i-th GPIO value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return 0;
+
+	if (!desc->gpios)
+		return desc->platform_ops->
+		       gpio_ops_group_set_values(desc, mask, values);
+
+	for (i = 0; i < desc->num_gpios; i++) {
+		if (!(mask & NO_OS_BIT(i)))
+			continue;
+		ret = no_os_gpio_set_value(desc->gpios[i],
+					   !!(values & NO_OS_BIT(i)));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to read, bit i selects the i-th GPIO.
+ * @param values - The values, bit i is the i-th GPIO value. The bits not
+ * 		   selected by mask are cleared.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t *values)
+{
+	uint8_t value;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return 0;
+
+	if (!values)
+		return -EINVAL;
+
+	if (!desc->gpios)
+		return desc->platform_ops->
+		       gpio_ops_group_get_values(desc, mask, values);
+
+	*values = 0;
+	for (i = 0; i < desc->num_gpios; i++) {
+		if (!(mask & NO_OS_BIT(i)))
+			continue;
+		ret = no_os_gpio_get_value(desc->gpios[i], &value);
+		if (ret)
+			return ret;
+		if (value)
+			*values |= NO_OS_BIT(i);
+	}
+
+	return 0;
+}
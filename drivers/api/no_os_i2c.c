@@ -109,3 +109,48 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 	return desc->platform_ops->i2c_ops_read(desc, data, bytes_number,
 						stop_bit);
 }
+
+/**
+ * @brief Do a sequence of messages with the slave device, separated by
+ * repeated starts and ended by a stop condition.
+ *
+ * A register read is a write message with the register address followed by
+ * a read message. Platforms without a combined transfer do each message with
+ * no_os_i2c_write() or no_os_i2c_read(), in which case the messages must not
+ * be longer than 255 bytes.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len)
+{
+	int32_t ret;
+	uint8_t stop;
+	uint32_t i;
+
+	if (!desc || !desc->platform_ops || (len && !msgs))
+		return -EINVAL;
+
+	if (desc->platform_ops->i2c_ops_transfer)
+		return desc->platform_ops->i2c_ops_transfer(desc, msgs, len);
+
+	for (i = 0; i < len; i++) {
+		if (msgs[i].bytes_number > UINT8_MAX)
+			return -EINVAL;
+
+		stop = (i == len - 1);
+		if (msgs[i].flags & NO_OS_I2C_M_RD)
+			ret = no_os_i2c_read(desc, msgs[i].buff,
+					     msgs[i].bytes_number, stop);
+		else
+			ret = no_os_i2c_write(desc, msgs[i].buff,
+					      msgs[i].bytes_number, stop);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
@@ -41,6 +41,114 @@
 #include "no_os_spi.h"
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_mutex.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* SPI controllers in use, shared by the devices on the same controller */
+static struct no_os_spi_bus_desc *spi_buses;
+
+/* Protects spi_buses, created by the first no_os_spi_init() */
+static void *spi_buses_mutex;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the bus descriptor of a SPI controller, allocating it for the
+ * first device on the bus.
+ * @param param - The structure that contains the SPI parameters.
+ * @param bus - The bus descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_spi_bus_get(const struct no_os_spi_init_param *param,
+				 struct no_os_spi_bus_desc **bus)
+{
+	struct no_os_spi_bus_desc *b;
+	uintptr_t bus_id;
+	int32_t ret = 0;
+
+	if (param->platform_ops->get_bus_id)
+		bus_id = param->platform_ops->get_bus_id(param);
+	else
+		bus_id = param->device_id;
+
+	/*
+	 * Like the rest of the driver initialization, the first SPI device
+	 * must be initialized before other threads use the SPI API.
+	 */
+	if (!spi_buses_mutex)
+		no_os_mutex_init(&spi_buses_mutex);
+
+	no_os_mutex_lock(spi_buses_mutex);
+
+	for (b = spi_buses; b; b = b->next)
+		if (b->bus_id == bus_id &&
+		    b->platform_ops == param->platform_ops)
+			break;
+
+	if (b) {
+		b->slave_number++;
+		*bus = b;
+		goto unlock;
+	}
+
+	b = calloc(1, sizeof(*b));
+	if (!b) {
+		ret = -ENOMEM;
+		goto unlock;
+	}
+
+	no_os_mutex_init(&b->mutex);
+	no_os_mutex_init(&b->queue_mutex);
+	b->device_id = param->device_id;
+	b->bus_id = bus_id;
+	b->platform_ops = param->platform_ops;
+	b->slave_number = 1;
+	b->next = spi_buses;
+	spi_buses = b;
+	*bus = b;
+
+unlock:
+	no_os_mutex_unlock(spi_buses_mutex);
+
+	return ret;
+}
+
+/**
+ * @brief Release the bus descriptor of a device, freeing it with the last
+ * device on the bus.
+ * @param bus - The bus descriptor.
+ */
+static void no_os_spi_bus_put(struct no_os_spi_bus_desc *bus)
+{
+	struct no_os_spi_bus_desc **b;
+
+	no_os_mutex_lock(spi_buses_mutex);
+
+	if (--bus->slave_number) {
+		no_os_mutex_unlock(spi_buses_mutex);
+		return;
+	}
+
+	for (b = &spi_buses; *b; b = &(*b)->next)
+		if (*b == bus) {
+			*b = bus->next;
+			break;
+		}
+
+	no_os_mutex_unlock(spi_buses_mutex);
+
+	if (bus->async_started)
+		bus->platform_ops->async_stop(bus);
+
+	no_os_mutex_remove(bus->queue_mutex);
+	no_os_mutex_remove(bus->mutex);
+	free(bus);
+}
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -51,13 +159,21 @@
 int32_t no_os_spi_init(struct no_os_spi_desc **desc,
 		       const struct no_os_spi_init_param *param)
 {
+	struct no_os_spi_bus_desc *bus;
+
 	if (!param)
 		return -1;
 
-	if ((param->platform_ops->init(desc, param)))
+	if (no_os_spi_bus_get(param, &bus))
+		return -1;
+
+	if ((param->platform_ops->init(desc, param))) {
+		no_os_spi_bus_put(bus);
 		return -1;
+	}
 
 	(*desc)->platform_ops = param->platform_ops;
+	(*desc)->bus = bus;
 
 	return 0;
 }
@@ -69,7 +185,17 @@ int32_t no_os_spi_init(struct no_os_spi_desc **desc,
  */
 int32_t no_os_spi_remove(struct no_os_spi_desc *desc)
 {
-	return desc->platform_ops->remove(desc);
+	struct no_os_spi_bus_desc *bus = desc->bus;
+	int32_t ret;
+
+	ret = desc->platform_ops->remove(desc);
+	if (ret)
+		return ret;
+
+	if (bus)
+		no_os_spi_bus_put(bus);
+
+	return 0;
 }
 
 /**
@@ -83,7 +209,13 @@ int32_t no_os_spi_write_and_read(struct no_os_spi_desc *desc,
 				 uint8_t *data,
 				 uint16_t bytes_number)
 {
-	return desc->platform_ops->write_and_read(desc, data, bytes_number);
+	int32_t ret;
+
+	no_os_spi_bus_lock(desc);
+	ret = desc->platform_ops->write_and_read(desc, data, bytes_number);
+	no_os_spi_bus_unlock(desc);
+
+	return ret;
 }
 
 /**
@@ -103,17 +235,212 @@ int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 	if (!desc || !desc->platform_ops)
 		return -EINVAL;
 
-	if (desc->platform_ops->transfer)
-		return desc->platform_ops->transfer(desc, msgs, len);
+	no_os_spi_bus_lock(desc);
 
+	if (desc->platform_ops->transfer) {
+		ret = desc->platform_ops->transfer(desc, msgs, len);
+		goto unlock;
+	}
+
+	ret = 0;
 	for (i = 0; i < len; i++) {
-		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff)
-			return -EINVAL;
+		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff) {
+			ret = -EINVAL;
+			break;
+		}
 		ret = no_os_spi_write_and_read(desc, msgs[i].rx_buff,
 					       msgs[i].bytes_number);
 		if (NO_OS_IS_ERR_VALUE(ret))
+			break;
+	}
+
+unlock:
+	no_os_spi_bus_unlock(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Start batching the transfers of a device.
+ *
+ * Until no_os_spi_batch_commit(), platforms supporting it record the
+ * no_os_spi_write_and_read() and no_os_spi_transfer() calls of the device
+ * instead of doing them, then do them all at once on commit, each with its own
+ * chip select frame. The recording calls return 0 and the errors are reported
+ * by no_os_spi_batch_commit(). The data to send is copied when recorded. The
+ * received data is discarded, unless NO_OS_SPI_BATCH_READBACK is set, in which
+ * case it is copied back to the caller buffers on commit and these must remain
+ * valid until then. On the other platforms the transfers are done right away.
+ * The bus stays locked until the commit.
+ * @param desc - The SPI descriptor.
+ * @param flags - NO_OS_SPI_BATCH_READBACK or 0.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_batch_begin(struct no_os_spi_desc *desc, uint32_t flags)
+{
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	no_os_spi_bus_lock(desc);
+
+	if (!desc->platform_ops->batch_begin)
+		return 0;
+
+	ret = desc->platform_ops->batch_begin(desc, flags);
+	if (ret)
+		no_os_spi_bus_unlock(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Do the transfers batched since no_os_spi_batch_begin() and unlock the
+ * bus.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_batch_commit(struct no_os_spi_desc *desc)
+{
+	int32_t ret = 0;
+
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (desc->platform_ops->batch_commit)
+		ret = desc->platform_ops->batch_commit(desc);
+
+	no_os_spi_bus_unlock(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Lock the bus of a device, so that a sequence of transfers is not
+ * interleaved with transfers of other contexts or devices. The lock is
+ * recursive and is also taken by each transfer.
+ * @param desc - The SPI descriptor.
+ */
+void no_os_spi_bus_lock(struct no_os_spi_desc *desc)
+{
+	if (desc && desc->bus)
+		no_os_mutex_lock(desc->bus->mutex);
+}
+
+/**
+ * @brief Unlock the bus of a device.
+ * @param desc - The SPI descriptor.
+ */
+void no_os_spi_bus_unlock(struct no_os_spi_desc *desc)
+{
+	if (desc && desc->bus)
+		no_os_mutex_unlock(desc->bus->mutex);
+}
+
+/**
+ * @brief Process the asynchronous transfers queued on a bus, highest priority
+ * first, until the queue is empty.
+ *
+ * Called by the platform background processing, or by
+ * no_os_spi_transfer_async() when the platform has none. The bus lock is only
+ * held during each transfer, so synchronous transfers and bus lock users get
+ * the bus between two queued transfers.
+ * @param bus - The bus descriptor.
+ */
+void no_os_spi_bus_run(struct no_os_spi_bus_desc *bus)
+{
+	struct no_os_spi_async_xfer *xfer;
+
+	while (true) {
+		no_os_mutex_lock(bus->queue_mutex);
+		xfer = bus->queue;
+		if (!xfer) {
+			bus->running = false;
+			no_os_mutex_unlock(bus->queue_mutex);
+			return;
+		}
+		bus->queue = xfer->next;
+		if (!bus->queue)
+			bus->queue_tail = NULL;
+		bus->running = true;
+		no_os_mutex_unlock(bus->queue_mutex);
+
+		xfer->status = no_os_spi_transfer(xfer->desc, xfer->msgs,
+						  xfer->len);
+		/* Set before the callback, which may queue the transfer again. */
+		xfer->done = true;
+		if (xfer->callback)
+			xfer->callback(xfer);
+	}
+}
+
+/**
+ * @brief Queue a message list to be transferred asynchronously.
+ *
+ * The transfer is queued on the bus of the device, after the queued transfers
+ * with the same or a higher priority. On platforms with background processing
+ * the function returns right away. On the others the queue is processed in
+ * the calling context, unless another context is already processing it.
+ * Must not be called from interrupt context.
+ * @param desc - The SPI descriptor.
+ * @param xfer - The transfer. Its callback is called, and done is set, once
+ * 		 the transfer is finished.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_transfer_async(struct no_os_spi_desc *desc,
+				 struct no_os_spi_async_xfer *xfer)
+{
+	struct no_os_spi_async_xfer **pos;
+	struct no_os_spi_bus_desc *bus;
+	bool run = false;
+	int32_t ret;
+
+	if (!desc || !desc->bus || !xfer || (!xfer->msgs && xfer->len))
+		return -EINVAL;
+
+	bus = desc->bus;
+
+	xfer->desc = desc;
+	xfer->status = 0;
+	xfer->done = false;
+
+	no_os_mutex_lock(bus->queue_mutex);
+
+	if (bus->platform_ops->async_start && !bus->async_started) {
+		ret = bus->platform_ops->async_start(bus);
+		if (ret) {
+			no_os_mutex_unlock(bus->queue_mutex);
 			return ret;
+		}
+		bus->async_started = true;
 	}
 
+	/* Transfers mostly share a priority, check the tail first. */
+	if (!bus->queue_tail || bus->queue_tail->priority >= xfer->priority) {
+		pos = bus->queue_tail ? &bus->queue_tail->next : &bus->queue;
+	} else {
+		pos = &bus->queue;
+		while ((*pos)->priority >= xfer->priority)
+			pos = &(*pos)->next;
+	}
+	xfer->next = *pos;
+	*pos = xfer;
+	if (!xfer->next)
+		bus->queue_tail = xfer;
+
+	if (!bus->async_started && !bus->running) {
+		bus->running = true;
+		run = true;
+	}
+
+	no_os_mutex_unlock(bus->queue_mutex);
+
+	if (bus->async_started)
+		return bus->platform_ops->async_notify(bus);
+
+	if (run)
+		no_os_spi_bus_run(bus);
+
 	return 0;
 }
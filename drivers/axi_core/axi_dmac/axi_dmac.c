@@ -44,61 +44,12 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "no_os_axi_io.h"
 #include "no_os_error.h"
 #include "no_os_delay.h"
 #include "axi_dmac.h"
 
-/***************************************************************************//**
- * @brief dma_isr
-*******************************************************************************/
-void axi_dmac_default_isr(void *instance)
-{
-	struct axi_dmac *dmac = (struct axi_dmac *)instance;
-	uint32_t remaining_size, burst_size;
-	uint32_t reg_val;
-
-	/* Get interrupt sources and clear interrupts. */
-	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
-
-	if ((reg_val & AXI_DMAC_IRQ_SOT) && (dmac->big_transfer.size != 0)) {
-		remaining_size = dmac->big_transfer.size -
-				 dmac->big_transfer.size_done;
-		burst_size = (remaining_size <= dmac->transfer_max_size) ?
-			     remaining_size : dmac->transfer_max_size;
-
-		dmac->big_transfer.size_done += burst_size;
-		dmac->big_transfer.address += burst_size;
-		switch (dmac->direction) {
-		case DMA_DEV_TO_MEM:
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS,
-				       dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-			break;
-		case DMA_MEM_TO_DEV:
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS,
-				       dmac->big_transfer.address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-			break;
-		default:
-			return; // Other directions are not supported yet
-		}
-		/* The current transfer was started and a new one is queued. */
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-			       burst_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
-
-		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-	}
-	if (reg_val & AXI_DMAC_IRQ_EOT) {
-		dmac->big_transfer.transfer_done = true;
-		dmac->big_transfer.address = 0;
-		dmac->big_transfer.size = 0;
-		dmac->big_transfer.size_done = 0;
-	}
-}
-
 /***************************************************************************//**
  * @brief axi_dmac_read
  *******************************************************************************/
@@ -124,168 +75,344 @@ int32_t axi_dmac_write(struct axi_dmac *dmac,
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer_nonblock
+ * @brief Mask the DMAC interrupt while the transfer queue is updated.
+ * The controller ops are called directly, so projects that don't use the
+ * interrupt don't have to link no_os_irq.c.
  *******************************************************************************/
-int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
-				      uint32_t address, uint32_t size)
+static void axi_dmac_lock(struct axi_dmac *dmac)
 {
-	uint32_t reg_val;
+	if (dmac->irq_ctrl)
+		dmac->irq_ctrl->platform_ops->disable(dmac->irq_ctrl,
+						      dmac->irq_id);
+}
 
-	if (size == 0)
-		return 0; /* nothing to do */
+/***************************************************************************//**
+ * @brief Unmask the DMAC interrupt.
+ *******************************************************************************/
+static void axi_dmac_unlock(struct axi_dmac *dmac)
+{
+	if (dmac->irq_ctrl)
+		dmac->irq_ctrl->platform_ops->enable(dmac->irq_ctrl,
+						     dmac->irq_id);
+}
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
-	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
-		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
-	}
+/***************************************************************************//**
+ * @brief Give the core as many transfers as its queue accepts.
+ *******************************************************************************/
+static void axi_dmac_start_transfers(struct axi_dmac *dmac)
+{
+	struct axi_dmac_desc *desc;
+	struct axi_dmac_sg *sg;
+	uint32_t address, x_length, y_length;
+	uint32_t flags, id, reg_val;
+	bool last_sg;
+
+	while (dmac->submit_desc) {
+		/* The core didn't take the previous transfer yet */
+		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+		if (reg_val & 1)
+			return;
+
+		desc = dmac->submit_desc;
+		sg = &desc->sg[desc->sg_idx];
+		y_length = sg->y_length ? sg->y_length : 1;
+		if (y_length > 1) {
+			address = sg->address;
+			x_length = sg->x_length;
+			last_sg = true;
+		} else {
+			address = sg->address + desc->sg_offset;
+			x_length = sg->x_length - desc->sg_offset;
+			if (x_length - 1 > dmac->transfer_max_size)
+				x_length = dmac->transfer_max_size + 1;
+			last_sg = desc->sg_offset + x_length == sg->x_length;
+		}
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	if (!(reg_val & 1)) {
 		switch (dmac->direction) {
 		case DMA_DEV_TO_MEM:
 			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
+			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE,
+				       sg->stride);
 			break;
 		case DMA_MEM_TO_DEV:
 			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE,
+				       sg->stride);
 			break;
 		default:
-			return -1; // Other directions are not supported yet
+			return; // Other directions are not supported yet
 		}
-		if ((size - 1) > dmac->transfer_max_size) {
-			dmac->big_transfer.address = address;
-			dmac->big_transfer.size = size - 1;
-			dmac->big_transfer.size_done = dmac->transfer_max_size;
+		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, x_length - 1);
+		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, y_length - 1);
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-				       dmac->transfer_max_size);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+		if (last_sg) {
+			desc->sg_idx++;
+			desc->sg_offset = 0;
+		} else {
+			desc->sg_offset += x_length;
+		}
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+		/* DMA_LAST marks the end of the descriptor only */
+		flags = desc->flags;
+		if (desc->sg_idx != desc->nb_sg)
+			flags &= ~DMA_LAST;
+		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, flags);
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
-		} else {
-			axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-				       size - 1);
-			axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+		id %= AXI_DMAC_MAX_TRANSFER_IDS;
+		dmac->hw_desc[id] = desc;
+		dmac->hw_pending |= NO_OS_BIT(id);
+		desc->nb_inflight++;
+
+		if (desc->sg_idx == desc->nb_sg)
+			dmac->submit_desc = desc->next;
+
+		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	}
+}
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief Complete the transfers reported done by the core and queue new ones.
+ *******************************************************************************/
+static void axi_dmac_process(struct axi_dmac *dmac)
+{
+	struct axi_dmac_desc *desc;
+	uint32_t reg_val, done, id;
 
-			axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	/* Get interrupt sources and clear interrupts. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	if (dmac->hw_pending) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+		done &= dmac->hw_pending;
+		dmac->hw_pending &= ~done;
+
+		for (id = 0; done; id++, done >>= 1) {
+			if (!(done & 1))
+				continue;
+
+			desc = dmac->hw_desc[id];
+			dmac->hw_desc[id] = NULL;
+			if (!desc || --desc->nb_inflight ||
+			    desc->sg_idx != desc->nb_sg)
+				continue;
+
+			/* The core completes transfers in order */
+			dmac->queue_head = desc->next;
+			if (!dmac->queue_head)
+				dmac->queue_tail = NULL;
+			desc->next = NULL;
+			desc->done = true;
+			if (desc->callback)
+				desc->callback(dmac, desc);
 		}
-	} else {
-		return -1;
 	}
 
+	axi_dmac_start_transfers(dmac);
+}
+
+/***************************************************************************//**
+ * @brief dma_isr
+*******************************************************************************/
+void axi_dmac_default_isr(void *instance)
+{
+	axi_dmac_process((struct axi_dmac *)instance);
+}
+
+/***************************************************************************//**
+ * @brief Process the completed transfers without waiting for an interrupt.
+ *******************************************************************************/
+int32_t axi_dmac_poll(struct axi_dmac *dmac)
+{
+	if (!dmac)
+		return -EINVAL;
+
+	axi_dmac_lock(dmac);
+	axi_dmac_process(dmac);
+	axi_dmac_unlock(dmac);
+
 	return 0;
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_is_transfer_ready
+ * @brief Queue a descriptor. The segments are given to the core as its
+ * transfer queue frees up, from axi_dmac_default_isr() or axi_dmac_poll().
  *******************************************************************************/
-int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy)
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc)
 {
-	*rdy = dmac->big_transfer.transfer_done;
+	uint32_t reg_val, i;
+
+	if (!dmac || !desc || !desc->sg || !desc->nb_sg)
+		return -EINVAL;
+
+	for (i = 0; i < desc->nb_sg; i++) {
+		if (!desc->sg[i].x_length)
+			return -EINVAL;
+		/* Lines of a 2D segment can't be split */
+		if (desc->sg[i].y_length > 1 &&
+		    desc->sg[i].x_length - 1 > dmac->transfer_max_size)
+			return -EINVAL;
+	}
+
+	/* A cyclic transfer is repeated by the core, so it can't be split */
+	if ((desc->flags & DMA_CYCLIC) &&
+	    (desc->nb_sg != 1 || (desc->sg[0].y_length <= 1 &&
+				  desc->sg[0].x_length - 1 >
+				  dmac->transfer_max_size)))
+		return -EINVAL;
+
+	desc->done = false;
+	desc->sg_idx = 0;
+	desc->sg_offset = 0;
+	desc->nb_inflight = 0;
+	desc->next = NULL;
+
+	axi_dmac_lock(dmac);
+
+	if (!dmac->queue_head) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+		if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+			axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+			axi_dmac_write(dmac, AXI_DMAC_REG_CTRL,
+				       AXI_DMAC_CTRL_ENABLE);
+		}
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+		dmac->queue_head = desc;
+	} else {
+		dmac->queue_tail->next = desc;
+	}
+	dmac->queue_tail = desc;
+	if (!dmac->submit_desc)
+		dmac->submit_desc = desc;
+
+	axi_dmac_start_transfers(dmac);
+
+	axi_dmac_unlock(dmac);
 
 	return 0;
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer
+ * @brief Stop the core and drop the queued descriptors. The dropped
+ * descriptors are not marked as done.
  *******************************************************************************/
-int32_t axi_dmac_transfer(struct axi_dmac *dmac,
-			  uint32_t address, uint32_t size)
+int32_t axi_dmac_stop(struct axi_dmac *dmac)
 {
-	uint32_t transfer_id;
 	uint32_t reg_val;
-	uint32_t timeout = 0;
 
-	if (size == 0)
-		return 0; /* nothing to do */
-
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+	if (!dmac)
+		return -EINVAL;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	axi_dmac_lock(dmac);
 
-	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
-	switch (dmac->direction) {
-	case DMA_DEV_TO_MEM:
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
-		break;
-	case DMA_MEM_TO_DEV:
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
-		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
-		break;
-	default:
-		return -1; // Other directions are not supported yet
-	}
+	dmac->queue_head = NULL;
+	dmac->queue_tail = NULL;
+	dmac->submit_desc = NULL;
+	dmac->hw_pending = 0;
+	memset(dmac->hw_desc, 0, sizeof(dmac->hw_desc));
 
-	if ((size - 1) > dmac->transfer_max_size) {
-		dmac->big_transfer.address = address;
-		dmac->big_transfer.size = size - 1;
-		dmac->big_transfer.size_done = dmac->transfer_max_size;
+	axi_dmac_unlock(dmac);
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH,
-			       dmac->transfer_max_size);
-		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	return 0;
+}
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief Queue a single segment transfer on the descriptor of the core.
+ *******************************************************************************/
+static int32_t axi_dmac_start_single(struct axi_dmac *dmac, uint32_t address,
+				     uint32_t size, uint32_t flags)
+{
+	/* The previous transfer is still running */
+	if (dmac->desc.sg && !dmac->desc.done &&
+	    (dmac->queue_head || dmac->submit_desc))
+		return -EBUSY;
+
+	dmac->sg.address = address;
+	dmac->sg.x_length = size;
+	dmac->sg.y_length = 0;
+	dmac->sg.stride = 0;
+	dmac->desc.sg = &dmac->sg;
+	dmac->desc.nb_sg = 1;
+	dmac->desc.flags = flags;
+	dmac->desc.callback = NULL;
+
+	return axi_dmac_submit(dmac, &dmac->desc);
+}
 
-		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_nonblock
+ *******************************************************************************/
+int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
+				      uint32_t address, uint32_t size)
+{
+	if (size == 0)
+		return 0; /* nothing to do */
 
-		while(!dmac->big_transfer.transfer_done) {
-			timeout++;
-			if (timeout == UINT32_MAX)
-				return -1;
-		}
+	return axi_dmac_start_single(dmac, address, size, dmac->flags);
+}
 
-		dmac->big_transfer.address = 0;
-		dmac->big_transfer.size = 0;
-		dmac->big_transfer.size_done = 0;
+/***************************************************************************//**
+ * @brief axi_dmac_is_transfer_ready
+ *******************************************************************************/
+int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy)
+{
+	/* Make progress also when the interrupt is not used */
+	if (!dmac->desc.done)
+		axi_dmac_poll(dmac);
 
-		return 0;
-	}
+	*rdy = dmac->desc.done;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, size - 1);
-	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	return 0;
+}
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags);
+/***************************************************************************//**
+ * @brief Transfer in the given mode. Waits for the end of the transfer
+ * unless flags has DMA_CYCLIC.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_flags(struct axi_dmac *dmac, uint32_t address,
+				uint32_t size, uint32_t flags)
+{
+	uint32_t timeout = 0;
+	int32_t ret;
 
-	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+	if (size == 0)
+		return 0; /* nothing to do */
 
-	if (dmac->flags & DMA_CYCLIC)
-		return 0;
+	/* Restart the core, aborting any running (e.g. cyclic) transfer */
+	axi_dmac_stop(dmac);
 
-	/* Wait until the new transfer is queued. */
-	do {
-		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
-	} while(reg_val == 1);
+	ret = axi_dmac_start_single(dmac, address, size, flags);
+	if (ret)
+		return ret;
 
-	/* Wait until the current transfer is completed. */
-	do {
-		axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-		if (reg_val == (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
-			break;
-	} while(!dmac->big_transfer.transfer_done);
-	if (reg_val != (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	if (flags & DMA_CYCLIC)
+		return 0;
 
-	/* Wait until the transfer with the ID transfer_id is completed. */
-	do {
-		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
-	} while((reg_val & (1u << transfer_id)) != (1u << transfer_id));
+	while (!dmac->desc.done) {
+		if (timeout++ == UINT32_MAX) {
+			axi_dmac_stop(dmac);
+			return -ETIMEDOUT;
+		}
+		axi_dmac_poll(dmac);
+	}
 
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief axi_dmac_transfer. Uses the mode given at init.
+ *******************************************************************************/
+int32_t axi_dmac_transfer(struct axi_dmac *dmac,
+			  uint32_t address, uint32_t size)
+{
+	return axi_dmac_transfer_flags(dmac, address, size, dmac->flags);
+}
+
 /***************************************************************************//**
  * @brief axi_dmac_init
  *******************************************************************************/
@@ -302,6 +429,8 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->base = init->base;
 	dmac->direction = init->direction;
 	dmac->flags = init->flags;
+	dmac->irq_ctrl = init->irq_ctrl;
+	dmac->irq_id = init->irq_id;
 	dmac->transfer_max_size = -1;
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
@@ -43,7 +43,9 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_util.h"
+#include "no_os_irq.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -68,6 +70,9 @@
 #define AXI_DMAC_REG_SRC_STRIDE		0x424
 #define AXI_DMAC_REG_TRANSFER_DONE	0x428
 
+/* Number of transfer ids reported by AXI_DMAC_REG_TRANSFER_DONE */
+#define AXI_DMAC_MAX_TRANSFER_IDS	32
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -82,11 +87,52 @@ enum dma_flags {
 	DMA_PARTIAL_REPORTING_EN = 4
 };
 
-struct axi_dma_transfer {
-	uint32_t size;
+struct axi_dmac;
+
+/**
+ * @struct axi_dmac_sg
+ * @brief One segment of a transfer. 1D segments larger than the maximum
+ * transfer size of the core are split by the driver.
+ */
+struct axi_dmac_sg {
+	/** Address of the memory side of the segment */
 	uint32_t address;
-	uint32_t size_done;
-	volatile bool transfer_done;
+	/** Number of bytes in a line */
+	uint32_t x_length;
+	/** Number of lines. 0 or 1 for a 1D segment */
+	uint32_t y_length;
+	/** Distance in bytes between the starts of two consecutive lines */
+	uint32_t stride;
+};
+
+/**
+ * @struct axi_dmac_desc
+ * @brief Transfer of a list of segments, queued with axi_dmac_submit().
+ * The descriptor and the segments must be valid until the transfer is done.
+ */
+struct axi_dmac_desc {
+	/** Segments, transferred in order */
+	struct axi_dmac_sg *sg;
+	/** Number of segments */
+	uint32_t nb_sg;
+	/** Mode of the transfer, a combination of enum dma_flags */
+	uint32_t flags;
+	/** Called when all the segments are transferred. Optional.
+	 * Runs in the context of axi_dmac_default_isr() or axi_dmac_poll() */
+	void (*callback)(struct axi_dmac *dmac, struct axi_dmac_desc *desc);
+	/** Passed back to the callback through the descriptor */
+	void *ctx;
+	/** Set when all the segments are transferred */
+	volatile bool done;
+	/* Fields below are used by the driver */
+	/** Next segment to be given to the core */
+	uint32_t sg_idx;
+	/** Bytes of the current 1D segment already given to the core */
+	uint32_t sg_offset;
+	/** Transfers given to the core and not completed yet */
+	uint32_t nb_inflight;
+	/** Next descriptor in the queue */
+	struct axi_dmac_desc *next;
 };
 
 struct axi_dmac {
@@ -95,7 +141,24 @@ struct axi_dmac {
 	enum dma_direction direction;
 	uint32_t flags;
 	uint32_t transfer_max_size;
-	volatile struct axi_dma_transfer big_transfer;
+	/** Interrupt controller of the DMAC interrupt. Optional */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** DMAC interrupt id */
+	uint32_t irq_id;
+	/** Queued descriptors, in order. The head completes first */
+	struct axi_dmac_desc *queue_head;
+	struct axi_dmac_desc *queue_tail;
+	/** First queued descriptor with segments not given to the core */
+	struct axi_dmac_desc *submit_desc;
+	/** Descriptor of each transfer id given to the core */
+	struct axi_dmac_desc *hw_desc[AXI_DMAC_MAX_TRANSFER_IDS];
+	/** Mask of the transfer ids given to the core and not completed */
+	uint32_t hw_pending;
+	/** Descriptor used by axi_dmac_transfer() and
+	 * axi_dmac_transfer_nonblocking() */
+	struct axi_dmac_desc desc;
+	/** Segment of desc */
+	struct axi_dmac_sg sg;
 };
 
 struct axi_dmac_init {
@@ -103,6 +166,11 @@ struct axi_dmac_init {
 	uint32_t base;
 	enum dma_direction direction;
 	uint32_t flags;
+	/** Interrupt controller of the DMAC interrupt. Optional. When set,
+	 * the interrupt is masked while the transfer queue is updated */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** DMAC interrupt id */
+	uint32_t irq_id;
 };
 
 /******************************************************************************/
@@ -118,6 +186,11 @@ int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
+int32_t axi_dmac_transfer_flags(struct axi_dmac *dmac, uint32_t address,
+				uint32_t size, uint32_t flags);
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc);
+int32_t axi_dmac_poll(struct axi_dmac *dmac);
+int32_t axi_dmac_stop(struct axi_dmac *dmac);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
 		      const struct axi_dmac_init *init);
 int32_t axi_dmac_remove(struct axi_dmac *dmac);
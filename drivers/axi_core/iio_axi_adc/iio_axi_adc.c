@@ -47,6 +47,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_util.h"
 #include "iio.h"
 #include "iio_axi_adc.h"
 
@@ -357,8 +358,8 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 	iio_adc = (struct iio_axi_adc_desc *)dev;
 	bytes = nb_samples * no_os_hweight8(iio_adc->mask) * (STORAGE_BITS / 8);
 
-	iio_adc->dmac->flags = 0;
-	ret = axi_dmac_transfer(iio_adc->dmac, (uintptr_t)buff, bytes);
+	ret = axi_dmac_transfer_flags(iio_adc->dmac, (uintptr_t)buff, bytes,
+				      0);
 	if (ret < 0)
 		return ret;
 
@@ -368,6 +369,137 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 	return 0;
 }
 
+/* Wake iiod, waiting for the block, when the dma completed it */
+static void iio_axi_adc_dma_done(struct axi_dmac *dmac,
+				 struct axi_dmac_desc *desc)
+{
+	iio_buffer_notify(desc->ctx);
+}
+
+/**
+ * @brief Transfer data from the device to the iio buffer.
+ * If the buffer is split in several blocks, the transfers are not waited: up
+ * to nb_blocks - 1 blocks are filled while the previous ones are sent to the
+ * client.
+ * @param dev_data - Device instance and iio buffer
+ * @return 0 in case of success or negative value otherwise.
+ */
+int32_t iio_axi_adc_submit(struct iio_device_data *dev_data)
+{
+	struct iio_axi_adc_dma_block *blk;
+	struct iio_axi_adc_desc *iio_adc;
+	struct iio_buffer *buffer;
+	uint32_t max_queued;
+	void *buff;
+	int32_t ret;
+
+	if (!dev_data)
+		return -1;
+
+	iio_adc = (struct iio_axi_adc_desc *)dev_data->dev;
+	buffer = dev_data->buffer;
+
+	if (buffer->nb_blocks <= 1) {
+		ret = iio_buffer_get_block(buffer, &buff);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = iio_axi_adc_read_dev(iio_adc, buff,
+					   buffer->block_size /
+					   buffer->bytes_per_scan);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		return iio_buffer_block_done(buffer);
+	}
+
+	/* One block is kept for the client while the others are filled */
+	max_queued = buffer->nb_blocks - 1;
+	if (!iio_adc->dma_queued && iio_adc->nb_dma_blocks < max_queued) {
+		free(iio_adc->dma_blocks);
+		iio_adc->nb_dma_blocks = 0;
+		iio_adc->dma_blocks = calloc(max_queued,
+					     sizeof(*iio_adc->dma_blocks));
+		if (!iio_adc->dma_blocks)
+			return -ENOMEM;
+		iio_adc->nb_dma_blocks = max_queued;
+		iio_adc->dma_head = 0;
+	}
+	max_queued = no_os_min(max_queued, iio_adc->nb_dma_blocks);
+
+	/* Make progress also when the interrupt is not used */
+	if (iio_adc->dma_queued)
+		axi_dmac_poll(iio_adc->dmac);
+
+	/* The dma completes the blocks in order */
+	while (iio_adc->dma_queued) {
+		blk = &iio_adc->dma_blocks[iio_adc->dma_head];
+		if (!blk->desc.done)
+			break;
+
+		if (iio_adc->dcache_invalidate_range)
+			iio_adc->dcache_invalidate_range(blk->sg.address,
+							 buffer->block_size);
+
+		iio_adc->dma_head = (iio_adc->dma_head + 1) %
+				    iio_adc->nb_dma_blocks;
+		iio_adc->dma_queued--;
+		ret = iio_buffer_dequeue_block(buffer);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	while (iio_adc->dma_queued < max_queued) {
+		ret = iio_buffer_queue_block(buffer, &buff);
+		if (ret == -EAGAIN)
+			/* The other blocks are waiting to be sent */
+			break;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		blk = &iio_adc->dma_blocks[(iio_adc->dma_head +
+					    iio_adc->dma_queued) %
+					   iio_adc->nb_dma_blocks];
+		blk->sg.address = (uintptr_t)buff;
+		blk->sg.x_length = buffer->block_size;
+		blk->sg.y_length = 0;
+		blk->sg.stride = 0;
+		blk->desc.sg = &blk->sg;
+		blk->desc.nb_sg = 1;
+		blk->desc.flags = 0;
+		blk->desc.callback = iio_axi_adc_dma_done;
+		blk->desc.ctx = buffer;
+		ret = axi_dmac_submit(iio_adc->dmac, &blk->desc);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		iio_adc->dma_queued++;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Stop the dma transfers still running after the buffer is closed.
+ * @param dev - Instance of the iio_axi_adc
+ * @return 0 in case of success or negative value otherwise.
+ */
+int32_t iio_axi_adc_post_disable(void *dev)
+{
+	struct iio_axi_adc_desc *iio_adc = dev;
+
+	if (!iio_adc)
+		return -1;
+
+	if (iio_adc->dma_queued) {
+		axi_dmac_stop(iio_adc->dmac);
+		iio_adc->dma_queued = 0;
+		iio_adc->dma_head = 0;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Delete iio_device.
  * @param iio_device - Structure describing a device, channels and attributes.
@@ -438,7 +570,8 @@ static int32_t iio_axi_adc_create_device_descriptor(
 	}
 
 	iio_device->pre_enable = iio_axi_adc_prepare_transfer;
-	iio_device->read_dev = iio_axi_adc_read_dev;
+	iio_device->submit = iio_axi_adc_submit;
+	iio_device->post_disable = iio_axi_adc_post_disable;
 
 	return 0;
 error:
@@ -517,6 +650,7 @@ int32_t iio_axi_adc_remove(struct iio_axi_adc_desc *desc)
 	if (status < 0)
 		return status;
 
+	free(desc->dma_blocks);
 	free(desc);
 
 	return 0;
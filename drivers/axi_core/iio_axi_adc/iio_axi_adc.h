@@ -52,6 +52,17 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @struct iio_axi_adc_dma_block
+ * @brief DMA transfer of one block of the iio buffer, in buffer block mode
+ */
+struct iio_axi_adc_dma_block {
+	/** Descriptor queued to the dma */
+	struct axi_dmac_desc desc;
+	/** Single segment covering the block */
+	struct axi_dmac_sg sg;
+};
+
 /**
  * @struct iio_axi_adc_desc
  * @brief iio_axi_adc_descriptor
@@ -63,6 +74,14 @@ struct iio_axi_adc_desc {
 	uint32_t mask;
 	/** dma device */
 	struct axi_dmac *dmac;
+	/** Ring of the blocks being filled by dma, in buffer block mode */
+	struct iio_axi_adc_dma_block *dma_blocks;
+	/** Number of entries of dma_blocks */
+	uint32_t nb_dma_blocks;
+	/** Index in dma_blocks of the oldest block being filled */
+	uint32_t dma_head;
+	/** Number of blocks being filled */
+	uint32_t dma_queued;
 	/** Invalidate cache memory function pointer */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 	/** Custom implementation for get sampling frequency */
@@ -81,7 +100,12 @@ struct iio_axi_adc_desc {
 struct iio_axi_adc_init_param {
 	/** ADC device */
 	struct axi_adc *rx_adc;
-	/** Receive DMA device */
+	/**
+	 * Receive DMA device. If the client splits the buffer in several
+	 * blocks, the capture of a block runs in background. Its completion
+	 * is handled by axi_dmac_default_isr or polled when no interrupt is
+	 * registered.
+	 */
 	struct axi_dmac *rx_dmac;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
@@ -509,9 +509,8 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 	if(iio_dac->dcache_flush_range)
 		iio_dac->dcache_flush_range((uintptr_t)buff, bytes);
 
-	iio_dac->dmac->flags = DMA_CYCLIC;
-
-	return axi_dmac_transfer(iio_dac->dmac, (uintptr_t)buff, bytes);
+	return axi_dmac_transfer_flags(iio_dac->dmac, (uintptr_t)buff, bytes,
+				       DMA_CYCLIC);
 }
 
 enum ch_type {
@@ -63,7 +63,8 @@ significant delays */
 const struct no_os_spi_platform_ops spi_eng_platform_ops = {
 	.init = &spi_engine_init,
 	.write_and_read = &spi_engine_write_and_read,
-	.remove = &spi_engine_remove
+	.remove = &spi_engine_remove,
+	.get_bus_id = &spi_engine_get_bus_id
 };
 
 /******************************************************************************/
@@ -165,11 +166,11 @@ void spi_engine_set_speed(struct no_os_spi_desc *desc,
  * @param bytes_number The number of bytes to be converted
  * @return uint8_t A number of words in which bytes_number can be grouped
  */
-static uint8_t spi_get_words_number(struct spi_engine_desc *desc,
-				    uint8_t bytes_number)
+static uint32_t spi_get_words_number(struct spi_engine_desc *desc,
+				     uint32_t bytes_number)
 {
 	uint8_t xfer_word_len;
-	uint8_t words_number;
+	uint32_t words_number;
 
 	xfer_word_len = desc->data_width / 8;
 	words_number = bytes_number / xfer_word_len;
@@ -225,119 +226,6 @@ static int32_t spi_get_sleep_div(struct no_os_spi_desc *desc,
 	return 0;
 }
 
-/**
- * @brief Create a new commands queue used in a spi transfer
- *
- * @param fifo Command buffer, usualy used in fifo mode
- * @param cmd Command with wich the buffer will be initiated
- * @return int32_t Failure if the memory allocation failed
- */
-static int32_t spi_engine_queue_new_cmd(struct spi_engine_cmd_queue **fifo,
-					uint32_t cmd)
-{
-	struct spi_engine_cmd_queue *local_fifo;
-
-	local_fifo = (spi_engine_cmd_queue*)malloc(sizeof(*local_fifo));
-
-	if(!local_fifo)
-		return -1;
-
-	local_fifo->cmd = cmd;
-	local_fifo->next = NULL;
-	*fifo = local_fifo;
-
-	return 0;
-}
-
-/**
- * @brief Add a command at the end of an existing queue
- *
- * @param fifo Command buffer, usualy used in fifo mode
- * @param cmd Command to be added
- */
-static void spi_engine_queue_add_cmd(struct spi_engine_cmd_queue **fifo,
-				     uint32_t cmd)
-{
-	struct spi_engine_cmd_queue *to_add = NULL;
-	struct spi_engine_cmd_queue *local_fifo;
-
-	local_fifo = *fifo;
-	while (local_fifo->next != NULL) {
-		// Get the last element
-		local_fifo = local_fifo->next;
-	}
-
-	// Create a new element
-	spi_engine_queue_new_cmd(&to_add, cmd);
-	// Add as the next element
-	local_fifo->next = to_add;
-}
-
-/**
- * @brief Add a command at the beginning of an existing queue
- *
- * @param fifo Command buffer, usualy used in fifo mode
- * @param cmd Command to be added
- */
-static void spi_engine_queue_append_cmd(struct spi_engine_cmd_queue **fifo,
-					uint32_t cmd)
-{
-	struct spi_engine_cmd_queue *to_add = NULL;
-
-	// Create a new element
-	spi_engine_queue_new_cmd(&to_add, cmd);
-	// Interchange the addresses
-	to_add->next = *fifo;
-	*fifo = to_add;
-}
-
-
-/**
- * @brief Get the command from the beginning of the queue
- *
- * @param fifo Command buffer, usualy used in fifo mode
- * @param cmd Value of the command that was extracted
- * @return int32_t Return -1 if the queue is empty
- */
-static int32_t spi_engine_queue_get_cmd(struct spi_engine_cmd_queue **fifo,
-					uint32_t *cmd)
-{
-	struct spi_engine_cmd_queue *local_fifo;
-
-	if (!*fifo)
-		return -1;
-
-	local_fifo = *fifo;
-	*cmd = local_fifo->cmd;
-	if ((*fifo)->next) {
-		*fifo = local_fifo->next;
-		free(local_fifo);
-	} else {
-		free(*fifo);
-		*fifo = NULL;
-	}
-
-	return 0;
-}
-
-/**
- * @brief Free the memory allocated by a queue
- *
- * @param fifo The queue that needs it's memory freed
- * @return int32_t This function allways returns 0
- */
-static int32_t spi_engine_queue_free(struct spi_engine_cmd_queue **fifo)
-{
-	if(*fifo && (*fifo)->next)
-		spi_engine_queue_free(&(*fifo)->next);
-	if((*fifo) != NULL) {
-		free(*fifo);
-		*fifo = NULL;
-	}
-
-	return 0;
-}
-
 /**
  * @brief Write the SPI engine's command fifo
  *
@@ -366,98 +254,88 @@ static int32_t spi_engine_write_cmd_reg(struct spi_engine_desc *desc,
 }
 
 /**
- * @brief Write a transfer command to the SPI engine's command fifo
+ * @brief Append an engine command to a program
  *
- * @param desc Decriptor containing SPI Engine's parameters
- * @param read_write Read/Write operation flag
- * @param bytes_number Number of bytes to transfer
- * @return int32_t This function allways returns 0
+ * @param prog The program being built
+ * @param cmd Engine command
+ * @return int32_t - 0 if the command was added
+ *		   - -ENOMEM if the program is full
  */
-static int32_t spi_engine_transfer(struct spi_engine_desc *desc,
-				   uint8_t read_write,
-				   uint8_t bytes_number)
+static int32_t spi_engine_program_add(struct spi_engine_program *prog,
+				      uint32_t cmd)
 {
-	uint8_t words_number;
-
-	words_number = spi_get_words_number(desc, bytes_number);
+	if (prog->no_cmds >= SPI_ENGINE_PROGRAM_MAX_CMDS)
+		return -ENOMEM;
 
-	desc->offload_tx_len += words_number;
-
-	/*
-	 * Engine Wiki:
-	 *
-	 * https://wiki.analog.com/resources/fpga/peripherals/spi_engine
-	 *
-	 * The words number is zero based
-	 */
-
-	spi_engine_write_cmd_reg(desc,
-				 SPI_ENGINE_CMD_TRANSFER(read_write,
-						 words_number  - 1));
+	prog->cmds[prog->no_cmds++] = cmd;
 
 	return 0;
 }
 
 /**
- * @brief Change the state of the chip select port
+ * @brief Append the transfer commands needed for a number of words
  *
- * @param desc Decriptor containing SPI interface parameters
- * @param assert Chip select state.
- * 		 The supported values are :
- * 			-true (HIGH)
- * 			-false (LOW)
+ * @param prog The program being built
+ * @param read_write Read/Write operation flag
+ * @param words_number Number of words to transfer
+ * @return int32_t - 0 if the commands were added
+ *		   - -ENOMEM if the program is full
  */
-static void spi_engine_set_cs(struct no_os_spi_desc *desc,
-			      bool assert)
+static int32_t spi_engine_program_add_transfer(struct spi_engine_program *prog,
+		uint8_t read_write,
+		uint32_t words_number)
 {
-	uint8_t			mask;
-	struct spi_engine_desc	*eng_desc;
+	uint32_t	len;
+	int32_t		ret;
 
-	eng_desc = desc->extra;
+	prog->no_words += words_number;
+	if (read_write & SPI_ENGINE_INSTRUCTION_TRANSFER_W)
+		prog->no_tx_words += words_number;
+	if (read_write & SPI_ENGINE_INSTRUCTION_TRANSFER_R)
+		prog->no_rx_words += words_number;
 
-	mask = 0xFF;
-	/* Switch the state only of the selected chip select */
-	if (!assert)
-		mask ^= NO_OS_BIT(desc->chip_select);
+	/*
+	 * Engine Wiki:
+	 *
+	 * https://wiki.analog.com/resources/fpga/peripherals/spi_engine
+	 *
+	 * The words number is zero based and is 8 bits wide
+	 */
+	while (words_number) {
+		len = no_os_min(words_number, 256u);
+		ret = spi_engine_program_add(prog,
+					     SPI_ENGINE_CMD_TRANSFER(read_write,
+							     len - 1));
+		if (ret)
+			return ret;
+		words_number -= len;
+	}
 
-	spi_engine_write_cmd_reg(eng_desc,
-				 SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay,
-						 mask));
+	return 0;
 }
 
 /**
- * @brief Add a delay bewtheen the engine commands
+ * @brief Translate a command and append it to a program
  *
- * @param desc Decriptor containing SPI interface parameters
- * @param sleep_time_ns Number of nanoseconds to sleep between commands
- */
-static void spi_gen_sleep_ns(struct no_os_spi_desc *desc,
-			     uint32_t sleep_time_ns)
-{
-	uint32_t 		sleep_div;
-	struct spi_engine_desc	*eng_desc;
-
-	eng_desc = desc->extra;
-
-	spi_get_sleep_div(desc, sleep_time_ns, &sleep_div);
-
-	spi_engine_write_cmd_reg(eng_desc, SPI_ENGINE_CMD_SLEEP(sleep_div));
-}
-
-/**
- * @brief Spi engine command interpreter
+ * The CS delay, the sleep prescaler and the word count of the transfers are
+ * computed here, from the current settings of the descriptor.
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param cmd Command to send to the engine
- * @return int32_t - 0 if the command is transfered
- *		   - -1 if the command format is invalid
+ * @param prog The program being built
+ * @param cmd Command in the format of the spi_engine.h macros
+ * @return int32_t - 0 if the command was added
+ *		   - -EINVAL if the command format is invalid
+ *		   - -ENOMEM if the program is full
  */
-static int32_t spi_engine_write_cmd(struct no_os_spi_desc *desc,
-				    uint32_t cmd)
+static int32_t spi_engine_program_add_cmd(struct no_os_spi_desc *desc,
+		struct spi_engine_program *prog,
+		uint32_t cmd)
 {
 	uint8_t				engine_command;
 	uint8_t				parameter;
 	uint8_t				modifier;
+	uint8_t				mask;
+	uint32_t			sleep_div;
 	struct spi_engine_desc		*desc_extra;
 
 	desc_extra = desc->extra;
@@ -468,149 +346,276 @@ static int32_t spi_engine_write_cmd(struct no_os_spi_desc *desc,
 
 	switch(engine_command) {
 	case SPI_ENGINE_INST_TRANSFER:
-		spi_engine_transfer(desc_extra, modifier, parameter);
-		break;
+		return spi_engine_program_add_transfer(prog, modifier,
+						       spi_get_words_number(desc_extra,
+								       parameter));
 
 	case SPI_ENGINE_INST_ASSERT:
-		if(parameter == 0xFF) {
-			/* Set the CS HIGH */
-			spi_engine_set_cs(desc, true);
-		} else if(parameter == 0x00) {
-			/* Set the CS LOW */
-			spi_engine_set_cs(desc, false);
-		}
-		break;
+		mask = 0xFF;
+		if(parameter == 0x00)
+			/* Set the CS LOW. Switch only the selected chip select */
+			mask ^= NO_OS_BIT(desc->chip_select);
+		else if(parameter != 0xFF)
+			return 0;
+
+		return spi_engine_program_add(prog,
+					      SPI_ENGINE_CMD_ASSERT(desc_extra->cs_delay,
+							      mask));
 
 	/* The SYNC and SLEEP commands got the same value but different
 	modifier */
 	case SPI_ENGINE_INST_SYNC_SLEEP:
-		/* SYNC instruction */
-		if(modifier == 0x00) {
-			spi_engine_write_cmd_reg(desc_extra, cmd);
-		} else if(modifier == 0x01) {
-			spi_gen_sleep_ns(desc, parameter);
-		}
-		break;
-	case SPI_ENGINE_INST_CONFIG:
-		spi_engine_write_cmd_reg(desc_extra, cmd);
+		if(modifier == SPI_ENGINE_MISC_SYNC)
+			return spi_engine_program_add(prog, cmd);
+		if(modifier != SPI_ENGINE_MISC_SLEEP)
+			return 0;
+
+		spi_get_sleep_div(desc, parameter, &sleep_div);
 
-		break;
+		return spi_engine_program_add(prog,
+					      SPI_ENGINE_CMD_SLEEP(sleep_div));
+	case SPI_ENGINE_INST_CONFIG:
+		return spi_engine_program_add(prog, cmd);
 
 	default:
 
-		return -1;
+		return -EINVAL;
 	}
-
-	return 0;
 }
 
 /**
- * @brief Prepare the command queue before sending it to the engine
+ * @brief Start building a program: add the configuration header
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Structure used to store the transfer messages
- * @return int32_t This function allways returns 0
+ * @param prog The program being built
  */
-static int32_t spi_engine_compile_message(struct no_os_spi_desc *desc,
-		struct spi_engine_msg *msg)
+static void spi_engine_program_begin(struct no_os_spi_desc *desc,
+				     struct spi_engine_program *prog)
 {
 	struct spi_engine_desc	*desc_extra;
 
 	desc_extra = desc->extra;
 
-	/* Configure the prescaler */
-	spi_engine_queue_append_cmd(&msg->cmds,
-				    SPI_ENGINE_CMD_CONFIG(
-					    SPI_ENGINE_CMD_REG_CLK_DIV,
-					    desc_extra->clk_div));
+	prog->no_cmds = 0;
+	prog->no_words = 0;
+	prog->no_tx_words = 0;
+	prog->no_rx_words = 0;
+	prog->clk_div = desc_extra->clk_div;
+	prog->data_width = desc_extra->data_width;
+	prog->mode = desc->mode;
+	prog->chip_select = desc->chip_select;
 
+	/* Configure the prescaler */
+	spi_engine_program_add(prog,
+			       SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CLK_DIV,
+					       desc_extra->clk_div));
 	/* Set the data transfer length */
-	spi_engine_queue_append_cmd(&msg->cmds,
-				    SPI_ENGINE_CMD_CONFIG(
-					    SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
-					    desc_extra->data_width));
+	spi_engine_program_add(prog,
+			       SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
+					       desc_extra->data_width));
 	/*
 	 * Configure the spi mode :
 	 *	- 3 wire
 	 *	- CPOL
 	 *	- CPHA
 	 */
-	spi_engine_queue_append_cmd(&msg->cmds,
-				    SPI_ENGINE_CMD_CONFIG(
-					    SPI_ENGINE_CMD_REG_CONFIG,
-					    desc->mode));
+	spi_engine_program_add(prog,
+			       SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CONFIG,
+					       desc->mode));
+}
+
+/**
+ * @brief Finish building a program: add the sync command
+ *
+ * The id of the sync command is filled in on each execution.
+ *
+ * @param prog The program being built
+ * @return int32_t - 0 if the program is complete
+ *		   - -ENOMEM if the program is full
+ */
+static int32_t spi_engine_program_end(struct spi_engine_program *prog)
+{
+	int32_t ret;
 
 	/* Add a sync command to signal that the transfer has finished */
-	spi_engine_queue_add_cmd(&msg->cmds, SPI_ENGINE_CMD_SYNC(_sync_id));
+	ret = spi_engine_program_add(prog, SPI_ENGINE_CMD_SYNC(0));
+	if (ret) {
+		prog->no_cmds = 0;
+		return ret;
+	}
 
 	return 0;
 }
 
 /**
- * @brief Initiate a spi transfer
+ * @brief Check if a program matches the current settings of the descriptor
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param prog The program
+ * @return bool - true if the program can be executed as is
+ */
+static bool spi_engine_program_is_valid(struct no_os_spi_desc *desc,
+					const struct spi_engine_program *prog)
+{
+	struct spi_engine_desc	*desc_extra;
+
+	desc_extra = desc->extra;
+
+	return prog->no_cmds &&
+	       prog->clk_div == desc_extra->clk_div &&
+	       prog->data_width == desc_extra->data_width &&
+	       prog->mode == desc->mode &&
+	       prog->chip_select == desc->chip_select;
+}
+
+/**
+ * @brief Build a program from a list of commands
+ *
+ * The configuration header (clock divider, data width and spi mode) and the
+ * final sync command are added to the commands. The program stays valid as
+ * long as the speed, the data width and the mode of the descriptor don't
+ * change, and can be executed any number of times.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param prog The program to be built
+ * @param commands Commands in the format of the spi_engine.h macros
+ * @param no_commands Number of commands
+ * @return int32_t - 0 if the program was built
+ *		   - -EINVAL if a command is invalid
+ *		   - -ENOMEM if the commands don't fit in a program
+ */
+int32_t spi_engine_program_build(struct no_os_spi_desc *desc,
+				 struct spi_engine_program *prog,
+				 const uint32_t *commands,
+				 uint32_t no_commands)
+{
+	uint32_t	i;
+	int32_t		ret;
+
+	if (!desc || !prog || (no_commands && !commands))
+		return -EINVAL;
+
+	spi_engine_program_begin(desc, prog);
+
+	for (i = 0; i < no_commands; i++) {
+		ret = spi_engine_program_add_cmd(desc, prog, commands[i]);
+		if (ret) {
+			prog->no_cmds = 0;
+			return ret;
+		}
+	}
+
+	return spi_engine_program_end(prog);
+}
+
+/**
+ * @brief Load the commands of a program into the engine
+ *
+ * @param desc Decriptor containing SPI Engine's parameters
+ * @param prog The program
+ */
+static void spi_engine_program_load(struct spi_engine_desc *desc,
+				    struct spi_engine_program *prog)
+{
+	uint32_t	i;
+
+	/* The last command is the sync */
+	prog->cmds[prog->no_cmds - 1] = SPI_ENGINE_CMD_SYNC(_sync_id);
+
+	for (i = 0; i < prog->no_cmds; i++)
+		spi_engine_write_cmd_reg(desc, prog->cmds[i]);
+
+	desc->offload_tx_len = prog->no_words;
+}
+
+/**
+ * @brief Wait for the sync command of the last loaded program
+ *
+ * @param desc Decriptor containing SPI Engine's parameters
+ */
+static void spi_engine_program_wait(struct spi_engine_desc *desc)
+{
+	uint32_t	sync_id;
+
+	do {
+		spi_engine_read(desc, SPI_ENGINE_REG_SYNC_ID, &sync_id);
+	}
+	/* Wait for the end sync signal */
+	while(sync_id != _sync_id);
+	_sync_id++;
+}
+
+/**
+ * @brief Execute a program built with spi_engine_program_build()
+ *
+ * No memory is allocated. When the offload module is enabled the program and
+ * the tx words are only loaded in the offload memories.
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Structure used to store the transfer messages
+ * @param prog The program
+ * @param tx_buf Words to be sent on the SDO line, prog->no_tx_words of them
+ * @param rx_buf Where the prog->no_rx_words words read on the SDI line are
+ *		 stored. Can be NULL
  * @return int32_t - 0 if the transfer finished
- *		   - -1 if the memory allocation failed
+ *		   - -EINVAL if the program was built for other settings
  */
-static int32_t spi_engine_transfer_message(struct no_os_spi_desc *desc,
-		struct spi_engine_msg *msg)
+int32_t spi_engine_program_execute(struct no_os_spi_desc *desc,
+				   struct spi_engine_program *prog,
+				   const uint32_t *tx_buf,
+				   uint32_t *rx_buf)
 {
 	uint32_t		i;
 	uint32_t		data;
-	uint32_t		sync_id;
-	bool 			offload_en;
 	struct spi_engine_desc	*desc_extra;
 
+	if (!desc || !prog || (prog->no_tx_words && !tx_buf) ||
+	    !spi_engine_program_is_valid(desc, prog))
+		return -EINVAL;
+
 	desc_extra = desc->extra;
 
-	spi_engine_compile_message(desc, msg);
+	spi_engine_program_load(desc_extra, prog);
 
-	offload_en = (desc_extra->offload_config & OFFLOAD_TX_EN) |
-		     (desc_extra->offload_config & OFFLOAD_RX_EN);
+	/* Write a number of tx_length WORDS on the SDO line */
+	if(desc_extra->offload_config & (OFFLOAD_TX_EN | OFFLOAD_RX_EN)) {
+		for(i = 0; i < prog->no_tx_words; i++)
+			spi_engine_write(desc_extra,
+					 SPI_ENGINE_REG_OFFLOAD_SDO_MEM(0),
+					 tx_buf[i]);
 
-	/* Write the command fifo buffer */
-	while(msg->cmds != NULL) {
-		spi_engine_queue_get_cmd(&msg->cmds, &data);
-		spi_engine_write_cmd(desc, data);
+		return 0;
 	}
 
-	/* Write a number of tx_length WORDS on the SDO line */
+	for(i = 0; i < prog->no_tx_words; i++)
+		spi_engine_write(desc_extra, SPI_ENGINE_REG_SDO_DATA_FIFO,
+				 tx_buf[i]);
 
-	if(offload_en) {
-		for(i = 0; i < desc_extra->offload_tx_len; i++)
-			spi_engine_write(desc_extra,
-					 SPI_ENGINE_REG_OFFLOAD_SDO_MEM(0),
-					 msg->tx_buf[i]);
+	spi_engine_program_wait(desc_extra);
 
-	} else {
-		for(i = 0; i < msg->length; i++)
-			spi_engine_write(desc_extra,
-					 SPI_ENGINE_REG_SDO_DATA_FIFO,
-					 msg->tx_buf[i]);
-		do {
-			spi_engine_read(desc_extra,
-					SPI_ENGINE_REG_SYNC_ID,
-					&sync_id);
-		}
-		/* Wait for the end sync signal */
-		while(sync_id != _sync_id);
-		_sync_id++;
-
-		/* Read a number of rx_length WORDS from the SDI line and store
-		them */
-		for(i = 0; i < msg->length; i++) {
-			spi_engine_read(desc_extra,
-					SPI_ENGINE_REG_SDI_DATA_FIFO,
-					&data);
-			msg->rx_buf[i] = data;
-		}
+	/* Read a number of rx_length WORDS from the SDI line and store them */
+	for(i = 0; i < prog->no_rx_words; i++) {
+		spi_engine_read(desc_extra, SPI_ENGINE_REG_SDI_DATA_FIFO, &data);
+		if (rx_buf)
+			rx_buf[i] = data;
 	}
 
 	return 0;
 }
 
+/**
+ * @brief Identify the SPI engine of a device. The devices of different cores
+ * may use the same device_id.
+ *
+ * @param param Structure containing the spi init parameters
+ * @return uintptr_t - The base address of the core
+ */
+uintptr_t spi_engine_get_bus_id(const struct no_os_spi_init_param *param)
+{
+	struct spi_engine_init_param *spi_engine_init = param->extra;
+
+	return spi_engine_init->spi_engine_baseaddr;
+}
+
 /**
  * @brief Initialize the spi engine
  *
@@ -637,7 +642,7 @@ int32_t spi_engine_init(struct no_os_spi_desc **desc,
 		return -1;
 	}
 
-	eng_desc = (struct spi_engine_desc*)malloc(sizeof(*eng_desc));
+	eng_desc = (struct spi_engine_desc*)calloc(1, sizeof(*eng_desc));
 
 	if (!eng_desc)
 		return -1;
@@ -692,12 +697,13 @@ int32_t spi_engine_write_and_read(struct no_os_spi_desc *desc,
 				  uint8_t *data,
 				  uint16_t bytes_number)
 {
-	uint8_t 		i;
-	uint8_t 		word_len;
-	uint8_t 		words_number;
-	int32_t 		ret;
-	struct spi_engine_msg	msg;
-	struct spi_engine_desc	*desc_extra;
+	uint32_t			i;
+	uint32_t			j;
+	uint32_t			word;
+	uint8_t 			word_len;
+	int32_t 			ret;
+	struct spi_engine_program	*prog;
+	struct spi_engine_desc		*desc_extra;
 
 	desc_extra = desc->extra;
 
@@ -708,43 +714,54 @@ int32_t spi_engine_write_and_read(struct no_os_spi_desc *desc,
 	/* This is set in spi_engine_offload_transfer() */
 	spi_engine_write(desc_extra, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
 
-	words_number = spi_get_words_number(desc_extra, bytes_number);
-
-	msg.cmds = (spi_engine_cmd_queue*)malloc(sizeof(*msg.cmds));
-	if (!msg.cmds)
-		return -1;
-
-	msg.tx_buf =(uint32_t*)calloc(words_number, sizeof(msg.tx_buf[0]));
-	msg.rx_buf =(uint32_t*)calloc(words_number, sizeof(msg.rx_buf[0]));
-	msg.length = words_number;
+	/* Reuse the program of the previous transfer if it has the same shape */
+	prog = &desc_extra->xfer_prog;
+	if (desc_extra->xfer_prog_bytes != bytes_number ||
+	    !spi_engine_program_is_valid(desc, prog)) {
+		spi_engine_program_begin(desc, prog);
+		/* Make sure the CS is HIGH before starting a transaction */
+		spi_engine_program_add_cmd(desc, prog, CS_HIGH);
+		spi_engine_program_add_cmd(desc, prog, CS_LOW);
+		ret = spi_engine_program_add_transfer(prog,
+						      SPI_ENGINE_INSTRUCTION_TRANSFER_RW,
+						      spi_get_words_number(desc_extra,
+								      bytes_number));
+		if (!ret)
+			ret = spi_engine_program_add_cmd(desc, prog, CS_HIGH);
+		if (!ret)
+			ret = spi_engine_program_end(prog);
+		if (ret) {
+			prog->no_cmds = 0;
+			return ret;
+		}
+		desc_extra->xfer_prog_bytes = bytes_number;
+	}
 
 	/* Get the length of transfered word */
 	word_len = spi_get_word_lenght(desc_extra);
 
-	/* Make sure the CS is HIGH before starting a transaction */
-	msg.cmds->next = NULL;
-	msg.cmds->cmd = CS_HIGH;
-	spi_engine_queue_add_cmd(&msg.cmds, CS_LOW);
-	spi_engine_queue_add_cmd(&msg.cmds, WRITE_READ(bytes_number));
-	spi_engine_queue_add_cmd(&msg.cmds, CS_HIGH);
+	spi_engine_program_load(desc_extra, prog);
 
 	/* Pack the bytes into engine WORDS */
-	for (i = 0; i < bytes_number; i++)
-		msg.tx_buf[i / word_len] |= data[i] << (desc_extra->data_width-
-							(i % word_len + 1) * 8);
-
-	ret = spi_engine_transfer_message(desc, &msg);
+	for (i = 0; i < bytes_number; i += word_len) {
+		word = 0;
+		for (j = 0; j < word_len && i + j < bytes_number; j++)
+			word |= (uint32_t)data[i + j] <<
+				(desc_extra->data_width - (j + 1) * 8);
+		spi_engine_write(desc_extra, SPI_ENGINE_REG_SDO_DATA_FIFO, word);
+	}
 
-	for (i = 0; i < bytes_number; i++)
-		data[i] = msg.rx_buf[(i) / word_len] >>
-			  (desc_extra->data_width -
-			   ((i) % word_len + 1) * 8);
+	spi_engine_program_wait(desc_extra);
 
-	spi_engine_queue_free(&msg.cmds);
-	free(msg.tx_buf);
-	free(msg.rx_buf);
+	/* Unpack the engine WORDS read on the SDI line */
+	for (i = 0; i < bytes_number; i += word_len) {
+		spi_engine_read(desc_extra, SPI_ENGINE_REG_SDI_DATA_FIFO, &word);
+		for (j = 0; j < word_len && i + j < bytes_number; j++)
+			data[i + j] = word >>
+				      (desc_extra->data_width - (j + 1) * 8);
+	}
 
-	return ret;
+	return 0;
 }
 
 /**
@@ -804,10 +821,10 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples)
 {
-	struct spi_engine_msg	transfer;
-	struct spi_engine_desc	*eng_desc;
-	uint32_t 		i;
-	uint8_t 		word_length;
+	struct spi_engine_program	transfer;
+	struct spi_engine_desc		*eng_desc;
+	uint8_t 			word_length;
+	int32_t				ret;
 
 	eng_desc = desc->extra;
 
@@ -822,23 +839,16 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 	eng_desc->offload_tx_len = 0;
 	eng_desc->offload_rx_len = 0;
 
-	transfer.cmds = (spi_engine_cmd_queue*)malloc(sizeof(*transfer.cmds));
-
-	if (!transfer.cmds)
-		return -1;
-
-	transfer.tx_buf = msg.commands_data;
-
-	/* Load the commands into the message */
-	transfer.cmds->next = NULL;
-	transfer.cmds->cmd = msg.commands[0];
-	i = 1;
-	while(i < msg.no_commands) {
-		spi_engine_queue_add_cmd(&transfer.cmds, msg.commands[i++]);
+	ret = spi_engine_program_build(desc, &transfer, msg.commands,
+				       msg.no_commands);
+	if (ret)
+		return ret;
 
-	}
-
-	spi_engine_transfer_message(desc, &transfer);
+	/* Load the commands and the data in the offload memories */
+	ret = spi_engine_program_execute(desc, &transfer, msg.commands_data,
+					 NULL);
+	if (ret)
+		return ret;
 
 	/* Start transfer */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
@@ -860,8 +870,6 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 
 	usleep(1000);
 
-	spi_engine_queue_free(&transfer.cmds);
-
 	return 0;
 }
 
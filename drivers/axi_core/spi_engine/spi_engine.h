@@ -60,6 +60,9 @@
 
 #define SPI_ENGINE_MSG_QUEUE_END	0xFFFFFFFF
 
+/* Maximum number of engine commands in a program, header and sync included */
+#define SPI_ENGINE_PROGRAM_MAX_CMDS	32
+
 /* Spi engine commands */
 #define	WRITE(no_bytes)			((SPI_ENGINE_INST_TRANSFER << 12) |\
 	(SPI_ENGINE_INSTRUCTION_TRANSFER_W << 8) | no_bytes)
@@ -98,6 +101,32 @@ struct spi_engine_init_param {
 	uint8_t			data_width;
 };
 
+/**
+ * @struct spi_engine_program
+ * @brief  Engine commands of a message, translated for the settings of a
+ * descriptor and preceded by the configuration commands. Built once with
+ * spi_engine_program_build() and executed any number of times.
+ */
+struct spi_engine_program {
+	/** Engine commands: CLK_DIV, DATA_TRANSFER_LEN, CONFIG, ..., SYNC */
+	uint32_t	cmds[SPI_ENGINE_PROGRAM_MAX_CMDS];
+	/** Number of commands in cmds. 0 if the program is not built */
+	uint32_t	no_cmds;
+	/** Number of words transferred by the program */
+	uint32_t	no_words;
+	/** Number of words sent on the SDO line */
+	uint32_t	no_tx_words;
+	/** Number of words read on the SDI line */
+	uint32_t	no_rx_words;
+	/** Clock divider the program was built for */
+	uint32_t	clk_div;
+	/** Data width the program was built for */
+	uint8_t		data_width;
+	/** SPI mode the program was built for */
+	uint8_t		mode;
+	/** Chip select the program was built for */
+	uint8_t		chip_select;
+};
 
 /**
  * @struct spi_engine_desc
@@ -115,9 +144,9 @@ struct spi_engine_desc {
 	/** Offload's module transfer direction : TX, RX or both */
 	uint8_t			offload_config;
 	/** Number of words that the module has to send */
-	uint8_t			offload_tx_len;
+	uint32_t		offload_tx_len;
 	/** Number of words that the module has to receive */
-	uint8_t			offload_rx_len;
+	uint32_t		offload_rx_len;
 	/** Base address where the HDL core is situated */
 	uint32_t		spi_engine_baseaddr;
 	/** Base address where the RX DMAC core is situated */
@@ -132,6 +161,10 @@ struct spi_engine_desc {
 	uint8_t			data_width;
 	/** The maximum data width supported by the engine */
 	uint8_t 		max_data_width;
+	/** Program of the last spi_engine_write_and_read() transfer */
+	struct spi_engine_program	xfer_prog;
+	/** Number of bytes transferred by xfer_prog */
+	uint16_t		xfer_prog_bytes;
 };
 
 
@@ -192,6 +225,9 @@ int32_t spi_engine_read(struct spi_engine_desc *desc,
 int32_t spi_engine_init(struct no_os_spi_desc **desc,
 			const struct no_os_spi_init_param *param);
 
+/* Identify the SPI engine of a device by its base address */
+uintptr_t spi_engine_get_bus_id(const struct no_os_spi_init_param *param);
+
 /* Write and read data over SPI using the SPI engine */
 int32_t spi_engine_write_and_read(struct no_os_spi_desc *desc,
 				  uint8_t *data,
@@ -209,6 +245,18 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Build a reusable program from a list of SPI engine commands */
+int32_t spi_engine_program_build(struct no_os_spi_desc *desc,
+				 struct spi_engine_program *prog,
+				 const uint32_t *commands,
+				 uint32_t no_commands);
+
+/* Execute a program built with spi_engine_program_build() */
+int32_t spi_engine_program_execute(struct no_os_spi_desc *desc,
+				   struct spi_engine_program *prog,
+				   const uint32_t *tx_buf,
+				   uint32_t *rx_buf);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct no_os_spi_desc *desc,
 				      uint8_t data_wdith);
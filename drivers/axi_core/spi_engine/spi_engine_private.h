@@ -134,20 +134,4 @@
 			SPI_ENGINE_MISC_SYNC, 				\
 			(id))
 
-/******************************************************************************/
-/*************************** Types Declarations *******************************/
-/******************************************************************************/
-
-typedef struct spi_engine_cmd_queue {
-	uint32_t	cmd;
-	struct		spi_engine_cmd_queue *next;
-} spi_engine_cmd_queue;
-
-typedef struct spi_engine_msg {
-	uint32_t			*tx_buf;
-	uint32_t			*rx_buf;
-	uint32_t			length;
-	struct spi_engine_cmd_queue	*cmds;
-} spi_engine_msg;
-
 #endif // SPI_ENGINE_PRIVATE_H
@@ -80,3 +80,49 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 
 	return 0;
 }
+
+/**
+ * @brief AXI IO generic read function for a register range.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - buffer where returned data is stored
+ * @param count - number of consecutive 32-bit registers to read
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t count)
+{
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < count; i++) {
+		ret = no_os_axi_io_read(base, offset + i * 4, &data[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief AXI IO generic write function for a register range.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - data to be written
+ * @param count - number of consecutive 32-bit registers to write
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t count)
+{
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < count; i++) {
+		ret = no_os_axi_io_write(base, offset + i * 4, data[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
@@ -36,81 +36,251 @@
  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
-
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include "no_os_error.h"
 #include "no_os_axi_io.h"
+#include "linux_axi_io.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct uio_map
+ * @brief Persistent mapping of an UIO register window.
+ */
+struct uio_map {
+	/** UIO index (/dev/uioX) */
+	uint32_t base;
+	/** /dev/uioX file descriptor */
+	int fd;
+	/** Start of the mapped register window */
+	volatile uint32_t *addr;
+	/** Size of the mapped register window in bytes */
+	size_t size;
+	/** Next cached mapping */
+	struct uio_map *next;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/** List of the UIO windows mapped so far */
+static struct uio_map *uio_maps;
+
+/** Protects uio_maps */
+static pthread_mutex_t uio_maps_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
 /**
- * @brief AXI IO through UIO read/write function.
+ * @brief Get the size of the first memory region exported by an UIO device.
  * @param base - UIO index (/dev/uioX).
- * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
- * @return 0 in case of success, -1 otherwise.
+ * @return Region size in bytes, 0 if it can't be determined.
  */
-static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-			      uint32_t *write)
+static size_t uio_get_map_size(uint32_t base)
 {
-	char buf[32];
+	char path[64];
+	unsigned long long size;
+	FILE *f;
 	int ret;
-	int uio_fd;
-	int32_t status = 0;
-	void *uio_addr;
 
-	sprintf(buf, "/dev/uio%"PRIu32"", base);
+	snprintf(path, sizeof(path),
+		 "/sys/class/uio/uio%"PRIu32"/maps/map0/size", base);
+
+	f = fopen(path, "r");
+	if (!f)
+		return 0;
+
+	ret = fscanf(f, "%llx", &size);
+	fclose(f);
+	if (ret != 1)
+		return 0;
+
+	return (size_t)size;
+}
+
+/**
+ * @brief (Re)map an UIO register window so that it covers a given length.
+ * The previous window is unmapped only once the new one is mapped, so it
+ * stays usable if the remapping fails.
+ * @param map - The UIO mapping.
+ * @param len - Minimum number of bytes that must be accessible.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t uio_map_window(struct uio_map *map, size_t len)
+{
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t size;
+	void *addr;
 
-	uio_fd = open(buf, O_RDWR);
-	if (uio_fd < 0) {
-		printf("%s: Can't open %s\n\r", __func__, buf);
+	size = uio_get_map_size(map->base);
+	if (size < len)
+		size = len;
+	if (size > SIZE_MAX - page_size)
 		return -1;
-	}
+	size = (size + page_size - 1) & ~(page_size - 1);
 
-	uio_addr = mmap(NULL,
-			offset + sizeof(*read),
-			PROT_READ|PROT_WRITE,
-			MAP_SHARED,
-			uio_fd,
-			0);
-	if (uio_addr == MAP_FAILED) {
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0);
+	if (addr == MAP_FAILED) {
 		printf("%s: mmap() failed\n\r", __func__);
-		status = -1;
-		goto close;
+		return -1;
 	}
 
-	if (read)
-		*read = *(uint32_t *)((uintptr_t)uio_addr + offset);
-	if (write)
-		*(uint32_t *)((uintptr_t)uio_addr + offset) = *write;
+	if (map->addr)
+		munmap((void *)map->addr, map->size);
 
-	ret = munmap(uio_addr, offset + sizeof(*read));
-	if (ret < 0) {
-		printf("%s: munmap() failed\n\r", __func__);
-		status = -1;
+	map->addr = addr;
+	map->size = size;
+
+	return 0;
+}
+
+/**
+ * @brief Get the register window of an UIO device, mapping it on first use.
+ * Must be called with uio_maps_lock held: the window may be remapped by a
+ * later call or unmapped by linux_axi_io_unmap() once the lock is released.
+ * @param base - UIO index (/dev/uioX).
+ * @param len - Minimum number of bytes that must be accessible.
+ * @return The UIO mapping, NULL in case of error.
+ */
+static struct uio_map *uio_get_window(uint32_t base, size_t len)
+{
+	struct uio_map **pos;
+	struct uio_map *map;
+	char buf[32];
+
+	for (pos = &uio_maps; *pos; pos = &(*pos)->next)
+		if ((*pos)->base == base)
+			break;
+
+	map = *pos;
+	if (map && pos != &uio_maps) {
+		/* Move it to the front, the next access is likely on it too */
+		*pos = map->next;
+		map->next = uio_maps;
+		uio_maps = map;
 	}
 
-close:
-	ret = close(uio_fd);
+	if (!map) {
+		map = calloc(1, sizeof(*map));
+		if (!map)
+			return NULL;
+
+		sprintf(buf, "/dev/uio%"PRIu32"", base);
+		map->base = base;
+		map->fd = open(buf, O_RDWR | O_SYNC);
+		if (map->fd < 0) {
+			printf("%s: Can't open %s\n\r", __func__, buf);
+			free(map);
+			return NULL;
+		}
+
+		if (uio_map_window(map, len)) {
+			close(map->fd);
+			free(map);
+			return NULL;
+		}
+
+		map->next = uio_maps;
+		uio_maps = map;
+	} else if (map->size < len) {
+		if (uio_map_window(map, len))
+			return NULL;
+	}
+
+	return map;
+}
+
+/**
+ * @brief Unmap and close an UIO register window.
+ * @param map - The UIO mapping.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t uio_unmap_window(struct uio_map *map)
+{
+	int32_t status = 0;
+	int ret;
+
+	if (map->addr) {
+		ret = munmap((void *)map->addr, map->size);
+		if (ret < 0) {
+			printf("%s: munmap() failed\n\r", __func__);
+			status = -1;
+		}
+	}
+
+	ret = close(map->fd);
 	if (ret < 0) {
-		printf("%s: Can't close %s\n\r", __func__, buf);
+		printf("%s: Can't close /dev/uio%"PRIu32"\n\r", __func__,
+		       map->base);
 		status = -1;
 	}
 
+	free(map);
+
 	return status;
 }
 
+/**
+ * @brief AXI IO through UIO read/write function.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset.
+ * @param read - Location where read data will be stored.
+ * @param write - Data to be written.
+ * @param count - Number of consecutive 32-bit registers to access.
+ * @return 0 in case of success, -EINVAL for an offset not aligned to 4 bytes,
+ *	   -1 otherwise.
+ */
+static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
+			      const uint32_t *write, uint32_t count)
+{
+	volatile uint32_t *regs;
+	struct uio_map *map;
+	int32_t ret = 0;
+	uint32_t i;
+
+	/* The registers are accessed as 32-bit words */
+	if (offset % sizeof(uint32_t) ||
+	    count > (SIZE_MAX - offset) / sizeof(uint32_t))
+		return -EINVAL;
+
+	pthread_mutex_lock(&uio_maps_lock);
+
+	map = uio_get_window(base, (size_t)offset +
+			     (size_t)count * sizeof(uint32_t));
+	if (!map) {
+		ret = -1;
+		goto unlock;
+	}
+
+	regs = map->addr + offset / sizeof(uint32_t);
+
+	if (read)
+		for (i = 0; i < count; i++)
+			read[i] = regs[i];
+	if (write)
+		for (i = 0; i < count; i++)
+			regs[i] = write[i];
+
+unlock:
+	pthread_mutex_unlock(&uio_maps_lock);
+
+	return ret;
+}
+
 #ifdef DEVMEM
 /**
  * @brief AXI IO through devmem read/write function.
@@ -159,6 +329,7 @@ close:
 	return ret;
 }
 #endif //DEVMEM
+
 /**
  * @brief AXI IO through UIO/devmem read function.
  * @param base - UIO index (/dev/uioX)/base address.
@@ -171,7 +342,7 @@ int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, data, NULL);
 #else
-	return uio_read_write(base, offset, data, NULL);
+	return uio_read_write(base, offset, data, NULL, 1);
 #endif
 }
 
@@ -187,6 +358,113 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, NULL, &data);
 #else
-	return uio_read_write(base, offset, NULL, &data);
+	return uio_read_write(base, offset, NULL, &data, 1);
+#endif
+}
+
+/**
+ * @brief AXI IO through UIO/devmem read function for a register range.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Location where read data will be stored.
+ * @param count - Number of consecutive 32-bit registers to read.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t count)
+{
+#ifdef DEVMEM
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < count; i++) {
+		ret = devmem_read_write(base, offset + i * 4, &data[i], NULL);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+#else
+	return uio_read_write(base, offset, data, NULL, count);
+#endif
+}
+
+/**
+ * @brief AXI IO through UIO/devmem write function for a register range.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Data to be written.
+ * @param count - Number of consecutive 32-bit registers to write.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t count)
+{
+#ifdef DEVMEM
+	uint32_t i;
+	uint32_t val;
+	int32_t ret;
+
+	for (i = 0; i < count; i++) {
+		val = data[i];
+		ret = devmem_read_write(base, offset + i * 4, NULL, &val);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+#else
+	return uio_read_write(base, offset, NULL, data, count);
 #endif
 }
+
+/**
+ * @brief Release the cached mapping of an UIO register window.
+ * The window is mapped again on the next access.
+ * @param base - UIO index (/dev/uioX).
+ * @return 0 in case of success (or if not mapped), -1 otherwise.
+ */
+int32_t linux_axi_io_unmap(uint32_t base)
+{
+	struct uio_map **prev;
+	struct uio_map *map;
+	int32_t ret = 0;
+
+	pthread_mutex_lock(&uio_maps_lock);
+
+	for (prev = &uio_maps; *prev; prev = &(*prev)->next) {
+		map = *prev;
+		if (map->base == base) {
+			*prev = map->next;
+			ret = uio_unmap_window(map);
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&uio_maps_lock);
+
+	return ret;
+}
+
+/**
+ * @brief Release all the cached UIO register window mappings.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t linux_axi_io_unmap_all(void)
+{
+	struct uio_map *map;
+	int32_t status = 0;
+
+	pthread_mutex_lock(&uio_maps_lock);
+
+	while (uio_maps) {
+		map = uio_maps;
+		uio_maps = map->next;
+		if (uio_unmap_window(map))
+			status = -1;
+	}
+
+	pthread_mutex_unlock(&uio_maps_lock);
+
+	return status;
+}
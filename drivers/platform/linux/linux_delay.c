@@ -41,21 +41,112 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdint.h>
-#include <unistd.h>
+#include <time.h>
+#include "no_os_delay.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_DELAY_NSEC_PER_SEC	1000000000ULL
+/* Number of sleeps used to measure the wake-up latency */
+#define LINUX_DELAY_CALIB_ROUNDS	16
+/* Bounds of the measured wake-up latency, in nanoseconds */
+#define LINUX_DELAY_MIN_SLACK_NS	10000ULL
+#define LINUX_DELAY_MAX_SLACK_NS	2000000ULL
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Time before a deadline at which sleeping stops and busy-waiting starts */
+static uint64_t linux_delay_slack_ns;
+static pthread_once_t linux_delay_calib_once = PTHREAD_ONCE_INIT;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Get the CLOCK_MONOTONIC time.
+ * @return The time in nanoseconds.
+ */
+static uint64_t linux_delay_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * LINUX_DELAY_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Sleep until a CLOCK_MONOTONIC deadline, even if signals interrupt the
+ * sleep.
+ * @param deadline_ns - The deadline, in nanoseconds.
+ */
+static void linux_delay_sleep_until(uint64_t deadline_ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec = deadline_ns / LINUX_DELAY_NSEC_PER_SEC;
+	ts.tv_nsec = deadline_ns % LINUX_DELAY_NSEC_PER_SEC;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) ==
+	       EINTR)
+		;
+}
+
+/**
+ * @brief Measure how late the scheduler wakes this process up from a short
+ * sleep, done once before the first microseconds delay. The worst case of a
+ * few sleeps is used as the busy-wait window.
+ */
+static void linux_delay_calibrate(void)
+{
+	uint64_t start, late, worst = 0;
+	uint32_t i;
+
+	for (i = 0; i < LINUX_DELAY_CALIB_ROUNDS; i++) {
+		start = linux_delay_now_ns();
+		linux_delay_sleep_until(start + 1000);
+		late = linux_delay_now_ns() - start - 1000;
+		if (late > worst)
+			worst = late;
+	}
+
+	if (worst < LINUX_DELAY_MIN_SLACK_NS)
+		worst = LINUX_DELAY_MIN_SLACK_NS;
+	if (worst > LINUX_DELAY_MAX_SLACK_NS)
+		worst = LINUX_DELAY_MAX_SLACK_NS;
+
+	linux_delay_slack_ns = worst;
+}
+
 /**
  * @brief Generate microseconds delay.
+ *
+ * Delays shorter than the calibrated wake-up latency are busy-waited on
+ * CLOCK_MONOTONIC. Longer ones sleep until that latency before the deadline
+ * and busy-wait the rest, so they neither return early nor overshoot by a
+ * whole scheduler wake-up.
  * @param usecs - Delay in microseconds.
  * @return None.
  */
 void no_os_udelay(uint32_t usecs)
 {
-	usleep(usecs);
+	uint64_t deadline;
+
+	pthread_once(&linux_delay_calib_once, linux_delay_calibrate);
+
+	deadline = linux_delay_now_ns() + (uint64_t)usecs * 1000;
+	if ((uint64_t)usecs * 1000 > linux_delay_slack_ns)
+		linux_delay_sleep_until(deadline - linux_delay_slack_ns);
+
+	while (linux_delay_now_ns() < deadline)
+		;
 }
 
 /**
@@ -65,5 +156,6 @@ void no_os_udelay(uint32_t usecs)
  */
 void no_os_mdelay(uint32_t msecs)
 {
-	usleep(msecs * 1000);
+	linux_delay_sleep_until(linux_delay_now_ns() +
+				(uint64_t)msecs * 1000000);
 }
@@ -39,9 +39,37 @@
 #ifndef LINUX_GPIO_H_
 #define LINUX_GPIO_H_
 
+#include <stdint.h>
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
+
+/**
+ * @struct linux_gpio_cdev_init_param
+ * @brief Linux GPIO character device specific initialization parameters.
+ * The GPIO number is the line offset within the chip.
+ */
+struct linux_gpio_cdev_init_param {
+	/** GPIO chip number, the lines are requested from /dev/gpiochip"chip" */
+	uint32_t chip;
+	/** Consumer label shown by the kernel for the lines, may be NULL */
+	const char *consumer;
+};
+
 /**
  * @brief Linux specific GPIO platform ops structure
  */
 extern const struct no_os_gpio_platform_ops linux_gpio_ops;
 
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+extern const struct no_os_gpio_platform_ops linux_gpio_cdev_ops;
+
+/* Configure the edge detection of a GPIO character device line. */
+int32_t linux_gpio_cdev_set_edge(struct no_os_gpio_desc *desc,
+				 enum no_os_irq_trig_level trig, uint8_t enable);
+
+/* Get the file descriptor delivering the edge events of a GPIO. */
+int linux_gpio_cdev_get_fd(struct no_os_gpio_desc *desc);
+
 #endif // LINUX_GPIO_H_
@@ -0,0 +1,679 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpio_cdev.c
+ *   @brief  Implementation of the Linux GPIO character device driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_error.h"
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
+#include "no_os_util.h"
+#include "linux_gpio.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_GPIO_CDEV_CONSUMER	"no-OS"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpio_cdev_lines
+ * @brief Lines requested from a GPIO chip with a single GPIO_V2_GET_LINE
+ * request. Bit i of the masks refers to the i-th requested line.
+ */
+struct linux_gpio_cdev_lines {
+	/** Line request file descriptor */
+	int fd;
+	/** Number of requested lines */
+	uint32_t num_lines;
+	/** Bias flags, common to all the lines */
+	uint64_t bias;
+	/** Lines configured as outputs */
+	uint64_t out_mask;
+	/** Last values driven on the output lines */
+	uint64_t out_values;
+	/** Edge detection flags of the input lines */
+	uint64_t edge;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Convert the no-OS pull configuration to GPIO_V2 bias flags.
+ * @param pull - The pull configuration.
+ * @return The bias flags.
+ */
+static uint64_t linux_gpio_cdev_bias(enum no_os_gpio_pull_up pull)
+{
+	switch (pull) {
+	case NO_OS_PULL_UP:
+	case NO_OS_PULL_UP_WEAK:
+		return GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+	case NO_OS_PULL_DOWN:
+	case NO_OS_PULL_DOWN_WEAK:
+		return GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Request lines from a GPIO chip.
+ *
+ * Without a pull configuration the lines are requested "as is", so that
+ * outputs already driven by the bootloader or a previous user do not glitch.
+ * The current direction and output values are read back to seed the cached
+ * configuration.
+ * @param lines - The line request.
+ * @param offsets - Line offsets within the chip.
+ * @param num_lines - Number of lines.
+ * @param pull - The pull configuration of all the lines.
+ * @param extra - Linux GPIO character device initialization parameters, may be
+ * 		  NULL to use /dev/gpiochip0.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_cdev_request(struct linux_gpio_cdev_lines *lines,
+				       const int32_t *offsets,
+				       uint32_t num_lines,
+				       enum no_os_gpio_pull_up pull,
+				       const struct linux_gpio_cdev_init_param *extra)
+{
+	struct gpio_v2_line_request req;
+	struct gpio_v2_line_values vals;
+	struct gpio_v2_line_info info;
+	const char *consumer;
+	char path[32];
+	int32_t ret;
+	uint32_t i;
+	int fd;
+
+	if (num_lines > GPIO_V2_LINES_MAX)
+		return -EINVAL;
+
+	sprintf(path, "/dev/gpiochip%u", extra ? extra->chip : 0);
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		return -errno;
+	}
+
+	consumer = (extra && extra->consumer) ? extra->consumer :
+		   LINUX_GPIO_CDEV_CONSUMER;
+
+	memset(&req, 0, sizeof(req));
+	strncpy(req.consumer, consumer, sizeof(req.consumer) - 1);
+	req.num_lines = num_lines;
+
+	lines->bias = linux_gpio_cdev_bias(pull);
+	lines->edge = 0;
+	lines->out_mask = 0;
+	lines->out_values = 0;
+	for (i = 0; i < num_lines; i++) {
+		if (offsets[i] < 0) {
+			ret = -EINVAL;
+			goto close_chip;
+		}
+		req.offsets[i] = offsets[i];
+
+		memset(&info, 0, sizeof(info));
+		info.offset = offsets[i];
+		if (ioctl(fd, GPIO_V2_GET_LINEINFO_IOCTL, &info) < 0) {
+			ret = -errno;
+			goto close_chip;
+		}
+		if (info.flags & GPIO_V2_LINE_FLAG_OUTPUT)
+			lines->out_mask |= (uint64_t)1 << i;
+	}
+
+	/* Bias needs an explicit direction, keep the current one. */
+	if (lines->bias) {
+		req.config.flags = GPIO_V2_LINE_FLAG_INPUT | lines->bias;
+		if (lines->out_mask) {
+			req.config.num_attrs = 1;
+			req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+			req.config.attrs[0].attr.flags =
+				GPIO_V2_LINE_FLAG_OUTPUT | lines->bias;
+			req.config.attrs[0].mask = lines->out_mask;
+		}
+	}
+
+	if (ioctl(fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+		printf("%s: Can't request the lines from %s\n\r", __func__, path);
+		ret = -errno;
+		goto close_chip;
+	}
+
+	close(fd);
+	lines->fd = req.fd;
+	lines->num_lines = num_lines;
+
+	if (lines->out_mask) {
+		vals.mask = lines->out_mask;
+		vals.bits = 0;
+		if (ioctl(lines->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &vals) < 0) {
+			ret = -errno;
+			close(lines->fd);
+			return ret;
+		}
+		lines->out_values = vals.bits & lines->out_mask;
+	}
+
+	return 0;
+
+close_chip:
+	close(fd);
+
+	return ret;
+}
+
+/**
+ * @brief Apply a new direction configuration to the requested lines.
+ * @param lines - The line request.
+ * @param out_mask - Lines to be configured as outputs, the others are inputs.
+ * @param out_values - Values of the output lines.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_cdev_configure(struct linux_gpio_cdev_lines *lines,
+		uint64_t out_mask, uint64_t out_values)
+{
+	struct gpio_v2_line_config config;
+
+	/* Edge detection is only available on inputs. */
+	if (lines->edge && out_mask)
+		return -EBUSY;
+
+	memset(&config, 0, sizeof(config));
+	config.flags = GPIO_V2_LINE_FLAG_INPUT | lines->bias | lines->edge;
+	if (out_mask) {
+		config.num_attrs = 2;
+		config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_OUTPUT |
+					     lines->bias;
+		config.attrs[0].mask = out_mask;
+		config.attrs[1].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		config.attrs[1].attr.values = out_values;
+		config.attrs[1].mask = out_mask;
+	}
+
+	if (ioctl(lines->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0)
+		return -errno;
+
+	lines->out_mask = out_mask;
+	lines->out_values = out_values & out_mask;
+
+	return 0;
+}
+
+/**
+ * @brief Set the values of the selected lines with a single ioctl.
+ * @param lines - The line request.
+ * @param mask - The lines to set.
+ * @param values - The values.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_cdev_set(struct linux_gpio_cdev_lines *lines,
+				   uint64_t mask, uint64_t values)
+{
+	struct gpio_v2_line_values vals;
+
+	if (!mask)
+		return 0;
+
+	vals.mask = mask;
+	vals.bits = values & mask;
+	if (ioctl(lines->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &vals) < 0)
+		return -errno;
+
+	lines->out_values = (lines->out_values & ~mask) | vals.bits;
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of the selected lines with a single ioctl.
+ * @param lines - The line request.
+ * @param mask - The lines to read.
+ * @param values - The values, the bits not selected by mask are cleared.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_cdev_get(struct linux_gpio_cdev_lines *lines,
+				   uint64_t mask, uint64_t *values)
+{
+	struct gpio_v2_line_values vals;
+
+	*values = 0;
+	if (!mask)
+		return 0;
+
+	vals.mask = mask;
+	vals.bits = 0;
+	if (ioctl(lines->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &vals) < 0)
+		return -errno;
+
+	*values = vals.bits & mask;
+
+	return 0;
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters. The GPIO number is the line
+ * 		  offset within the chip selected by the extra parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_get_desc(struct no_os_gpio_desc **desc,
+				 const struct no_os_gpio_init_param *param)
+{
+	struct linux_gpio_cdev_lines *lines;
+	struct no_os_gpio_desc *descriptor;
+	int32_t ret;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	lines = calloc(1, sizeof(*lines));
+	if (!lines) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	ret = linux_gpio_cdev_request(lines, &param->number, 1, param->pull,
+				      param->extra);
+	if (ret)
+		goto free_lines;
+
+	descriptor->number = param->number;
+	descriptor->pull = param->pull;
+	descriptor->extra = lines;
+	*desc = descriptor;
+
+	return 0;
+
+free_lines:
+	free(lines);
+free_desc:
+	free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Get the value of an optional GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_get_optional(struct no_os_gpio_desc **desc,
+				     const struct no_os_gpio_init_param *param)
+{
+	return linux_gpio_cdev_get_desc(desc, param);
+}
+
+/**
+ * @brief Free the resources allocated by linux_gpio_cdev_get_desc().
+ * @param desc - The GPIO descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_remove(struct no_os_gpio_desc *desc)
+{
+	struct linux_gpio_cdev_lines *lines;
+
+	if (!desc)
+		return -EINVAL;
+
+	lines = desc->extra;
+	close(lines->fd);
+	free(lines);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_direction_input(struct no_os_gpio_desc *desc)
+{
+	return linux_gpio_cdev_configure(desc->extra, 0, 0);
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: NO_OS_GPIO_HIGH
+ *                         NO_OS_GPIO_LOW
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_direction_output(struct no_os_gpio_desc *desc,
+		uint8_t value)
+{
+	return linux_gpio_cdev_configure(desc->extra, 1, !!value);
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ *                    Example: NO_OS_GPIO_OUT
+ *                             NO_OS_GPIO_IN
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_get_direction(struct no_os_gpio_desc *desc,
+				      uint8_t *direction)
+{
+	struct linux_gpio_cdev_lines *lines = desc->extra;
+
+	*direction = lines->out_mask ? NO_OS_GPIO_OUT : NO_OS_GPIO_IN;
+
+	return 0;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: NO_OS_GPIO_HIGH
+ *                         NO_OS_GPIO_LOW
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_set_value(struct no_os_gpio_desc *desc, uint8_t value)
+{
+	return linux_gpio_cdev_set(desc->extra, 1, !!value);
+}
+
+/**
+ * @brief Get the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: NO_OS_GPIO_HIGH
+ *                         NO_OS_GPIO_LOW
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_get_value(struct no_os_gpio_desc *desc, uint8_t *value)
+{
+	uint64_t values;
+	int32_t ret;
+
+	ret = linux_gpio_cdev_get(desc->extra, 1, &values);
+	if (ret)
+		return ret;
+
+	*value = values ? NO_OS_GPIO_HIGH : NO_OS_GPIO_LOW;
+
+	return 0;
+}
+
+/**
+ * @brief Configure the edge detection of a GPIO obtained with
+ * linux_gpio_cdev_ops.
+ *
+ * The edge events are read from the file descriptor returned by
+ * linux_gpio_cdev_get_fd(), as struct gpio_v2_line_event. The GPIO is
+ * switched to input.
+ * @param desc - The GPIO descriptor.
+ * @param trig - NO_OS_IRQ_EDGE_FALLING, NO_OS_IRQ_EDGE_RISING or
+ * 		 NO_OS_IRQ_EDGE_BOTH. Level triggers are not supported by the
+ * 		 GPIO character device.
+ * @param enable - 0 to disable the edge detection, enable it otherwise.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_set_edge(struct no_os_gpio_desc *desc,
+				 enum no_os_irq_trig_level trig, uint8_t enable)
+{
+	struct linux_gpio_cdev_lines *lines;
+	uint64_t edge;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	switch (trig) {
+	case NO_OS_IRQ_EDGE_FALLING:
+		edge = GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		break;
+	case NO_OS_IRQ_EDGE_RISING:
+		edge = GPIO_V2_LINE_FLAG_EDGE_RISING;
+		break;
+	case NO_OS_IRQ_EDGE_BOTH:
+		edge = GPIO_V2_LINE_FLAG_EDGE_RISING |
+		       GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	lines = desc->extra;
+	lines->edge = enable ? edge : 0;
+	ret = linux_gpio_cdev_configure(lines, 0, 0);
+	if (ret)
+		lines->edge = 0;
+
+	return ret;
+}
+
+/**
+ * @brief Get the line request file descriptor of a GPIO obtained with
+ * linux_gpio_cdev_ops, for polling its edge events.
+ * @param desc - The GPIO descriptor.
+ * @return The file descriptor, negative error code otherwise.
+ */
+int linux_gpio_cdev_get_fd(struct no_os_gpio_desc *desc)
+{
+	struct linux_gpio_cdev_lines *lines;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	lines = desc->extra;
+
+	return lines->fd;
+}
+
+/**
+ * @brief Obtain a descriptor for a group of GPIOs, all requested from the same
+ * chip with a single line request.
+ * @param desc - The GPIO group descriptor.
+ * @param param - GPIO group initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_get(struct no_os_gpio_group_desc **desc,
+				  const struct no_os_gpio_group_init_param *param)
+{
+	struct no_os_gpio_group_desc *descriptor;
+	struct linux_gpio_cdev_lines *lines;
+	int32_t ret;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	lines = calloc(1, sizeof(*lines));
+	if (!lines) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	ret = linux_gpio_cdev_request(lines, param->numbers, param->num_gpios,
+				      param->pull, param->extra);
+	if (ret)
+		goto free_lines;
+
+	descriptor->num_gpios = param->num_gpios;
+	descriptor->extra = lines;
+	*desc = descriptor;
+
+	return 0;
+
+free_lines:
+	free(lines);
+free_desc:
+	free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by linux_gpio_cdev_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_remove(struct no_os_gpio_group_desc *desc)
+{
+	struct linux_gpio_cdev_lines *lines;
+
+	if (!desc)
+		return -EINVAL;
+
+	lines = desc->extra;
+	close(lines->fd);
+	free(lines);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Enable the input direction of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to configure, bit i selects the i-th GPIO.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_direction_input(struct no_os_gpio_group_desc *desc,
+		uint32_t mask)
+{
+	struct linux_gpio_cdev_lines *lines = desc->extra;
+
+	return linux_gpio_cdev_configure(lines, lines->out_mask & ~mask,
+					 lines->out_values);
+}
+
+/**
+ * @brief Enable the output direction of the selected GPIOs of a group.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to configure, bit i selects the i-th GPIO.
+ * @param values - The initial output values, bit i is the i-th GPIO value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_direction_output(struct no_os_gpio_group_desc
+		*desc, uint32_t mask, uint32_t values)
+{
+	struct linux_gpio_cdev_lines *lines = desc->extra;
+
+	return linux_gpio_cdev_configure(lines, lines->out_mask | mask,
+					 (lines->out_values & ~(uint64_t)mask) |
+					 (values & mask));
+}
+
+/**
+ * @brief Set the values of the selected GPIOs of a group with a single ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to set, bit i selects the i-th GPIO.
+ * @param values - The values, bit i is the i-th GPIO value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_set_values(struct no_os_gpio_group_desc *desc,
+		uint32_t mask, uint32_t values)
+{
+	return linux_gpio_cdev_set(desc->extra, mask, values);
+}
+
+/**
+ * @brief Get the values of the selected GPIOs of a group with a single ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - The GPIOs to read, bit i selects the i-th GPIO.
+ * @param values - The values, bit i is the i-th GPIO value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_cdev_group_get_values(struct no_os_gpio_group_desc *desc,
+		uint32_t mask, uint32_t *values)
+{
+	uint64_t vals;
+	int32_t ret;
+
+	ret = linux_gpio_cdev_get(desc->extra, mask, &vals);
+	if (ret)
+		return ret;
+
+	*values = (uint32_t)vals;
+
+	return 0;
+}
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+const struct no_os_gpio_platform_ops linux_gpio_cdev_ops = {
+	.gpio_ops_get = &linux_gpio_cdev_get_desc,
+	.gpio_ops_get_optional = &linux_gpio_cdev_get_optional,
+	.gpio_ops_remove = &linux_gpio_cdev_remove,
+	.gpio_ops_direction_input = &linux_gpio_cdev_direction_input,
+	.gpio_ops_direction_output = &linux_gpio_cdev_direction_output,
+	.gpio_ops_get_direction = &linux_gpio_cdev_get_direction,
+	.gpio_ops_set_value = &linux_gpio_cdev_set_value,
+	.gpio_ops_get_value = &linux_gpio_cdev_get_value,
+	.gpio_ops_group_get = &linux_gpio_cdev_group_get,
+	.gpio_ops_group_remove = &linux_gpio_cdev_group_remove,
+	.gpio_ops_group_direction_input = &linux_gpio_cdev_group_direction_input,
+	.gpio_ops_group_direction_output = &linux_gpio_cdev_group_direction_output,
+	.gpio_ops_group_set_values = &linux_gpio_cdev_group_set_values,
+	.gpio_ops_group_get_values = &linux_gpio_cdev_group_get_values,
+};
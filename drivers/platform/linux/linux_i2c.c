@@ -50,6 +50,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
 /******************************************************************************/
@@ -63,6 +64,8 @@
 struct linux_i2c_desc {
 	/** /dev/i2c-"device_id" file descriptor */
 	int fd;
+	/** Slave address bound to fd with I2C_SLAVE, -1 if none */
+	int bound_address;
 };
 
 /******************************************************************************/
@@ -92,6 +95,7 @@ int32_t linux_i2c_init(struct no_os_i2c_desc **desc,
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
+	linux_desc->bound_address = -1;
 	linux_init = param->extra;
 
 	snprintf(path, sizeof(path), "/dev/i2c-%d", linux_init->device_id);
@@ -140,6 +144,34 @@ int32_t linux_i2c_remove(struct no_os_i2c_desc *desc)
 	return 0;
 }
 
+/**
+ * @brief Bind the file descriptor to the slave address of the descriptor,
+ * unless it is already.
+ * @param desc - The I2C descriptor.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t linux_i2c_bind(struct no_os_i2c_desc *desc)
+{
+	struct linux_i2c_desc *linux_desc;
+	int32_t ret;
+
+	linux_desc = desc->extra;
+
+	if (linux_desc->bound_address == desc->slave_address)
+		return 0;
+
+	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
+	if (ret < 0) {
+		printf("%s: Can't select device\n\r", __func__);
+		linux_desc->bound_address = -1;
+		return -1;
+	}
+
+	linux_desc->bound_address = desc->slave_address;
+
+	return 0;
+}
+
 /**
  * @brief Write data to a slave device.
  * @param desc - The I2C descriptor.
@@ -160,11 +192,9 @@ int32_t linux_i2c_write(struct no_os_i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
+	ret = linux_i2c_bind(desc);
+	if (ret < 0)
 		return -1;
-	}
 
 	ret = write(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -199,11 +229,9 @@ int32_t linux_i2c_read(struct no_os_i2c_desc *desc,
 
 	linux_desc = desc->extra;
 
-	ret = ioctl(linux_desc->fd, I2C_SLAVE, desc->slave_address);
-	if (ret < 0) {
-		printf("%s: Can't select device\n\r", __func__);
+	ret = linux_i2c_bind(desc);
+	if (ret < 0)
 		return -1;
-	}
 
 	ret = read(linux_desc->fd, data, bytes_number);
 	if (ret < 0) {
@@ -218,6 +246,50 @@ int32_t linux_i2c_read(struct no_os_i2c_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Do a sequence of messages with a single I2C_RDWR ioctl, so that they
+ * are separated by repeated starts.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_i2c_transfer(struct no_os_i2c_desc *desc,
+				  struct no_os_i2c_msg *msgs,
+				  uint32_t len)
+{
+	struct i2c_msg i2c_msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	struct i2c_rdwr_ioctl_data rdwr;
+	struct linux_i2c_desc *linux_desc;
+	uint32_t i;
+	int ret;
+
+	if (!len)
+		return 0;
+	if (len > I2C_RDWR_IOCTL_MAX_MSGS)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	for (i = 0; i < len; i++) {
+		i2c_msgs[i].addr = desc->slave_address;
+		i2c_msgs[i].flags = (msgs[i].flags & NO_OS_I2C_M_RD) ? I2C_M_RD : 0;
+		i2c_msgs[i].len = msgs[i].bytes_number;
+		i2c_msgs[i].buf = msgs[i].buff;
+	}
+
+	rdwr.msgs = i2c_msgs;
+	rdwr.nmsgs = len;
+
+	ret = ioctl(linux_desc->fd, I2C_RDWR, &rdwr);
+	if (ret < 0) {
+		printf("%s: Can't transfer i2c messages (%d)\n\r", __func__, errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
@@ -225,5 +297,6 @@ const struct no_os_i2c_platform_ops linux_i2c_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
-	.i2c_ops_remove = &linux_i2c_remove
+	.i2c_ops_remove = &linux_i2c_remove,
+	.i2c_ops_transfer = &linux_i2c_transfer
 };
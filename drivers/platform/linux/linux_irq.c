@@ -0,0 +1,743 @@
+/***************************************************************************//**
+ *   @file   linux/linux_irq.c
+ *   @brief  Implementation of the Linux IRQ controller driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_error.h"
+#include "no_os_irq.h"
+#include "no_os_util.h"
+#include "linux_gpio.h"
+#include "linux_irq.h"
+#include "linux_timer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* epoll tag of the control eventfd, outside of the IRQ ID range */
+#define LINUX_IRQ_CTL_ID	LINUX_IRQ_MAX_IRQS
+/* Number of events handled per epoll_wait() and per GPIO read() */
+#define LINUX_IRQ_MAX_EVENTS	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_irq_line
+ * @brief State of an IRQ ID.
+ */
+struct linux_irq_line {
+	/** Interrupt file descriptor, -1 when no callback is registered */
+	int fd;
+	/** Interrupt source */
+	enum linux_irq_source source;
+	/** GPIO descriptor, for LINUX_IRQ_SOURCE_GPIO */
+	struct no_os_gpio_desc *gpio;
+	/** Trigger of the GPIO edge events */
+	enum no_os_irq_trig_level trig;
+	/** Registered callback */
+	struct no_os_callback_desc callback;
+	/** Enabled with no_os_irq_enable() */
+	bool enabled;
+	/** File descriptor being watched by the dispatch thread */
+	bool armed;
+};
+
+/**
+ * @struct linux_irq_desc
+ * @brief Linux platform specific IRQ controller descriptor
+ */
+struct linux_irq_desc {
+	/** epoll instance watching the armed IRQ file descriptors */
+	int epoll_fd;
+	/** eventfd used to wake up the dispatch thread */
+	int ctl_fd;
+	/** Callback dispatch thread */
+	pthread_t thread;
+	/** Protects the IRQ state, held while the callbacks run */
+	pthread_mutex_t lock;
+	/** Stop request for the dispatch thread */
+	bool stop;
+	/** Interrupts are globally enabled */
+	bool global_enabled;
+	/** IRQ IDs */
+	struct linux_irq_line irqs[LINUX_IRQ_MAX_IRQS];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Add or remove an IRQ file descriptor from the epoll set, depending on
+ * the IRQ and global enable state. Called with the lock held.
+ * @param ldesc - The Linux IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_irq_update(struct linux_irq_desc *ldesc, uint32_t irq_id)
+{
+	struct linux_irq_line *line = &ldesc->irqs[irq_id];
+	struct epoll_event ev;
+	bool arm;
+
+	arm = line->fd >= 0 && line->enabled && ldesc->global_enabled;
+	if (arm == line->armed)
+		return 0;
+
+	if (arm) {
+		ev.events = EPOLLIN;
+		ev.data.u32 = irq_id;
+		if (epoll_ctl(ldesc->epoll_fd, EPOLL_CTL_ADD, line->fd, &ev) < 0)
+			return -errno;
+	} else {
+		if (epoll_ctl(ldesc->epoll_fd, EPOLL_CTL_DEL, line->fd, NULL) < 0)
+			return -errno;
+	}
+
+	line->armed = arm;
+
+	return 0;
+}
+
+/**
+ * @brief Consume the pending events of an IRQ and run its callback. Called with
+ * the lock held.
+ *
+ * The callback gets the IRQ ID as event. The extra parameter depends on the
+ * source: the eventfd counter or the number of timer expiries (uint64_t *),
+ * the struct gpio_v2_line_event of the edge, with the callback called once per
+ * edge, or the UIO interrupt counter (uint32_t *).
+ * @param line - The IRQ.
+ * @param irq_id - Interrupt identifier.
+ */
+static void linux_irq_dispatch(struct linux_irq_line *line, uint32_t irq_id)
+{
+	struct gpio_v2_line_event events[LINUX_IRQ_MAX_EVENTS];
+	uint32_t uio_count, i;
+	uint64_t count;
+	ssize_t ret;
+
+	switch (line->source) {
+	case LINUX_IRQ_SOURCE_EVENTFD:
+	case LINUX_IRQ_SOURCE_TIMER:
+		if (read(line->fd, &count, sizeof(count)) != sizeof(count))
+			return;
+		line->callback.callback(line->callback.ctx, irq_id, &count);
+		break;
+	case LINUX_IRQ_SOURCE_GPIO:
+		ret = read(line->fd, events, sizeof(events));
+		if (ret <= 0)
+			return;
+		for (i = 0; i < ret / sizeof(events[0]); i++) {
+			line->callback.callback(line->callback.ctx, irq_id,
+						&events[i]);
+			/* The callback may have disabled or removed the IRQ. */
+			if (!line->armed)
+				break;
+		}
+		break;
+	case LINUX_IRQ_SOURCE_UIO:
+		if (read(line->fd, &uio_count, sizeof(uio_count)) !=
+		    sizeof(uio_count))
+			return;
+		line->callback.callback(line->callback.ctx, irq_id, &uio_count);
+		/* UIO masks the interrupt after each one, unmask it again. */
+		if (line->armed) {
+			uio_count = 1;
+			if (write(line->fd, &uio_count, sizeof(uio_count)) < 0)
+				printf("%s: Can't unmask IRQ %u\n\r", __func__,
+				       irq_id);
+		}
+		break;
+	}
+}
+
+/**
+ * @brief Dispatch thread, waits for the armed IRQs and runs their callbacks.
+ * @param arg - The Linux IRQ controller descriptor.
+ * @return NULL
+ */
+static void *linux_irq_thread(void *arg)
+{
+	struct epoll_event events[LINUX_IRQ_MAX_EVENTS];
+	struct linux_irq_desc *ldesc = arg;
+	struct linux_irq_line *line;
+	uint64_t count;
+	uint32_t id;
+	int ret, i;
+
+	while (true) {
+		ret = epoll_wait(ldesc->epoll_fd, events, LINUX_IRQ_MAX_EVENTS,
+				 -1);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			printf("%s: epoll_wait failed\n\r", __func__);
+			return NULL;
+		}
+
+		for (i = 0; i < ret; i++) {
+			id = events[i].data.u32;
+			pthread_mutex_lock(&ldesc->lock);
+			if (id == LINUX_IRQ_CTL_ID) {
+				if (read(ldesc->ctl_fd, &count, sizeof(count)) < 0)
+					count = 0;
+				if (ldesc->stop) {
+					pthread_mutex_unlock(&ldesc->lock);
+					return NULL;
+				}
+			} else if (id < LINUX_IRQ_MAX_IRQS) {
+				/* The IRQ may have been disarmed meanwhile. */
+				line = &ldesc->irqs[id];
+				if (line->armed)
+					linux_irq_dispatch(line, id);
+			}
+			pthread_mutex_unlock(&ldesc->lock);
+		}
+	}
+}
+
+/**
+ * @brief Initialize the IRQ controller and start the dispatch thread.
+ * @param desc - The IRQ controller descriptor.
+ * @param param - The IRQ controller initialization parameters, the extra
+ * 		  parameters are a struct linux_irq_init_param and may be NULL.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
+			    const struct no_os_irq_init_param *param)
+{
+	struct linux_irq_init_param *extra;
+	struct no_os_irq_ctrl_desc *descriptor;
+	struct linux_irq_desc *ldesc;
+	pthread_mutexattr_t mattr;
+	struct sched_param sched;
+	struct epoll_event ev;
+	pthread_attr_t attr;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	extra = param->extra;
+	if (extra && (extra->priority < 0 || extra->priority > 99))
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	for (i = 0; i < LINUX_IRQ_MAX_IRQS; i++) {
+		ldesc->irqs[i].fd = -1;
+		ldesc->irqs[i].trig = NO_OS_IRQ_EDGE_RISING;
+	}
+	/* Like an MCU coming out of reset, only the IRQ enables matter. */
+	ldesc->global_enabled = true;
+
+	/* Callbacks may enable, disable or unregister IRQs. */
+	pthread_mutexattr_init(&mattr);
+	pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE);
+	ret = -pthread_mutex_init(&ldesc->lock, &mattr);
+	pthread_mutexattr_destroy(&mattr);
+	if (ret)
+		goto free_ldesc;
+
+	ldesc->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (ldesc->epoll_fd < 0) {
+		ret = -errno;
+		goto destroy_lock;
+	}
+
+	ldesc->ctl_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (ldesc->ctl_fd < 0) {
+		ret = -errno;
+		goto close_epoll;
+	}
+
+	ev.events = EPOLLIN;
+	ev.data.u32 = LINUX_IRQ_CTL_ID;
+	if (epoll_ctl(ldesc->epoll_fd, EPOLL_CTL_ADD, ldesc->ctl_fd, &ev) < 0) {
+		ret = -errno;
+		goto close_ctl;
+	}
+
+	pthread_attr_init(&attr);
+	if (extra && extra->priority) {
+		sched.sched_priority = extra->priority;
+		pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+		pthread_attr_setschedparam(&attr, &sched);
+	}
+	ret = -pthread_create(&ldesc->thread, &attr, linux_irq_thread, ldesc);
+	pthread_attr_destroy(&attr);
+	if (ret) {
+		printf("%s: Can't start the dispatch thread\n\r", __func__);
+		goto close_ctl;
+	}
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	descriptor->extra = ldesc;
+	*desc = descriptor;
+
+	return 0;
+
+close_ctl:
+	close(ldesc->ctl_fd);
+close_epoll:
+	close(ldesc->epoll_fd);
+destroy_lock:
+	pthread_mutex_destroy(&ldesc->lock);
+free_ldesc:
+	free(ldesc);
+free_desc:
+	free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Register a callback for an IRQ ID and map the ID to its file
+ * descriptor. The IRQ stays disabled until no_os_irq_enable() is called.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @param callback_desc - Callback descriptor, config is a
+ * 			  struct linux_irq_config or NULL for an eventfd.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
+				    uint32_t irq_id,
+				    struct no_os_callback_desc *callback_desc)
+{
+	struct linux_irq_config *config;
+	struct linux_irq_desc *ldesc;
+	struct linux_irq_line *line;
+	char path[32];
+	int32_t ret = 0;
+	int fd;
+
+	if (!desc || !callback_desc || !callback_desc->callback ||
+	    irq_id >= LINUX_IRQ_MAX_IRQS)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	config = callback_desc->config;
+
+	pthread_mutex_lock(&ldesc->lock);
+
+	line = &ldesc->irqs[irq_id];
+	if (line->fd >= 0) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	line->source = config ? config->source : LINUX_IRQ_SOURCE_EVENTFD;
+	line->gpio = NULL;
+
+	switch (line->source) {
+	case LINUX_IRQ_SOURCE_EVENTFD:
+		fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (fd < 0)
+			ret = -errno;
+		break;
+	case LINUX_IRQ_SOURCE_GPIO:
+		fd = linux_gpio_cdev_get_fd(config->gpio);
+		if (fd < 0) {
+			ret = fd;
+			break;
+		}
+		ret = linux_gpio_cdev_set_edge(config->gpio, line->trig, 1);
+		if (ret)
+			break;
+		if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+			ret = -errno;
+			linux_gpio_cdev_set_edge(config->gpio, line->trig, 0);
+			break;
+		}
+		line->gpio = config->gpio;
+		break;
+	case LINUX_IRQ_SOURCE_UIO:
+		sprintf(path, "/dev/uio%u", config->uio);
+		fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) {
+			printf("%s: Can't open %s\n\r", __func__, path);
+			ret = -errno;
+		}
+		break;
+	case LINUX_IRQ_SOURCE_TIMER:
+		fd = linux_timer_get_fd(config->timer);
+		if (fd < 0)
+			ret = fd;
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+	if (ret)
+		goto unlock;
+
+	line->fd = fd;
+	line->callback = *callback_desc;
+	line->enabled = false;
+	line->armed = false;
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Unregister the callback of an IRQ ID and release its file
+ * descriptor. The GPIO or timer itself is left to its owner.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_unregister(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_desc *ldesc;
+	struct linux_irq_line *line;
+	int32_t ret;
+
+	if (!desc || irq_id >= LINUX_IRQ_MAX_IRQS)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+
+	line = &ldesc->irqs[irq_id];
+	if (line->fd < 0) {
+		ret = -ENOENT;
+		goto unlock;
+	}
+
+	line->enabled = false;
+	ret = linux_irq_update(ldesc, irq_id);
+	if (ret)
+		goto unlock;
+
+	/* The GPIO and timer file descriptors belong to their descriptors. */
+	if (line->source == LINUX_IRQ_SOURCE_GPIO)
+		ret = linux_gpio_cdev_set_edge(line->gpio, line->trig, 0);
+	else if (line->source != LINUX_IRQ_SOURCE_TIMER)
+		close(line->fd);
+	line->fd = -1;
+	line->gpio = NULL;
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Enable the dispatching of all the enabled IRQs.
+ * @param desc - The IRQ controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_global_enable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+	int32_t ret = 0;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->global_enabled = true;
+	for (i = 0; i < LINUX_IRQ_MAX_IRQS && !ret; i++)
+		ret = linux_irq_update(ldesc, i);
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Stop dispatching all the IRQs. The events occurring meanwhile stay
+ * pending and are dispatched once the interrupts are enabled again.
+ * @param desc - The IRQ controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_global_disable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+	int32_t ret = 0;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->global_enabled = false;
+	for (i = 0; i < LINUX_IRQ_MAX_IRQS && !ret; i++)
+		ret = linux_irq_update(ldesc, i);
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Set the trigger of a GPIO IRQ. May be called before the callback is
+ * registered, the default trigger is NO_OS_IRQ_EDGE_RISING.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @param trig - New trigger, only edge triggers are supported.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_trigger_level_set(struct no_os_irq_ctrl_desc *desc,
+				    uint32_t irq_id,
+				    enum no_os_irq_trig_level trig)
+{
+	struct linux_irq_desc *ldesc;
+	struct linux_irq_line *line;
+	int32_t ret = 0;
+
+	if (!desc || irq_id >= LINUX_IRQ_MAX_IRQS)
+		return -EINVAL;
+
+	if (trig != NO_OS_IRQ_EDGE_FALLING && trig != NO_OS_IRQ_EDGE_RISING &&
+	    trig != NO_OS_IRQ_EDGE_BOTH)
+		return -ENOTSUP;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+
+	line = &ldesc->irqs[irq_id];
+	if (line->fd >= 0) {
+		if (line->source != LINUX_IRQ_SOURCE_GPIO) {
+			ret = -ENOTSUP;
+			goto unlock;
+		}
+		ret = linux_gpio_cdev_set_edge(line->gpio, trig, 1);
+		if (ret)
+			goto unlock;
+	}
+	line->trig = trig;
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Enable or disable an IRQ.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @param enable - The new state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_irq_set_enable(struct no_os_irq_ctrl_desc *desc,
+				    uint32_t irq_id, bool enable)
+{
+	struct linux_irq_desc *ldesc;
+	struct linux_irq_line *line;
+	uint32_t uio_enable;
+	int32_t ret;
+
+	if (!desc || irq_id >= LINUX_IRQ_MAX_IRQS)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+
+	line = &ldesc->irqs[irq_id];
+	if (line->fd < 0) {
+		ret = -ENOENT;
+		goto unlock;
+	}
+
+	if (line->source == LINUX_IRQ_SOURCE_UIO) {
+		uio_enable = enable;
+		if (write(line->fd, &uio_enable, sizeof(uio_enable)) < 0) {
+			ret = -errno;
+			goto unlock;
+		}
+	}
+
+	line->enabled = enable;
+	ret = linux_irq_update(ldesc, irq_id);
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Enable an IRQ. Events that occurred while it was disabled are
+ * dispatched right away.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_enable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	return linux_irq_set_enable(desc, irq_id, true);
+}
+
+/**
+ * @brief Disable an IRQ. Once this returns, its callback is not running and
+ * will not be called until the IRQ is enabled again.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_disable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	return linux_irq_set_enable(desc, irq_id, false);
+}
+
+/**
+ * @brief Trigger an IRQ mapped to an eventfd, from any thread. Triggers that
+ * occur before the callback runs are coalesced into a single call.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_trigger(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_desc *ldesc;
+	struct linux_irq_line *line;
+	uint64_t one = 1;
+	int32_t ret = 0;
+
+	if (!desc || irq_id >= LINUX_IRQ_MAX_IRQS)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+
+	line = &ldesc->irqs[irq_id];
+	if (line->fd < 0 || line->source != LINUX_IRQ_SOURCE_EVENTFD)
+		ret = -EINVAL;
+	else if (write(line->fd, &one, sizeof(one)) < 0)
+		ret = -errno;
+
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the dispatch thread and free the resources allocated by
+ * linux_irq_ctrl_init().
+ * @param desc - The IRQ controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_ctrl_remove(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+	uint64_t one = 1;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->stop = true;
+	if (write(ldesc->ctl_fd, &one, sizeof(one)) < 0) {
+		ldesc->stop = false;
+		pthread_mutex_unlock(&ldesc->lock);
+		return -errno;
+	}
+	pthread_mutex_unlock(&ldesc->lock);
+
+	pthread_join(ldesc->thread, NULL);
+
+	for (i = 0; i < LINUX_IRQ_MAX_IRQS; i++)
+		if (ldesc->irqs[i].fd >= 0)
+			linux_irq_unregister(desc, i);
+
+	close(ldesc->ctl_fd);
+	close(ldesc->epoll_fd);
+	pthread_mutex_destroy(&ldesc->lock);
+	free(ldesc);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Linux specific IRQ platform ops structure
+ */
+const struct no_os_irq_platform_ops linux_irq_ops = {
+	.init = &linux_irq_ctrl_init,
+	.register_callback = &linux_irq_register_callback,
+	.unregister = &linux_irq_unregister,
+	.global_enable = &linux_irq_global_enable,
+	.global_disable = &linux_irq_global_disable,
+	.trigger_level_set = &linux_irq_trigger_level_set,
+	.enable = &linux_irq_enable,
+	.disable = &linux_irq_disable,
+	.remove = &linux_irq_ctrl_remove,
+};
@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ *   @file   linux/linux_irq.h
+ *   @brief  Header file of the Linux IRQ controller driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_IRQ_H_
+#define LINUX_IRQ_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
+#include "no_os_timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of IRQ IDs handled by a controller, IDs go from 0 to this - 1 */
+#define LINUX_IRQ_MAX_IRQS	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_irq_source
+ * @brief File descriptors an IRQ ID can be mapped to.
+ */
+enum linux_irq_source {
+	/** eventfd, triggered in software with linux_irq_trigger() */
+	LINUX_IRQ_SOURCE_EVENTFD,
+	/** Edge events of a GPIO obtained with linux_gpio_cdev_ops */
+	LINUX_IRQ_SOURCE_GPIO,
+	/** UIO device interrupt */
+	LINUX_IRQ_SOURCE_UIO,
+	/** Periodic expiry of a timer obtained with no_os_timer_init() */
+	LINUX_IRQ_SOURCE_TIMER,
+};
+
+/**
+ * @struct linux_irq_config
+ * @brief Linux specific callback configuration, passed as
+ * no_os_callback_desc.config. A NULL config maps the IRQ ID to an eventfd.
+ */
+struct linux_irq_config {
+	/** Interrupt source */
+	enum linux_irq_source source;
+	/** GPIO descriptor, for LINUX_IRQ_SOURCE_GPIO */
+	struct no_os_gpio_desc *gpio;
+	/** UIO device number, /dev/uio"uio" for LINUX_IRQ_SOURCE_UIO */
+	uint32_t uio;
+	/** Timer descriptor, for LINUX_IRQ_SOURCE_TIMER */
+	struct no_os_timer_desc *timer;
+};
+
+/**
+ * @struct linux_irq_init_param
+ * @brief Linux specific IRQ controller initialization parameters.
+ */
+struct linux_irq_init_param {
+	/**
+	 * SCHED_FIFO priority of the callback dispatch thread, 1 to 99.
+	 * 0 keeps the default scheduling policy.
+	 */
+	int32_t priority;
+};
+
+/**
+ * @brief Linux specific IRQ platform ops structure
+ */
+extern const struct no_os_irq_platform_ops linux_irq_ops;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Trigger an IRQ mapped to an eventfd. */
+int32_t linux_irq_trigger(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id);
+
+#endif // LINUX_IRQ_H_
@@ -46,12 +46,24 @@
 #include "linux_spi.h"
 
 #include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <linux/spi/spidev.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of transfers of a batch, before it is flushed */
+#define LINUX_SPI_BATCH_MAX_XFERS	64
+/* Batch data buffer size, spidev default bufsiz */
+#define LINUX_SPI_BATCH_BUF_SIZE	4096
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,6 +75,41 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Transfer array passed to SPI_IOC_MESSAGE, reused between calls */
+	struct spi_ioc_transfer *tr;
+	/** Number of entries of tr */
+	uint32_t tr_size;
+	/** Transfers are batched */
+	bool batching;
+	/** Batch flags (NO_OS_SPI_BATCH_READBACK) */
+	uint32_t batch_flags;
+	/** Number of transfers recorded in tr */
+	uint32_t batch_len;
+	/** Bytes used in batch_buf */
+	uint32_t batch_bytes;
+	/** First error of the batch */
+	int32_t batch_ret;
+	/** Sent and received data of the batched transfers */
+	uint8_t *batch_buf;
+	/** Caller buffers receiving the data of the batched transfers */
+	uint8_t *batch_rx[LINUX_SPI_BATCH_MAX_XFERS];
+};
+
+/**
+ * @struct linux_spi_worker
+ * @brief Thread processing the asynchronous transfers of a SPI bus
+ */
+struct linux_spi_worker {
+	/** Worker thread */
+	pthread_t thread;
+	/** Protects pending and stop */
+	pthread_mutex_t lock;
+	/** Signaled when transfers are queued or the worker must stop */
+	pthread_cond_t cond;
+	/** Transfers were queued since the worker last went through the queue */
+	bool pending;
+	/** Stop request */
+	bool stop;
 };
 
 /******************************************************************************/
@@ -88,11 +135,19 @@ int32_t linux_spi_init(struct no_os_spi_desc **desc,
 	if (!descriptor)
 		return -1;
 
-	linux_desc = (struct linux_spi_desc*) malloc(sizeof(struct linux_spi_desc));
+	linux_desc = (struct linux_spi_desc*) calloc(1, sizeof(struct linux_spi_desc));
 	if (!linux_desc)
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
+	linux_desc->spidev_fd = -1;
+
+	linux_desc->tr = calloc(LINUX_SPI_BATCH_MAX_XFERS,
+				sizeof(*linux_desc->tr));
+	linux_desc->batch_buf = malloc(LINUX_SPI_BATCH_BUF_SIZE);
+	if (!linux_desc->tr || !linux_desc->batch_buf)
+		goto free;
+	linux_desc->tr_size = LINUX_SPI_BATCH_MAX_XFERS;
 
 	snprintf(path, sizeof(path), "/dev/spidev%d.%d",
 		 param->device_id, param->chip_select);
@@ -128,6 +183,10 @@ int32_t linux_spi_init(struct no_os_spi_desc **desc,
 
 	return 0;
 free:
+	if (linux_desc->spidev_fd >= 0)
+		close(linux_desc->spidev_fd);
+	free(linux_desc->batch_buf);
+	free(linux_desc->tr);
 	free(linux_desc);
 free_desc:
 	free(descriptor);
@@ -135,6 +194,91 @@ free_desc:
 	return -1;
 }
 
+/**
+ * @brief Do the transfers recorded in the batch and copy the received data
+ * back, if requested.
+ * @param linux_desc - The Linux SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_batch_flush(struct linux_spi_desc *linux_desc)
+{
+	uint32_t i;
+	int ret;
+
+	if (!linux_desc->batch_len)
+		return 0;
+
+	/* Release the chip select after the last transfer */
+	linux_desc->tr[linux_desc->batch_len - 1].cs_change = 0;
+
+	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(linux_desc->batch_len),
+		    linux_desc->tr);
+	if (ret < 0) {
+		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
+		ret = -errno;
+	} else if (linux_desc->batch_flags & NO_OS_SPI_BATCH_READBACK) {
+		for (i = 0; i < linux_desc->batch_len; i++)
+			if (linux_desc->batch_rx[i])
+				memcpy(linux_desc->batch_rx[i],
+				       (uint8_t *)(uintptr_t)linux_desc->tr[i].rx_buf,
+				       linux_desc->tr[i].len);
+		ret = 0;
+	} else {
+		ret = 0;
+	}
+
+	linux_desc->batch_len = 0;
+	linux_desc->batch_bytes = 0;
+	if (ret && !linux_desc->batch_ret)
+		linux_desc->batch_ret = ret;
+
+	return ret;
+}
+
+/**
+ * @brief Record a transfer in the batch, flushing it first if it is full.
+ * @param linux_desc - The Linux SPI descriptor.
+ * @param tx - Data to send, NULL to send zeros.
+ * @param rx - Buffer receiving the data, NULL to discard it.
+ * @param len - Number of bytes.
+ * @param cs_change - Release the chip select after this transfer.
+ * @return 0 if the transfer was recorded, -EMSGSIZE if it does not fit in an
+ * empty batch.
+ */
+static int32_t linux_spi_batch_add(struct linux_spi_desc *linux_desc,
+				   const uint8_t *tx, uint8_t *rx,
+				   uint32_t len, bool cs_change)
+{
+	struct spi_ioc_transfer *tr;
+	uint8_t *buf;
+
+	if (len > LINUX_SPI_BATCH_BUF_SIZE)
+		return -EMSGSIZE;
+
+	if (linux_desc->batch_len == LINUX_SPI_BATCH_MAX_XFERS ||
+	    linux_desc->batch_bytes + len > LINUX_SPI_BATCH_BUF_SIZE)
+		linux_spi_batch_flush(linux_desc);
+
+	buf = linux_desc->batch_buf + linux_desc->batch_bytes;
+	if (tx)
+		memcpy(buf, tx, len);
+	else
+		memset(buf, 0, len);
+
+	tr = &linux_desc->tr[linux_desc->batch_len];
+	memset(tr, 0, sizeof(*tr));
+	tr->tx_buf = (unsigned long)buf;
+	tr->rx_buf = (unsigned long)buf;
+	tr->len = len;
+	tr->cs_change = cs_change;
+
+	linux_desc->batch_rx[linux_desc->batch_len] = rx;
+	linux_desc->batch_len++;
+	linux_desc->batch_bytes += len;
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -156,8 +300,17 @@ int32_t linux_spi_write_and_read(struct no_os_spi_desc *desc,
 
 	linux_desc = desc->extra;
 
+	if (linux_desc->batching) {
+		ret = linux_spi_batch_add(linux_desc, data, data, bytes_number,
+					  true);
+		if (!ret)
+			return 0;
+		/* Too large to be batched, keep the order and do it now */
+		linux_spi_batch_flush(linux_desc);
+	}
+
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(1), &tr);
-	if (ret == 1) {
+	if (ret < 0) {
 		printf("%s: Can't send spi message\n\r", __func__);
 		return -1;
 	}
@@ -183,12 +336,51 @@ int32_t linux_spi_remove(struct no_os_spi_desc *desc)
 		return -1;
 	}
 
+	free(linux_desc->batch_buf);
+	free(linux_desc->tr);
 	free(desc->extra);
 	free(desc);
 
 	return 0;
 }
 
+/**
+ * @brief Record the messages in the batch, keeping each message group in its
+ * own chip select frame.
+ * @param linux_desc - The Linux SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 if all the messages were recorded, negative error code otherwise.
+ */
+static int32_t linux_spi_batch_transfer(struct linux_spi_desc *linux_desc,
+					struct no_os_spi_msg *msgs,
+					uint32_t len)
+{
+	uint32_t i, bytes = 0;
+	int32_t ret;
+
+	for (i = 0; i < len; i++)
+		bytes += msgs[i].bytes_number;
+
+	/* A frame split over two ioctls would lose its chip select */
+	if (len > LINUX_SPI_BATCH_MAX_XFERS || bytes > LINUX_SPI_BATCH_BUF_SIZE)
+		return -EMSGSIZE;
+	if (linux_desc->batch_len + len > LINUX_SPI_BATCH_MAX_XFERS ||
+	    linux_desc->batch_bytes + bytes > LINUX_SPI_BATCH_BUF_SIZE)
+		linux_spi_batch_flush(linux_desc);
+
+	for (i = 0; i < len; i++) {
+		ret = linux_spi_batch_add(linux_desc, msgs[i].tx_buff,
+					  msgs[i].rx_buff,
+					  msgs[i].bytes_number,
+					  msgs[i].cs_change || i == len - 1);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
 				  struct no_os_spi_msg *msgs,
 				  uint32_t len)
@@ -201,10 +393,25 @@ static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
 
 	linux_desc = desc->extra;
 
-	tr = (struct spi_ioc_transfer *)calloc(len, sizeof(*tr));
-	if (!tr)
-		return -ENOMEM;
+	if (!len)
+		return 0;
 
+	if (linux_desc->batching) {
+		if (!linux_spi_batch_transfer(linux_desc, msgs, len))
+			return 0;
+		linux_spi_batch_flush(linux_desc);
+	}
+
+	if (len > linux_desc->tr_size) {
+		tr = realloc(linux_desc->tr, len * sizeof(*tr));
+		if (!tr)
+			return -ENOMEM;
+		linux_desc->tr = tr;
+		linux_desc->tr_size = len;
+	}
+
+	tr = linux_desc->tr;
+	memset(tr, 0, len * sizeof(*tr));
 	for (i = 0; i < len; i++) {
 		tr[i].tx_buf = (unsigned long) msgs[i].tx_buff;
 		tr[i].rx_buf = (unsigned long) msgs[i].rx_buff;
@@ -213,13 +420,163 @@ static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
 	}
 
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
-	if (ret < 0)
+	if (ret < 0) {
 		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
+		return -errno;
+	}
 
-	free(tr);
+	return 0;
+}
 
-	return ret;
+/**
+ * @brief Start recording the transfers of a device in a batch.
+ * @param desc - The SPI descriptor.
+ * @param flags - NO_OS_SPI_BATCH_READBACK or 0.
+ * @return 0 in case of success, -EBUSY if a batch is already open.
+ */
+static int32_t linux_spi_batch_begin(struct no_os_spi_desc *desc,
+				     uint32_t flags)
+{
+	struct linux_spi_desc *linux_desc = desc->extra;
+
+	if (linux_desc->batching)
+		return -EBUSY;
+
+	linux_desc->batch_flags = flags;
+	linux_desc->batch_len = 0;
+	linux_desc->batch_bytes = 0;
+	linux_desc->batch_ret = 0;
+	linux_desc->batching = true;
+
+	return 0;
+}
+
+/**
+ * @brief Do the batched transfers with a single SPI_IOC_MESSAGE ioctl.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, the first error of the batch otherwise.
+ */
+static int32_t linux_spi_batch_commit(struct no_os_spi_desc *desc)
+{
+	struct linux_spi_desc *linux_desc = desc->extra;
+
+	if (!linux_desc->batching)
+		return -EINVAL;
+
+	linux_spi_batch_flush(linux_desc);
+	linux_desc->batching = false;
+
+	return linux_desc->batch_ret;
+}
+
+/**
+ * @brief Worker thread, processes the bus queue each time it is notified.
+ * @param arg - The SPI bus descriptor.
+ * @return NULL
+ */
+static void *linux_spi_worker_thread(void *arg)
+{
+	struct no_os_spi_bus_desc *bus = arg;
+	struct linux_spi_worker *worker = bus->extra;
+
+	pthread_mutex_lock(&worker->lock);
+	while (true) {
+		while (!worker->pending && !worker->stop)
+			pthread_cond_wait(&worker->cond, &worker->lock);
+		if (!worker->pending)
+			break;
+		worker->pending = false;
+		pthread_mutex_unlock(&worker->lock);
+
+		no_os_spi_bus_run(bus);
+
+		pthread_mutex_lock(&worker->lock);
+	}
+	pthread_mutex_unlock(&worker->lock);
+
+	return NULL;
+}
+
+/**
+ * @brief Start the worker thread of a SPI bus.
+ * @param bus - The SPI bus descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_async_start(struct no_os_spi_bus_desc *bus)
+{
+	struct linux_spi_worker *worker;
+	int ret;
+
+	/* The weak no-op mutexes are linked if linux_mutex.c is missing */
+	if (!bus->mutex || !bus->queue_mutex) {
+		printf("%s: The SPI worker needs linux_mutex.c\n\r", __func__);
+		return -ENOSYS;
+	}
+
+	worker = calloc(1, sizeof(*worker));
+	if (!worker)
+		return -ENOMEM;
+
+	pthread_mutex_init(&worker->lock, NULL);
+	pthread_cond_init(&worker->cond, NULL);
+	bus->extra = worker;
+
+	ret = pthread_create(&worker->thread, NULL, linux_spi_worker_thread,
+			     bus);
+	if (ret) {
+		printf("%s: Can't start the SPI worker\n\r", __func__);
+		pthread_cond_destroy(&worker->cond);
+		pthread_mutex_destroy(&worker->lock);
+		free(worker);
+		bus->extra = NULL;
+		return -ret;
+	}
+
+	return 0;
 }
+
+/**
+ * @brief Wake up the worker thread of a SPI bus.
+ * @param bus - The SPI bus descriptor.
+ * @return 0
+ */
+static int32_t linux_spi_async_notify(struct no_os_spi_bus_desc *bus)
+{
+	struct linux_spi_worker *worker = bus->extra;
+
+	pthread_mutex_lock(&worker->lock);
+	worker->pending = true;
+	pthread_cond_signal(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+
+	return 0;
+}
+
+/**
+ * @brief Stop the worker thread of a SPI bus, once the queued transfers are
+ * done.
+ * @param bus - The SPI bus descriptor.
+ * @return 0
+ */
+static int32_t linux_spi_async_stop(struct no_os_spi_bus_desc *bus)
+{
+	struct linux_spi_worker *worker = bus->extra;
+
+	pthread_mutex_lock(&worker->lock);
+	worker->stop = true;
+	pthread_cond_signal(&worker->cond);
+	pthread_mutex_unlock(&worker->lock);
+
+	pthread_join(worker->thread, NULL);
+
+	pthread_cond_destroy(&worker->cond);
+	pthread_mutex_destroy(&worker->lock);
+	free(worker);
+	bus->extra = NULL;
+
+	return 0;
+}
+
 /**
  * @brief Linux platform specific SPI platform ops structure
  */
@@ -227,5 +584,10 @@ const struct no_os_spi_platform_ops linux_spi_ops = {
 	.init = &linux_spi_init,
 	.write_and_read = &linux_spi_write_and_read,
 	.remove = &linux_spi_remove,
-	.transfer = &linux_spi_transfer
+	.transfer = &linux_spi_transfer,
+	.async_start = &linux_spi_async_start,
+	.async_notify = &linux_spi_async_notify,
+	.async_stop = &linux_spi_async_stop,
+	.batch_begin = &linux_spi_batch_begin,
+	.batch_commit = &linux_spi_batch_commit
 };
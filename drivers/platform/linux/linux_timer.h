@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ *   @file   linux/linux_timer.h
+ *   @brief  Header file of the Linux timer driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_TIMER_H_
+#define LINUX_TIMER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_timer.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_timer_init_param
+ * @brief Linux specific timer initialization parameters.
+ */
+struct linux_timer_init_param {
+	/**
+	 * Period of the timer expiry, in nanoseconds. The expiries are
+	 * delivered through the IRQ layer, by registering a callback with a
+	 * LINUX_IRQ_SOURCE_TIMER source. 0 disables the periodic expiry.
+	 */
+	uint64_t period_ns;
+};
+
+/**
+ * @struct linux_timer_desc
+ * @brief Linux specific timer descriptor.
+ */
+struct linux_timer_desc {
+	/** timerfd delivering the periodic expiries */
+	int fd;
+	/** Period of the timer expiry, in nanoseconds */
+	uint64_t period_ns;
+	/** CLOCK_MONOTONIC time matching the load value, in nanoseconds */
+	uint64_t start_ns;
+	/** Counter value at start_ns */
+	uint32_t load_value;
+	/** CLOCK_MONOTONIC time of the last start, in nanoseconds */
+	uint64_t run_start_ns;
+	/** Time counted before the last stop, in nanoseconds */
+	uint64_t elapsed_ns;
+	/** Counter is running */
+	uint8_t running;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Get the timerfd delivering the periodic expiries of a timer. */
+int linux_timer_get_fd(struct no_os_timer_desc *desc);
+
+#endif // LINUX_TIMER_H_
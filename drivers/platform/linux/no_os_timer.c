@@ -0,0 +1,370 @@
+/***************************************************************************//**
+ *   @file   linux/no_os_timer.c
+ *   @brief  Implementation of the Linux timer driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "no_os_error.h"
+#include "no_os_timer.h"
+#include "linux_timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_TIMER_NSEC_PER_SEC	1000000000ULL
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the CLOCK_MONOTONIC time.
+ * @return The time in nanoseconds.
+ */
+static uint64_t linux_timer_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * LINUX_TIMER_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Compute the counter value at a given time.
+ * @param desc - The timer descriptor.
+ * @param now_ns - CLOCK_MONOTONIC time, in nanoseconds.
+ * @return The counter value, wrapping around at 32 bits like a hardware
+ * 	   counter.
+ */
+static uint32_t linux_timer_counter_at(struct no_os_timer_desc *desc,
+				       uint64_t now_ns)
+{
+	struct linux_timer_desc *ldesc = desc->extra;
+	uint64_t delta, ticks;
+
+	if (!ldesc->running)
+		return ldesc->load_value;
+
+	/* Split the conversion so that it does not overflow for long runs. */
+	delta = now_ns - ldesc->start_ns;
+	ticks = (delta / LINUX_TIMER_NSEC_PER_SEC) * desc->freq_hz +
+		(delta % LINUX_TIMER_NSEC_PER_SEC) * desc->freq_hz /
+		LINUX_TIMER_NSEC_PER_SEC;
+
+	return ldesc->load_value + (uint32_t)ticks;
+}
+
+/**
+ * @brief Arm or disarm the periodic expiry of a timer.
+ * @param ldesc - The Linux timer descriptor.
+ * @param arm - 0 to disarm, arm otherwise.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_timer_arm(struct linux_timer_desc *ldesc, uint8_t arm)
+{
+	struct itimerspec its;
+
+	if (!ldesc->period_ns)
+		return 0;
+
+	memset(&its, 0, sizeof(its));
+	if (arm) {
+		its.it_interval.tv_sec = ldesc->period_ns / LINUX_TIMER_NSEC_PER_SEC;
+		its.it_interval.tv_nsec = ldesc->period_ns % LINUX_TIMER_NSEC_PER_SEC;
+		its.it_value = its.it_interval;
+	}
+
+	if (timerfd_settime(ldesc->fd, 0, &its, NULL) < 0)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * @brief Initialize a timer counting at freq_hz from load_value, based on
+ *        CLOCK_MONOTONIC.
+ * @param [out] desc - Pointer to the reference of the device handler.
+ * @param [in] param - Initialization structure, the extra parameters are a
+ * 		       struct linux_timer_init_param and may be NULL.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_timer_init(struct no_os_timer_desc **desc,
+			 struct no_os_timer_init_param *param)
+{
+	struct linux_timer_init_param *linit;
+	struct linux_timer_desc *ldesc;
+	struct no_os_timer_desc *dev;
+	int32_t ret;
+
+	if (!desc || !param || !param->freq_hz ||
+	    param->freq_hz > LINUX_TIMER_NSEC_PER_SEC)
+		return -EINVAL;
+
+	linit = param->extra;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+
+	ldesc = calloc(1, sizeof(*ldesc));
+	if (!ldesc) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	ldesc->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (ldesc->fd < 0) {
+		ret = -errno;
+		goto error_ldesc;
+	}
+
+	ldesc->period_ns = linit ? linit->period_ns : 0;
+	ldesc->load_value = param->load_value;
+
+	dev->id = param->id;
+	dev->freq_hz = param->freq_hz;
+	dev->load_value = param->load_value;
+	dev->extra = ldesc;
+	*desc = dev;
+
+	return 0;
+
+error_ldesc:
+	free(ldesc);
+error_desc:
+	free(dev);
+
+	return ret;
+}
+
+/**
+ * @brief Free the memory allocated by no_os_timer_init().
+ * @param [in] desc - Pointer to the device handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_timer_remove(struct no_os_timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	close(ldesc->fd);
+	free(ldesc);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Start a timer.
+ * @param [in] desc - Pointer to the device handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_timer_start(struct no_os_timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+	uint64_t now;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	if (ldesc->running)
+		return 0;
+
+	now = linux_timer_now_ns();
+	ldesc->start_ns = now;
+	ldesc->run_start_ns = now;
+	ldesc->running = 1;
+
+	return linux_timer_arm(ldesc, 1);
+}
+
+/**
+ * @brief Stop a timer from counting. The counter keeps its value.
+ * @param [in] desc - Pointer to the device handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_timer_stop(struct no_os_timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+	uint64_t now;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	if (!ldesc->running)
+		return 0;
+
+	now = linux_timer_now_ns();
+	ldesc->load_value = linux_timer_counter_at(desc, now);
+	ldesc->elapsed_ns += now - ldesc->run_start_ns;
+	ldesc->running = 0;
+
+	return linux_timer_arm(ldesc, 0);
+}
+
+/**
+ * @brief Get the value of the counter register for the timer.
+ * @param [in]  desc    - Pointer to the device handler.
+ * @param [out] counter - Pointer to the counter value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_timer_counter_get(struct no_os_timer_desc *desc,
+				uint32_t *counter)
+{
+	if (!desc || !counter)
+		return -EINVAL;
+
+	*counter = linux_timer_counter_at(desc, linux_timer_now_ns());
+
+	return 0;
+}
+
+/**
+ * @brief Set the timer counter register value.
+ * @param [in] desc    - Pointer to the device handler.
+ * @param [in] new_val - The new value of the counter register.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_timer_counter_set(struct no_os_timer_desc *desc, uint32_t new_val)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	ldesc->load_value = new_val;
+	ldesc->start_ns = linux_timer_now_ns();
+
+	return 0;
+}
+
+/**
+ * @brief Get the timer clock frequency.
+ * @param [in]  desc    - Pointer to the device handler.
+ * @param [out] freq_hz - The value in Hz of the timer clock.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_timer_count_clk_get(struct no_os_timer_desc *desc,
+				  uint32_t *freq_hz)
+{
+	if (!desc || !freq_hz)
+		return -EINVAL;
+
+	*freq_hz = desc->freq_hz;
+
+	return 0;
+}
+
+/**
+ * @brief Set the timer clock frequency. The counter continues from its
+ *        current value at the new frequency.
+ * @param [in] desc    - Pointer to the device handler.
+ * @param [in] freq_hz - The value in Hz of the new timer clock, up to 1 GHz.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_timer_count_clk_set(struct no_os_timer_desc *desc,
+				  uint32_t freq_hz)
+{
+	struct linux_timer_desc *ldesc;
+	uint64_t now;
+
+	if (!desc || !freq_hz || freq_hz > LINUX_TIMER_NSEC_PER_SEC)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	now = linux_timer_now_ns();
+	ldesc->load_value = linux_timer_counter_at(desc, now);
+	ldesc->start_ns = now;
+	desc->freq_hz = freq_hz;
+
+	return 0;
+}
+
+/**
+ * @brief Get the time the timer has been running for, in nanoseconds.
+ * @param [in] desc          - Pointer to the device handler.
+ * @param [out] elapsed_time - The elapsed time.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_timer_get_elapsed_time_nsec(struct no_os_timer_desc *desc,
+		uint64_t *elapsed_time)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc || !elapsed_time)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	*elapsed_time = ldesc->elapsed_ns;
+	if (ldesc->running)
+		*elapsed_time += linux_timer_now_ns() - ldesc->run_start_ns;
+
+	return 0;
+}
+
+/**
+ * @brief Get the timerfd delivering the periodic expiries of a timer.
+ * @param desc - Pointer to the device handler.
+ * @return The file descriptor, negative error code otherwise.
+ */
+int linux_timer_get_fd(struct no_os_timer_desc *desc)
+{
+	struct linux_timer_desc *ldesc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	return ldesc->fd;
+}
@@ -450,11 +450,52 @@ error:
 	return ret;
 }
 
+/**
+ * @brief Identify the controller of a device by its base address. The PS
+ * and PL controllers use the same device_id numbering.
+ *
+ * @param param Structure containing the spi init parameters
+ * @return uintptr_t The base address of the controller, the device_id if it
+ *		     can't be found
+ */
+static uintptr_t xil_spi_get_bus_id(const struct no_os_spi_init_param *param)
+{
+	struct xil_spi_init_param *xinit = param->extra;
+#ifdef XSPI_H
+	XSpi_Config *pl_cfg;
+#endif
+#ifdef XSPIPS_H
+	XSpiPs_Config *ps_cfg;
+#endif
+
+	switch (xinit->type) {
+	case SPI_PL:
+#ifdef XSPI_H
+		pl_cfg = XSpi_LookupConfig(param->device_id);
+		if (pl_cfg)
+			return pl_cfg->BaseAddress;
+#endif
+		break;
+	case SPI_PS:
+#ifdef XSPIPS_H
+		ps_cfg = XSpiPs_LookupConfig(param->device_id);
+		if (ps_cfg)
+			return ps_cfg->BaseAddress;
+#endif
+		break;
+	default:
+		break;
+	}
+
+	return param->device_id;
+}
+
 /**
  * @brief Xilinx platform specific SPI platform ops structure
  */
 const struct no_os_spi_platform_ops xil_spi_ops = {
 	.init = &xil_spi_init,
 	.write_and_read = &xil_spi_write_and_read,
-	.remove = &xil_spi_remove
+	.remove = &xil_spi_remove,
+	.get_bus_id = &xil_spi_get_bus_id
 };
@@ -688,27 +688,83 @@ const char *ad9361_ensm_states[] = {
 	"rx", "rx_flush", "fdd", "fdd_flush"
 };
 
+/* Registers which are updated by the device itself, never cached */
+static const struct no_os_regcache_range ad9361_volatile_ranges[] = {
+	{REG_SPI_CONF, REG_SPI_CONF},
+	{REG_START_TEMP_READING, REG_TEMPERATURE},
+	{REG_ENSM_CONFIG_1, REG_ENSM_CONFIG_1},
+	{REG_CALIBRATION_CTRL, REG_STATE},
+	{REG_AUXADC_WORD_MSB, REG_AUXADC_LSB},
+	{REG_PRODUCT_ID, REG_PRODUCT_ID},
+	{REG_CH_1_OVERFLOW, REG_TX_FILTER_CONF},
+	{REG_TX_RSSI1, REG_TX_RSSI_LSB},
+	{REG_TX1_OUT_1_PHASE_CORR, REG_TX2_OUT_2_OFFSET_Q},
+	{REG_QUAD_CAL_STATUS_TX1, REG_QUAD_CAL_COUNT},
+	{REG_TX_BBF_R1, REG_TX_BBF_CP},
+	{REG_RX_FILTER_COEF_ADDR, REG_RX_FILTER_CONFIG},
+	{REG_LMT_OVERLOAD_COUNTERS, REG_DIGITAL_SAT_COUNTER},
+	{REG_GAIN_TABLE_ADDRESS, REG_LNA_GAIN_DIFF_READ_BACK},
+	{REG_CAL_TEMP_SENSOR_WORD, REG_CAL_TEMP_SENSOR_WORD},
+	{REG_LNA_GAIN, REG_CH2_RX_FILTER_POWER},
+	{REG_RX_QUAD_GAIN1, REG_RX2_INPUT_BC_I_OFFSET},
+	{REG_RX1_BB_DC_WORD_I_MSB, REG_RX_PATH_GAIN_LSB},
+	{REG_INPUT_A_MSBS, REG_INPUTS_BC_MSBS},
+	{REG_RX_BBF_R2346, REG_RX_BBF_C3_LSB},
+	{REG_RX_FORCE_ALC, REG_RX_ALC_VARACTOR},
+	{REG_RX_CAL_STATUS, REG_RX_CAL_STATUS},
+	{REG_RX_CP_OVERRANGE_VCO_LOCK, REG_RX_CP_OVERRANGE_VCO_LOCK},
+	{REG_RX_CORRECTION_WORD0, REG_RX_CORRECTION_WORD1},
+	{REG_RX_FAST_LOCK_PROGRAM_ADDR, REG_RX_FAST_LOCK_PROGRAM_CTRL},
+	{REG_TX_FORCE_ALC, REG_TX_ALCVARACT_OR},
+	{REG_TX_CAL_STATUS, REG_TX_CAL_STATUS},
+	{REG_TX_CP_OVERRANGE_VCO_LOCK, REG_TX_CP_OVERRANGE_VCO_LOCK},
+	{REG_TX_CORRECTION_WORD0, REG_TX_CORRECTION_WORD1},
+	{REG_DCXO_TEMPCO_WRITE, REG_DELTA_T_READ},
+	{REG_TX_FAST_LOCK_PROGRAM_ADDR, REG_TX_FAST_LOCK_PROGRAM_CTRL},
+	{REG_GAIN_RX1, REG_OVRG_SIGS_RX2},
+};
+
+/* Register caches of the initialized devices, indexed by their SPI descriptor */
+static struct {
+	struct no_os_spi_desc *spi;
+	struct no_os_regcache *regcache;
+} ad9361_regcache_devs[MAX_REGCACHE_DEVICES];
+
 /**
- * SPI multiple bytes register read.
+ * Get the register cache of a device.
+ * @param spi
+ * @return The register cache or NULL if the device registers are not cached.
+ */
+static struct no_os_regcache *ad9361_spi_to_regcache(struct no_os_spi_desc *spi)
+{
+	uint32_t i;
+
+	for (i = 0; i < MAX_REGCACHE_DEVICES; i++)
+		if (ad9361_regcache_devs[i].spi == spi)
+			return ad9361_regcache_devs[i].regcache;
+
+	return NULL;
+}
+
+/**
+ * SPI multiple bytes register read, without using the register cache.
  * @param spi
  * @param reg The register address.
  * @param rbuf The data buffer.
  * @param num The number of bytes to read.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad9361_spi_readm(struct no_os_spi_desc *spi, uint32_t reg,
-			 uint8_t *rbuf, uint32_t num)
+static int32_t ad9361_spi_hw_readm(struct no_os_spi_desc *spi, uint32_t reg,
+				   uint8_t *rbuf, uint32_t num)
 {
+	uint8_t rbuffer[MAX_MBYTE_SPI + 2];
 	int32_t ret = 0;
 	uint16_t cmd;
-	uint8_t *rbuffer;
+
 	if (num > MAX_MBYTE_SPI)
 		return -EINVAL;
 
 	cmd = AD_READ | AD_CNT(num) | AD_ADDR(reg);
-	rbuffer = malloc(num + 2);
-	if(!rbuffer)
-		return -ENOMEM;
 	rbuffer[0] = cmd >> 8;
 	rbuffer[1] = cmd & 0xFF;
 	ret = no_os_spi_write_and_read(spi, &rbuffer[0], 2 + num);
@@ -718,7 +774,6 @@ int32_t ad9361_spi_readm(struct no_os_spi_desc *spi, uint32_t reg,
 	else
 		memcpy(rbuf, &rbuffer[2], num);
 
-	free(rbuffer);
 #ifdef _DEBUG
 	{
 		int32_t i;
@@ -731,6 +786,183 @@ int32_t ad9361_spi_readm(struct no_os_spi_desc *spi, uint32_t reg,
 	return ret;
 }
 
+/**
+ * SPI multiple bytes register write, without using the register cache.
+ * @param spi
+ * @param reg The register address.
+ * @param tbuf The data buffer.
+ * @param num The number of bytes to write.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_spi_hw_writem(struct no_os_spi_desc *spi,
+				    uint32_t reg, const uint8_t *tbuf,
+				    uint32_t num)
+{
+	uint8_t buf[MAX_MBYTE_SPI + 2];
+	int32_t ret;
+	uint16_t cmd;
+
+	if (num > MAX_MBYTE_SPI)
+		return -EINVAL;
+
+	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
+	buf[0] = cmd >> 8;
+	buf[1] = cmd & 0xFF;
+
+#ifndef ALTERA_PLATFORM
+	memcpy(&buf[2], tbuf, num);
+#else
+	int32_t i;
+	for (i = 0; i < num; i++)
+		buf[2 + i] =  tbuf[i];
+#endif
+	ret = no_os_spi_write_and_read(spi, buf, num + 2);
+	if (ret < 0) {
+		dev_err(&spi->dev, "Write Error %"PRId32, ret);
+		return ret;
+	}
+
+#ifdef _DEBUG
+	{
+		int32_t i;
+		for (i = 0; i < num; i++)
+			dev_dbg(&spi->dev, "Reg 0x%"PRIX32" val 0x%X", reg--, tbuf[i]);
+	}
+#endif
+
+	return 0;
+}
+
+/**
+ * Register cache read callback.
+ * @param ctx The SPI descriptor.
+ * @param reg The register address.
+ * @param val The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_regcache_hw_read(void *ctx, uint32_t reg, uint8_t *val)
+{
+	return ad9361_spi_hw_readm(ctx, reg, val, 1);
+}
+
+/**
+ * Register cache write callback.
+ * @param ctx The SPI descriptor.
+ * @param reg The register address.
+ * @param val The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_regcache_hw_write(void *ctx, uint32_t reg, uint8_t val)
+{
+	return ad9361_spi_hw_writem(ctx, reg, &val, 1);
+}
+
+/**
+ * Initialize the register cache of the device.
+ *
+ * Once initialized, all the ad9361_spi_* accesses made through phy->spi are
+ * served from the cache, except for the volatile registers.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_regcache_init(struct ad9361_rf_phy *phy)
+{
+	struct no_os_regcache_init_param param = {
+		.max_reg = MAX_REG_SPI,
+		.volatile_ranges = ad9361_volatile_ranges,
+		.num_volatile_ranges = NO_OS_ARRAY_SIZE(ad9361_volatile_ranges),
+		.hw_read = ad9361_regcache_hw_read,
+		.hw_write = ad9361_regcache_hw_write,
+		.ctx = phy->spi,
+	};
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < MAX_REGCACHE_DEVICES; i++)
+		if (!ad9361_regcache_devs[i].spi)
+			break;
+	if (i == MAX_REGCACHE_DEVICES)
+		return -ENOMEM;
+
+	ret = no_os_regcache_init(&phy->regcache, &param);
+	if (ret < 0)
+		return ret;
+
+	ad9361_regcache_devs[i].spi = phy->spi;
+	ad9361_regcache_devs[i].regcache = phy->regcache;
+
+	return 0;
+}
+
+/**
+ * Free the register cache of the device.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_regcache_remove(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	if (!phy->regcache)
+		return 0;
+
+	for (i = 0; i < MAX_REGCACHE_DEVICES; i++) {
+		if (ad9361_regcache_devs[i].regcache == phy->regcache) {
+			ad9361_regcache_devs[i].spi = NULL;
+			ad9361_regcache_devs[i].regcache = NULL;
+		}
+	}
+
+	no_os_regcache_remove(phy->regcache);
+	phy->regcache = NULL;
+
+	return 0;
+}
+
+/**
+ * SPI multiple bytes register read.
+ * @param spi
+ * @param reg The register address.
+ * @param rbuf The data buffer.
+ * @param num The number of bytes to read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_spi_readm(struct no_os_spi_desc *spi, uint32_t reg,
+			 uint8_t *rbuf, uint32_t num)
+{
+	struct no_os_regcache *regcache = ad9361_spi_to_regcache(spi);
+	int32_t ret;
+	uint32_t i;
+
+	if (num > MAX_MBYTE_SPI)
+		return -EINVAL;
+
+	if (!regcache)
+		return ad9361_spi_hw_readm(spi, reg, rbuf, num);
+
+	if (num == 1)
+		return no_os_regcache_read(regcache, reg, rbuf);
+
+	/* Burst reads go downwards, from reg to reg - num + 1 */
+	for (i = 0; i < num; i++)
+		if (no_os_regcache_get(regcache, reg - i, &rbuf[i]))
+			break;
+	if (i == num)
+		return 0;
+
+	if (regcache->cache_only && !regcache->bypass)
+		return -EBUSY;
+
+	ret = ad9361_spi_hw_readm(spi, reg, rbuf, num);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < num; i++)
+		no_os_regcache_set(regcache, reg - i, rbuf[i]);
+
+	return ret;
+}
+
 /**
  * SPI register read.
  * @param spi
@@ -796,24 +1028,20 @@ static int32_t __ad9361_spi_readf(struct no_os_spi_desc *spi, uint32_t reg,
 int32_t ad9361_spi_write(struct no_os_spi_desc *spi,
 			 uint32_t reg, uint32_t val)
 {
-	uint8_t buf[3];
+	struct no_os_regcache *regcache = ad9361_spi_to_regcache(spi);
+	uint8_t buf = val;
 	int32_t ret;
-	uint16_t cmd;
 
-	cmd = AD_WRITE | AD_CNT(1) | AD_ADDR(reg);
-	buf[0] = cmd >> 8;
-	buf[1] = cmd & 0xFF;
-	buf[2] = val;
+	if (!regcache)
+		return ad9361_spi_hw_writem(spi, reg, &buf, 1);
 
-	ret = no_os_spi_write_and_read(spi, buf, 3);
-	if (ret < 0) {
-		dev_err(&spi->dev, "Write Error %"PRId32, ret);
+	ret = no_os_regcache_write(regcache, reg, buf);
+	if (ret < 0)
 		return ret;
-	}
 
-#ifdef _DEBUG
-	dev_dbg(&spi->dev, "%s: reg 0x%"PRIX32" val 0x%X", __func__, reg, buf[2]);
-#endif
+	/* A soft reset restores the default value of all the registers */
+	if (reg == REG_SPI_CONF && (val & SOFT_RESET))
+		no_os_regcache_invalidate(regcache);
 
 	return 0;
 }
@@ -868,37 +1096,31 @@ static int32_t __ad9361_spi_writef(struct no_os_spi_desc *spi, uint32_t reg,
 static int32_t ad9361_spi_writem(struct no_os_spi_desc *spi,
 				 uint32_t reg, uint8_t *tbuf, uint32_t num)
 {
-	uint8_t buf[10];
+	struct no_os_regcache *regcache = ad9361_spi_to_regcache(spi);
 	int32_t ret;
-	uint16_t cmd;
+	uint32_t i;
 
 	if (num > MAX_MBYTE_SPI)
 		return -EINVAL;
 
-	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
-	buf[0] = cmd >> 8;
-	buf[1] = cmd & 0xFF;
+	if (regcache && regcache->cache_only && !regcache->bypass) {
+		for (i = 0; i < num; i++) {
+			ret = no_os_regcache_write(regcache, reg - i, tbuf[i]);
+			if (ret < 0)
+				return ret;
+		}
 
-#ifndef ALTERA_PLATFORM
-	memcpy(&buf[2], tbuf, num);
-#else
-	int32_t i;
-	for (i = 0; i < num; i++)
-		buf[2 + i] =  tbuf[i];
-#endif
-	ret = no_os_spi_write_and_read(spi, buf, num + 2);
-	if (ret < 0) {
-		dev_err(&spi->dev, "Write Error %"PRId32, ret);
-		return ret;
+		return 0;
 	}
 
-#ifdef _DEBUG
-	{
-		int32_t i;
+	ret = ad9361_spi_hw_writem(spi, reg, tbuf, num);
+	if (ret < 0)
+		return ret;
+
+	/* Burst writes go downwards, from reg to reg - num + 1 */
+	if (regcache)
 		for (i = 0; i < num; i++)
-			dev_dbg(&spi->dev, "Reg 0x%"PRIX32" val 0x%X", reg--, tbuf[i]);
-	}
-#endif
+			no_os_regcache_set(regcache, reg - i, tbuf[i]);
 
 	return 0;
 }
@@ -1018,6 +1240,8 @@ int32_t ad9361_reset(struct ad9361_rf_phy *phy)
 		no_os_mdelay(1);
 		no_os_gpio_set_value(phy->gpio_desc_resetb, 1);
 		no_os_mdelay(1);
+		if (phy->regcache)
+			no_os_regcache_invalidate(phy->regcache);
 		dev_dbg(&phy->spi->dev, "%s: by GPIO", __func__);
 		return 0;
 	}
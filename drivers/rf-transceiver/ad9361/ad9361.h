@@ -43,6 +43,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_gpio.h"
+#include "no_os_regcache.h"
 #include "common.h"
 
 /******************************************************************************/
@@ -2848,6 +2849,8 @@
 #define MAX_BASEBAND_RATE		61440000UL
 
 #define MAX_MBYTE_SPI			8
+#define MAX_REG_SPI			0x3FF
+#define MAX_REGCACHE_DEVICES		4
 
 #define RFPLL_MODULUS			8388593UL
 #define BBPLL_MODULUS			2088960UL
@@ -3340,6 +3343,7 @@ enum dev_id {
 struct ad9361_rf_phy {
 	enum dev_id		dev_sel;
 	struct no_os_spi_desc 	*spi;
+	struct no_os_regcache	*regcache;
 	struct no_os_gpio_desc 	*gpio_desc_resetb;
 	struct no_os_gpio_desc 	*gpio_desc_sync;
 	struct no_os_gpio_desc 	*gpio_desc_cal_sw1;
@@ -3445,6 +3449,8 @@ int32_t ad9361_spi_readm(struct no_os_spi_desc *spi, uint32_t reg,
 int32_t ad9361_spi_read(struct no_os_spi_desc *spi, uint32_t reg);
 int32_t ad9361_spi_write(struct no_os_spi_desc *spi,
 			 uint32_t reg, uint32_t val);
+int32_t ad9361_regcache_init(struct ad9361_rf_phy *phy);
+int32_t ad9361_regcache_remove(struct ad9361_rf_phy *phy);
 int32_t ad9361_reset(struct ad9361_rf_phy *phy);
 int32_t ad9361_register_clocks(struct ad9361_rf_phy *phy);
 int32_t ad9361_unregister_clocks(struct ad9361_rf_phy *phy);
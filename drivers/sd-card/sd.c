@@ -46,6 +46,8 @@
 #include "sd.h"
 #include "no_os_delay.h"
 #include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_crc.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -59,6 +61,9 @@
 
 #define CMD0_RETRY_NUMBER		(5u)
 #define WAIT_RESP_TIMEOUT		(1000u) //1000ms
+#define WAIT_FAST_POLLS			(64u) //Polls before delaying between them
+#define BUSY_POLL_LEN			(8u)
+#define TOKEN_POLL_LEN			(8u)
 
 #define R1_READY_STATE			(0x00u)
 #define R1_IDLE_STATE			(0x01u)
@@ -75,6 +80,12 @@
 #define STUFF_ARG			(0x00000000u)
 #define CMD8_ARG			(0x000001AAu)
 #define ACMD41_ARG			(0x40000000u)
+#define CMD59_ARG_CRC_ON		(0x00000001u)
+
+/* x^7 + x^3 + 1, shifted to the msb of a CRC-8 */
+#define CRC7_POLYNOMIAL			(0x12u)
+/* x^16 + x^12 + x^5 + 1 (CRC-16-CCITT) */
+#define CRC16_POLYNOMIAL		(0x1021u)
 
 #define DATA_BLOCK_BITS			(9u)
 #define MASK_ADDR_IN_BLOCK		(DATA_BLOCK_LEN - 1u)
@@ -86,6 +97,12 @@
 #define MASK_RESPONSE_TOKEN		(0x0Eu)
 #define MASK_ERROR_TOKEN		(0xF0u)
 
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+NO_OS_DECLARE_CRC8_TABLE(sd_crc7);
+NO_OS_DECLARE_CRC16_TABLE(sd_crc16);
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -100,22 +117,25 @@
 static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
 {
 	uint32_t	not_timeout;
-	int32_t		ret;
+	uint32_t	polls;
 
-	ret = -1;
+	polls = 0;
 	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
+	while (true) {
+		/* Keep MOSI high, the card must not see a command */
+		*data_out = 0xFF;
 		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc,
 						  data_out, 1))
-			break;
-		if (*data_out != 0xFF) {
-			ret = 0;
-			break;
-		}
+			return -1;
+		if (*data_out != 0xFF)
+			return 0;
+		/* Responses and data tokens usually come in a few bytes */
+		if (++polls < WAIT_FAST_POLLS)
+			continue;
+		if (!not_timeout--)
+			return -1;
 		no_os_mdelay(1);
-	} while (not_timeout--);
-
-	return ret;
+	}
 }
 
 /**
@@ -126,23 +146,58 @@ static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
 static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 {
 	uint32_t	not_timeout;
-	int32_t		ret;
-	uint8_t		data;
+	uint32_t	polls;
 
-	ret = -1;
+	polls = 0;
 	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		data = 0xFF;
-		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, &data, 1))
-			break;
-		if (data != 0x00) {
-			ret = 0;
-			break;
-		}
+	while (true) {
+		/* The card ignores the bytes clocked once it is not busy */
+		memset(sd_desc->buff, 0xFF, BUSY_POLL_LEN);
+		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc,
+						  sd_desc->buff, BUSY_POLL_LEN))
+			return -1;
+		if (sd_desc->buff[BUSY_POLL_LEN - 1] != 0x00)
+			return 0;
+		if (++polls < WAIT_FAST_POLLS)
+			continue;
+		if (!not_timeout--)
+			return -1;
 		no_os_mdelay(1);
-	} while (not_timeout--);
+	}
+}
+
+/**
+ * Read SD card bytes, a few at a time, until the start of a data block.
+ * The bytes following the token are the first bytes of the block.
+ * @param sd_desc	- Instance of the SD card
+ * @param pos		- Position of the token in the buffer of sd_desc
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t wait_for_token(struct sd_desc *sd_desc, uint32_t *pos)
+{
+	uint32_t	not_timeout;
+	uint32_t	polls;
+	uint32_t	i;
 
-	return ret;
+	polls = 0;
+	not_timeout = WAIT_RESP_TIMEOUT;
+	while (true) {
+		memset(sd_desc->buff, 0xFF, TOKEN_POLL_LEN);
+		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc,
+						  sd_desc->buff, TOKEN_POLL_LEN))
+			return -1;
+		for (i = 0; i < TOKEN_POLL_LEN; i++) {
+			if (sd_desc->buff[i] != 0xFF) {
+				*pos = i;
+				return 0;
+			}
+		}
+		if (++polls < WAIT_FAST_POLLS)
+			continue;
+		if (!not_timeout--)
+			return -1;
+		no_os_mdelay(1);
+	}
 }
 
 /**
@@ -188,10 +243,7 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 	sd_desc->buff[3] = (cmd_desc->arg >> 16) & 0xff;
 	sd_desc->buff[4] = (cmd_desc->arg >> 8) & 0xff;
 	sd_desc->buff[5] = cmd_desc->arg & 0xff;
-	if (cmd_desc->cmd == CMD(0))					/* Set crc if needed */
-		sd_desc->buff[6] = 0x95;
-	else if (cmd_desc->cmd == CMD(8))
-		sd_desc->buff[6] = 0x87;
+	sd_desc->buff[6] = no_os_crc8(sd_crc7, sd_desc->buff + 1, 5, 0) | 0x01;	/* Set crc */
 
 	/* Send command */
 	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CMD_LEN))
@@ -211,32 +263,57 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 }
 
 /**
- * Send one block of data to the SD card
+ * Send one block of data to the SD card. The start token, the data and the
+ * CRC are sent with a single message chain.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to be written
- * @param nb_of_blocks	- Number of blocks written in the executing command
+ * @param token		- Start block token
  * @return 0 in case of success, -1 otherwise.
  */
 static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
-			   uint32_t nb_of_blocks)
+			   uint8_t token)
 {
-	/* Send start block token */
-	sd_desc->buff[0] = START_N_BLOCK_TOKEN;
-	if (nb_of_blocks == 1)
-		sd_desc->buff[0] = START_1_BLOCK_TOKEN;
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 1))
-		return -1;
-
-	/* Send data with CRC */
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return -1;
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	struct no_os_spi_msg	msgs[3] = {0};
+	uint16_t		crc;
+	uint8_t			response;
+
+	crc = 0xFFFF;
+	if (sd_desc->crc_enable)
+		crc = no_os_crc16(sd_crc16, data, DATA_BLOCK_LEN, 0);
+
+	/* Start block token */
+	sd_desc->buff[0] = token;
+	msgs[0].tx_buff = sd_desc->buff;
+	msgs[0].rx_buff = sd_desc->buff;
+	msgs[0].bytes_number = 1;
+
+	/* Data. Without direct_io the received bytes overwrite the sent ones,
+	 * so the data is copied */
+	if (sd_desc->direct_io) {
+		msgs[1].tx_buff = data;
+	} else {
+		memcpy(sd_desc->block_buff, data, DATA_BLOCK_LEN);
+		msgs[1].tx_buff = sd_desc->block_buff;
+		msgs[1].rx_buff = sd_desc->block_buff;
+	}
+	msgs[1].bytes_number = DATA_BLOCK_LEN;
+
+	/* CRC and the byte where the data response token is usually sent */
+	sd_desc->buff[1] = crc >> 8;
+	sd_desc->buff[2] = crc & 0xFF;
+	sd_desc->buff[3] = 0xFF;
+	msgs[2].tx_buff = sd_desc->buff + 1;
+	msgs[2].rx_buff = sd_desc->buff + 1;
+	msgs[2].bytes_number = CRC_LEN + 1;
+	msgs[2].cs_change = 1;
+
+	if (0 != no_os_spi_transfer(sd_desc->spi_desc, msgs,
+				    NO_OS_ARRAY_SIZE(msgs)))
 		return -1;
 
 	/* Read response and check if write was ok */
-	uint8_t		response;
-	if (0 != wait_for_response(sd_desc, &response))
+	response = sd_desc->buff[3];
+	if (response == 0xFF && 0 != wait_for_response(sd_desc, &response))
 		return -1;
 	switch (response & MASK_RESPONSE_TOKEN) {
 	case 0x4:
@@ -258,17 +335,23 @@ static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
 }
 
 /**
- * Read one block of data to the SD card
+ * Read one block of data to the SD card. The data and the CRC are read with
+ * a single message chain once the start block token is received.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Buffer were data will be read
  * @return 0 in case of success, -1 otherwise.
  */
 static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 {
+	struct no_os_spi_msg	msgs[2] = {0};
+	uint32_t		pos, received;
+	uint16_t		crc;
+
 	/* Reading Start block token */
 	uint8_t	response;
-	if (0 != wait_for_response(sd_desc, &response))
+	if (0 != wait_for_token(sd_desc, &pos))
 		return -1;
+	response = sd_desc->buff[pos];
 	if ((response & MASK_ERROR_TOKEN) == 0) {
 		DEBUG_MSG("Received data error token on read\n");
 		switch (response) {
@@ -295,111 +378,390 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 		return -1;
 	}
 
-	/* Read data block */
-	memset(data, 0xff, DATA_BLOCK_LEN);
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
+	/* Read data block, after the bytes received with the token */
+	received = TOKEN_POLL_LEN - pos - 1;
+	memcpy(data, sd_desc->buff + pos + 1, received);
+	if (sd_desc->direct_io) {
+		msgs[0].tx_buff = sd_desc->block_buff;
+	} else {
+		memset(data + received, 0xFF, DATA_BLOCK_LEN - received);
+		msgs[0].tx_buff = data + received;
+	}
+	msgs[0].rx_buff = data + received;
+	msgs[0].bytes_number = DATA_BLOCK_LEN - received;
+
+	/* Read crc */
+	sd_desc->buff[0] = 0xFF;
+	sd_desc->buff[1] = 0xFF;
+	msgs[1].tx_buff = sd_desc->buff;
+	msgs[1].rx_buff = sd_desc->buff;
+	msgs[1].bytes_number = CRC_LEN;
+	msgs[1].cs_change = 1;
+
+	if (0 != no_os_spi_transfer(sd_desc->spi_desc, msgs,
+				    NO_OS_ARRAY_SIZE(msgs)))
 		return -1;
 
-	/* Read crc*/
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	if (sd_desc->crc_enable) {
+		crc = no_os_crc16(sd_crc16, data, DATA_BLOCK_LEN, 0);
+		if (crc != ((sd_desc->buff[0] << 8) | sd_desc->buff[1])) {
+			DEBUG_MSG("Data CRC error\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Get the buffer of a block of a multiple block transfer
+ * @param data		- Contiguous buffer of the blocks, if blocks is NULL
+ * @param blocks	- Buffer of each block
+ * @param i		- Index of the block in the transfer
+ * @return Address of the block buffer
+ */
+static inline uint8_t *get_block_buff(uint8_t *data, uint8_t **blocks,
+				      uint32_t i)
+{
+	return blocks ? blocks[i] : data + ((uint64_t)i << DATA_BLOCK_BITS);
+}
+
+/**
+ * Send a read or write command and check its response
+ * @param sd_desc	- Instance of the SD card
+ * @param cmd		- Command code
+ * @param block		- First block number
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t start_transfer(struct sd_desc *sd_desc, uint8_t cmd,
+			      uint32_t block)
+{
+	struct cmd_desc	cmd_desc;
+
+	cmd_desc.cmd = cmd;
+	cmd_desc.arg = block;
+	cmd_desc.response_len = R1_LEN;
+	if (0 != send_command(sd_desc, &cmd_desc))
 		return -1;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to send Data command\n");
+		return -1;
+	}
 
 	return 0;
 }
 
 /**
- * Prepare and write data block by block
+ * End a multiple block read with the stop transmission command
  * @param sd_desc	- Instance of the SD card
- * @param data		- Data to be written
- * @param addr		- Address in memory where data will be written
- * @param len		- Length of data to be written
- * @param nb_of_blocks	- Number of block to be written
- * @param first_block	- First block where data will be written with unmodified
- * 						  data
- * @param last_block	- Last block where data will be written with unmodified
- * 						  data
  * @return 0 in case of success, -1 otherwise.
  */
-static int32_t write_multiple_blocks(struct sd_desc *sd_desc,
-				     uint8_t *data, uint64_t addr, uint64_t len,
-				     uint8_t *first_block, uint8_t *last_block)
+static int32_t stop_read(struct sd_desc *sd_desc)
 {
-	uint16_t	buff_first_idx;
-	uint16_t	buff_copy_len;
-	uint32_t	i;
-	uint64_t	data_idx;
-	uint32_t	nb_of_blocks = get_nb_of_blocks(addr, len);
+	struct cmd_desc	cmd_desc;
 
-	data_idx = 0;
-	i = 0;
-	while (i < nb_of_blocks) {
-		buff_first_idx = 0x0000u;
-		if (i == 0)
-			buff_first_idx = addr & MASK_ADDR_IN_BLOCK;
-		buff_copy_len = DATA_BLOCK_LEN - buff_first_idx;
-		if (i == nb_of_blocks - 1)
-			buff_copy_len = ((addr + len - 1) & MASK_ADDR_IN_BLOCK) - buff_first_idx + 1;
-		if (buff_first_idx == 0x0000u && buff_copy_len == DATA_BLOCK_LEN) {
-			/* Write every block beside the first and last if the write is not the entire block */
-			if (0 != write_block(sd_desc, data + data_idx, nb_of_blocks))
-				return -1;
-		} else {			/* If we are not writing a full block */
-			if (i == 0) {		/* If is the first block */
-				memcpy(first_block + buff_first_idx, data + data_idx, buff_copy_len);
-				if (0 != write_block(sd_desc, first_block, nb_of_blocks))
-					return -1;
-			} else {		/* Is the last block */
-				memcpy(last_block, data + data_idx, buff_copy_len);
-				if (0 != write_block(sd_desc, last_block, nb_of_blocks))
-					return -1;
-			}
-		}
-		data_idx += buff_copy_len;
-		i++;
+	cmd_desc.cmd = CMD(12);
+	cmd_desc.arg = STUFF_ARG;
+	cmd_desc.response_len = R1_LEN;
+	if (0 != send_command(sd_desc, &cmd_desc))
+		return -1;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to send stop transmission command\n");
+		return -1;
 	}
 
 	return 0;
 }
 
 /**
- * Prepare and read data block by block
+ * End a multiple block write with the stop transmission token
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t stop_write(struct sd_desc *sd_desc)
+{
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		return -1;
+
+	return wait_until_not_busy(sd_desc);
+}
+
+/**
+ * Read consecutive blocks with a single read command (CMD17 or CMD18)
+ * @param sd_desc	- Instance of the SD card
+ * @param block		- First block number
+ * @param nb_of_blocks	- Number of blocks
+ * @param data		- Where the blocks are read, if blocks is NULL
+ * @param blocks	- Where each block is read
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t read_blocks(struct sd_desc *sd_desc, uint32_t block,
+			   uint32_t nb_of_blocks, uint8_t *data,
+			   uint8_t **blocks)
+{
+	uint32_t	i;
+
+	if (0 != start_transfer(sd_desc, (nb_of_blocks == 1) ? CMD(17) : CMD(18),
+				block))
+		return -1;
+
+	for (i = 0; i < nb_of_blocks; i++)
+		if (0 != read_block(sd_desc, get_block_buff(data, blocks, i)))
+			return -1;
+
+	if (nb_of_blocks != 1)
+		return stop_read(sd_desc);
+
+	return 0;
+}
+
+/**
+ * Write consecutive blocks with a single write command (CMD24 or CMD25)
  * @param sd_desc	- Instance of the SD card
- * @param data		- Data to be read
- * @param addr		- Address in memory from where data will be read
- * @param len		- Length of data to be read
- * @param nb_of_blocks	- Number of block to be read
+ * @param block		- First block number
+ * @param nb_of_blocks	- Number of blocks
+ * @param data		- Data of the blocks, if blocks is NULL
+ * @param blocks	- Data of each block
  * @return 0 in case of success, -1 otherwise.
  */
-static int32_t read_multiple_blocks(struct sd_desc *sd_desc,
-				    uint8_t *data, uint64_t addr, uint64_t len)
+static int32_t write_blocks(struct sd_desc *sd_desc, uint32_t block,
+			    uint32_t nb_of_blocks, uint8_t *data,
+			    uint8_t **blocks)
 {
-	uint8_t		buff[DATA_BLOCK_LEN] __attribute__ ((aligned));
 	uint32_t	i;
-	uint64_t	data_idx;
 
-	data_idx = 0;
+	if (nb_of_blocks == 1) {
+		if (0 != start_transfer(sd_desc, CMD(24), block))
+			return -1;
+		return write_block(sd_desc, get_block_buff(data, blocks, 0),
+				   START_1_BLOCK_TOKEN);
+	}
+
+	if (0 != start_transfer(sd_desc, CMD(25), block))
+		return -1;
+
+	for (i = 0; i < nb_of_blocks; i++)
+		if (0 != write_block(sd_desc, get_block_buff(data, blocks, i),
+				     START_N_BLOCK_TOKEN))
+			return -1;
+
+	return stop_write(sd_desc);
+}
+
+/**
+ * Find a block in the cache
+ * @param sd_desc	- Instance of the SD card
+ * @param block		- Block number
+ * @return The cache entry of the block, NULL if it is not cached
+ */
+static struct sd_cache_entry *cache_find(struct sd_desc *sd_desc,
+		uint32_t block)
+{
+	uint32_t i;
+
+	for (i = 0; i < sd_desc->cache_blocks; i++)
+		if (sd_desc->cache[i].valid && sd_desc->cache[i].block == block)
+			return &sd_desc->cache[i];
+
+	return NULL;
+}
+
+/**
+ * Write all the modified cache entries to the card. Entries of consecutive
+ * blocks are written with a single multiple block write command. On error,
+ * the entries not written are kept valid and modified.
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t cache_flush(struct sd_desc *sd_desc)
+{
+	struct sd_cache_entry	**dirty;
+	struct sd_cache_entry	*entry;
+	uint32_t		nb_dirty;
+	uint32_t		i, j;
+
+	/* Sort the modified entries by block number */
+	dirty = sd_desc->flush_list;
+	nb_dirty = 0;
+	for (i = 0; i < sd_desc->cache_blocks; i++) {
+		entry = &sd_desc->cache[i];
+		if (!entry->valid || !entry->dirty)
+			continue;
+		for (j = nb_dirty; j > 0 && dirty[j - 1]->block > entry->block; j--)
+			dirty[j] = dirty[j - 1];
+		dirty[j] = entry;
+		nb_dirty++;
+	}
+
+	/* Write each run of consecutive blocks */
 	i = 0;
-	while (i < get_nb_of_blocks(addr, len)) {
-		uint16_t		buff_first_idx;
-		uint16_t		buff_copy_len;
-
-		buff_first_idx = 0x0000u;
-		if (i == 0)
-			buff_first_idx = addr & MASK_ADDR_IN_BLOCK;
-		buff_copy_len = DATA_BLOCK_LEN - buff_first_idx;
-		if (i == get_nb_of_blocks(addr, len) - 1)
-			buff_copy_len = ((addr + len - 1) & MASK_ADDR_IN_BLOCK) - buff_first_idx + 1;
-		if (buff_first_idx == 0x0000u && buff_copy_len == DATA_BLOCK_LEN) {
-			if (0 != read_block(sd_desc, data + data_idx))
-				return -1;
-		} else {
-			if (0 != read_block(sd_desc, buff))
-				return -1;
-			memcpy(data + data_idx, buff + buff_first_idx, buff_copy_len);
+	while (i < nb_dirty) {
+		entry = dirty[i];
+		j = 1;
+		while (i + j < nb_dirty &&
+		       dirty[i + j]->block == entry->block + j)
+			j++;
+
+		for (uint32_t k = 0; k < j; k++)
+			sd_desc->io_blocks[i + k] = dirty[i + k]->data;
+		/* Entries not written stay dirty, a later flush retries them */
+		if (0 != write_blocks(sd_desc, entry->block, j, NULL,
+				      &sd_desc->io_blocks[i]))
+			return -1;
+		for (uint32_t k = 0; k < j; k++)
+			dirty[i + k]->dirty = false;
+		i += j;
+	}
+
+	return 0;
+}
+
+/**
+ * Get the least recently used cache entry, writing back the modified entries
+ * if it must be reused
+ * @param sd_desc	- Instance of the SD card
+ * @param keep		- Entries which must not be evicted
+ * @param nb_keep	- Number of entries in keep
+ * @return The entry, not valid anymore, NULL in case of error
+ */
+static struct sd_cache_entry *cache_evict(struct sd_desc *sd_desc,
+		struct sd_cache_entry **keep,
+		uint32_t nb_keep)
+{
+	struct sd_cache_entry	*victim;
+	struct sd_cache_entry	*entry;
+	uint32_t		i, j;
+
+	victim = NULL;
+	for (i = 0; i < sd_desc->cache_blocks; i++) {
+		entry = &sd_desc->cache[i];
+		for (j = 0; j < nb_keep && keep[j] != entry; j++)
+			;
+		if (j < nb_keep)
+			continue;
+		if (!entry->valid) {
+			victim = entry;
+			break;
+		}
+		if (!victim || (int32_t)(entry->last_use - victim->last_use) < 0)
+			victim = entry;
+	}
+
+	if (!victim)
+		return NULL;
+
+	if (victim->valid && victim->dirty)
+		if (0 != cache_flush(sd_desc))
+			return NULL;
+
+	victim->valid = false;
+
+	return victim;
+}
+
+/**
+ * Get the cache entry of a block, reading it from the card if needed.
+ *
+ * On a miss following a sequential access, the next blocks which are not
+ * cached are read with the same command.
+ * @param sd_desc	- Instance of the SD card
+ * @param block		- Block number
+ * @param fill		- Read the block data on a miss, false if the whole block
+ * 			  is going to be overwritten
+ * @return The cache entry, NULL in case of error
+ */
+static struct sd_cache_entry *cache_get(struct sd_desc *sd_desc,
+					uint32_t block, bool fill)
+{
+	struct sd_cache_entry	**taken = sd_desc->fill_list;
+	struct sd_cache_entry	*entry;
+	uint32_t		last_block;
+	uint32_t		nb, i;
+
+	sd_desc->cache_clock++;
+
+	entry = cache_find(sd_desc, block);
+	if (entry) {
+		entry->last_use = sd_desc->cache_clock;
+		return entry;
+	}
+
+	nb = 1;
+	if (fill && block == sd_desc->next_block) {
+		last_block = (sd_desc->memory_size >> DATA_BLOCK_BITS) - 1;
+		while (nb <= sd_desc->read_ahead && nb < sd_desc->cache_blocks &&
+		       block + nb <= last_block && !cache_find(sd_desc, block + nb))
+			nb++;
+	}
+
+	for (i = 0; i < nb; i++) {
+		entry = cache_evict(sd_desc, taken, i);
+		if (!entry)
+			goto error;
+		entry->block = block + i;
+		entry->dirty = false;
+		/* Read ahead blocks are evicted before the requested one */
+		entry->last_use = sd_desc->cache_clock - (i ? 1 : 0);
+		entry->valid = true;
+		taken[i] = entry;
+	}
+
+	/* An eviction may flush through io_blocks, fill it afterwards */
+	for (i = 0; i < nb; i++)
+		sd_desc->io_blocks[i] = taken[i]->data;
+
+	if (fill && 0 != read_blocks(sd_desc, block, nb, NULL,
+				     sd_desc->io_blocks))
+		goto error;
+
+	return taken[0];
+error:
+	while (i--)
+		taken[i]->valid = false;
+	return NULL;
+}
+
+/**
+ * Read or modify a part of a single block through the cache, or with a
+ * read-modify-write of the whole block if there is no cache
+ * @param sd_desc	- Instance of the SD card
+ * @param block		- Block number
+ * @param data		- Data to write or where data is read
+ * @param offset	- Offset in the block
+ * @param len		- Length of data, up to the end of the block
+ * @param write		- true to write data, false to read it
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t access_block(struct sd_desc *sd_desc, uint32_t block,
+			    uint8_t *data, uint32_t offset, uint32_t len,
+			    bool write)
+{
+	uint8_t			buff[DATA_BLOCK_LEN] __attribute__ ((aligned));
+	struct sd_cache_entry	*entry;
+
+	if (!sd_desc->cache) {
+		if (0 != read_blocks(sd_desc, block, 1, buff, NULL))
+			return -1;
+		if (!write) {
+			memcpy(data, buff + offset, len);
+			return 0;
 		}
-		data_idx += buff_copy_len;
-		i++;
+		memcpy(buff + offset, data, len);
+
+		return write_blocks(sd_desc, block, 1, buff, NULL);
+	}
+
+	entry = cache_get(sd_desc, block, !write || len != DATA_BLOCK_LEN);
+	if (!entry)
+		return -1;
+
+	if (write) {
+		memcpy(entry->data + offset, data, len);
+		entry->dirty = true;
+	} else {
+		memcpy(data, entry->data + offset, len);
 	}
 
 	return 0;
@@ -408,6 +770,10 @@ static int32_t read_multiple_blocks(struct sd_desc *sd_desc,
 /**
  * Read data of size len from the specified address and store it in data.
  * This operation returns only when the read is complete
+ *
+ * With the cache enabled, blocks are served from the cache when possible.
+ * Transfers of at least as many whole blocks as the cache holds bypass it and
+ * use a single multiple block command.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Where data will be read
  * @param address	- Address in memory from where data will be read
@@ -417,40 +783,47 @@ static int32_t read_multiple_blocks(struct sd_desc *sd_desc,
 int32_t sd_read(struct sd_desc *sd_desc,
 		uint8_t *data, uint64_t address, uint64_t len)
 {
-	struct cmd_desc	cmd_desc;
+	struct sd_cache_entry	*entry;
+	uint32_t		block, nb, i;
+	uint32_t		offset, chunk;
 
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
 	    len > sd_desc->memory_size ||
-	    address + len > sd_desc->memory_size)
-		return -1;
-
-	/* Send read command */
-	cmd_desc.cmd = (get_nb_of_blocks(address, len) == 1) ? CMD(17): CMD(18);
-	cmd_desc.arg = address >> DATA_BLOCK_BITS;;
-	cmd_desc.response_len = R1_LEN;
-	if (0 != send_command(sd_desc, &cmd_desc))
-		return -1;
-	if (cmd_desc.response[0] != R1_READY_STATE) {
-		DEBUG_MSG("Failed to write Data command\n");
+	    address + len > sd_desc->memory_size ||
+	    sd_desc->stream != SD_STREAM_IDLE)
 		return -1;
-	}
 
-	/* Read blocks */
-	if (0 != read_multiple_blocks(sd_desc, data, address, len))
-		return -1;
+	while (len) {
+		block = address >> DATA_BLOCK_BITS;
+		offset = address & MASK_ADDR_IN_BLOCK;
+		nb = len >> DATA_BLOCK_BITS;
 
-	/* Send stop transmission command */
-	if (get_nb_of_blocks(address, len) != 1) {
-		cmd_desc.cmd = CMD(12);
-		cmd_desc.arg = STUFF_ARG;
-		cmd_desc.response_len = R1_LEN;
-		if (0 != send_command(sd_desc, &cmd_desc))
-			return -1;
-		if(cmd_desc.response[0] != R1_READY_STATE) {
-			DEBUG_MSG("Failed to send stop transmission command\n");
-			return -1;
+		if (!offset && nb && (!sd_desc->cache || nb >= sd_desc->cache_blocks)) {
+			/* Whole blocks, directly to the user buffer */
+			if (0 != read_blocks(sd_desc, block, nb, data, NULL))
+				return -1;
+			/* Cached data is more recent than the card */
+			for (i = 0; i < sd_desc->cache_blocks; i++) {
+				entry = &sd_desc->cache[i];
+				if (entry->valid && entry->dirty &&
+				    entry->block - block < nb)
+					memcpy(data + ((entry->block - block) <<
+						       DATA_BLOCK_BITS),
+					       entry->data, DATA_BLOCK_LEN);
+			}
+			chunk = nb << DATA_BLOCK_BITS;
+		} else {
+			chunk = no_os_min(len, (uint64_t)DATA_BLOCK_LEN - offset);
+			if (0 != access_block(sd_desc, block, data, offset, chunk,
+					      false))
+				return -1;
 		}
+
+		sd_desc->next_block = ((address + chunk - 1) >> DATA_BLOCK_BITS) + 1;
+		data += chunk;
+		address += chunk;
+		len -= chunk;
 	}
 
 	return 0;
@@ -459,6 +832,11 @@ int32_t sd_read(struct sd_desc *sd_desc,
 /**
  * Write data of size len to the specified address
  * This operation returns only when the write is complete
+ *
+ * With the cache enabled, the data is only written to the cache. It is written
+ * to the card when the cache entries are reused or on sd_flush(), with
+ * consecutive blocks coalesced in multiple block writes. Transfers of at least
+ * as many whole blocks as the cache holds bypass it.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to write
  * @param address	- Address in memory where data will be written
@@ -468,57 +846,237 @@ int32_t sd_read(struct sd_desc *sd_desc,
 int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 		 uint64_t len)
 {
-	struct cmd_desc	cmd_desc;
-	uint8_t		first_block[DATA_BLOCK_LEN] __attribute__ ((aligned));
-	uint8_t		last_block[DATA_BLOCK_LEN] __attribute__ ((aligned));
+	struct sd_cache_entry	*entry;
+	uint32_t		block, nb, i;
+	uint32_t		offset, chunk;
 
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
-	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
-		return -1;
-
-	/* Read first and last block in memory if needed to be updated with user data and then written back                                                                        */
-	/* If not writing from the beginning of a block or */
-	if ((address & MASK_ADDR_IN_BLOCK) != 0 ||
-	    /* If writing from the beginning but not the full block */
-	    ((address & MASK_ADDR_IN_BLOCK) == 0 && len < DATA_BLOCK_LEN))
-		sd_read(sd_desc, first_block, address & MASK_BLOCK_NUMBER, DATA_BLOCK_LEN);
-	/* If the last block is different from the first and */
-	if (((address + len - 1) & MASK_BLOCK_NUMBER) != (address & MASK_BLOCK_NUMBER)
-	    /* If reading less than the full block */
-	    && ((address + len - 1) & MASK_ADDR_IN_BLOCK) != MASK_ADDR_IN_BLOCK)
-		sd_read(sd_desc, last_block, (address + len - 1) & MASK_BLOCK_NUMBER,
-			DATA_BLOCK_LEN);
-
-	/* Send write command to SD */
-	cmd_desc.cmd = (get_nb_of_blocks(address, len) == 1) ? CMD(24): CMD(25);
-	cmd_desc.arg = address >> DATA_BLOCK_BITS; //Address of first block
-	cmd_desc.response_len = R1_LEN;
-	if (0 != send_command(sd_desc, &cmd_desc))
-		return -1;
-	if (cmd_desc.response[0] != R1_READY_STATE) {
-		DEBUG_MSG("Failed to write Data command\n");
+	    len > sd_desc->memory_size || address + len > sd_desc->memory_size ||
+	    sd_desc->stream != SD_STREAM_IDLE)
 		return -1;
+
+	while (len) {
+		block = address >> DATA_BLOCK_BITS;
+		offset = address & MASK_ADDR_IN_BLOCK;
+		nb = len >> DATA_BLOCK_BITS;
+
+		if (!offset && nb && (!sd_desc->cache || nb >= sd_desc->cache_blocks)) {
+			/* Whole blocks, directly from the user buffer */
+			if (0 != write_blocks(sd_desc, block, nb, data, NULL))
+				return -1;
+			/* Drop the outdated cached copies */
+			for (i = 0; i < sd_desc->cache_blocks; i++) {
+				entry = &sd_desc->cache[i];
+				if (entry->valid && entry->block - block < nb)
+					entry->valid = false;
+			}
+			chunk = nb << DATA_BLOCK_BITS;
+		} else {
+			chunk = no_os_min(len, (uint64_t)DATA_BLOCK_LEN - offset);
+			if (0 != access_block(sd_desc, block, data, offset, chunk,
+					      true))
+				return -1;
+		}
+
+		data += chunk;
+		address += chunk;
+		len -= chunk;
 	}
 
-	/* Write blocks */
-	if (0 != write_multiple_blocks(sd_desc, data, address, len,
-				       first_block, last_block))
+	return 0;
+}
+
+/**
+ * Write the data modified in the cache to the card
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_flush(struct sd_desc *sd_desc)
+{
+	if (!sd_desc || sd_desc->stream != SD_STREAM_IDLE)
+		return -1;
+
+	if (!sd_desc->cache)
+		return 0;
+
+	return cache_flush(sd_desc);
+}
+
+/**
+ * Start a stream of consecutive blocks with a single multiple block command
+ * @param sd_desc	- Instance of the SD card
+ * @param address	- Address of the first block, multiple of DATA_BLOCK_LEN
+ * @param stream	- SD_STREAM_READ or SD_STREAM_WRITE
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t stream_start(struct sd_desc *sd_desc, uint64_t address,
+			    enum sd_stream_state stream)
+{
+	uint32_t	i;
+
+	if (!sd_desc || sd_desc->stream != SD_STREAM_IDLE ||
+	    (address & MASK_ADDR_IN_BLOCK) || address >= sd_desc->memory_size)
+		return -1;
+
+	/* The card must hold the cached data and written blocks must not be
+	 * served from the cache anymore */
+	if (0 != sd_flush(sd_desc))
+		return -1;
+	if (stream == SD_STREAM_WRITE)
+		for (i = 0; i < sd_desc->cache_blocks; i++)
+			sd_desc->cache[i].valid = false;
+
+	sd_desc->stream_block = address >> DATA_BLOCK_BITS;
+	if (0 != start_transfer(sd_desc, (stream == SD_STREAM_READ) ?
+				CMD(18) : CMD(25), sd_desc->stream_block))
+		return -1;
+	sd_desc->stream = stream;
+
+	return 0;
+}
+
+/**
+ * Start reading consecutive blocks with sd_stream_read(), until
+ * sd_stream_stop() is called. sd_read(), sd_write() and sd_flush() fail while
+ * the stream is started.
+ * @param sd_desc	- Instance of the SD card
+ * @param address	- Address of the first block, multiple of DATA_BLOCK_LEN
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_stream_read_start(struct sd_desc *sd_desc, uint64_t address)
+{
+	return stream_start(sd_desc, address, SD_STREAM_READ);
+}
+
+/**
+ * Start writing consecutive blocks with sd_stream_write(), until
+ * sd_stream_stop() is called. sd_read(), sd_write() and sd_flush() fail while
+ * the stream is started.
+ * @param sd_desc	- Instance of the SD card
+ * @param address	- Address of the first block, multiple of DATA_BLOCK_LEN
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_stream_write_start(struct sd_desc *sd_desc, uint64_t address)
+{
+	return stream_start(sd_desc, address, SD_STREAM_WRITE);
+}
+
+/**
+ * Check a transfer of a started stream
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data buffer
+ * @param len		- Length of data in bytes
+ * @param stream	- Direction of the transfer
+ * @return 0 if the transfer is valid, -1 otherwise.
+ */
+static int32_t stream_check(struct sd_desc *sd_desc, uint8_t *data,
+			    uint32_t len, enum sd_stream_state stream)
+{
+	if (!sd_desc || !data || sd_desc->stream != stream ||
+	    (len & MASK_ADDR_IN_BLOCK))
+		return -1;
+
+	if ((uint64_t)(sd_desc->stream_block + (len >> DATA_BLOCK_BITS)) >
+	    (sd_desc->memory_size >> DATA_BLOCK_BITS))
+		return -1;
+
+	return 0;
+}
+
+/**
+ * Read the next blocks of a stream started with sd_stream_read_start().
+ * The blocks are read directly in data.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Where data will be read
+ * @param len		- Length in bytes, multiple of DATA_BLOCK_LEN
+ * @return 0 in case of success, -1 otherwise. After an error, the stream must
+ * still be ended with sd_stream_stop().
+ */
+int32_t sd_stream_read(struct sd_desc *sd_desc, uint8_t *data, uint32_t len)
+{
+	if (0 != stream_check(sd_desc, data, len, SD_STREAM_READ))
 		return -1;
 
-	/* Send stop transmission token */
-	if (get_nb_of_blocks(address, len) != 1) {
-		sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
-		sd_desc->buff[1] = 0xFF;
-		if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+	while (len) {
+		if (0 != read_block(sd_desc, data))
 			return -1;
-		if (0 != wait_until_not_busy(sd_desc))
+		sd_desc->stream_block++;
+		data += DATA_BLOCK_LEN;
+		len -= DATA_BLOCK_LEN;
+	}
+
+	return 0;
+}
+
+/**
+ * Write the next blocks of a stream started with sd_stream_write_start().
+ * The blocks are sent directly from data if the SPI platform implements
+ * no_os_spi_transfer().
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data to write
+ * @param len		- Length in bytes, multiple of DATA_BLOCK_LEN
+ * @return 0 in case of success, -1 otherwise. After an error, the stream must
+ * still be ended with sd_stream_stop().
+ */
+int32_t sd_stream_write(struct sd_desc *sd_desc, uint8_t *data, uint32_t len)
+{
+	if (0 != stream_check(sd_desc, data, len, SD_STREAM_WRITE))
+		return -1;
+
+	while (len) {
+		if (0 != write_block(sd_desc, data, START_N_BLOCK_TOKEN))
 			return -1;
+		sd_desc->stream_block++;
+		data += DATA_BLOCK_LEN;
+		len -= DATA_BLOCK_LEN;
 	}
 
 	return 0;
 }
 
+/**
+ * End the stream started with sd_stream_read_start() or
+ * sd_stream_write_start()
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_stream_stop(struct sd_desc *sd_desc)
+{
+	enum sd_stream_state	stream;
+
+	if (!sd_desc)
+		return -1;
+
+	stream = sd_desc->stream;
+	sd_desc->stream = SD_STREAM_IDLE;
+	switch (stream) {
+	case SD_STREAM_READ:
+		return stop_read(sd_desc);
+	case SD_STREAM_WRITE:
+		return stop_write(sd_desc);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Free the cache of an instance of SD card
+ * @param sd_desc	- Instance of the SD card
+ */
+static void free_cache(struct sd_desc *sd_desc)
+{
+	uint32_t	i;
+
+	if (sd_desc->cache)
+		for (i = 0; i < sd_desc->cache_blocks; i++)
+			free(sd_desc->cache[i].data);
+	free(sd_desc->cache);
+	free(sd_desc->io_blocks);
+	free(sd_desc->flush_list);
+	free(sd_desc->fill_list);
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
@@ -539,6 +1097,11 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 	if (!local_desc)
 		return -1;
 	local_desc->spi_desc = param->spi_desc;
+	local_desc->direct_io = param->spi_desc->platform_ops->transfer != NULL;
+	memset(local_desc->block_buff, 0xFF, DATA_BLOCK_LEN);
+
+	no_os_crc8_populate_msb(sd_crc7, CRC7_POLYNOMIAL);
+	no_os_crc16_populate_msb(sd_crc16, CRC16_POLYNOMIAL);
 
 	/* Synchronize SD card frequency: Send 10 dummy bytes*/
 	memset(local_desc->buff, 0xFF, 10);
@@ -573,7 +1136,19 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 		goto failure;
 	}
 
-	/* For enabling CRC send CMD 59 here (CRC not implemented)*/
+	/* Enable the CRC check of the card */
+	if (param->crc_enable) {
+		cmd_desc.cmd = CMD(59);
+		cmd_desc.arg = CMD59_ARG_CRC_ON;
+		cmd_desc.response_len = R1_LEN;
+		if (0 != send_command(local_desc, &cmd_desc))
+			goto failure;
+		if (cmd_desc.response[0] != R1_IDLE_STATE) {
+			DEBUG_MSG("Failed to enable CRC\n");
+			goto failure;
+		}
+		local_desc->crc_enable = true;
+	}
 
 	/* Change to ready state */
 	cmd_desc.cmd = ACMD(41);
@@ -623,10 +1198,34 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 	local_desc->memory_size = ((uint64_t)c_size + 1) *
 				  ((uint64_t)DATA_BLOCK_LEN << 10u);
 
+	/* Allocate the cache */
+	if (param->cache_blocks) {
+		local_desc->cache = calloc(param->cache_blocks,
+					   sizeof(*local_desc->cache));
+		local_desc->io_blocks = calloc(param->cache_blocks,
+					       sizeof(*local_desc->io_blocks));
+		local_desc->flush_list = calloc(param->cache_blocks,
+						sizeof(*local_desc->flush_list));
+		local_desc->fill_list = calloc(param->cache_blocks,
+					       sizeof(*local_desc->fill_list));
+		if (!local_desc->cache || !local_desc->io_blocks ||
+		    !local_desc->flush_list || !local_desc->fill_list)
+			goto failure;
+		local_desc->cache_blocks = param->cache_blocks;
+		for (i = 0; i < param->cache_blocks; i++) {
+			local_desc->cache[i].data = malloc(DATA_BLOCK_LEN);
+			if (!local_desc->cache[i].data)
+				goto failure;
+		}
+		local_desc->read_ahead = no_os_min(param->read_ahead,
+						   param->cache_blocks - 1);
+	}
+
 	*sd_desc = local_desc;
 
 	return 0;
 failure:
+	free_cache(local_desc);
 	free(local_desc);
 	return -1;
 }
@@ -641,6 +1240,13 @@ int32_t sd_remove(struct sd_desc *desc)
 	if (desc == NULL)
 		return -1;
 
+	if (0 != sd_stream_stop(desc))
+		return -1;
+
+	if (0 != sd_flush(desc))
+		return -1;
+
+	free_cache(desc);
 	free(desc);
 	return 0;
 }
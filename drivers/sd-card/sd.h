@@ -85,6 +85,43 @@
 struct sd_init_param {
 	/** Descriptor of an initialized SPI channel */
 	struct no_os_spi_desc *spi_desc;
+	/** Number of data blocks kept in the cache, 0 to disable it */
+	uint32_t	cache_blocks;
+	/** Number of blocks read in advance on sequential cache misses */
+	uint32_t	read_ahead;
+	/** Generate and check the CRC16 of data blocks and enable the CRC check
+	 *  of the card */
+	bool		crc_enable;
+};
+
+/**
+ * @enum sd_stream_state
+ * @brief State of the multiple block stream of the SD card
+ */
+enum sd_stream_state {
+	/** No stream started */
+	SD_STREAM_IDLE,
+	/** Multiple block read command in progress */
+	SD_STREAM_READ,
+	/** Multiple block write command in progress */
+	SD_STREAM_WRITE
+};
+
+/**
+ * @struct sd_cache_entry
+ * @brief Data block kept in the SD card cache
+ */
+struct sd_cache_entry {
+	/** Block number */
+	uint32_t	block;
+	/** Value of the cache clock at the last access, for LRU eviction */
+	uint32_t	last_use;
+	/** The entry holds the data of block */
+	bool		valid;
+	/** The data was modified and not written to the card yet */
+	bool		dirty;
+	/** Block data */
+	uint8_t		*data;
 };
 
 /**
@@ -100,6 +137,34 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** Bytes of 0xFF sent while reading a block if direct_io is set, copy
+	 *  of the block being written otherwise */
+	uint8_t		block_buff[DATA_BLOCK_LEN];
+	/** The SPI platform implements no_os_spi_transfer(), blocks are
+	 *  transferred directly from/to the user buffers */
+	bool		direct_io;
+	/** Generate and check the CRC16 of data blocks */
+	bool		crc_enable;
+	/** State of the multiple block stream */
+	enum sd_stream_state	stream;
+	/** Next block of the stream */
+	uint32_t	stream_block;
+	/** Cache entries, NULL if the cache is disabled */
+	struct sd_cache_entry	*cache;
+	/** Number of cache entries */
+	uint32_t	cache_blocks;
+	/** Number of blocks read in advance on sequential cache misses */
+	uint32_t	read_ahead;
+	/** Incremented at each cache access */
+	uint32_t	cache_clock;
+	/** Block following the last one read, to detect sequential reads */
+	uint32_t	next_block;
+	/** Block buffers of a multiple block transfer of cache entries */
+	uint8_t		**io_blocks;
+	/** Modified cache entries, sorted when the cache is flushed */
+	struct sd_cache_entry	**flush_list;
+	/** Entries taken by a cache miss, kept from being evicted by it */
+	struct sd_cache_entry	**fill_list;
 };
 
 /**
@@ -132,6 +197,12 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_flush(struct sd_desc *desc);
+int32_t sd_stream_read_start(struct sd_desc *desc, uint64_t address);
+int32_t sd_stream_write_start(struct sd_desc *desc, uint64_t address);
+int32_t sd_stream_read(struct sd_desc *desc, uint8_t *data, uint32_t len);
+int32_t sd_stream_write(struct sd_desc *desc, uint8_t *data, uint32_t len);
+int32_t sd_stream_stop(struct sd_desc *desc);
 
 #endif /* __SD_H__ */
 
@@ -61,6 +61,13 @@
 #ifdef ENABLE_IIO_NETWORK
 #include "no_os_delay.h"
 #include "tcp_socket.h"
+#ifdef LINUX_PLATFORM
+#define IIO_EPOLL_EVENT_LOOP
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 #endif
 
 /******************************************************************************/
@@ -71,6 +78,26 @@
 #define MAX_SOCKET_TO_HANDLE	10
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
 #define IIOD_CONN_BUFFER_SIZE	0x1000
+/* Maximum number of blocks a client can split a buffer in */
+#define IIO_MAX_BUFFERS_COUNT	64
+
+#ifdef IIO_EPOLL_EVENT_LOOP
+/* epoll data of the server socket. Connections use their iiod conn_id */
+#define IIO_EPOLL_SERVER_ID	UINT32_MAX
+/* epoll data of the eventfd signaled by iio_buffer_notify() */
+#define IIO_EPOLL_WAKE_ID	(UINT32_MAX - 1)
+/* Maximum time in ms iio_step waits for activity on the sockets */
+#ifndef IIO_EPOLL_TIMEOUT_MS
+#define IIO_EPOLL_TIMEOUT_MS	100
+#endif
+/*
+ * Period in ms of the retries of connections waiting for device data, used
+ * while a device with an open buffer doesn't call iio_buffer_notify()
+ */
+#ifndef IIO_EPOLL_POLL_MS
+#define IIO_EPOLL_POLL_MS	1
+#endif
+#endif
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -109,6 +136,8 @@ static const char * const iio_chan_type_string[] = {
 	[IIO_ANGL_VEL] = "anglvel",
 	[IIO_TEMP] = "temp",
 	[IIO_CAPACITANCE] = "capacitance",
+	[IIO_ACCEL] = "accel",
+	[IIO_TIMESTAMP] = "timestamp",
 };
 
 static const char * const iio_modifier_names[] = {
@@ -116,6 +145,9 @@ static const char * const iio_modifier_names[] = {
 	[IIO_MOD_Y] = "y",
 };
 
+/* Lookup scopes of input and output channels */
+static const uint8_t iio_ch_scope[2];
+
 /* Parameters used in show and store functions */
 struct attr_fun_params {
 	void			*dev_instance;
@@ -133,10 +165,34 @@ struct iio_buffer_priv {
 	int8_t			*raw_buf;
 	/* Length of raw_buf */
 	uint32_t		raw_buf_len;
+	/* Number of blocks requested by the client with BUFFERS_COUNT */
+	uint32_t		nb_blocks;
+	/* Number of blocks returned by iio_buffer_queue_block not done yet */
+	uint32_t		nb_queued;
 	/* Set when this devices has buffer */
 	bool			initalized;
 	/* Set when calloc was used to initalize cb.buf */
 	bool			allocated;
+	/* eventfd of the iio_desc to signal, NULL for iio_buffer_alloc() */
+	int			*wake_fd;
+	/* Set once the device called iio_buffer_notify() */
+	bool			notifies;
+};
+
+/*
+ * Entry of the per device lookup table. Channels and attributes are looked up
+ * by name inside a scope: the attribute list that holds them or, for channels,
+ * the direction of the channel.
+ */
+struct iio_lookup_entry {
+	/* Hash of name and scope. Used to skip most string compares */
+	uint32_t		hash;
+	/* Channel id or attribute name. NULL for empty slots */
+	const char		*name;
+	/* Attribute list or channel direction the entry belongs to */
+	const void		*scope;
+	/* struct iio_channel or struct iio_attribute */
+	void			*item;
 };
 
 /**
@@ -159,6 +215,12 @@ struct iio_dev_priv {
 	struct iio_device	*dev_descriptor;
 	/* Structure storing buffer related fields */
 	struct iio_buffer_priv buffer;
+	/** Channel ids, formatted once at init. Indexed like the channels */
+	char			**ch_ids;
+	/** Open addressing hash table of channels and attributes */
+	struct iio_lookup_entry	*lookup;
+	/** Number of entries in lookup. Power of 2 */
+	uint32_t		lookup_size;
 };
 
 struct iio_desc {
@@ -179,6 +241,20 @@ struct iio_desc {
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
 #endif
+#ifdef IIO_EPOLL_EVENT_LOOP
+	/* epoll instance watching the server and client sockets */
+	int			epoll_fd;
+	/* Mask of connections that can advance without any socket event */
+	uint32_t		busy_conns;
+	/* Mask of connections waiting for device data */
+	uint32_t		polled_conns;
+	/* Mask of connections blocked on send, watched for EPOLLOUT */
+	uint32_t		out_conns;
+	/* Socket file descriptor of each connection */
+	uint32_t		conn_fds[IIOD_MAX_CONNECTIONS];
+#endif
+	/* eventfd waking iio_step when device data is ready, -1 if unused */
+	int			wake_fd;
 };
 
 /******************************************************************************/
@@ -225,50 +301,126 @@ static int iio_send(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 	return desc->send(ctx->conn, buf, len);
 }
 
-static inline void _print_ch_id(char *buff, struct iio_channel *ch)
+static inline int _print_ch_id(char *buff, uint32_t len,
+			       struct iio_channel *ch)
 {
 	if(ch->modified) {
-		sprintf(buff, "%s_%s", iio_chan_type_string[ch->ch_type],
-			iio_modifier_names[ch->channel2]);
+		return snprintf(buff, len, "%s_%s",
+				iio_chan_type_string[ch->ch_type],
+				iio_modifier_names[ch->channel2]);
 	} else {
 		if(ch->indexed) {
 			if (ch->diferential)
-				sprintf(buff, "%s%d-%s%d", iio_chan_type_string[ch->ch_type],
-					(int)ch->channel, iio_chan_type_string[ch->ch_type],
-					(int)ch->channel2);
+				return snprintf(buff, len, "%s%d-%s%d",
+						iio_chan_type_string[ch->ch_type],
+						(int)ch->channel,
+						iio_chan_type_string[ch->ch_type],
+						(int)ch->channel2);
 			else
-				sprintf(buff, "%s%d", iio_chan_type_string[ch->ch_type],
-					(int)ch->channel);
+				return snprintf(buff, len, "%s%d",
+						iio_chan_type_string[ch->ch_type],
+						(int)ch->channel);
 		} else {
-			sprintf(buff, "%s", iio_chan_type_string[ch->ch_type]);
+			return snprintf(buff, len, "%s",
+					iio_chan_type_string[ch->ch_type]);
 		}
 	}
 }
 
+/* FNV-1a hash of a name, seeded with the scope it belongs to */
+static uint32_t iio_lookup_hash(const void *scope, const char *name)
+{
+	uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)scope;
+
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
 /**
- * @brief Get channel ID from a list of channels.
- * @param channel - Channel name.
- * @param desc - Device descriptor
- * @param ch_out - If "true" is output channel, if "false" is input channel.
- * @return Channel ID, or negative value if attribute is not found.
+ * @brief Find a channel or an attribute in the lookup table of a device.
+ * @param dev - Device.
+ * @param scope - Attribute list or channel direction of the item.
+ * @param name - Channel id or attribute name.
+ * @return Item if found, NULL otherwise.
  */
-static inline struct iio_channel *iio_get_channel(const char *channel,
-		struct iio_device *desc, bool ch_out)
+static void *iio_lookup(struct iio_dev_priv *dev, const void *scope,
+			const char *name)
 {
-	int16_t i = 0;
-	char	ch_id[64];
-
-	while (i < desc->num_ch) {
-		_print_ch_id(ch_id, &desc->channels[i]);
-		if (!strcmp(channel, ch_id) &&
-		    (desc->channels[i].ch_out == ch_out))
-			return &desc->channels[i];
-		i++;
+	struct iio_lookup_entry *entry;
+	uint32_t hash, i;
+
+	if (!dev->lookup_size || !scope)
+		return NULL;
+
+	hash = iio_lookup_hash(scope, name);
+	i = hash & (dev->lookup_size - 1);
+	/* The table is never full, so an empty slot ends the probing */
+	while (dev->lookup[i].name) {
+		entry = &dev->lookup[i];
+		if (entry->hash == hash && entry->scope == scope &&
+		    !strcmp(entry->name, name))
+			return entry->item;
+		i = (i + 1) & (dev->lookup_size - 1);
 	}
 
 	return NULL;
 }
 
+/* Add an item to the lookup table. Duplicates are ignored */
+static void iio_lookup_add(struct iio_dev_priv *dev, const void *scope,
+			   const char *name, void *item)
+{
+	struct iio_lookup_entry *entry;
+	uint32_t hash, i;
+
+	hash = iio_lookup_hash(scope, name);
+	i = hash & (dev->lookup_size - 1);
+	while (dev->lookup[i].name) {
+		entry = &dev->lookup[i];
+		if (entry->hash == hash && entry->scope == scope &&
+		    !strcmp(entry->name, name))
+			return;
+		i = (i + 1) & (dev->lookup_size - 1);
+	}
+
+	entry = &dev->lookup[i];
+	entry->hash = hash;
+	entry->name = name;
+	entry->scope = scope;
+	entry->item = item;
+}
+
+/* Add all the attributes of a list to the lookup table */
+static void iio_lookup_add_attrs(struct iio_dev_priv *dev,
+				 struct iio_attribute *attributes)
+{
+	uint32_t i;
+
+	if (!attributes)
+		return;
+
+	for (i = 0; attributes[i].name; i++)
+		iio_lookup_add(dev, attributes, attributes[i].name,
+			       &attributes[i]);
+}
+
+/**
+ * @brief Get channel from a list of channels.
+ * @param channel - Channel name.
+ * @param dev - Device
+ * @param ch_out - If "true" is output channel, if "false" is input channel.
+ * @return Channel pointer, or NULL if channel is not found.
+ */
+static inline struct iio_channel *iio_get_channel(const char *channel,
+		struct iio_dev_priv *dev, bool ch_out)
+{
+	return iio_lookup(dev, &iio_ch_scope[ch_out], channel);
+}
+
 /**
  * @brief Find interface with "device_name".
  * @param device_name - Device name.
@@ -278,110 +430,62 @@ static inline struct iio_channel *iio_get_channel(const char *channel,
 static struct iio_dev_priv *get_iio_device(struct iio_desc *desc,
 		const char *device_name)
 {
-	uint32_t i;
+	static const char prefix[] = "iio:device";
+	uint32_t i = 0;
 
-	for (i = 0; i < desc->nb_devs; i++) {
-		if (strcmp(desc->devs[i].dev_id, device_name) == 0)
-			return &desc->devs[i];
-	}
+	/* Ids are "iio:deviceN" with N being the index in desc->devs */
+	if (strncmp(device_name, prefix, sizeof(prefix) - 1))
+		return NULL;
 
-	return NULL;
-}
+	device_name += sizeof(prefix) - 1;
+	/* No sign, leading zeros or trailing characters are accepted */
+	if (*device_name == '0' && device_name[1])
+		return NULL;
+	do {
+		if (*device_name < '0' || *device_name > '9' ||
+		    i > (UINT32_MAX - 9) / 10)
+			return NULL;
+		i = i * 10 + (*device_name++ - '0');
+	} while (*device_name);
 
-/**
- * @brief Read all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Buffer where values are read.
- * @param len - Maximum length of value to be stored in buf.
- * @param channel - Channel properties.
- * @param attributes - List of attributes to be read.
- * @return Number of bytes read or negative value in case of error.
- */
-static int iio_read_all_attr(struct attr_fun_params *params,
-			     struct iio_attribute *attributes)
-{
-	/* TODO Not sure if working corectly */
-	return -EINVAL;
-
-#if 0
-	int16_t i = 0, j = 0;
-	char local_buf[256];
-	int attr_length;
-	uint32_t *pattr_length;
-
-	while (attributes[i].name) {
-		attr_length = attributes[i].show(params->dev_instance,
-						 local_buf, params->len,
-						 params->ch_info,
-						 attributes[i].priv);
-		if (NO_OS_IS_ERR_VALUE(attr_length))
-			attr_length = snprintf(local_buf, params->len, "%d",
-					       attr_length);
-
-		attr_length += 1;//Add '\0' to the count
-		pattr_length = (uint32_t *)(params->buf + j);
-		if (j + 4 > params->len)
-			return -EINVAL;
-		*pattr_length = no_os_bswap_constant_32(attr_length);
-		j += 4;
-		if (attr_length >= 0) {
-			if (attr_length + j > params->len)
-				return -EINVAL;
-			sprintf(params->buf + j, "%s", local_buf);
-			if (attr_length & 0x3) /* multiple of 4 */
-				attr_length = ((attr_length >> 2) + 1) << 2;
-			j += attr_length;
-		}
-		i++;
-	}
-	if (j == 0)
-		return -ENOENT;
+	if (i >= desc->nb_devs)
+		return NULL;
 
-	return j;
-#endif
+	return &desc->devs[i];
 }
 
 /**
- * @brief Write all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Values to be written.
- * @param len - Length of buf.
- * @param channel - Channel properties.
- * @param attributes - List of attributes to be written.
- * @return Number of written bytes or negative value in case of error.
+ * @brief Call the show or store function of an attribute.
+ * @param params - Structure describing parameters for store and show functions
+ * @param attribute - Attribute to be read or written.
+ * @param is_write -If it has value "1", writes attribute, otherwise reads
+ * 		attribute.
+ * @return Length of chars written/read or negative value in case of error.
  */
-static int iio_write_all_attr(struct attr_fun_params *params,
-			      struct iio_attribute *attributes)
+static int iio_call_attribute(struct attr_fun_params *params,
+			      struct iio_attribute *attribute,
+			      bool is_write)
 {
-	/* TODO Not sure if working corectly */
-	return -EINVAL;
-
-#if 0
-	int16_t i = 0, j = 0;
-	int16_t attr_length;
-
-	while (attributes[i].name) {
-		attr_length = no_os_bswap_constant_32((uint32_t)(params->buf + j));
-		j += 4;
-		attributes[i].store(params->dev_instance, (params->buf + j),
-				    attr_length, params->ch_info,
-				    attributes[i].priv);
-		j += attr_length;
-		if (j & 0x3)
-			j = ((j >> 2) + 1) << 2;
-		i++;
-	}
-
-	if (params->len == 0)
-		return -ENOENT;
+	if (is_write) {
+		if (!attribute->store)
+			return -ENOENT;
 
-	return params->len;
-#endif
+		return attribute->store(params->dev_instance, params->buf,
+					params->len, params->ch_info,
+					attribute->priv);
+	} else {
+		if (!attribute->show)
+			return -ENOENT;
+		return attribute->show(params->dev_instance, params->buf,
+				       params->len, params->ch_info,
+				       attribute->priv);
+	}
 }
 
 /**
  * @brief Read/write attribute.
  * @param params - Structure describing parameters for store and show functions
+ * @param dev - Device owning the attributes.
  * @param attributes - Array of attributes.
  * @param attr_name - Attribute name to be modified
  * @param is_write -If it has value "1", writes attribute, otherwise reads
@@ -389,36 +493,18 @@ static int iio_write_all_attr(struct attr_fun_params *params,
  * @return Length of chars written/read or negative value in case of error.
  */
 static int iio_rd_wr_attribute(struct attr_fun_params *params,
+			       struct iio_dev_priv *dev,
 			       struct iio_attribute *attributes,
 			       const char *attr_name,
 			       bool is_write)
 {
-	int16_t i = 0;
-
-	/* Search attribute */
-	while (attributes[i].name) {
-		if (!strcmp(attr_name, attributes[i].name))
-			break;
-		i++;
-	}
+	struct iio_attribute *attribute;
 
-	if (!attributes[i].name)
+	attribute = iio_lookup(dev, attributes, attr_name);
+	if (!attribute)
 		return -ENOENT;
 
-	if (is_write) {
-		if (!attributes[i].store)
-			return -ENOENT;
-
-		return attributes[i].store(params->dev_instance, params->buf,
-					   params->len, params->ch_info,
-					   attributes[i].priv);
-	} else {
-		if (!attributes[i].show)
-			return -ENOENT;
-		return attributes[i].show(params->dev_instance, params->buf,
-					  params->len, params->ch_info,
-					  attributes[i].priv);
-	}
+	return iio_call_attribute(params, attribute, is_write);
 }
 
 /* Read a device register. The register address to read is set on
@@ -478,6 +564,165 @@ static int32_t debug_reg_write(struct iio_dev_priv *dev, const char *buf,
 	return len;
 }
 
+/**
+ * @brief Get the number of attributes in an attribute list.
+ * @param attributes - List of attributes.
+ * @return Number of attributes.
+ */
+static uint32_t iio_get_nb_attrs(struct iio_attribute *attributes)
+{
+	uint32_t i = 0;
+
+	if (attributes)
+		while (attributes[i].name)
+			i++;
+
+	return i;
+}
+
+/*
+ * Size of the big endian length preceding each value when all the attributes
+ * of a list are read or written at once. Values are padded to this size.
+ */
+#define IIO_ALL_ATTR_LEN_SIZE	4
+
+/* Check if direct_reg_access is reported after the debug attributes */
+static inline bool iio_has_reg_access(struct iio_dev_priv *dev,
+				      enum iio_attr_type type)
+{
+	return type == IIO_ATTR_TYPE_DEBUG &&
+	       (dev->dev_descriptor->debug_reg_read ||
+		dev->dev_descriptor->debug_reg_write);
+}
+
+/**
+ * @brief Read all attributes from an attribute list.
+ * Each value is preceded by its length, including the null terminator, as a
+ * big endian 32 bit value and is padded to a multiple of 4 bytes. When reading
+ * an attribute fails, the error code is sent instead of the length.
+ * @param params - Structure describing parameters for show functions.
+ * @param dev - Device owning the attributes.
+ * @param type - Type of the attributes.
+ * @param attributes - List of attributes to be read.
+ * @return Number of bytes read or negative value in case of error.
+ */
+static int iio_read_all_attr(struct attr_fun_params *params,
+			     struct iio_dev_priv *dev,
+			     enum iio_attr_type type,
+			     struct iio_attribute *attributes)
+{
+	struct attr_fun_params	lparams = *params;
+	uint32_t		i, j, nb_attrs, padded;
+	int32_t			ret;
+
+	nb_attrs = iio_get_nb_attrs(attributes);
+	if (iio_has_reg_access(dev, type))
+		nb_attrs++;
+	if (!nb_attrs)
+		return -ENOENT;
+
+	j = 0;
+	for (i = 0; i < nb_attrs; i++) {
+		if (params->len - j < IIO_ALL_ATTR_LEN_SIZE)
+			return -EINVAL;
+
+		lparams.buf = params->buf + j + IIO_ALL_ATTR_LEN_SIZE;
+		lparams.len = params->len - j - IIO_ALL_ATTR_LEN_SIZE;
+		if (attributes && attributes[i].name)
+			ret = iio_call_attribute(&lparams, &attributes[i], 0);
+		else if (dev->dev_descriptor->debug_reg_read)
+			ret = debug_reg_read(dev, lparams.buf, lparams.len);
+		else
+			ret = -ENOENT;
+
+		if (!NO_OS_IS_ERR_VALUE(ret)) {
+			/* Values are sent with their null terminator */
+			if ((uint32_t)ret >= lparams.len)
+				return -EINVAL;
+			lparams.buf[ret++] = '\0';
+		}
+
+		no_os_put_unaligned_be32(ret, (uint8_t *)params->buf + j);
+		j += IIO_ALL_ATTR_LEN_SIZE;
+		if (ret <= 0)
+			continue;
+
+		padded = no_os_round_up(ret, IIO_ALL_ATTR_LEN_SIZE) *
+			 IIO_ALL_ATTR_LEN_SIZE;
+		if (padded > params->len - j)
+			return -EINVAL;
+		memset(params->buf + j + ret, 0, padded - ret);
+		j += padded;
+	}
+
+	return j;
+}
+
+/**
+ * @brief Write all attributes from an attribute list.
+ * Uses the same encoding as iio_read_all_attr. Attributes with a length of 0
+ * are skipped.
+ * @param params - Structure describing parameters for store functions.
+ * @param dev - Device owning the attributes.
+ * @param type - Type of the attributes.
+ * @param attributes - List of attributes to be written.
+ * @return Number of written bytes or negative value in case of error.
+ */
+static int iio_write_all_attr(struct attr_fun_params *params,
+			      struct iio_dev_priv *dev,
+			      enum iio_attr_type type,
+			      struct iio_attribute *attributes)
+{
+	struct attr_fun_params	lparams = *params;
+	uint32_t		i, j, nb_attrs, attr_len;
+	char			last;
+	int32_t			ret;
+
+	nb_attrs = iio_get_nb_attrs(attributes);
+	if (iio_has_reg_access(dev, type))
+		nb_attrs++;
+	if (!nb_attrs || !params->len)
+		return -ENOENT;
+
+	j = 0;
+	for (i = 0; i < nb_attrs; i++) {
+		if (params->len - j < IIO_ALL_ATTR_LEN_SIZE)
+			return -EINVAL;
+
+		attr_len = no_os_get_unaligned_be32((uint8_t *)params->buf + j);
+		j += IIO_ALL_ATTR_LEN_SIZE;
+		if ((int32_t)attr_len <= 0)
+			continue;
+		if (attr_len > params->len - j)
+			return -EINVAL;
+
+		/*
+		 * Store functions expect null terminated strings. The byte
+		 * after the value is either padding, the next length or the
+		 * terminator the caller places after the data.
+		 */
+		lparams.buf = params->buf + j;
+		lparams.len = attr_len;
+		last = lparams.buf[attr_len];
+		lparams.buf[attr_len] = '\0';
+		if (attributes && attributes[i].name)
+			ret = iio_call_attribute(&lparams, &attributes[i], 1);
+		else if (dev->dev_descriptor->debug_reg_write)
+			ret = debug_reg_write(dev, lparams.buf, lparams.len);
+		else
+			ret = -ENOENT;
+		lparams.buf[attr_len] = last;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		/* Padding may be missing after the last value */
+		j += no_os_min(no_os_round_up(attr_len, IIO_ALL_ATTR_LEN_SIZE) *
+			       IIO_ALL_ATTR_LEN_SIZE, params->len - j);
+	}
+
+	return params->len;
+}
+
 static int32_t __iio_str_parse(char *buf, int32_t *integer, int32_t *_fract,
 			       bool scale_db)
 {
@@ -625,6 +870,81 @@ static struct iio_attribute *get_attributes(enum iio_attr_type type,
 	return NULL;
 }
 
+/**
+ * @brief Get the attribute with the given index from an attribute list.
+ * @param attributes - List of attributes.
+ * @param idx - Index of the attribute, as ordered in the xml description.
+ * @return Attribute pointer if found, NULL otherwise.
+ */
+static struct iio_attribute *iio_get_attr_by_idx(struct iio_attribute *attributes,
+		uint32_t idx)
+{
+	uint32_t i;
+
+	if (!attributes)
+		return NULL;
+
+	for (i = 0; i < idx; i++)
+		if (!attributes[i].name)
+			return NULL;
+
+	return attributes[idx].name ? &attributes[idx] : NULL;
+}
+
+/**
+ * @brief Find the device, channel and attribute list targeted by attr.
+ * Attributes sent with the binary protocol have no name and the channel is
+ * selected by index.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param attr - Attribute description.
+ * @param params - Show and store parameters to be filled.
+ * @param ch_info - Where channel information is stored.
+ * @param dev - Where the device is stored.
+ * @param attributes - Where the attribute list is stored.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_resolve_attr(struct iiod_ctx *ctx, const char *device,
+			    struct iiod_attr *attr,
+			    struct attr_fun_params *params,
+			    struct iio_ch_info *ch_info,
+			    struct iio_dev_priv **dev,
+			    struct iio_attribute **attributes)
+{
+	struct iio_channel *ch = NULL;
+	int8_t ch_out;
+
+	*dev = get_iio_device(ctx->instance, device);
+	if (!*dev)
+		return -ENODEV;
+
+	if (attr->type == IIO_ATTR_TYPE_CH_IN ||
+	    attr->type == IIO_ATTR_TYPE_CH_OUT) {
+		if (attr->name) {
+			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
+			ch = iio_get_channel(attr->channel, *dev, ch_out);
+		} else if (attr->ch_idx < (*dev)->dev_descriptor->num_ch) {
+			ch = &(*dev)->dev_descriptor->channels[attr->ch_idx];
+		}
+		if (!ch)
+			return -ENOENT;
+
+		ch_info->ch_out = ch->ch_out;
+		ch_info->ch_num = ch->channel;
+		ch_info->type = ch->ch_type;
+		ch_info->differential = ch->diferential;
+		ch_info->address = ch->address;
+		params->ch_info = ch_info;
+	} else {
+		params->ch_info = NULL;
+	}
+
+	params->dev_instance = (*dev)->dev_instance;
+	*attributes = get_attributes(attr->type, *dev, ch);
+
+	return 0;
+}
+
 /**
  * @brief Read global attribute of a device.
  * @param ctx - IIO instance and conn instance
@@ -639,14 +959,32 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 {
 	struct iio_dev_priv *dev;
 	struct iio_ch_info ch_info;
-	struct iio_channel *ch = NULL;
 	struct attr_fun_params params;
 	struct iio_attribute *attributes;
-	int8_t ch_out;
+	struct iio_attribute *attribute;
+	int ret;
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev)
-		return -1;
+	ret = iio_resolve_attr(ctx, device, attr, &params, &ch_info, &dev,
+			       &attributes);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	params.buf = buf;
+	params.len = len;
+
+	if (!attr->name) {
+		/* Binary protocol. Selected by index */
+		attribute = iio_get_attr_by_idx(attributes, attr->idx);
+		if (attribute)
+			return iio_call_attribute(&params, attribute, 0);
+		/* direct_reg_access follows the debug attributes */
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    attr->idx == iio_get_nb_attrs(attributes) &&
+		    dev->dev_descriptor->debug_reg_read)
+			return debug_reg_read(dev, buf, len);
+
+		return -ENOENT;
+	}
 
 	if (attr->type == IIO_ATTR_TYPE_DEBUG &&
 	    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -656,30 +994,11 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 			return -ENOENT;
 	}
 
-	if (attr->channel) {
-		ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-		ch = iio_get_channel(attr->channel, dev->dev_descriptor,
-				     ch_out);
-		if (!ch)
-			return -ENOENT;
-		ch_info.ch_out = ch_out;
-		ch_info.ch_num = ch->channel;
-		ch_info.type = ch->ch_type;
-		ch_info.differential = ch->diferential;
-		ch_info.address = ch->address;
-		params.ch_info = &ch_info;
-	} else {
-		params.ch_info = NULL;
-	}
-
-	params.buf = buf;
-	params.len = len;
-	params.dev_instance = dev->dev_instance;
-	attributes = get_attributes(attr->type, dev, ch);
 	if (!strcmp(attr->name, ""))
-		return iio_read_all_attr(&params, attributes);
+		return iio_read_all_attr(&params, dev, attr->type, attributes);
 	else
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 0);
+		return iio_rd_wr_attribute(&params, dev, attributes, attr->name,
+					   0);
 }
 
 /**
@@ -697,13 +1016,31 @@ static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 	struct iio_dev_priv	*dev;
 	struct attr_fun_params	params;
 	struct iio_attribute	*attributes;
+	struct iio_attribute	*attribute;
 	struct iio_ch_info ch_info;
-	struct iio_channel *ch = NULL;
-	int8_t ch_out;
+	int ret;
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev)
-		return -ENODEV;
+	ret = iio_resolve_attr(ctx, device, attr, &params, &ch_info, &dev,
+			       &attributes);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	params.buf = (char *)buf;
+	params.len = len;
+
+	if (!attr->name) {
+		/* Binary protocol. Selected by index */
+		attribute = iio_get_attr_by_idx(attributes, attr->idx);
+		if (attribute)
+			return iio_call_attribute(&params, attribute, 1);
+		/* direct_reg_access follows the debug attributes */
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    attr->idx == iio_get_nb_attrs(attributes) &&
+		    dev->dev_descriptor->debug_reg_write)
+			return debug_reg_write(dev, buf, len);
+
+		return -ENOENT;
+	}
 
 	if (attr->type == IIO_ATTR_TYPE_DEBUG &&
 	    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -713,31 +1050,12 @@ static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 			return -ENOENT;
 	}
 
-	if (attr->channel) {
-		ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-		ch = iio_get_channel(attr->channel, dev->dev_descriptor,
-				     ch_out);
-		if (!ch)
-			return -ENOENT;
-
-		ch_info.ch_out = ch_out;
-		ch_info.ch_num = ch->channel;
-		ch_info.type = ch->ch_type;
-		ch_info.differential = ch->diferential;
-		ch_info.address = ch->address;
-		params.ch_info = &ch_info;
-	} else {
-		params.ch_info = NULL;
-	}
-
-	params.buf = (char *)buf;
-	params.len = len;
-	params.dev_instance = dev->dev_instance;
-	attributes = get_attributes(attr->type, dev, ch);
 	if (!strcmp(attr->name, ""))
-		return iio_write_all_attr(&params, attributes);
+		return iio_write_all_attr(&params, dev, attr->type,
+					  attributes);
 	else
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 1);
+		return iio_rd_wr_attribute(&params, dev, attributes, attr->name,
+					   1);
 }
 
 static uint32_t bytes_per_scan(struct iio_channel *channels, uint32_t mask)
@@ -768,6 +1086,7 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
 			uint32_t samples, uint32_t mask, bool cyclic)
 {
 	struct iio_dev_priv *dev;
+	uint32_t scan_size;
 	uint32_t ch_mask;
 	int32_t ret;
 	int8_t *buf;
@@ -784,10 +1103,19 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
 	if (!mask)
 		return -ENOENT;
 
+	scan_size = bytes_per_scan(dev->dev_descriptor->channels, mask);
+	/* A wrapped size would give a buffer smaller than a DMA block */
+	if (scan_size &&
+	    samples > UINT32_MAX / dev->buffer.nb_blocks / scan_size)
+		return -EINVAL;
+
 	dev->buffer.public.active_mask = mask;
-	dev->buffer.public.bytes_per_scan =
-		bytes_per_scan(dev->dev_descriptor->channels, mask);
-	dev->buffer.public.size = dev->buffer.public.bytes_per_scan * samples;
+	dev->buffer.public.bytes_per_scan = scan_size;
+	dev->buffer.public.block_size = scan_size * samples;
+	dev->buffer.public.nb_blocks = dev->buffer.nb_blocks;
+	dev->buffer.public.size = dev->buffer.public.block_size *
+				  dev->buffer.public.nb_blocks;
+	dev->buffer.nb_queued = 0;
 	if (dev->buffer.raw_buf && dev->buffer.raw_buf_len) {
 		if (dev->buffer.raw_buf_len < dev->buffer.public.size)
 			/* Need a bigger buffer or to allocate */
@@ -836,6 +1164,7 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
 static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
 {
 	struct iio_dev_priv *dev;
+	int32_t ret = 0;
 
 	dev = get_iio_device(ctx->instance, device);
 	if (!dev)
@@ -844,15 +1173,42 @@ static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
 	if (!dev->buffer.initalized)
 		return -EINVAL;
 
+	dev->buffer.public.active_mask = 0;
+	if (dev->dev_descriptor->post_disable)
+		ret = dev->dev_descriptor->post_disable(dev->dev_instance);
+
+	/* Freed after post_disable so no DMA transfer can be still running */
 	if (dev->buffer.allocated) {
 		/* Should something else be used to free internal strucutre */
 		free(dev->buffer.cb.buff);
 		dev->buffer.allocated = 0;
 	}
+	dev->buffer.nb_queued = 0;
+	/* BUFFERS_COUNT applies to the next open of this client only */
+	dev->buffer.nb_blocks = 1;
 
-	dev->buffer.public.active_mask = 0;
-	if (dev->dev_descriptor->post_disable)
-		return dev->dev_descriptor->post_disable(dev->dev_instance);
+	return ret;
+}
+
+/**
+ * @brief Set the number of blocks the buffer will be split in.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param buffers_count - Number of blocks. Applied on the next open. At most
+ * IIO_MAX_BUFFERS_COUNT.
+ * @return 0, negative value in case of failure.
+ */
+static int iio_set_buffers_count(struct iiod_ctx *ctx, const char *device,
+				 uint32_t buffers_count)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized || !buffers_count ||
+	    buffers_count > IIO_MAX_BUFFERS_COUNT)
+		return -EINVAL;
+
+	dev->buffer.nb_blocks = buffers_count;
 
 	return 0;
 }
@@ -882,7 +1238,7 @@ static int iio_call_submit(struct iiod_ctx *ctx, const char *device,
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
-		nb_scans = buffer->size / buffer->bytes_per_scan;
+		nb_scans = buffer->block_size / buffer->bytes_per_scan;
 		if (dir == IIO_DIRECTION_INPUT)
 			ret = dev->dev_descriptor->read_dev(dev->dev_instance,
 							    buff, nb_scans);
@@ -946,6 +1302,73 @@ static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
 	return bytes;
 }
 
+/**
+ * @brief Get the address of a chunk of data from the buffer, without copying.
+ * When the buffer is split in blocks, the device is given the chance to
+ * complete finished transfers and start new ones.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param buf - Where to store the address of the data.
+ * @param bytes - Maximum number of bytes to get.
+ * @return Number of bytes available at buf or negative value in case of error.
+ */
+static int iio_get_read_block(struct iiod_ctx *ctx, const char *device,
+			      char **buf, uint32_t bytes)
+{
+	struct iio_dev_priv	*dev;
+	int32_t			ret;
+	uint32_t		size;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	if (dev->buffer.public.nb_blocks > 1 && dev->dev_descriptor->submit) {
+		ret = dev->dev_descriptor->submit(&dev->dev_data);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	ret = no_os_cb_prepare_async_read(&dev->buffer.cb, bytes, (void **)buf,
+					  &size);
+	/* On overrun the read index is moved and data is still valid */
+	if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Release the data returned by iio_get_read_block.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @return 0, negative value in case of failure.
+ */
+static int iio_read_block_done(struct iiod_ctx *ctx, const char *device)
+{
+	struct iio_dev_priv	*dev;
+	int32_t			ret;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	ret = no_os_cb_end_async_read(&dev->buffer.cb);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	/* Space was freed. Queue new blocks */
+	if (dev->buffer.public.nb_blocks > 1 && dev->dev_descriptor->submit) {
+		ret = dev->dev_descriptor->submit(&dev->dev_data);
+		/* The next iio_get_read_block asks again for the data */
+		if (ret == -EAGAIN)
+			return 0;
+		return ret;
+	}
+
+	return 0;
+}
+
 
 /**
  * @brief Write chunk of data into RAM.
@@ -992,11 +1415,11 @@ int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
 		return -EINVAL;
 
 	if (buffer->dir == IIO_DIRECTION_INPUT)
-		ret = no_os_cb_prepare_async_write(buffer->buf, buffer->size, addr,
-						   &size);
+		ret = no_os_cb_prepare_async_write(buffer->buf, buffer->block_size,
+						   addr, &size);
 	else
-		ret = no_os_cb_prepare_async_read(buffer->buf, buffer->size, addr,
-						  &size);
+		ret = no_os_cb_prepare_async_read(buffer->buf, buffer->block_size,
+						  addr, &size);
 	if (NO_OS_IS_ERR_VALUE(ret))
 		/* ToDo: Implement async cancel. And cancel transaction here.
 		 * Also cancel may be needed for a posible future abort callback
@@ -1006,11 +1429,11 @@ int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
 		 */
 		return ret;
 
-	/* This function is exepected to be called for a DMA transaction of the
-	 * full buffer. But if can't do in one transaction won't work.
+	/* This function is exepected to be called for a DMA transaction of a
+	 * full block. But if can't do in one transaction won't work.
 	 * This behavior is not expected anyway.
 	 */
-	if (size != buffer->size)
+	if (size != buffer->block_size)
 		return -ENOMEM;
 
 	return 0;
@@ -1027,6 +1450,201 @@ int iio_buffer_block_done(struct iio_buffer *buffer)
 	return no_os_cb_end_async_read(buffer->buf);
 }
 
+/**
+ * @brief Get the address of the next free block of the buffer.
+ * Several blocks can be queued before the first one is done, so DMA transfers
+ * can run while data from previous blocks is sent to the client.
+ * @param buffer - IIO buffer.
+ * @param addr - Where to store the address of the block.
+ * @return 0 in case of success, -EAGAIN if there is no free block.
+ */
+int iio_buffer_queue_block(struct iio_buffer *buffer, void **addr)
+{
+	struct iio_buffer_priv *priv;
+	struct no_os_circular_buffer *cb;
+	uint32_t used;
+	uint32_t idx;
+
+	if (!buffer || !addr || !buffer->block_size)
+		return -EINVAL;
+
+	priv = (struct iio_buffer_priv *)buffer;
+	cb = buffer->buf;
+
+	no_os_cb_size(cb, &used);
+	if (buffer->dir == IIO_DIRECTION_INPUT) {
+		/* Blocks are filled after the data not yet sent */
+		if (used + (priv->nb_queued + 1) * buffer->block_size >
+		    buffer->size)
+			return -EAGAIN;
+		idx = cb->write.idx;
+	} else {
+		/* Blocks are emptied only when the client wrote them */
+		if ((priv->nb_queued + 1) * buffer->block_size > used)
+			return -EAGAIN;
+		idx = cb->read.idx;
+	}
+
+	idx = (idx + priv->nb_queued * buffer->block_size) % buffer->size;
+	*addr = cb->buff + idx;
+	priv->nb_queued++;
+
+	return 0;
+}
+
+/**
+ * @brief Mark the oldest block returned by iio_buffer_queue_block as done.
+ * @param buffer - IIO buffer.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_dequeue_block(struct iio_buffer *buffer)
+{
+	struct iio_buffer_priv *priv;
+	int32_t ret;
+	uint32_t size;
+	void *addr;
+
+	if (!buffer)
+		return -EINVAL;
+
+	priv = (struct iio_buffer_priv *)buffer;
+	if (!priv->nb_queued)
+		return -ENOENT;
+
+	/* Blocks are aligned to the buffer so the whole block is returned */
+	if (buffer->dir == IIO_DIRECTION_INPUT) {
+		ret = no_os_cb_prepare_async_write(buffer->buf,
+						   buffer->block_size,
+						   &addr, &size);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+		ret = no_os_cb_end_async_write(buffer->buf);
+	} else {
+		ret = no_os_cb_prepare_async_read(buffer->buf,
+						  buffer->block_size,
+						  &addr, &size);
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+			return ret;
+		ret = no_os_cb_end_async_read(buffer->buf);
+	}
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	priv->nb_queued--;
+
+	return 0;
+}
+
+/**
+ * @brief Signal that the device has new data or room in the buffer.
+ * The connections waiting for the device are run on the next iio_step instead
+ * of being polled. Can be called from the transfer completion callback.
+ * @param buffer - IIO buffer.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_notify(struct iio_buffer *buffer)
+{
+	struct iio_buffer_priv *priv;
+#ifdef IIO_EPOLL_EVENT_LOOP
+	uint64_t val = 1;
+#endif
+
+	if (!buffer)
+		return -EINVAL;
+
+	priv = (struct iio_buffer_priv *)buffer;
+	priv->notifies = true;
+#ifdef IIO_EPOLL_EVENT_LOOP
+	if (priv->wake_fd && *priv->wake_fd >= 0 &&
+	    write(*priv->wake_fd, &val, sizeof(val)) < 0 && errno != EAGAIN)
+		return -errno;
+#endif
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a buffer to run the buffer callbacks of a device outside of
+ * iiod, for example to record its samples. The device callbacks can use it as
+ * the buffers created by iiod.
+ * @param buffer - Where to store the buffer.
+ * @param dev_descriptor - Device the buffer is used with.
+ * @param mask - Active channels.
+ * @param block_size - Size of a block in bytes, multiple of the scan size.
+ * @param nb_blocks - Number of blocks the buffer is split in.
+ * @param dir - Buffer direction.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_alloc(struct iio_buffer **buffer,
+		     struct iio_device *dev_descriptor, uint32_t mask,
+		     uint32_t block_size, uint32_t nb_blocks,
+		     enum iio_buffer_direction dir)
+{
+	struct iio_buffer_priv *priv;
+	uint32_t scan_size;
+	int8_t *buf;
+	int32_t ret;
+
+	if (!buffer || !dev_descriptor || !nb_blocks || !mask ||
+	    (dev_descriptor->num_ch < 32 && mask >> dev_descriptor->num_ch))
+		return -EINVAL;
+
+	scan_size = bytes_per_scan(dev_descriptor->channels, mask);
+	if (!block_size || block_size % scan_size)
+		return -EINVAL;
+
+	priv = calloc(1, sizeof(*priv));
+	if (!priv)
+		return -ENOMEM;
+
+	buf = calloc(nb_blocks, block_size);
+	if (!buf) {
+		free(priv);
+		return -ENOMEM;
+	}
+
+	ret = no_os_cb_cfg(&priv->cb, buf, nb_blocks * block_size);
+	if (NO_OS_IS_ERR_VALUE(ret)) {
+		free(buf);
+		free(priv);
+		return ret;
+	}
+
+	priv->public.active_mask = mask;
+	priv->public.size = nb_blocks * block_size;
+	priv->public.nb_blocks = nb_blocks;
+	priv->public.block_size = block_size;
+	priv->public.bytes_per_scan = scan_size;
+	priv->public.dir = dir;
+	priv->public.buf = &priv->cb;
+	priv->nb_blocks = nb_blocks;
+	priv->initalized = true;
+	priv->allocated = true;
+
+	*buffer = &priv->public;
+
+	return 0;
+}
+
+/**
+ * @brief Free a buffer allocated with iio_buffer_alloc().
+ * @param buffer - IIO buffer.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_free(struct iio_buffer *buffer)
+{
+	struct iio_buffer_priv *priv;
+
+	if (!buffer)
+		return -EINVAL;
+
+	priv = (struct iio_buffer_priv *)buffer;
+	free(priv->cb.buff);
+	free(priv);
+
+	return 0;
+}
+
 /* Write to buffer iio_buffer.bytes_per_scan bytes from data */
 int iio_buffer_push_scan(struct iio_buffer *buffer, void *data)
 {
@@ -1061,18 +1679,189 @@ static int32_t accept_network_clients(struct iio_desc *desc)
 		data.conn = sock;
 		data.buf = calloc(1, IIOD_CONN_BUFFER_SIZE);
 		data.len = IIOD_CONN_BUFFER_SIZE;
+		data.nonblocking_recv = true;
+		if (!data.buf) {
+			socket_remove(sock);
+			return -ENOMEM;
+		}
 
 		ret = iiod_conn_add(desc->iiod, &data, &id);
-		if (NO_OS_IS_ERR_VALUE(ret))
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			socket_remove(sock);
+			free(data.buf);
 			return ret;
+		}
+
+#ifdef IIO_EPOLL_EVENT_LOOP
+		struct epoll_event ev = {
+			.events = EPOLLIN | EPOLLRDHUP,
+			.data.u32 = id
+		};
 
+		ret = epoll_ctl(desc->epoll_fd, EPOLL_CTL_ADD,
+				socket_get_id(sock), &ev);
+		if (ret < 0) {
+			ret = -errno;
+		} else {
+			desc->conn_fds[id] = socket_get_id(sock);
+			desc->out_conns &= ~NO_OS_BIT(id);
+			/* Run it once in case data arrived before it was added */
+			desc->busy_conns |= NO_OS_BIT(id);
+		}
+#else
 		ret = _push_conn(desc, id);
+#endif
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 	} while (true);
 
 	return 0;
 }
+
+/* Free the resources of a network connection */
+static void remove_network_client(struct iio_desc *desc, uint32_t conn_id)
+{
+	struct iiod_conn_data data;
+
+	iiod_conn_remove(desc->iiod, conn_id, &data);
+#ifdef IIO_EPOLL_EVENT_LOOP
+	epoll_ctl(desc->epoll_fd, EPOLL_CTL_DEL, socket_get_id(data.conn),
+		  NULL);
+	desc->busy_conns &= ~NO_OS_BIT(conn_id);
+	desc->polled_conns &= ~NO_OS_BIT(conn_id);
+	desc->out_conns &= ~NO_OS_BIT(conn_id);
+#endif
+	socket_remove(data.conn);
+	free(data.buf);
+}
+#endif
+
+#ifdef IIO_EPOLL_EVENT_LOOP
+/* Watch the socket of a connection for EPOLLOUT if out is set, else EPOLLIN */
+static int iio_epoll_watch(struct iio_desc *desc, uint32_t id, bool out)
+{
+	struct epoll_event ev = {
+		.events = (out ? EPOLLOUT : EPOLLIN) | EPOLLRDHUP,
+		.data.u32 = id
+	};
+	int ret;
+
+	if (!!(desc->out_conns & NO_OS_BIT(id)) == out)
+		return 0;
+
+	ret = epoll_ctl(desc->epoll_fd, EPOLL_CTL_MOD, desc->conn_fds[id], &ev);
+	if (ret < 0)
+		return -errno;
+
+	if (out)
+		desc->out_conns |= NO_OS_BIT(id);
+	else
+		desc->out_conns &= ~NO_OS_BIT(id);
+
+	return 0;
+}
+
+/* True if an open buffer can only be polled for its device data */
+static bool iio_epoll_needs_polling(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->nb_devs; i++)
+		if (desc->devs[i].buffer.public.active_mask &&
+		    !desc->devs[i].buffer.notifies)
+			return true;
+
+	return false;
+}
+
+/**
+ * @brief Wait for activity on the sockets and serve the ready connections.
+ * Each ready connection is run until it would block. Connections waiting for
+ * data from the client or for room in the socket don't use any CPU time.
+ * Connections waiting for device data are run again when a device calls
+ * iio_buffer_notify(), or every IIO_EPOLL_POLL_MS if a device never does.
+ * @param desc - IIO descriptor
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_epoll_step(struct iio_desc *desc)
+{
+	struct epoll_event events[IIOD_MAX_CONNECTIONS + 2];
+	bool send_blocked;
+	uint64_t count;
+	uint32_t ready;
+	bool polling;
+	uint32_t id;
+	int32_t ret;
+	int nb_events;
+	int timeout;
+	int i;
+
+	polling = desc->polled_conns && iio_epoll_needs_polling(desc);
+	if (desc->busy_conns)
+		timeout = 0;
+	else if (polling)
+		timeout = IIO_EPOLL_POLL_MS;
+	else
+		timeout = IIO_EPOLL_TIMEOUT_MS;
+
+	nb_events = epoll_wait(desc->epoll_fd, events, NO_OS_ARRAY_SIZE(events),
+			       timeout);
+	if (nb_events < 0)
+		return errno == EINTR ? -EAGAIN : -errno;
+
+	ready = desc->busy_conns;
+	/* A missed notification only delays the device data */
+	if (polling || !nb_events)
+		ready |= desc->polled_conns;
+	for (i = 0; i < nb_events; i++) {
+		id = events[i].data.u32;
+		if (id == IIO_EPOLL_WAKE_ID) {
+			/* Reset the eventfd counter */
+			if (read(desc->wake_fd, &count, sizeof(count)) < 0 &&
+			    errno != EAGAIN)
+				return -errno;
+			ready |= desc->polled_conns;
+		} else if (id == IIO_EPOLL_SERVER_ID) {
+			ret = accept_network_clients(desc);
+			if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+				return ret;
+			ready |= desc->busy_conns;
+		} else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+			remove_network_client(desc, id);
+			ready &= ~NO_OS_BIT(id);
+		} else {
+			ready |= NO_OS_BIT(id);
+		}
+	}
+
+	for (id = 0; ready; id++, ready >>= 1) {
+		if (!(ready & 1))
+			continue;
+
+		do {
+			ret = iiod_conn_step(desc->iiod, id);
+		} while (ret == 0);
+
+		/* -ENOTCONN, -EPIPE, -ECONNRESET... end the connection */
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN) {
+			remove_network_client(desc, id);
+			continue;
+		}
+
+		desc->busy_conns &= ~NO_OS_BIT(id);
+		desc->polled_conns &= ~NO_OS_BIT(id);
+
+		send_blocked = iiod_conn_send_blocked(desc->iiod, id);
+		ret = iio_epoll_watch(desc, id, send_blocked);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		if (!send_blocked && !iiod_conn_needs_input(desc->iiod, id))
+			desc->polled_conns |= NO_OS_BIT(id);
+	}
+
+	return 0;
+}
 #endif
 
 /**
@@ -1082,10 +1871,14 @@ static int32_t accept_network_clients(struct iio_desc *desc)
  */
 int iio_step(struct iio_desc *desc)
 {
-	struct iiod_conn_data data;
 	uint32_t conn_id;
 	int32_t ret;
 
+#ifdef IIO_EPOLL_EVENT_LOOP
+	if (desc->server)
+		return iio_epoll_step(desc);
+#endif
+
 #ifdef ENABLE_IIO_NETWORK
 	if (desc->server) {
 		ret = accept_network_clients(desc);
@@ -1101,11 +1894,8 @@ int iio_step(struct iio_desc *desc)
 	ret = iiod_conn_step(desc->iiod, conn_id);
 	if (ret == -ENOTCONN) {
 #ifdef ENABLE_IIO_NETWORK
-		if (desc->server) {
-			iiod_conn_remove(desc->iiod, conn_id, &data);
-			socket_remove(data.conn);
-			free(data.buf);
-		}
+		if (desc->server)
+			remove_network_client(desc, conn_id);
 #endif
 	} else {
 		_push_conn(desc, conn_id);
@@ -1119,10 +1909,10 @@ int iio_step(struct iio_desc *desc)
  * Will return the size of the xml.
  * If buff_size is 0, no data will be written to buff, but size will be returned
  */
-static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
-					char *id, char *buff,
+static uint32_t iio_generate_device_xml(struct iio_dev_priv *dev, char *buff,
 					uint32_t buff_size)
 {
+	struct iio_device	*device = dev->dev_descriptor;
 	struct iio_channel	*ch;
 	struct iio_attribute	*attr;
 	char			ch_id[50];
@@ -1142,16 +1932,15 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 
 	i = 0;
 	i += snprintf(buff, no_os_max(n - i, 0),
-		      "<device id=\"%s\" name=\"%s\">", id, name);
+		      "<device id=\"%s\" name=\"%s\">", dev->dev_id, dev->name);
 
 	/* Write channels */
 	if (device->channels)
 		for (j = 0; j < device->num_ch; j++) {
 			ch = &device->channels[j];
-			_print_ch_id(ch_id, ch);
 			i += snprintf(buff + i, no_os_max(n - i, 0),
 				      "<channel id=\"%s\"",
-				      ch_id);
+				      dev->ch_ids[j]);
 			if(ch->name)
 				i += snprintf(buff + i, no_os_max(n - i, 0),
 					      " name=\"%s\"",
@@ -1294,9 +2083,7 @@ static int32_t iio_init_xml(struct iio_desc *desc)
 	size = sizeof(header) + sizeof(header_end) - 2;
 	for (i = 0; i < desc->nb_devs; i++) {
 		dev = desc->devs + i;
-		size += iio_generate_device_xml(dev->dev_descriptor,
-						(char *)dev->name,
-						dev->dev_id, NULL, -1);
+		size += iio_generate_device_xml(dev, NULL, -1);
 	}
 
 	desc->xml_desc = (char *)calloc(size + 1, sizeof(*desc->xml_desc));
@@ -1309,9 +2096,8 @@ static int32_t iio_init_xml(struct iio_desc *desc)
 	of = sizeof(header) - 1;
 	for (i = 0; i < desc->nb_devs; i++) {
 		dev = desc->devs + i;
-		of += iio_generate_device_xml(dev->dev_descriptor,
-					      (char *)dev->name, dev->dev_id,
-					      desc->xml_desc + of, size - of);
+		of += iio_generate_device_xml(dev, desc->xml_desc + of,
+					      size - of);
 	}
 
 	strcpy(desc->xml_desc + of, header_end);
@@ -1319,6 +2105,90 @@ static int32_t iio_init_xml(struct iio_desc *desc)
 	return 0;
 }
 
+/**
+ * @brief Format the channel ids of a device and build the hash table used to
+ * look up its channels and attributes by name.
+ * @param dev - Device.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_init_dev_lookup(struct iio_dev_priv *dev)
+{
+	struct iio_device *device = dev->dev_descriptor;
+	struct iio_channel *ch;
+	uint32_t i, cnt, ids_len;
+	char *ids;
+	int len;
+
+	cnt = iio_get_nb_attrs(device->attributes) +
+	      iio_get_nb_attrs(device->debug_attributes) +
+	      iio_get_nb_attrs(device->buffer_attributes);
+
+	ids_len = 0;
+	if (device->channels)
+		for (i = 0; i < device->num_ch; i++) {
+			ch = &device->channels[i];
+			len = _print_ch_id(NULL, 0, ch);
+			if (len < 0)
+				return -EINVAL;
+			ids_len += len + 1;
+			cnt += 1 + iio_get_nb_attrs(ch->attributes);
+		}
+
+	/* Keep the load factor under 1/2 */
+	dev->lookup_size = 1;
+	while (dev->lookup_size < 2 * cnt + 1)
+		dev->lookup_size <<= 1;
+	dev->lookup = calloc(dev->lookup_size, sizeof(*dev->lookup));
+	if (!dev->lookup)
+		return -ENOMEM;
+
+	if (device->channels && device->num_ch) {
+		/* The pointers and the strings are allocated together */
+		dev->ch_ids = calloc(1, device->num_ch * sizeof(char *) +
+				     ids_len);
+		if (!dev->ch_ids) {
+			free(dev->lookup);
+			dev->lookup = NULL;
+			dev->lookup_size = 0;
+			return -ENOMEM;
+		}
+
+		ids = (char *)(dev->ch_ids + device->num_ch);
+		for (i = 0; i < device->num_ch; i++) {
+			ch = &device->channels[i];
+			dev->ch_ids[i] = ids;
+			len = _print_ch_id(NULL, 0, ch) + 1;
+			_print_ch_id(ids, len, ch);
+			ids += len;
+			iio_lookup_add(dev, &iio_ch_scope[ch->ch_out],
+				       dev->ch_ids[i], ch);
+			iio_lookup_add_attrs(dev, ch->attributes);
+		}
+	}
+
+	iio_lookup_add_attrs(dev, device->attributes);
+	iio_lookup_add_attrs(dev, device->debug_attributes);
+	iio_lookup_add_attrs(dev, device->buffer_attributes);
+
+	return 0;
+}
+
+/* Free the devices and their lookup tables */
+static void iio_free_devs(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->devs)
+		return;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		free(desc->devs[i].ch_ids);
+		free(desc->devs[i].lookup);
+	}
+	free(desc->devs);
+	desc->devs = NULL;
+}
+
 static int32_t iio_init_devs(struct iio_desc *desc,
 			     struct iio_device_init *devs, uint32_t n)
 {
@@ -1347,16 +2217,26 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 		    ndev->dev_descriptor->submit) {
 			ldev->buffer.raw_buf = ndev->raw_buf;
 			ldev->buffer.raw_buf_len = ndev->raw_buf_len;
+			ldev->buffer.nb_blocks = 1;
 			ldev->buffer.public.buf = &ldev->buffer.cb;
+			ldev->buffer.wake_fd = &desc->wake_fd;
 			ldev->buffer.initalized = 1;
 		} else {
 			ldev->buffer.initalized = 0;
 		}
+		ret = iio_init_dev_lookup(ldev);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_devs;
 	}
 
 	ret = iio_init_xml(desc);
 	if (NO_OS_IS_ERR_VALUE(ret))
-		free(desc->devs);
+		goto free_devs;
+
+	return 0;
+
+free_devs:
+	iio_free_devs(desc);
 
 	return ret;
 }
@@ -1382,6 +2262,7 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ldesc = (struct iio_desc *)calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return -ENOMEM;
+	ldesc->wake_fd = -1;
 
 	ret = iio_init_devs(ldesc, init_param->devs, init_param->nb_devs);
 	if (NO_OS_IS_ERR_VALUE(ret))
@@ -1392,11 +2273,14 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ops->read_attr = iio_read_attr;
 	ops->write_attr = iio_write_attr;
 	ops->read_buffer = iio_read_buffer;
+	ops->get_read_block = iio_get_read_block;
+	ops->read_block_done = iio_read_block_done;
 	ops->write_buffer = iio_write_buffer;
 	ops->refill_buffer = iio_refill_buffer;
 	ops->push_buffer = iio_push_buffer;
 	ops->open = iio_open_dev;
 	ops->close = iio_close_dev;
+	ops->set_buffers_count = iio_set_buffers_count;
 	ops->send = iio_send;
 	ops->recv = iio_recv;
 
@@ -1443,6 +2327,38 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_listen(ldesc->server, MAX_BACKLOG);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_pylink;
+#ifdef IIO_EPOLL_EVENT_LOOP
+		struct epoll_event ev = {
+			.events = EPOLLIN,
+			.data.u32 = IIO_EPOLL_SERVER_ID
+		};
+
+		ldesc->epoll_fd = epoll_create1(0);
+		if (ldesc->epoll_fd < 0) {
+			ret = -errno;
+			goto free_pylink;
+		}
+		ret = epoll_ctl(ldesc->epoll_fd, EPOLL_CTL_ADD,
+				socket_get_id(ldesc->server), &ev);
+		if (ret < 0) {
+			ret = -errno;
+			goto free_epoll;
+		}
+
+		ldesc->wake_fd = eventfd(0, EFD_NONBLOCK);
+		if (ldesc->wake_fd < 0) {
+			ret = -errno;
+			goto free_epoll;
+		}
+		ev.data.u32 = IIO_EPOLL_WAKE_ID;
+		ret = epoll_ctl(ldesc->epoll_fd, EPOLL_CTL_ADD, ldesc->wake_fd,
+				&ev);
+		if (ret < 0) {
+			ret = -errno;
+			close(ldesc->wake_fd);
+			goto free_epoll;
+		}
+#endif
 	}
 #endif
 	else {
@@ -1454,6 +2370,10 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 
 	return 0;
 
+#ifdef IIO_EPOLL_EVENT_LOOP
+free_epoll:
+	close(ldesc->epoll_fd);
+#endif
 free_pylink:
 #ifdef ENABLE_IIO_NETWORK
 	socket_remove(ldesc->server);
@@ -1463,7 +2383,7 @@ free_conns:
 free_iiod:
 	iiod_remove(ldesc->iiod);
 free_devs:
-	free(ldesc->devs);
+	iio_free_devs(ldesc);
 	free(ldesc->xml_desc);
 free_desc:
 	free(ldesc);
@@ -1478,15 +2398,33 @@ free_desc:
  */
 int iio_remove(struct iio_desc *desc)
 {
+#ifdef ENABLE_IIO_NETWORK
+	struct iiod_conn_data data;
+#endif
+
 	if (!desc)
 		return -EINVAL;
 
 #ifdef ENABLE_IIO_NETWORK
+	if (desc->server) {
+		uint32_t i;
+
+		/* Close the clients still connected */
+		for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+			if (iiod_conn_remove(desc->iiod, i, &data) == 0) {
+				socket_remove(data.conn);
+				free(data.buf);
+			}
+#ifdef IIO_EPOLL_EVENT_LOOP
+		close(desc->wake_fd);
+		close(desc->epoll_fd);
+#endif
+	}
 	socket_remove(desc->server);
 #endif
 	no_os_cb_remove(desc->conns);
 	iiod_remove(desc->iiod);
-	free(desc->devs);
+	iio_free_devs(desc);
 	free(desc->xml_desc);
 	free(desc);
 
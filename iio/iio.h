@@ -108,11 +108,28 @@ int iio_format_value(char *buf, uint32_t len, enum iio_val fmt,
 		     int32_t size, int32_t *vals);
 
 /* DMA buffer functions. */
-/* Get buffer addr where to write iio_buffer.size bytes */
+/* Get buffer addr where to write iio_buffer.block_size bytes */
 int iio_buffer_get_block(struct iio_buffer *buffer, void **addr);
 /* To be called to mark last iio_buffer_read as done */
 int iio_buffer_block_done(struct iio_buffer *buffer);
 
+/* DMA block queue functions. To keep iio_buffer.nb_blocks transfers in flight */
+/* Get addr of the next free block of iio_buffer.block_size bytes */
+int iio_buffer_queue_block(struct iio_buffer *buffer, void **addr);
+/* Mark the oldest queued block as done */
+int iio_buffer_dequeue_block(struct iio_buffer *buffer);
+/* Wake iio_step when the device has new data or room in the buffer */
+int iio_buffer_notify(struct iio_buffer *buffer);
+
+/* Buffers used outside of iiod, to call the device buffer callbacks */
+/* Allocate a buffer of nb_blocks blocks of block_size bytes */
+int iio_buffer_alloc(struct iio_buffer **buffer,
+		     struct iio_device *dev_descriptor, uint32_t mask,
+		     uint32_t block_size, uint32_t nb_blocks,
+		     enum iio_buffer_direction dir);
+/* Free a buffer allocated with iio_buffer_alloc() */
+int iio_buffer_free(struct iio_buffer *buffer);
+
 /* Trigger buffer functions. */
 /* Write to buffer iio_buffer.bytes_per_scan bytes from data */
 int iio_buffer_push_scan(struct iio_buffer *buffer, void *data);
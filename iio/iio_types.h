@@ -73,7 +73,9 @@ enum iio_chan_type {
 	IIO_ALTVOLTAGE,
 	IIO_ANGL_VEL,
 	IIO_TEMP,
-	IIO_CAPACITANCE
+	IIO_CAPACITANCE,
+	IIO_ACCEL,
+	IIO_TIMESTAMP
 };
 
 /**
@@ -197,6 +199,10 @@ struct iio_buffer {
 	uint32_t active_mask;
 	/* Size in bytes */
 	uint32_t size;
+	/* Number of blocks the buffer is split in (BUFFERS_COUNT) */
+	uint32_t nb_blocks;
+	/* Size in bytes of a block. size = block_size * nb_blocks */
+	uint32_t block_size;
 	/* Number of bytes per sample * number of active channels */
 	uint32_t bytes_per_scan;
 	/* Buffer direction */
@@ -244,7 +250,15 @@ struct iio_device {
 	int32_t (*pre_enable)(void *dev, uint32_t mask);
 	/** Called after disabling buffer */
 	int32_t (*post_disable)(void *dev);
-	/** Called when buffer ready to transfer. Write/read to/from dev */
+	/**
+	 * Called when buffer ready to transfer. Write/read to/from dev.
+	 * If buffer->nb_blocks > 1 it is also called each time data is
+	 * needed or was consumed. It must not block in this case: it should
+	 * complete the finished blocks with iio_buffer_dequeue_block() and
+	 * start transfers on the ones returned by iio_buffer_queue_block().
+	 * It may return -EAGAIN if the device has no data yet, iiod then
+	 * calls it again later.
+	 */
 	int32_t	(*submit)(struct iio_device_data *dev);
 
 	/* Read device register */
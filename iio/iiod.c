@@ -76,7 +76,8 @@ static struct iiod_str cmds[] = {
 	[IIOD_CMD_WRITEBUF]	= IIOD_STR("WRITEBUF"),
 	[IIOD_CMD_GETTRIG]	= IIOD_STR("GETTRIG"),
 	[IIOD_CMD_SETTRIG]	= IIOD_STR("SETTRIG"),
-	[IIOD_CMD_SET]		= IIOD_STR("SET")
+	[IIOD_CMD_SET]		= IIOD_STR("SET"),
+	[IIOD_CMD_BINARY]	= IIOD_STR("BINARY")
 };
 static const uint32_t priority_array[] = {
 	/* Order not tested, just personal expectation. Function can
@@ -94,7 +95,8 @@ static const uint32_t priority_array[] = {
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
 	IIOD_CMD_HELP,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
 };
 
 static_assert(NO_OS_ARRAY_SIZE(cmds) == NO_OS_ARRAY_SIZE(priority_array),
@@ -247,6 +249,7 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 	case IIOD_CMD_EXIT:
 	case IIOD_CMD_PRINT:
 	case IIOD_CMD_VERSION:
+	case IIOD_CMD_BINARY:
 		return 0;
 	case IIOD_CMD_TIMEOUT:
 		return parse_num(token, &res->timeout, 10);
@@ -276,7 +279,7 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 
 		return 0;
 	case IIOD_CMD_SET:
-		return iiod_parse_set(buf, res, ctx);
+		return iiod_parse_set(token, res, ctx);
 	default:
 		break;
 	}
@@ -347,6 +350,11 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 					       dummy_close);
 	ops->push_buffer = SET_DUMMY_IF_NULL(new_ops->push_buffer,
 					     dummy_close);
+	/* Optional. read_buffer is used if not set */
+	if (new_ops->get_read_block && new_ops->read_block_done) {
+		ops->get_read_block = new_ops->get_read_block;
+		ops->read_block_done = new_ops->read_block_done;
+	}
 
 	return 0;
 }
@@ -393,7 +401,7 @@ static void conn_clean_state(struct iiod_conn_priv *conn)
 	conn->res.buf.buf = NULL;
 	conn->res.buf.idx = 0;
 	conn->parser_idx = 0;
-	conn->state = IIOD_READING_LINE;
+	conn->state = conn->binary ? IIOD_BIN_READING_CMD : IIOD_READING_LINE;
 }
 
 int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
@@ -418,6 +426,7 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 			 */
 			conn->payload_buf = data->buf;
 			conn->payload_buf_len = data->len;
+			conn->nonblocking_recv = data->nonblocking_recv;
 			*new_conn_id = i;
 
 			return 0;
@@ -429,7 +438,7 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data)
 {
-	if (!desc || conn_id > IIOD_MAX_CONNECTIONS ||
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
 	    !desc->conns[conn_id].used)
 		return -EINVAL;
 	struct iiod_conn_priv *conn;
@@ -437,6 +446,7 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 	data->conn = conn->conn;
 	data->len = conn->payload_buf_len;
 	data->buf = conn->payload_buf;
+	data->nonblocking_recv = conn->nonblocking_recv;
 	conn->used = 0;
 
 	return 0;
@@ -459,7 +469,7 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 		return ops->set_trigger(ctx, data->device, data->trigger,
 					strlen(data->trigger));
 	case IIOD_CMD_SET:
-		break;
+		return ops->set_buffers_count(ctx, data->device, data->count);
 	default:
 		break;
 	}
@@ -467,6 +477,54 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 	return -EINVAL;
 }
 
+/*
+ * Receive at most len bytes from a connection. Data received in bulk by
+ * previous calls is returned first.
+ */
+static int32_t iiod_recv(struct iiod_desc *desc, struct iiod_conn_priv *conn,
+			 uint8_t *buf, uint32_t len)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	int32_t ret;
+
+	if (conn->rx_idx == conn->rx_len) {
+		/* Small reads are done in rx_buf to get the whole command */
+		if (!conn->nonblocking_recv || len >= IIOD_RX_BUF_SIZE)
+			return desc->ops.recv(&ctx, buf, len);
+
+		ret = desc->ops.recv(&ctx, (uint8_t *)conn->rx_buf,
+				     IIOD_RX_BUF_SIZE);
+		if (NO_OS_IS_ERR_VALUE(ret) || ret == 0)
+			return ret;
+
+		conn->rx_idx = 0;
+		conn->rx_len = ret;
+	}
+
+	len = no_os_min(len, conn->rx_len - conn->rx_idx);
+	memcpy(buf, conn->rx_buf + conn->rx_idx, len);
+	conn->rx_idx += len;
+
+	return len;
+}
+
+/*
+ * Send at most len bytes on a connection and remember if it could not take
+ * all of them, so the caller knows to wait until the socket is writable.
+ */
+static int32_t iiod_send(struct iiod_desc *desc, struct iiod_conn_priv *conn,
+			 uint8_t *buf, uint32_t len)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	int32_t ret;
+
+	ret = desc->ops.send(&ctx, buf, len);
+	conn->send_blocked = ret == -EAGAIN ||
+			     (!NO_OS_IS_ERR_VALUE(ret) && (uint32_t)ret < len);
+
+	return ret;
+}
+
 /*
  * Unload data from buf without blocking.
  * When done will return 0, if there is still data to be sent it will return
@@ -475,7 +533,6 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 			    struct iiod_buff *buf, uint8_t flags)
 {
-	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
 	uint8_t *tmp_buf;
 	int32_t ret;
 	int32_t len;
@@ -484,9 +541,9 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 	if (len) {
 		tmp_buf = (uint8_t *)buf->buf + buf->idx;
 		if (flags & IIOD_WR)
-			ret = desc->ops.send(&ctx, tmp_buf, len);
+			ret = iiod_send(desc, conn, tmp_buf, len);
 		else
-			ret = desc->ops.recv(&ctx, tmp_buf, len);
+			ret = iiod_recv(desc, conn, tmp_buf, len);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
@@ -496,7 +553,7 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 	}
 
 	if (flags & IIOD_ENDL) {
-		ret = desc->ops.send(&ctx, (uint8_t *)"\n", 1);
+		ret = iiod_send(desc, conn, (uint8_t *)"\n", 1);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
@@ -513,12 +570,20 @@ static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
 	int32_t ret, len;
 
 	if (conn->nb_buf.len == 0) {
-		conn->nb_buf.buf = conn->payload_buf;
-		len = no_os_min(conn->payload_buf_len,
-				conn->cmd_data.bytes_count);
-		/* Read from dev */
-		ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
-					    conn->nb_buf.buf, len);
+		if (desc->ops.get_read_block) {
+			/* Send directly from the device buffer */
+			ret = desc->ops.get_read_block(&ctx,
+						       conn->cmd_data.device,
+						       &conn->nb_buf.buf,
+						       conn->cmd_data.bytes_count);
+		} else {
+			conn->nb_buf.buf = conn->payload_buf;
+			len = no_os_min(conn->payload_buf_len,
+					conn->cmd_data.bytes_count);
+			/* Read from dev */
+			ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
+						    conn->nb_buf.buf, len);
+		}
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 		len = ret;
@@ -531,6 +596,13 @@ static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
+		if (desc->ops.get_read_block) {
+			ret = desc->ops.read_block_done(&ctx,
+							conn->cmd_data.device);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+
 		conn->cmd_data.bytes_count -= conn->nb_buf.len;
 		conn->nb_buf.len = 0;
 		if (conn->cmd_data.bytes_count)
@@ -612,6 +684,20 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 		conn->res.buf.buf = IIOD_VERSION;
 		conn->res.buf.len = IIOD_VERSION_LEN;
 		break;
+	case IIOD_CMD_BINARY:
+#ifdef IIOD_ENABLE_BINARY
+		/* Next commands will use the binary protocol */
+		conn->binary = 1;
+		conn->res.val = 0;
+#else
+		/*
+		 * Buffers are not served over the binary protocol yet. A
+		 * refused BINARY keeps libiio clients on the text protocol.
+		 */
+		conn->res.val = -ENOSYS;
+#endif
+		conn->res.write_val = 1;
+		break;
 	case IIOD_CMD_READ:
 	case IIOD_CMD_GETTRIG:
 		if (data->cmd == IIOD_CMD_READ)
@@ -630,6 +716,12 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 		}
 		break;
 	case IIOD_CMD_WRITE:
+		/* Data that didn't fit in payload_buf was discarded */
+		if (data->bytes_count >= conn->payload_buf_len) {
+			conn->res.val = -EFBIG;
+			conn->res.write_val = 1;
+			break;
+		}
 		conn->payload_buf[data->bytes_count] = '\0';
 		ret = desc->ops.write_attr(&ctx, data->device, &attr,
 					   conn->payload_buf,
@@ -641,6 +733,9 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	case IIOD_CMD_READBUF:
 		conn->res.write_val = 1;
 		ret = desc->ops.refill_buffer(&ctx, data->device);
+		if (ret == -EAGAIN)
+			/* No data yet, the command is run again on next step */
+			return ret;
 		if (NO_OS_IS_ERR_VALUE(ret)) {
 			conn->res.val = ret;
 			break;
@@ -664,16 +759,12 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 static int32_t iiod_read_line(struct iiod_desc *desc,
 			      struct iiod_conn_priv *conn)
 {
-	struct iiod_ctx ctx = {
-		.instance = desc->app_instance,
-		.conn = conn->conn
-	};
 	int32_t ret;
 	char *ch;
 
 	while (conn->parser_idx < IIOD_PARSER_MAX_BUF_SIZE - 1) {
 		ch = conn->parser_buf + conn->parser_idx;
-		ret = desc->ops.recv(&ctx,(uint8_t *)ch, 1);
+		ret = iiod_recv(desc, conn, (uint8_t *)ch, 1);
 		if (ret == -EAGAIN || ret == 0)
 			return -EAGAIN;
 
@@ -697,6 +788,168 @@ end:
 	return ret;
 }
 
+/* Return true if a length and data follow the binary command header */
+static bool iiod_bin_has_data(uint8_t op)
+{
+	switch (op) {
+	case IIOD_OP_WRITE_ATTR:
+	case IIOD_OP_WRITE_DBG_ATTR:
+	case IIOD_OP_WRITE_BUF_ATTR:
+	case IIOD_OP_WRITE_CHN_ATTR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Execute a binary command and prepare the response. No I/O */
+static void iiod_bin_run_cmd(struct iiod_desc *desc,
+			     struct iiod_conn_priv *conn)
+{
+	static const enum iio_attr_type attr_types[] = {
+		[IIOD_OP_READ_ATTR] = IIO_ATTR_TYPE_DEVICE,
+		[IIOD_OP_READ_DBG_ATTR] = IIO_ATTR_TYPE_DEBUG,
+		[IIOD_OP_READ_BUF_ATTR] = IIO_ATTR_TYPE_BUFFER,
+		[IIOD_OP_READ_CHN_ATTR] = IIO_ATTR_TYPE_CH_IN,
+		[IIOD_OP_WRITE_ATTR] = IIO_ATTR_TYPE_DEVICE,
+		[IIOD_OP_WRITE_DBG_ATTR] = IIO_ATTR_TYPE_DEBUG,
+		[IIOD_OP_WRITE_BUF_ATTR] = IIO_ATTR_TYPE_BUFFER,
+		[IIOD_OP_WRITE_CHN_ATTR] = IIO_ATTR_TYPE_CH_IN,
+	};
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_bin_cmd *cmd = &conn->bin_cmd;
+	struct iiod_attr attr = {0};
+	char trig[sizeof(conn->bin_dev)];
+	uint32_t len;
+	int32_t ret;
+
+	snprintf(conn->bin_dev, sizeof(conn->bin_dev), "iio:device%"PRIu8,
+		 cmd->dev);
+
+	switch (cmd->op) {
+	case IIOD_OP_PRINT:
+		ret = desc->xml_len;
+		conn->res.buf.buf = desc->xml;
+		conn->res.buf.len = desc->xml_len;
+		break;
+	case IIOD_OP_TIMEOUT:
+		ret = desc->ops.set_timeout(&ctx, cmd->code);
+		break;
+	case IIOD_OP_READ_ATTR:
+	case IIOD_OP_READ_DBG_ATTR:
+	case IIOD_OP_READ_BUF_ATTR:
+	case IIOD_OP_READ_CHN_ATTR:
+		attr.type = attr_types[cmd->op];
+		attr.idx = cmd->code & 0xFFFF;
+		attr.ch_idx = (uint32_t)cmd->code >> 16;
+		ret = desc->ops.read_attr(&ctx, conn->bin_dev, &attr,
+					  conn->payload_buf,
+					  conn->payload_buf_len);
+		if (!NO_OS_IS_ERR_VALUE(ret)) {
+			conn->res.buf.buf = conn->payload_buf;
+			conn->res.buf.len = ret;
+		}
+		break;
+	case IIOD_OP_WRITE_ATTR:
+	case IIOD_OP_WRITE_DBG_ATTR:
+	case IIOD_OP_WRITE_BUF_ATTR:
+	case IIOD_OP_WRITE_CHN_ATTR:
+		/* Data that didn't fit in payload_buf was discarded */
+		if (conn->cmd_data.bytes_count >= conn->payload_buf_len) {
+			ret = -EFBIG;
+			break;
+		}
+		attr.type = attr_types[cmd->op];
+		attr.idx = cmd->code & 0xFFFF;
+		attr.ch_idx = (uint32_t)cmd->code >> 16;
+		conn->payload_buf[conn->cmd_data.bytes_count] = '\0';
+		ret = desc->ops.write_attr(&ctx, conn->bin_dev, &attr,
+					   conn->payload_buf,
+					   conn->cmd_data.bytes_count);
+		break;
+	case IIOD_OP_GETTRIG:
+		ret = desc->ops.get_trigger(&ctx, conn->bin_dev,
+					    conn->payload_buf,
+					    conn->payload_buf_len);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			break;
+		/* The trigger is sent as a device index */
+		len = no_os_min((uint32_t)ret, conn->payload_buf_len - 1);
+		conn->payload_buf[len] = '\0';
+		if (sscanf(conn->payload_buf, "iio:device%"SCNi32, &ret) != 1)
+			ret = -ENODEV;
+		break;
+	case IIOD_OP_SETTRIG:
+		if (cmd->code < 0)
+			trig[0] = '\0';
+		else
+			snprintf(trig, sizeof(trig), "iio:device%"PRIi32,
+				 cmd->code);
+		ret = desc->ops.set_trigger(&ctx, conn->bin_dev, trig,
+					    strlen(trig));
+		break;
+	default:
+		/* Buffer and event commands are not supported */
+		ret = -ENOSYS;
+		break;
+	}
+
+	conn->bin_res.client_id = cmd->client_id;
+	conn->bin_res.op = IIOD_OP_RESPONSE;
+	conn->bin_res.dev = cmd->dev;
+	conn->bin_res.code = ret;
+}
+
+/*
+ * Read the data of an attribute write in payload_buf. Data not fitting in
+ * payload_buf is read and discarded. Non blocking
+ */
+static int32_t iiod_read_write_data(struct iiod_desc *desc,
+				    struct iiod_conn_priv *conn)
+{
+	int32_t ret;
+
+	while (conn->data_left) {
+		if (conn->nb_buf.len == 0) {
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = no_os_min(conn->data_left,
+						     conn->payload_buf_len - 1);
+			conn->nb_buf.idx = 0;
+		}
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->data_left -= conn->nb_buf.len;
+		conn->cmd_data.bytes_count += conn->nb_buf.len;
+		memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+	}
+
+	return 0;
+}
+
+/* Read a fixed size field of a binary command. Non blocking */
+static int32_t iiod_bin_read(struct iiod_desc *desc,
+			     struct iiod_conn_priv *conn,
+			     void *field, uint32_t size)
+{
+	int32_t ret;
+
+	if (conn->nb_buf.len == 0) {
+		conn->nb_buf.buf = field;
+		conn->nb_buf.len = size;
+		conn->nb_buf.idx = 0;
+	}
+
+	ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+
+	return 0;
+}
+
 /*
  * Function will return SUCCESS when a state was processed.
  * If a state is still in processing state, it will return -EAGAIN.
@@ -729,9 +982,8 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 			conn->state = IIOD_WRITING_CMD_RESULT;
 		} else if (conn->cmd_data.cmd == IIOD_CMD_WRITE) {
 			/* Special case. Attribute needs to be read */
-			conn->nb_buf.buf = conn->payload_buf;
-			conn->nb_buf.len = conn->cmd_data.bytes_count;
-			conn->nb_buf.idx = 0;
+			conn->data_left = conn->cmd_data.bytes_count;
+			conn->cmd_data.bytes_count = 0;
 			conn->state = IIOD_READING_WRITE_DATA;
 		} else {
 			conn->state = IIOD_RUNNING_CMD;
@@ -817,12 +1069,72 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 		return 0;
 	case IIOD_READING_WRITE_DATA:
 		/* Read attribute */
-		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		ret = iiod_read_write_data(desc, conn);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
 		conn->state = IIOD_RUNNING_CMD;
 
+		return 0;
+	case IIOD_BIN_READING_CMD:
+		/* Read fixed size command header. I/O Calls */
+		ret = iiod_bin_read(desc, conn, &conn->bin_cmd,
+				    sizeof(conn->bin_cmd));
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		if (iiod_bin_has_data(conn->bin_cmd.op))
+			conn->state = IIOD_BIN_READING_LEN;
+		else
+			conn->state = IIOD_BIN_RUNNING_CMD;
+
+		return 0;
+	case IIOD_BIN_READING_LEN:
+		ret = iiod_bin_read(desc, conn, &conn->data_left,
+				    sizeof(conn->data_left));
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->cmd_data.bytes_count = 0;
+		conn->state = IIOD_BIN_READING_DATA;
+
+		return 0;
+	case IIOD_BIN_READING_DATA:
+		ret = iiod_read_write_data(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->state = IIOD_BIN_RUNNING_CMD;
+
+		return 0;
+	case IIOD_BIN_RUNNING_CMD:
+		/* Execute or call necessary ops depending on op. No I/O */
+		iiod_bin_run_cmd(desc, conn);
+		conn->state = IIOD_BIN_WRITING_RESULT;
+
+		return 0;
+	case IIOD_BIN_WRITING_RESULT:
+		/* Write response header. Non blocking */
+		if (conn->nb_buf.len == 0) {
+			conn->nb_buf.buf = (char *)&conn->bin_res;
+			conn->nb_buf.len = sizeof(conn->bin_res);
+			conn->nb_buf.idx = 0;
+		}
+		if (conn->nb_buf.idx < conn->nb_buf.len) {
+			ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_WR);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+		/* Send data of the response. Non blocking */
+		if (conn->res.buf.buf &&
+		    conn->res.buf.idx < conn->res.buf.len) {
+			ret = rw_iiod_buff(desc, conn, &conn->res.buf, IIOD_WR);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+
+		conn->state = IIOD_LINE_DONE;
+
 		return 0;
 	default:
 		/* Should never get here */
@@ -835,11 +1147,12 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 	struct iiod_conn_priv *conn;
 	int32_t ret;
 
-	if (!desc || conn_id > IIOD_MAX_CONNECTIONS ||
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
 	    !desc->conns[conn_id].used)
 		return -EINVAL;
 
 	conn = &desc->conns[conn_id];
+	conn->send_blocked = false;
 	do {
 		ret = iiod_run_state(desc, conn);
 		if (ret == -EAGAIN)
@@ -853,3 +1166,33 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 
 	return ret;
 }
+
+bool iiod_conn_needs_input(struct iiod_desc *desc, uint32_t conn_id)
+{
+	struct iiod_conn_priv *conn;
+
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
+	    !desc->conns[conn_id].used)
+		return false;
+
+	conn = &desc->conns[conn_id];
+	if (conn->rx_idx < conn->rx_len)
+		return false;
+
+	return conn->state == IIOD_READING_LINE ||
+	       conn->state == IIOD_READING_WRITE_DATA ||
+	       conn->state == IIOD_BIN_READING_CMD ||
+	       conn->state == IIOD_BIN_READING_LEN ||
+	       conn->state == IIOD_BIN_READING_DATA ||
+	       (conn->state == IIOD_RW_BUF &&
+		conn->cmd_data.cmd == IIOD_CMD_WRITEBUF);
+}
+
+bool iiod_conn_send_blocked(struct iiod_desc *desc, uint32_t conn_id)
+{
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
+	    !desc->conns[conn_id].used)
+		return false;
+
+	return desc->conns[conn_id].send_blocked;
+}
@@ -65,6 +65,13 @@ struct iiod_attr {
 	 */
 	const char *name;
 	const char *channel;
+	/*
+	 * Set by the binary protocol, where name and channel are NULL.
+	 * Index of the attribute, as ordered in the xml description.
+	 */
+	uint32_t idx;
+	/* Index of the channel, as ordered in the xml description */
+	uint32_t ch_idx;
 };
 
 struct iiod_ctx {
@@ -81,6 +88,11 @@ struct iiod_conn_data {
 	char *buf;
 	/* Size of the provided buffer. It must fit the max attribute size */
 	uint32_t len;
+	/*
+	 * Set if recv returns the data available without blocking. Commands
+	 * are then received in bulk instead of one byte at a time.
+	 */
+	bool nonblocking_recv;
 };
 
 /* Functions should return a negative error code on failure */
@@ -113,6 +125,16 @@ struct iiod_ops {
 	/* Read data from opened buffer */
 	int (*read_buffer)(struct iiod_ctx *ctx, const char *device, char *buf,
 			   uint32_t bytes);
+	/*
+	 * Optional zero copy alternative to read_buffer.
+	 * buf must be set to the address of at most bytes of data from the
+	 * opened buffer and the number of bytes available there returned.
+	 * read_block_done is called once they were sent.
+	 */
+	int (*get_read_block)(struct iiod_ctx *ctx, const char *device,
+			      char **buf, uint32_t bytes);
+	/* Called when the data from get_read_block was sent */
+	int (*read_block_done)(struct iiod_ctx *ctx, const char *device);
 	/* Called to notify that buffer must be refiiled */
 	int (*refill_buffer)(struct iiod_ctx *ctx, const char *device);
 
@@ -185,5 +207,15 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data);
 /* Advance in the state machine of a connection. Will not block */
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id);
+/*
+ * Return true if the connection can only advance after new data is received
+ * and false if iiod_conn_step must be called again without waiting for data.
+ */
+bool iiod_conn_needs_input(struct iiod_desc *desc, uint32_t conn_id);
+/*
+ * Return true if the last iiod_conn_step stopped because the connection could
+ * not take more data. It can only advance after the peer reads some of it.
+ */
+bool iiod_conn_send_blocked(struct iiod_desc *desc, uint32_t conn_id);
 
 #endif //IIOD_H
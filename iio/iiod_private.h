@@ -44,6 +44,7 @@
 #define IIOD_ENDL			0x2
 #define IIOD_RD				0x4
 #define IIOD_PARSER_MAX_BUF_SIZE	128
+#define IIOD_RX_BUF_SIZE		256
 
 #define IIOD_STR(cmd) {(cmd), sizeof(cmd) - 1}
 
@@ -75,7 +76,59 @@ enum iiod_cmd {
 	IIOD_CMD_WRITEBUF,
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
+};
+
+/*
+ * Opcodes of the binary protocol, in the order used by libiio.
+ * A client switches to it by sending the BINARY command, which is only
+ * accepted when built with IIOD_ENABLE_BINARY. Buffer, block and event
+ * opcodes are not implemented, so enable it only for contexts without
+ * buffers.
+ */
+enum iiod_bin_op {
+	IIOD_OP_RESPONSE,
+	IIOD_OP_PRINT,
+	IIOD_OP_TIMEOUT,
+	IIOD_OP_READ_ATTR,
+	IIOD_OP_READ_DBG_ATTR,
+	IIOD_OP_READ_BUF_ATTR,
+	IIOD_OP_READ_CHN_ATTR,
+	IIOD_OP_WRITE_ATTR,
+	IIOD_OP_WRITE_DBG_ATTR,
+	IIOD_OP_WRITE_BUF_ATTR,
+	IIOD_OP_WRITE_CHN_ATTR,
+	IIOD_OP_GETTRIG,
+	IIOD_OP_SETTRIG,
+	IIOD_OP_CREATE_BUFFER,
+	IIOD_OP_FREE_BUFFER,
+	IIOD_OP_ENABLE_BUFFER,
+	IIOD_OP_DISABLE_BUFFER,
+	IIOD_OP_CREATE_BLOCK,
+	IIOD_OP_FREE_BLOCK,
+	IIOD_OP_TRANSFER_BLOCK,
+	IIOD_OP_ENQUEUE_BLOCK_CYCLIC,
+	IIOD_OP_RETRY_DEQUEUE_BLOCK,
+	IIOD_OP_CREATE_EVSTREAM,
+	IIOD_OP_FREE_EVSTREAM,
+	IIOD_OP_READ_EVENT,
+	IIOD_NB_OPCODES
+};
+
+/*
+ * Header of each binary command and response. It is sent in the host byte
+ * order, as libiio does. Responses reuse the client_id of the command.
+ */
+struct iiod_bin_cmd {
+	/* Client side id used to match the response to the command */
+	uint16_t client_id;
+	/* enum iiod_bin_op */
+	uint8_t op;
+	/* Device index */
+	uint8_t dev;
+	/* Command argument or result of the command in responses */
+	int32_t code;
 };
 
 /*
@@ -137,13 +190,33 @@ struct iiod_conn_priv {
 		/* I/O operations for WRITE cmd */
 		IIOD_READING_WRITE_DATA,
 		/* Set when a operation is finalized */
-		IIOD_LINE_DONE
+		IIOD_LINE_DONE,
+		/* Reading the header of a binary command */
+		IIOD_BIN_READING_CMD,
+		/* Reading the length of the data of a binary command */
+		IIOD_BIN_READING_LEN,
+		/* Reading the data of a binary command */
+		IIOD_BIN_READING_DATA,
+		/* Execute binary cmd without I/O operations */
+		IIOD_BIN_RUNNING_CMD,
+		/* Write header and data of the binary response */
+		IIOD_BIN_WRITING_RESULT
 	} state;
 
 	/* Buffer to store received line */
 	char parser_buf[IIOD_PARSER_MAX_BUF_SIZE];
 	/* Index in parser_buf. For nonblocking operation */
 	uint32_t parser_idx;
+	/* Set if recv can be called for more bytes than needed */
+	bool nonblocking_recv;
+	/* Data received in bulk and not yet processed */
+	char rx_buf[IIOD_RX_BUF_SIZE];
+	/* Index of the first unprocessed byte in rx_buf */
+	uint32_t rx_idx;
+	/* Number of valid bytes in rx_buf */
+	uint32_t rx_len;
+	/* Set when the last send could not take all the data */
+	bool send_blocked;
 	/* Buffer to store raw data (attributes or buffer data).*/
 	char *payload_buf;
 	/* Length of payload_buf_len */
@@ -157,6 +230,17 @@ struct iiod_conn_priv {
 	char buf_mask[10];
 	/* Context for strtok_r function */
 	char *strtok_ctx;
+
+	/* Set after the BINARY command. Binary protocol is used from then on */
+	bool binary;
+	/* Binary command being processed */
+	struct iiod_bin_cmd bin_cmd;
+	/* Binary response header */
+	struct iiod_bin_cmd bin_res;
+	/* Bytes of attribute data still to be received */
+	uint64_t data_left;
+	/* Device id ("iio:deviceX") of the binary command */
+	char bin_dev[21];
 };
 
 /* Private iiod information */
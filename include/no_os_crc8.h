@@ -47,8 +47,33 @@
 #define NO_OS_DECLARE_CRC8_TABLE(_table) \
 	static uint8_t _table[NO_OS_CRC8_TABLE_SIZE]
 
+#define NO_OS_DECLARE_CRC8_SLICE4_TABLE(_table) \
+	static uint8_t _table[4][NO_OS_CRC8_TABLE_SIZE]
+
+/* Precomputed tables for x^8 + x^2 + x + 1, [0] is the byte-wise table. */
+extern const uint8_t no_os_crc8_poly_0x07[4][NO_OS_CRC8_TABLE_SIZE];
+
 void no_os_crc8_populate_msb(uint8_t * table, const uint8_t polynomial);
+void no_os_crc8_populate_slice4_msb(uint8_t table[][NO_OS_CRC8_TABLE_SIZE],
+				    const uint8_t polynomial);
 uint8_t no_os_crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 		   uint8_t crc);
+uint8_t no_os_crc8_slice4(const uint8_t table[][NO_OS_CRC8_TABLE_SIZE],
+			  const uint8_t *pdata, size_t nbytes, uint8_t crc);
+
+/***************************************************************************//**
+ * @brief Updates a CRC-8 with one byte, for data received one byte at a time.
+ *
+ * @param table - Pointer to a CRC-8 lookup table for the desired polynomial.
+ * @param crc   - The CRC-8 computed so far.
+ * @param data  - The next data byte.
+ *
+ * @return The updated CRC-8 value.
+*******************************************************************************/
+static inline uint8_t no_os_crc8_update(const uint8_t *table, uint8_t crc,
+					uint8_t data)
+{
+	return table[crc ^ data];
+}
 
 #endif // _NO_OS_CRC8_H_
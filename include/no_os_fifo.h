@@ -45,6 +45,8 @@
 
 #include <stdint.h>
 
+struct no_os_pool;
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -60,6 +62,12 @@ struct no_os_fifo_element {
 	char *data;
 	/** FIFO length */
 	uint32_t len;
+	/** Last FIFO element, only maintained in the first element */
+	struct no_os_fifo_element *last;
+	/** Pool the element was taken from, NULL if allocated on the heap */
+	struct no_os_pool *pool;
+	/** The element is provided by the user and not freed by the FIFO */
+	uint8_t user_owned;
 };
 
 /******************************************************************************/
@@ -70,6 +78,15 @@ struct no_os_fifo_element {
 int32_t no_os_fifo_insert(struct no_os_fifo_element **p_fifo, char *buff,
 			  uint32_t len);
 
+/* Insert element to fifo tail, allocating it from a pool if possible. */
+int32_t no_os_fifo_insert_pool(struct no_os_fifo_element **p_fifo,
+			       struct no_os_pool *pool, char *buff,
+			       uint32_t len);
+
+/* Insert an element provided by the user to fifo tail. */
+int32_t no_os_fifo_link(struct no_os_fifo_element **p_fifo,
+			struct no_os_fifo_element *elem);
+
 /* Remove fifo head. */
 struct no_os_fifo_element *no_os_fifo_remove(struct no_os_fifo_element *p_fifo);
 
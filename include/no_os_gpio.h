@@ -53,6 +53,9 @@
 #define NO_OS_GPIO_OUT	0x01
 #define NO_OS_GPIO_IN		0x00
 
+/* Maximum number of GPIOs in a group, one bit per GPIO in the group masks */
+#define NO_OS_GPIO_GROUP_MAX	32
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -108,6 +111,38 @@ typedef struct no_os_gpio_desc {
 	void		*extra;
 } no_os_gpio_desc;
 
+/**
+ * @struct no_os_gpio_group_init_param
+ * @brief Structure holding the parameters for GPIO group initialization.
+ */
+typedef struct no_os_gpio_group_init_param {
+	/** GPIO numbers, bit i of the group masks and values is numbers[i] */
+	const int32_t	*numbers;
+	/** Number of GPIOs in the group, up to NO_OS_GPIO_GROUP_MAX */
+	uint32_t	num_gpios;
+	/** Pull up/down resistor configuration, common to all the GPIOs */
+	enum no_os_gpio_pull_up pull;
+	/** GPIO platform specific functions */
+	const struct no_os_gpio_platform_ops *platform_ops;
+	/** GPIO extra parameters (device specific) */
+	void		*extra;
+} no_os_gpio_group_init_param;
+
+/**
+ * @struct no_os_gpio_group_desc
+ * @brief Structure holding the GPIO group descriptor.
+ */
+typedef struct no_os_gpio_group_desc {
+	/** Number of GPIOs in the group */
+	uint32_t	num_gpios;
+	/** GPIO platform specific functions */
+	const struct no_os_gpio_platform_ops *platform_ops;
+	/** Single GPIO descriptors, used when the platform has no group ops */
+	struct no_os_gpio_desc **gpios;
+	/** GPIO extra parameters (device specific) */
+	void		*extra;
+} no_os_gpio_group_desc;
+
 /**
  * @enum no_os_gpio_values
  * @brief Enum that holds the possible output states of a GPIO.
@@ -145,6 +180,23 @@ struct no_os_gpio_platform_ops {
 	int32_t (*gpio_ops_set_value)(struct no_os_gpio_desc *, uint8_t);
 	/** gpio get value function pointer */
 	int32_t (*gpio_ops_get_value)(struct no_os_gpio_desc *, uint8_t *);
+	/** gpio group initialization function pointer (optional) */
+	int32_t (*gpio_ops_group_get)(struct no_os_gpio_group_desc **,
+				      const struct no_os_gpio_group_init_param *);
+	/** gpio group remove function pointer */
+	int32_t (*gpio_ops_group_remove)(struct no_os_gpio_group_desc *);
+	/** gpio group direction input function pointer */
+	int32_t (*gpio_ops_group_direction_input)(struct no_os_gpio_group_desc *,
+			uint32_t);
+	/** gpio group direction output function pointer */
+	int32_t (*gpio_ops_group_direction_output)(struct no_os_gpio_group_desc *,
+			uint32_t, uint32_t);
+	/** gpio group set values function pointer */
+	int32_t (*gpio_ops_group_set_values)(struct no_os_gpio_group_desc *,
+					     uint32_t, uint32_t);
+	/** gpio group get values function pointer */
+	int32_t (*gpio_ops_group_get_values)(struct no_os_gpio_group_desc *,
+					     uint32_t, uint32_t *);
 };
 
 /******************************************************************************/
@@ -181,4 +233,27 @@ int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
 int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 			     uint8_t *value);
 
+/* Obtain a descriptor for a group of GPIOs. */
+int32_t no_os_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param);
+
+/* Free the resources allocated by no_os_gpio_group_get(). */
+int32_t no_os_gpio_group_remove(struct no_os_gpio_group_desc *desc);
+
+/* Enable the input direction of the selected GPIOs of a group. */
+int32_t no_os_gpio_group_direction_input(struct no_os_gpio_group_desc *desc,
+		uint32_t mask);
+
+/* Enable the output direction of the selected GPIOs of a group. */
+int32_t no_os_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t mask, uint32_t values);
+
+/* Set the values of the selected GPIOs of a group. */
+int32_t no_os_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values);
+
+/* Get the values of the selected GPIOs of a group. */
+int32_t no_os_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t *values);
+
 #endif // _NO_OS_GPIO_H_
@@ -46,6 +46,13 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* The message reads data from the slave */
+#define	NO_OS_I2C_M_RD	0x01
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -91,6 +98,19 @@ typedef struct no_os_i2c_desc {
 	void		*extra;
 } no_os_i2c_desc;
 
+/**
+ * @struct no_os_i2c_msg
+ * @brief I2C message, part of a combined transfer
+ */
+struct no_os_i2c_msg {
+	/** Buffer with the data to write or receiving the read data */
+	uint8_t		*buff;
+	/** Number of bytes to write or read */
+	uint16_t	bytes_number;
+	/** NO_OS_I2C_M_RD for a read message, 0 for a write message */
+	uint8_t		flags;
+};
+
 /**
  * @struct no_os_i2c_platform_ops
  * @brief Structure holding i2c function pointers that point to the platform
@@ -106,6 +126,9 @@ struct no_os_i2c_platform_ops {
 	int32_t (*i2c_ops_read)(struct no_os_i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct no_os_i2c_desc *);
+	/** i2c combined transfer function pointer (optional) */
+	int32_t (*i2c_ops_transfer)(struct no_os_i2c_desc *, struct no_os_i2c_msg *,
+				    uint32_t);
 };
 
 /******************************************************************************/
@@ -131,4 +154,9 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 		       uint8_t bytes_number,
 		       uint8_t stop_bit);
 
+/* Do a sequence of messages, separated by repeated starts. */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len);
+
 #endif // _NO_OS_I2C_H_
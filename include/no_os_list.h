@@ -121,6 +121,24 @@ struct no_os_list_desc;
  */
 struct no_os_iterator;
 
+/**
+ * @struct no_os_list_elem
+ * @brief Format of each element of the list
+ *
+ * Elements are allocated by the list, unless they are added with
+ * no_os_list_link_first() or no_os_list_link_last().
+ */
+struct no_os_list_elem {
+	/** User data */
+	void			*data;
+	/** Reference to previous element */
+	struct no_os_list_elem	*prev;
+	/** Reference to next element */
+	struct no_os_list_elem	*next;
+	/** The element is provided by the user and not freed by the list */
+	bool			user_owned;
+};
+
 /**
  * @brief Prototype of the compare function.
  *
@@ -253,6 +271,10 @@ struct no_os_list_desc {
 int32_t no_os_list_init(struct no_os_list_desc **list_desc,
 			enum no_os_adapter_type type,
 			f_cmp comparator);
+int32_t no_os_list_init_pool(struct no_os_list_desc **list_desc,
+			     enum no_os_adapter_type type,
+			     f_cmp comparator,
+			     uint32_t nb_elements);
 int32_t no_os_list_remove(struct no_os_list_desc *list_desc);
 int32_t no_os_list_get_size(struct no_os_list_desc *list_desc,
 			    uint32_t *out_size);
@@ -292,6 +314,11 @@ int32_t no_os_list_add_last(struct no_os_list_desc *list_desc, void *data);
 int32_t no_os_list_edit_last(struct no_os_list_desc *list_desc, void *new_data);
 int32_t no_os_list_read_last(struct no_os_list_desc *list_desc, void **data);
 int32_t no_os_list_get_last(struct no_os_list_desc *list_desc, void **data);
+
+int32_t no_os_list_link_first(struct no_os_list_desc *list_desc,
+			      struct no_os_list_elem *elem, void *data);
+int32_t no_os_list_link_last(struct no_os_list_desc *list_desc,
+			     struct no_os_list_elem *elem, void *data);
 /** @}*/
 
 /**
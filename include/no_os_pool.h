@@ -0,0 +1,104 @@
+/***************************************************************************//**
+ *   @file   no_os_pool.h
+ *   @brief  Header file of the fixed size object pool.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_POOL_H_
+#define _NO_OS_POOL_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Space taken in the pool memory by an object of the given size */
+#define NO_OS_POOL_OBJ_SIZE(size) \
+	((((size) < sizeof(void *) ? sizeof(void *) : (size)) + \
+	  sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_pool
+ * @brief Pool of fixed size objects
+ */
+struct no_os_pool {
+	/** Size of an object in the pool memory */
+	uint32_t	obj_size;
+	/** Number of objects */
+	uint32_t	nb_objs;
+	/** Number of free objects */
+	uint32_t	nb_free;
+	/** Pool memory */
+	uint8_t		*buff;
+	/** First free object, each free object stores the next one */
+	void		*free_list;
+	/** The pool memory was allocated by no_os_pool_init() */
+	bool		own_buff;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a pool of nb_objs objects of obj_size bytes. */
+int32_t no_os_pool_init(struct no_os_pool **pool, uint32_t obj_size,
+			uint32_t nb_objs);
+
+/* Configure a pool in the given memory, without allocation. */
+int32_t no_os_pool_cfg(struct no_os_pool *pool, void *buff, uint32_t obj_size,
+		       uint32_t nb_objs);
+
+/* Free the resources allocated by no_os_pool_init(). */
+int32_t no_os_pool_remove(struct no_os_pool *pool);
+
+/* Take an object from the pool. */
+void *no_os_pool_alloc(struct no_os_pool *pool);
+
+/* Give an object back to the pool. */
+int32_t no_os_pool_free(struct no_os_pool *pool, void *obj);
+
+/* Check if an object belongs to the pool. */
+bool no_os_pool_owns(struct no_os_pool *pool, const void *obj);
+
+#endif // _NO_OS_POOL_H_
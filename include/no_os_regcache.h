@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ *   @file   no_os_regcache.h
+ *   @brief  Header file of the register cache.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_REGCACHE_H_
+#define _NO_OS_REGCACHE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_regcache_range
+ * @brief Inclusive range of register addresses.
+ */
+struct no_os_regcache_range {
+	/** First register of the range */
+	uint32_t min;
+	/** Last register of the range */
+	uint32_t max;
+};
+
+/**
+ * @struct no_os_regcache_init_param
+ * @brief Register cache initialization parameters.
+ */
+struct no_os_regcache_init_param {
+	/** Highest register address of the device */
+	uint32_t max_reg;
+	/** Registers that may change without being written by the driver */
+	const struct no_os_regcache_range *volatile_ranges;
+	/** Number of volatile ranges */
+	uint32_t num_volatile_ranges;
+	/** Read one register from the device */
+	int32_t (*hw_read)(void *ctx, uint32_t reg, uint8_t *val);
+	/** Write one register of the device */
+	int32_t (*hw_write)(void *ctx, uint32_t reg, uint8_t val);
+	/** Context passed to the hardware access callbacks */
+	void *ctx;
+};
+
+/**
+ * @struct no_os_regcache
+ * @brief Register cache descriptor.
+ */
+struct no_os_regcache {
+	/** Highest register address of the device */
+	uint32_t max_reg;
+	/** Read one register from the device */
+	int32_t (*hw_read)(void *ctx, uint32_t reg, uint8_t *val);
+	/** Write one register of the device */
+	int32_t (*hw_write)(void *ctx, uint32_t reg, uint8_t val);
+	/** Context passed to the hardware access callbacks */
+	void *ctx;
+	/** Shadow copy of the registers */
+	uint8_t *vals;
+	/** Bitmap of the volatile registers */
+	uint32_t *volatile_map;
+	/** Bitmap of the registers having a valid shadow copy */
+	uint32_t *valid_map;
+	/** Bitmap of the registers written only to the cache */
+	uint32_t *dirty_map;
+	/** Access the device directly, without using the cache */
+	bool bypass;
+	/** Keep writes in the cache until no_os_regcache_sync() is called */
+	bool cache_only;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the register cache. */
+int32_t no_os_regcache_init(struct no_os_regcache **cache,
+			    const struct no_os_regcache_init_param *param);
+
+/* Free the resources allocated by no_os_regcache_init(). */
+int32_t no_os_regcache_remove(struct no_os_regcache *cache);
+
+/* Check if a register is volatile. */
+bool no_os_regcache_is_volatile(struct no_os_regcache *cache, uint32_t reg);
+
+/* Get the shadow copy of a register, without accessing the device. */
+int32_t no_os_regcache_get(struct no_os_regcache *cache, uint32_t reg,
+			   uint8_t *val);
+
+/* Record a value that was read from or written to the device. */
+void no_os_regcache_set(struct no_os_regcache *cache, uint32_t reg,
+			uint8_t val);
+
+/* Read a register, from the cache if possible. */
+int32_t no_os_regcache_read(struct no_os_regcache *cache, uint32_t reg,
+			    uint8_t *val);
+
+/* Write a register through the cache. */
+int32_t no_os_regcache_write(struct no_os_regcache *cache, uint32_t reg,
+			     uint8_t val);
+
+/* Update the bits of a register selected by mask. */
+int32_t no_os_regcache_update_bits(struct no_os_regcache *cache, uint32_t reg,
+				   uint8_t mask, uint8_t val);
+
+/* Write the registers changed in cache only mode to the device. */
+int32_t no_os_regcache_sync(struct no_os_regcache *cache);
+
+/* Invalidate the shadow copy of a range of registers. */
+void no_os_regcache_drop(struct no_os_regcache *cache, uint32_t min,
+			 uint32_t max);
+
+/* Invalidate the whole cache, e.g. after a device reset. */
+void no_os_regcache_invalidate(struct no_os_regcache *cache);
+
+/* Enable or disable the cache bypass mode. */
+void no_os_regcache_set_bypass(struct no_os_regcache *cache, bool enable);
+
+/* Enable or disable the cache only mode. */
+void no_os_regcache_set_cache_only(struct no_os_regcache *cache, bool enable);
+
+#endif // _NO_OS_REGCACHE_H_
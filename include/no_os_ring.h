@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ *   @file   no_os_ring.h
+ *   @brief  Header file of the lock-free ring buffer.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_RING_H_
+#define _NO_OS_RING_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* A single producer and a single consumer use the ring (wait-free) */
+#define NO_OS_RING_SPSC		0x01
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_ring
+ * @brief Lock-free ring buffer descriptor
+ */
+struct no_os_ring;
+
+/**
+ * @struct no_os_ring_span
+ * @brief Contiguous elements of a ring, reserved for writing or reading
+ */
+struct no_os_ring_span {
+	/** Address of the first element */
+	void		*buff;
+	/** Number of elements */
+	uint32_t	nb_elems;
+	/** Position of the first element (internal) */
+	uint32_t	pos;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a ring of nb_elems elements of elem_size bytes. */
+int32_t no_os_ring_init(struct no_os_ring **ring, uint32_t elem_size,
+			uint32_t nb_elems, uint32_t flags);
+
+/* Free the resources allocated by no_os_ring_init(). */
+int32_t no_os_ring_remove(struct no_os_ring *ring);
+
+/* Get the number of elements written and not yet read. */
+int32_t no_os_ring_size(struct no_os_ring *ring, uint32_t *nb_elems);
+
+/* Copy an element into the ring. */
+int32_t no_os_ring_push(struct no_os_ring *ring, const void *elem);
+
+/* Copy an element out of the ring. */
+int32_t no_os_ring_pop(struct no_os_ring *ring, void *elem);
+
+/* Reserve up to nb_elems contiguous free elements for writing. */
+int32_t no_os_ring_reserve_write(struct no_os_ring *ring, uint32_t nb_elems,
+				 struct no_os_ring_span *span);
+
+/* Make the elements of a write span available to the consumers. */
+int32_t no_os_ring_commit_write(struct no_os_ring *ring,
+				struct no_os_ring_span *span);
+
+/* Reserve up to nb_elems contiguous written elements for reading. */
+int32_t no_os_ring_reserve_read(struct no_os_ring *ring, uint32_t nb_elems,
+				struct no_os_ring_span *span);
+
+/* Give the elements of a read span back to the producers. */
+int32_t no_os_ring_commit_read(struct no_os_ring *ring,
+			       struct no_os_ring_span *span);
+
+#endif // _NO_OS_RING_H_
@@ -45,6 +45,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -53,6 +54,9 @@
 #define	NO_OS_SPI_CPHA	0x01
 #define	NO_OS_SPI_CPOL	0x02
 
+/* Received data of batched transfers is copied back to the caller buffers */
+#define	NO_OS_SPI_BATCH_READBACK	0x01
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -105,6 +109,68 @@ struct no_os_spi_msg {
  */
 struct no_os_spi_platform_ops ;
 
+struct no_os_spi_desc;
+
+/**
+ * @struct no_os_spi_async_xfer
+ * @brief Message list transferred asynchronously, queued with
+ * no_os_spi_transfer_async(). The structure and the messages must be valid
+ * until the transfer is done.
+ */
+struct no_os_spi_async_xfer {
+	/** Messages, transferred in order with the chip select of the device */
+	struct no_os_spi_msg *msgs;
+	/** Number of messages */
+	uint32_t len;
+	/** Transfers with a higher priority are started first */
+	uint8_t priority;
+	/** Called when the transfer is done. Optional */
+	void (*callback)(struct no_os_spi_async_xfer *xfer);
+	/** Passed back to the callback through the transfer */
+	void *ctx;
+	/** Result of the transfer, valid once done is set */
+	int32_t status;
+	/** Set when the transfer is done */
+	volatile bool done;
+	/* Fields below are used by the SPI layer */
+	/** Device doing the transfer */
+	struct no_os_spi_desc *desc;
+	/** Next transfer in the bus queue */
+	struct no_os_spi_async_xfer *next;
+};
+
+/**
+ * @struct no_os_spi_bus_desc
+ * @brief SPI controller, shared by the devices with the same platform_ops and
+ * controller identifier, see no_os_spi_platform_ops.get_bus_id.
+ */
+struct no_os_spi_bus_desc {
+	/** Controller ID, the device_id of the devices */
+	uint32_t	device_id;
+	/** Controller identifier, the device_id without get_bus_id */
+	uintptr_t	bus_id;
+	/** Number of devices on the bus */
+	uint32_t	slave_number;
+	/** Bus lock, held for the duration of each transfer */
+	void		*mutex;
+	/** Protects the queue of asynchronous transfers */
+	void		*queue_mutex;
+	/** Queued asynchronous transfers, by decreasing priority */
+	struct no_os_spi_async_xfer *queue;
+	/** Last queued transfer */
+	struct no_os_spi_async_xfer *queue_tail;
+	/** The queue is being processed */
+	bool		running;
+	/** The background processing was started with async_start */
+	bool		async_started;
+	/** Platform ops of the devices on the bus */
+	const struct no_os_spi_platform_ops *platform_ops;
+	/** Platform specific asynchronous transfer state */
+	void		*extra;
+	/** Next controller in use */
+	struct no_os_spi_bus_desc *next;
+};
+
 /**
  * @struct no_os_spi_init_param
  * @brief Structure holding the parameters for SPI initialization
@@ -141,6 +207,8 @@ typedef struct no_os_spi_desc {
 	/** SPI bit order */
 	enum no_os_spi_bit_order	bit_order;
 	const struct no_os_spi_platform_ops *platform_ops;
+	/** SPI bus of the device */
+	struct no_os_spi_bus_desc *bus;
 	/**  SPI extra parameters (device specific) */
 	void		*extra;
 } no_os_spi_desc;
@@ -159,6 +227,26 @@ struct no_os_spi_platform_ops {
 	int32_t (*transfer)(struct no_os_spi_desc *, struct no_os_spi_msg *, uint32_t);
 	/** SPI remove function pointer */
 	int32_t (*remove)(struct no_os_spi_desc *);
+	/**
+	 * Start processing the asynchronous transfers of a bus in the
+	 * background (optional). Without it, the transfers are processed in
+	 * the context of no_os_spi_transfer_async().
+	 */
+	int32_t (*async_start)(struct no_os_spi_bus_desc *);
+	/** Notify the background processing that transfers are queued */
+	int32_t (*async_notify)(struct no_os_spi_bus_desc *);
+	/** Stop the background processing of a bus */
+	int32_t (*async_stop)(struct no_os_spi_bus_desc *);
+	/** Start recording transfers instead of doing them (optional) */
+	int32_t (*batch_begin)(struct no_os_spi_desc *, uint32_t);
+	/** Do the recorded transfers at once */
+	int32_t (*batch_commit)(struct no_os_spi_desc *);
+	/**
+	 * Identify the controller of a device, e.g. by its base address
+	 * (optional). Without it, the devices with the same device_id share
+	 * a controller.
+	 */
+	uintptr_t (*get_bus_id)(const struct no_os_spi_init_param *);
 };
 
 /******************************************************************************/
@@ -182,5 +270,24 @@ int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 			   struct no_os_spi_msg *msgs,
 			   uint32_t len);
 
+/* Queue a message list to be transferred asynchronously. */
+int32_t no_os_spi_transfer_async(struct no_os_spi_desc *desc,
+				 struct no_os_spi_async_xfer *xfer);
+
+/* Start batching the transfers of a device. */
+int32_t no_os_spi_batch_begin(struct no_os_spi_desc *desc, uint32_t flags);
+
+/* Do the transfers batched since no_os_spi_batch_begin(). */
+int32_t no_os_spi_batch_commit(struct no_os_spi_desc *desc);
+
+/* Lock the bus of a device, for a sequence of transfers. */
+void no_os_spi_bus_lock(struct no_os_spi_desc *desc);
+
+/* Unlock the bus of a device. */
+void no_os_spi_bus_unlock(struct no_os_spi_desc *desc);
+
+/* Process the asynchronous transfers queued on a bus. */
+void no_os_spi_bus_run(struct no_os_spi_bus_desc *bus);
+
 
 #endif // _NO_OS_SPI_H_
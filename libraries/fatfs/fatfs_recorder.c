@@ -0,0 +1,697 @@
+/***************************************************************************//**
+ *   @file   fatfs_recorder.c
+ *   @brief  Implementation of the FatFs sample recorder.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ff.h"
+#include "fatfs_recorder.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#ifdef IIO_SUPPORT
+#include "iio.h"
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define FATFS_RECORDER_VERSION		1
+/* "_<index>.bin" */
+#define FILE_SUFFIX_LEN			16
+
+#if FF_MAX_SS == FF_MIN_SS
+#define SECTOR_SIZE(fs)			FF_MAX_SS
+#else
+#define SECTOR_SIZE(fs)			((fs)->ssize)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct fatfs_recorder
+ * @brief Recorder descriptor
+ */
+struct fatfs_recorder {
+	/** Path of the files without extension */
+	const char *path;
+	/** Name written in the file header */
+	const char *name;
+	/** Source of the samples */
+	enum fatfs_recorder_source source;
+	/** Channels of the samples */
+	struct iio_device *iio_dev;
+	/** Device instance passed to the iio_device callbacks */
+	void *dev;
+	/** Mask of the recorded channels */
+	uint32_t ch_mask;
+	/** Bytes of one sample of each recorded channel */
+	uint32_t scan_size;
+	/** Data waiting to be written to the file */
+	struct no_os_circular_buffer *cb;
+	/** Buffer passed to iio_device.submit() */
+	struct iio_buffer *iio_buff;
+	/** Device instance and buffer passed to iio_device.submit() */
+	struct iio_device_data dev_data;
+	/** Number of buffers */
+	uint32_t nb_buffs;
+	/** Bytes written to the file at once */
+	uint32_t buff_size;
+	/** Size allocated for each file */
+	uint64_t file_size;
+	/** Duration of a file, 0 to only use file_size */
+	uint32_t file_time_ms;
+	/** Timer measuring time, optional */
+	struct no_os_timer_desc *timer;
+	/** Offset of the samples in the files, multiple of the cluster size */
+	uint32_t data_offset;
+	/** Header of the current file */
+	char *header;
+	/** Size of header */
+	uint32_t header_size;
+	/** Path of the current file */
+	char *file_path;
+	/** Current file */
+	FIL file;
+	/** Set while file is open */
+	bool file_open;
+	/** Set between fatfs_recorder_start() and fatfs_recorder_stop() */
+	bool started;
+	/** Index of the next file */
+	uint32_t file_index;
+	/** Time the current file was started */
+	uint64_t file_start_ns;
+	/** Statistics of the recording */
+	struct fatfs_recorder_stats stats;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Convert a FatFs result to an error code.
+ * @param res - FatFs result.
+ * @return 0 for FR_OK, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_err(FRESULT res)
+{
+	switch (res) {
+	case FR_OK:
+		return 0;
+	case FR_DENIED:
+		return -ENOSPC;
+	case FR_NO_FILE:
+	case FR_NO_PATH:
+		return -ENOENT;
+	case FR_INVALID_NAME:
+	case FR_INVALID_PARAMETER:
+		return -EINVAL;
+	case FR_NOT_ENOUGH_CORE:
+		return -ENOMEM;
+	default:
+		return -EIO;
+	}
+}
+
+/**
+ * @brief Get the time measured by the timer of the recorder.
+ * @param rec - Recorder descriptor.
+ * @return Elapsed time in ns, 0 if there is no timer.
+ */
+static uint64_t fatfs_recorder_time_ns(struct fatfs_recorder *rec)
+{
+	uint64_t ns;
+
+	if (!rec->timer ||
+	    no_os_timer_get_elapsed_time_nsec(rec->timer, &ns))
+		return 0;
+
+	return ns;
+}
+
+/**
+ * @brief Write the file header.
+ * The header is text: a line for each recorded channel with its index in the
+ * device, its name and its scan type in the libiio format, followed by the
+ * offset of the samples.
+ * @param rec - Recorder descriptor.
+ * @param buf - Where to write the header, NULL to only get its length.
+ * @param len - Size of buf.
+ * @param index - Index of the file.
+ * @param data_offset - Offset of the samples.
+ * @return Length of the header, without the terminating null byte.
+ */
+static uint32_t fatfs_recorder_header(struct fatfs_recorder *rec, char *buf,
+				      uint32_t len, uint32_t index,
+				      uint32_t data_offset)
+{
+	struct iio_channel *ch;
+	struct scan_type *st;
+	uint32_t i;
+	int n;
+
+	n = snprintf(buf, len, "no-OS recorder %d\nname %s\nfile %"PRIu32
+		     "\nscan_size %"PRIu32"\n", FATFS_RECORDER_VERSION,
+		     rec->name ? rec->name : "-", index, rec->scan_size);
+
+	for (i = 0; i < rec->iio_dev->num_ch; i++) {
+		if (!((rec->ch_mask >> i) & 1))
+			continue;
+		ch = &rec->iio_dev->channels[i];
+		st = ch->scan_type;
+		n += snprintf(buf ? buf + n : NULL, buf ? len - n : 0,
+			      "channel %"PRIu32" %s %s:%c%u/%u>>%u\n", i,
+			      ch->name ? ch->name : "-",
+			      st->is_big_endian ? "be" : "le", st->sign,
+			      st->realbits, st->storagebits, st->shift);
+	}
+
+	n += snprintf(buf ? buf + n : NULL, buf ? len - n : 0,
+		      "data %"PRIu32"\n", data_offset);
+
+	return n;
+}
+
+/**
+ * @brief Start the next file. It is allocated contiguously if possible, so
+ * samples are written without searching for free clusters.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_open(struct fatfs_recorder *rec)
+{
+	uint32_t len;
+	FRESULT res;
+	UINT bw;
+
+	sprintf(rec->file_path, "%s_%04"PRIu32".bin", rec->path,
+		rec->file_index);
+	res = f_open(&rec->file, rec->file_path, FA_WRITE | FA_CREATE_ALWAYS);
+	if (res != FR_OK)
+		return fatfs_recorder_err(res);
+	rec->file_open = true;
+
+#if FF_USE_EXPAND
+	/* On a fragmented volume, clusters are allocated while writing */
+	res = f_expand(&rec->file, rec->file_size, 1);
+	if (res != FR_OK && res != FR_DENIED)
+		return fatfs_recorder_err(res);
+#endif
+
+	len = fatfs_recorder_header(rec, rec->header, rec->header_size,
+				    rec->file_index, rec->data_offset);
+	res = f_write(&rec->file, rec->header, len, &bw);
+	if (res == FR_OK && bw != len)
+		return -ENOSPC;
+	if (res == FR_OK)
+		res = f_lseek(&rec->file, rec->data_offset);
+	if (res != FR_OK)
+		return fatfs_recorder_err(res);
+
+	rec->file_index++;
+	rec->file_start_ns = fatfs_recorder_time_ns(rec);
+	rec->stats.files++;
+
+	return 0;
+}
+
+/**
+ * @brief Close the current file, releasing the space allocated and not used.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_close(struct fatfs_recorder *rec)
+{
+	FRESULT res, res2;
+
+	if (!rec->file_open)
+		return 0;
+
+	rec->file_open = false;
+	res = f_truncate(&rec->file);
+	res2 = f_close(&rec->file);
+
+	return fatfs_recorder_err(res != FR_OK ? res : res2);
+}
+
+/**
+ * @brief Write samples from the circular buffer to the file, starting a new
+ * file first if they don't fit or if the current one is too old.
+ * @param rec - Recorder descriptor.
+ * @param len - Number of bytes to write.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_write(struct fatfs_recorder *rec, uint32_t len)
+{
+	uint64_t start, ns;
+	uint32_t size;
+	int32_t ret;
+	FRESULT res;
+	void *buff;
+	UINT bw;
+
+	start = fatfs_recorder_time_ns(rec);
+
+	if (!rec->file_open || f_tell(&rec->file) + len > rec->file_size ||
+	    (rec->file_time_ms && start - rec->file_start_ns >=
+	     rec->file_time_ms * 1000000ull)) {
+		ret = fatfs_recorder_close(rec);
+		if (ret)
+			return ret;
+		ret = fatfs_recorder_open(rec);
+		if (ret)
+			return ret;
+	}
+
+	/* Buffers are contiguous unless the caller's circular buffer overran */
+	while (len) {
+		ret = no_os_cb_prepare_async_read(rec->cb, len, &buff, &size);
+		if (ret == -NO_OS_EOVERRUN)
+			rec->stats.overruns++;
+		else if (ret)
+			return ret;
+
+		res = f_write(&rec->file, buff, size, &bw);
+		no_os_cb_end_async_read(rec->cb);
+		if (res != FR_OK)
+			return fatfs_recorder_err(res);
+		if (bw != size)
+			return -ENOSPC;
+
+		rec->stats.bytes += size;
+		len -= size;
+	}
+	rec->stats.buffs++;
+
+	ns = fatfs_recorder_time_ns(rec) - start;
+	rec->stats.write_ns += ns;
+	rec->stats.max_write_ns = no_os_max(rec->stats.max_write_ns, ns);
+
+	return 0;
+}
+
+/**
+ * @brief Write all the full buffers of the circular buffer.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_write_all(struct fatfs_recorder *rec)
+{
+	uint32_t size;
+	int32_t ret;
+
+	while (true) {
+		ret = no_os_cb_size(rec->cb, &size);
+		if (ret && ret != -NO_OS_EOVERRUN)
+			return ret;
+		if (size < rec->buff_size)
+			return 0;
+
+		ret = fatfs_recorder_write(rec, rec->buff_size);
+		if (ret)
+			return ret;
+	}
+}
+
+/**
+ * @brief Read one buffer of samples with iio_device.read_dev(), if one is
+ * free.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t fatfs_recorder_read_dev(struct fatfs_recorder *rec)
+{
+	uint32_t used, size;
+	int32_t ret;
+	void *buff;
+
+	ret = no_os_cb_size(rec->cb, &used);
+	if (ret)
+		return ret;
+	if (rec->cb->size - used < rec->buff_size)
+		return 0;
+
+	/* Buffers are aligned to the circular buffer, so this one is whole */
+	ret = no_os_cb_prepare_async_write(rec->cb, rec->buff_size, &buff,
+					   &size);
+	if (ret)
+		return ret;
+
+	ret = rec->iio_dev->read_dev(rec->dev, buff,
+				     rec->buff_size / rec->scan_size);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return no_os_cb_end_async_write(rec->cb);
+}
+
+/**
+ * @brief Allocate a recorder.
+ * The buffer size is rounded so buffers are written at cluster boundaries,
+ * directly from the circular buffer, and so files contain whole scans.
+ * @param rec - Where to store the recorder.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_init(struct fatfs_recorder **rec,
+			    const struct fatfs_recorder_init_param *param)
+{
+	struct fatfs_recorder *lrec;
+	struct iio_channel *ch;
+	uint32_t cluster, unit, i;
+	FATFS *fs;
+	FRESULT res;
+	DWORD nclst;
+	int32_t ret;
+
+	if (!rec || !param || !param->path || !param->iio_dev ||
+	    !param->ch_mask || !param->file_size ||
+	    (param->file_time_ms && !param->timer))
+		return -EINVAL;
+
+	if (param->iio_dev->num_ch < 32 &&
+	    param->ch_mask >> param->iio_dev->num_ch)
+		return -EINVAL;
+
+	switch (param->source) {
+	case FATFS_RECORDER_READ_DEV:
+		if (!param->iio_dev->read_dev || param->nb_buffs < 2)
+			return -EINVAL;
+		break;
+	case FATFS_RECORDER_SUBMIT:
+#ifndef IIO_SUPPORT
+		return -ENOSYS;
+#endif
+		if (!param->iio_dev->submit || param->nb_buffs < 2)
+			return -EINVAL;
+		break;
+	case FATFS_RECORDER_CB:
+		if (!param->cb)
+			return -EINVAL;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	lrec = calloc(1, sizeof(*lrec));
+	if (!lrec)
+		return -ENOMEM;
+
+	lrec->path = param->path;
+	lrec->name = param->name;
+	lrec->source = param->source;
+	lrec->iio_dev = param->iio_dev;
+	lrec->dev = param->dev;
+	lrec->ch_mask = param->ch_mask;
+	lrec->nb_buffs = param->nb_buffs;
+	lrec->file_size = param->file_size;
+	lrec->file_time_ms = param->file_time_ms;
+	lrec->timer = param->timer;
+	lrec->dev_data.dev = param->dev;
+
+	for (i = 0; i < param->iio_dev->num_ch; i++) {
+		ch = &param->iio_dev->channels[i];
+		if ((param->ch_mask >> i) & 1)
+			lrec->scan_size += ch->scan_type->storagebits / 8;
+	}
+	if (!lrec->scan_size) {
+		ret = -EINVAL;
+		goto error;
+	}
+
+	/* The cluster size is a power of 2 */
+	res = f_getfree(param->path, &nclst, &fs);
+	if (res != FR_OK) {
+		ret = fatfs_recorder_err(res);
+		goto error;
+	}
+	cluster = fs->csize * SECTOR_SIZE(fs);
+	unit = cluster / no_os_greatest_common_divisor(cluster,
+			lrec->scan_size) * lrec->scan_size;
+	lrec->buff_size = NO_OS_DIV_ROUND_UP(no_os_max(param->buff_size, 1),
+					     unit) * unit;
+
+	lrec->header_size = fatfs_recorder_header(lrec, NULL, 0, UINT32_MAX,
+			    UINT32_MAX) + 1;
+	lrec->data_offset = NO_OS_DIV_ROUND_UP(lrec->header_size, cluster) *
+			    cluster;
+	if (lrec->file_size < (uint64_t)lrec->data_offset + lrec->buff_size) {
+		ret = -EINVAL;
+		goto error;
+	}
+
+	lrec->header = calloc(1, lrec->header_size);
+	lrec->file_path = calloc(1, strlen(param->path) + FILE_SUFFIX_LEN);
+	if (!lrec->header || !lrec->file_path) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	if (param->source == FATFS_RECORDER_CB) {
+		if (param->cb->size % lrec->buff_size) {
+			ret = -EINVAL;
+			goto error;
+		}
+		lrec->cb = param->cb;
+	} else if (param->source == FATFS_RECORDER_READ_DEV) {
+		ret = no_os_cb_init(&lrec->cb, lrec->buff_size *
+				    param->nb_buffs);
+		if (ret)
+			goto error;
+	}
+
+	*rec = lrec;
+
+	return 0;
+error:
+	free(lrec->header);
+	free(lrec->file_path);
+	free(lrec);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the recording and free the recorder.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_remove(struct fatfs_recorder *rec)
+{
+	int32_t ret;
+
+	if (!rec)
+		return -EINVAL;
+
+	ret = fatfs_recorder_stop(rec);
+
+	if (rec->source == FATFS_RECORDER_READ_DEV)
+		no_os_cb_remove(rec->cb);
+	free(rec->header);
+	free(rec->file_path);
+	free(rec);
+
+	return ret;
+}
+
+/**
+ * @brief Enable the device and start the first file.
+ * Files are numbered from where the previous recording stopped.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_start(struct fatfs_recorder *rec)
+{
+	int32_t ret;
+
+	if (!rec || rec->started)
+		return -EINVAL;
+
+	memset(&rec->stats, 0, sizeof(rec->stats));
+
+	if (rec->source == FATFS_RECORDER_READ_DEV) {
+		ret = no_os_cb_cfg(rec->cb, rec->cb->buff, rec->cb->size);
+		if (ret)
+			return ret;
+	}
+#ifdef IIO_SUPPORT
+	if (rec->source == FATFS_RECORDER_SUBMIT) {
+		ret = iio_buffer_alloc(&rec->iio_buff, rec->iio_dev,
+				       rec->ch_mask, rec->buff_size,
+				       rec->nb_buffs, IIO_DIRECTION_INPUT);
+		if (ret)
+			return ret;
+		rec->dev_data.buffer = rec->iio_buff;
+		rec->cb = rec->iio_buff->buf;
+	}
+#endif
+
+	if (rec->source != FATFS_RECORDER_CB && rec->iio_dev->pre_enable) {
+		ret = rec->iio_dev->pre_enable(rec->dev, rec->ch_mask);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto error;
+	}
+
+	ret = fatfs_recorder_open(rec);
+	if (ret) {
+		fatfs_recorder_close(rec);
+		if (rec->source != FATFS_RECORDER_CB &&
+		    rec->iio_dev->post_disable)
+			rec->iio_dev->post_disable(rec->dev);
+		goto error;
+	}
+
+	rec->started = true;
+
+	return 0;
+error:
+#ifdef IIO_SUPPORT
+	if (rec->source == FATFS_RECORDER_SUBMIT) {
+		iio_buffer_free(rec->iio_buff);
+		rec->iio_buff = NULL;
+	}
+#endif
+
+	return ret;
+}
+
+/**
+ * @brief Get samples from the source and write the full buffers.
+ * With FATFS_RECORDER_SUBMIT, iio_device.submit() keeps the free buffers in
+ * flight while the full ones are written. With FATFS_RECORDER_READ_DEV, one
+ * buffer is read with iio_device.read_dev() at each call.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_step(struct fatfs_recorder *rec)
+{
+	int32_t ret;
+
+	if (!rec || !rec->started)
+		return -EINVAL;
+
+	switch (rec->source) {
+	case FATFS_RECORDER_READ_DEV:
+		ret = fatfs_recorder_read_dev(rec);
+		break;
+	case FATFS_RECORDER_SUBMIT:
+		ret = rec->iio_dev->submit(&rec->dev_data);
+		/* The device has no data yet, full buffers are still written */
+		if (ret == -EAGAIN)
+			ret = 0;
+		break;
+	default:
+		ret = 0;
+		break;
+	}
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return fatfs_recorder_write_all(rec);
+}
+
+/**
+ * @brief Write the remaining samples, disable the device and close the file.
+ * @param rec - Recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_stop(struct fatfs_recorder *rec)
+{
+	uint32_t size;
+	int32_t ret, ret2;
+
+	if (!rec)
+		return -EINVAL;
+
+	if (!rec->started)
+		return 0;
+	rec->started = false;
+
+	/* No transfer is running after post_disable */
+	ret = 0;
+	if (rec->source != FATFS_RECORDER_CB && rec->iio_dev->post_disable)
+		ret = rec->iio_dev->post_disable(rec->dev);
+
+	ret2 = fatfs_recorder_write_all(rec);
+	if (!ret2)
+		ret2 = no_os_cb_size(rec->cb, &size);
+	if (!ret2 && size)
+		ret2 = fatfs_recorder_write(rec, size);
+	if (!ret)
+		ret = ret2;
+
+	ret2 = fatfs_recorder_close(rec);
+	if (!ret)
+		ret = ret2;
+
+#ifdef IIO_SUPPORT
+	if (rec->source == FATFS_RECORDER_SUBMIT) {
+		iio_buffer_free(rec->iio_buff);
+		rec->iio_buff = NULL;
+		rec->cb = NULL;
+	}
+#endif
+
+	return ret;
+}
+
+/**
+ * @brief Get the statistics of the recording.
+ * @param rec - Recorder descriptor.
+ * @param stats - Where to store the statistics.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t fatfs_recorder_get_stats(struct fatfs_recorder *rec,
+				 struct fatfs_recorder_stats *stats)
+{
+	if (!rec || !stats)
+		return -EINVAL;
+
+	*stats = rec->stats;
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************//**
+ *   @file   fatfs_recorder.h
+ *   @brief  Header file of the FatFs sample recorder.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef FATFS_RECORDER_H_
+#define FATFS_RECORDER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "iio_types.h"
+#include "no_os_circular_buffer.h"
+#include "no_os_timer.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum fatfs_recorder_source
+ * @brief Where the recorded samples come from
+ */
+enum fatfs_recorder_source {
+	/** Each buffer is filled with iio_device.read_dev() */
+	FATFS_RECORDER_READ_DEV,
+	/** Buffers are filled by iio_device.submit(), which can keep several of
+	 *  them in flight. Needs IIO_SUPPORT */
+	FATFS_RECORDER_SUBMIT,
+	/** Samples are written by the caller in a circular buffer */
+	FATFS_RECORDER_CB,
+};
+
+/**
+ * @struct fatfs_recorder_init_param
+ * @brief Recorder initialization parameters
+ */
+struct fatfs_recorder_init_param {
+	/** Path of the files without extension, "_<index>.bin" is appended */
+	const char *path;
+	/** Name written in the file header, optional */
+	const char *name;
+	/** Source of the samples */
+	enum fatfs_recorder_source source;
+	/** Channels of the samples, also provides read_dev() or submit() */
+	struct iio_device *iio_dev;
+	/** Device instance passed to the iio_device callbacks */
+	void *dev;
+	/** Mask of the recorded channels */
+	uint32_t ch_mask;
+	/** Circular buffer filled by the caller, for FATFS_RECORDER_CB. Its
+	 *  size must be a multiple of buff_size */
+	struct no_os_circular_buffer *cb;
+	/** Bytes written to the file at once. Rounded up to a multiple of the
+	 *  cluster size and of the scan size */
+	uint32_t buff_size;
+	/** Number of buffers, at least 2. Not used for FATFS_RECORDER_CB */
+	uint32_t nb_buffs;
+	/** Size allocated for each file. A new file is started when the next
+	 *  buffer does not fit */
+	uint64_t file_size;
+	/** A new file is started after this time, 0 to only use file_size */
+	uint32_t file_time_ms;
+	/** Started timer, needed for file_time_ms and the time statistics */
+	struct no_os_timer_desc *timer;
+};
+
+/**
+ * @struct fatfs_recorder_stats
+ * @brief Recorder statistics, since the last fatfs_recorder_start()
+ */
+struct fatfs_recorder_stats {
+	/** Bytes of samples written */
+	uint64_t bytes;
+	/** Number of files started */
+	uint32_t files;
+	/** Number of buffers written */
+	uint32_t buffs;
+	/** Number of times the caller overwrote data not yet written, for
+	 *  FATFS_RECORDER_CB */
+	uint32_t overruns;
+	/** Time spent writing buffers and starting files, in ns */
+	uint64_t write_ns;
+	/** Longest time spent writing one buffer, including a file change */
+	uint64_t max_write_ns;
+};
+
+struct fatfs_recorder;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a recorder. The file system of path must be mounted. */
+int32_t fatfs_recorder_init(struct fatfs_recorder **rec,
+			    const struct fatfs_recorder_init_param *param);
+/* Stop the recording and free the recorder. */
+int32_t fatfs_recorder_remove(struct fatfs_recorder *rec);
+/* Enable the device and start the first file. */
+int32_t fatfs_recorder_start(struct fatfs_recorder *rec);
+/* Get samples from the source and write the full buffers. */
+int32_t fatfs_recorder_step(struct fatfs_recorder *rec);
+/* Write the remaining samples, disable the device and close the file. */
+int32_t fatfs_recorder_stop(struct fatfs_recorder *rec);
+/* Get the statistics of the recording. */
+int32_t fatfs_recorder_get_stats(struct fatfs_recorder *rec,
+				 struct fatfs_recorder_stats *stats);
+
+#endif /* FATFS_RECORDER_H_ */
@@ -137,12 +137,13 @@ static int32_t linux_socket_send(void *desc, uint32_t sock_id,
 {
 	int32_t ret;
 
-	ret = send(sock_id, data, size, 0);
+	ret = send(sock_id, data, size, MSG_NOSIGNAL);
 
 	if(ret < 0)
 		return -errno;
 
-	return size;
+	/* The socket is non blocking so only part of data may be sent */
+	return ret;
 }
 
 /** @brief See \ref network_interface.socket_recv */
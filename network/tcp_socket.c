@@ -466,3 +466,13 @@ int32_t socket_accept(struct tcp_socket_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Get the id used to reference the socket in the network interface.
+ * On Linux this is the socket file descriptor.
+ * @param desc - Socket descriptor
+ * @return Socket id
+ */
+uint32_t socket_get_id(struct tcp_socket_desc *desc)
+{
+	return desc->id;
+}
@@ -156,4 +156,7 @@ int32_t socket_listen(struct tcp_socket_desc *desc, uint32_t back_log);
 int32_t socket_accept(struct tcp_socket_desc *desc,
 		      struct tcp_socket_desc **new_client);
 
+/* Get the id of the socket in the network interface */
+uint32_t socket_get_id(struct tcp_socket_desc *desc);
+
 #endif
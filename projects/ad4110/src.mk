@@ -11,6 +11,7 @@
 
 SRC_DIRS += $(PROJECT)/src
 SRCS += $(DRIVERS)/api/no_os_spi.c \
+	$(NO-OS)/util/no_os_mutex.c \
 	$(DRIVERS)/api/no_os_irq.c \
 	$(DRIVERS)/api/no_os_gpio.c \
 	$(DRIVERS)/afe/ad4110/ad4110.c
@@ -20,7 +21,9 @@ SRCS += $(PLATFORM_DRIVERS)/xilinx_spi.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio_irq.c \
 	$(PLATFORM_DRIVERS)/delay.c \
-	$(NO-OS)/util/no_os_list.c
+	$(NO-OS)/util/no_os_list.c \
+	$(NO-OS)/util/no_os_pool.c \
+	$(NO-OS)/util/no_os_crc8.c
 
 INCS += $(DRIVERS)/afe/ad4110/ad4110.h
 
@@ -30,10 +33,13 @@ INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h \
 	$(PLATFORM_DRIVERS)/gpio_irq_extra.h
 
 INCS += $(INCLUDE)/no_os_spi.h \
+	$(INCLUDE)/no_os_mutex.h \
 	$(INCLUDE)/no_os_gpio.h \
 	$(INCLUDE)/no_os_error.h \
 	$(INCLUDE)/no_os_delay.h \
 	$(INCLUDE)/no_os_irq.h \
 	$(INCLUDE)/no_os_util.h \
 	$(INCLUDE)/no_os_print_log.h \
-	$(INCLUDE)/no_os_list.h
+	$(INCLUDE)/no_os_list.h \
+	$(INCLUDE)/no_os_pool.h \
+	$(INCLUDE)/no_os_crc8.h
@@ -2,6 +2,7 @@
 SRC_DIRS += $(PROJECT)/src
 SRCS += $(DRIVERS)/api/no_os_gpio.c \
         $(DRIVERS)/api/no_os_spi.c \
+	$(NO-OS)/util/no_os_mutex.c \
         $(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c \
         $(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c \
 	$(PLATFORM_DRIVERS)/delay.c \
@@ -9,6 +10,7 @@ SRCS += $(DRIVERS)/api/no_os_gpio.c \
 
 INCS += $(INCLUDE)/no_os_gpio.h \
 	$(INCLUDE)/no_os_spi.h \
+	$(INCLUDE)/no_os_mutex.h \
         $(INCLUDE)/no_os_error.h \
         $(INCLUDE)/no_os_delay.h \
         $(INCLUDE)/no_os_print_log.h \
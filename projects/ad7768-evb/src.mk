@@ -12,7 +12,9 @@
 # Add to SRCS source files to be build in the project
 SRCS += $(PROJECT)/src/ad7768_evb.c
 SRCS += $(NO-OS)/util/no_os_fifo.c
+SRCS += $(NO-OS)/util/no_os_pool.c
 SRCS += $(NO-OS)/util/no_os_util.c
+SRCS += $(NO-OS)/util/no_os_mutex.c
 SRCS += $(NO-OS)/util/no_os_list.c
 
 # Add to INCS inlcude files to be build in the project
@@ -20,6 +22,7 @@ INCS += $(INCLUDE)/no_os_error.h
 INCS += $(INCLUDE)/no_os_gpio.h
 INCS += $(INCLUDE)/no_os_delay.h
 INCS += $(INCLUDE)/no_os_util.h
+INCS += $(INCLUDE)/no_os_mutex.h
 INCS += $(INCLUDE)/no_os_axi_io.h
 INCS += $(INCLUDE)/no_os_spi.h
 INCS += $(INCLUDE)/no_os_timer.h
@@ -27,6 +30,7 @@ INCS += $(INCLUDE)/no_os_i2c.h
 INCS += $(INCLUDE)/no_os_uart.h
 INCS +=	$(INCLUDE)/no_os_irq.h
 INCS += $(INCLUDE)/no_os_list.h
+INCS += $(INCLUDE)/no_os_pool.h
 INCS += $(INCLUDE)/no_os_fifo.h
 INCS += $(PROJECT)/src/parameters.h
 
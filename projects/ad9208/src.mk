@@ -22,9 +22,11 @@ SRC_DIRS += $(DRIVERS)/axi_core/iio_axi_adc \
 
 SRCS	+= $(PLATFORM_DRIVERS)/no_os_uart.c \
 		$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.c \
-		$(NO-OS)/util/no_os_list.c 
+		$(NO-OS)/util/no_os_list.c \
+		$(NO-OS)/util/no_os_pool.c
 INCS	+= $(INCLUDE)/no_os_uart.h \
 		$(INCLUDE)/no_os_list.h \
+		$(INCLUDE)/no_os_pool.h \
 		$(INCLUDE)/no_os_irq.h \
 		$(PLATFORM_DRIVERS)/irq_extra.h \
 		$(PLATFORM_DRIVERS)/uart_extra.h
@@ -38,7 +40,8 @@ SRCS += $(DRIVERS)/axi_core/jesd204/axi_adxcvr.c \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_rx.c \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.c \
 	$(DRIVERS)/axi_core/jesd204/xilinx_transceiver.c \
-	$(NO-OS)/util/no_os_util.c
+	$(NO-OS)/util/no_os_util.c \
+	$(NO-OS)/util/no_os_mutex.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c \
 	$(PLATFORM_DRIVERS)/xilinx_spi.c \
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c \
@@ -56,4 +59,5 @@ INCS +=	$(INCLUDE)/no_os_axi_io.h \
 	$(INCLUDE)/no_os_gpio.h \
 	$(INCLUDE)/no_os_error.h \
 	$(INCLUDE)/no_os_delay.h \
-	$(INCLUDE)/no_os_util.h
+	$(INCLUDE)/no_os_util.h \
+	$(INCLUDE)/no_os_mutex.h
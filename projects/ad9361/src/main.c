@@ -150,17 +150,21 @@ struct axi_dac_init tx_dac_init = {
 	NULL
 };
 struct axi_dmac_init rx_dmac_init = {
-	"rx_dmac",
-	CF_AD9361_RX_DMA_BASEADDR,
-	DMA_DEV_TO_MEM,
-	0
+	.name = "rx_dmac",
+	.base = CF_AD9361_RX_DMA_BASEADDR,
+	.direction = DMA_DEV_TO_MEM,
+	.flags = 0,
+	.irq_ctrl = NULL,
+	.irq_id = 0
 };
 struct axi_dmac *rx_dmac;
 struct axi_dmac_init tx_dmac_init = {
-	"tx_dmac",
-	CF_AD9361_TX_DMA_BASEADDR,
-	DMA_MEM_TO_DEV,
-	DMA_CYCLIC
+	.name = "tx_dmac",
+	.base = CF_AD9361_TX_DMA_BASEADDR,
+	.direction = DMA_MEM_TO_DEV,
+	.flags = DMA_CYCLIC,
+	.irq_ctrl = NULL,
+	.irq_id = 0
 };
 struct axi_dmac *tx_dmac;
 
@@ -578,6 +582,46 @@ int main(void)
 
 	ad9361_set_tx_fir_config(ad9361_phy_b, tx_fir_config);
 	ad9361_set_rx_fir_config(ad9361_phy_b, rx_fir_config);
+#endif
+#if !defined AXI_ADC_NOT_PRESENT && \
+	(defined XILINX_PLATFORM || defined ALTERA_PLATFORM) && \
+	(defined ADC_DMA_EXAMPLE) && (defined ADC_DMA_IRQ_EXAMPLE)
+	/**
+	 * Xilinx platform dependent initialization for IRQ.
+	 */
+	struct xil_irq_init_param xil_irq_init_par = {
+		.type = IRQ_PS,
+	};
+
+	/**
+	 * IRQ initial configuration.
+	 */
+	struct no_os_irq_init_param irq_init_param = {
+		.irq_ctrl_id = INTC_DEVICE_ID,
+		.platform_ops = &xil_irq_ops,
+		.extra = &xil_irq_init_par,
+	};
+
+	/**
+	 * IRQ instance.
+	 */
+	struct no_os_irq_ctrl_desc *irq_desc;
+
+	status = no_os_irq_ctrl_init(&irq_desc, &irq_init_param);
+	if(status < 0)
+		return status;
+
+	status = no_os_irq_global_enable(irq_desc);
+	if (status < 0)
+		return status;
+
+	/* The DMAC drivers mask their interrupt while updating the queue */
+	rx_dmac_init.irq_ctrl = irq_desc;
+	rx_dmac_init.irq_id = XPAR_FABRIC_AXI_AD9361_ADC_DMA_IRQ_INTR;
+#ifdef DAC_DMA_EXAMPLE
+	tx_dmac_init.irq_ctrl = irq_desc;
+	tx_dmac_init.irq_id = XPAR_FABRIC_AXI_AD9361_DAC_DMA_IRQ_INTR;
+#endif
 #endif
 	status = axi_dmac_init(&tx_dmac, &tx_dmac_init);
 	if (status < 0) {
@@ -626,35 +670,6 @@ int main(void)
 	(defined ADC_DMA_EXAMPLE)
 	uint32_t samples = 16384;
 #if (defined ADC_DMA_IRQ_EXAMPLE)
-	/**
-	 * Xilinx platform dependent initialization for IRQ.
-	 */
-	struct xil_irq_init_param xil_irq_init_par = {
-		.type = IRQ_PS,
-	};
-
-	/**
-	 * IRQ initial configuration.
-	 */
-	struct no_os_irq_init_param irq_init_param = {
-		.irq_ctrl_id = INTC_DEVICE_ID,
-		.platform_ops = &xil_irq_ops,
-		.extra = &xil_irq_init_par,
-	};
-
-	/**
-	 * IRQ instance.
-	 */
-	struct no_os_irq_ctrl_desc *irq_desc;
-
-	status = no_os_irq_ctrl_init(&irq_desc, &irq_init_param);
-	if(status < 0)
-		return status;
-
-	status = no_os_irq_global_enable(irq_desc);
-	if (status < 0)
-		return status;
-
 	struct no_os_callback_desc rx_dmac_callback = {
 		.ctx = rx_dmac,
 		.callback = axi_dmac_default_isr,
@@ -233,7 +233,7 @@ int main(void)
 	hal.extra_gpio = &hal_gpio_param;
 #endif
 	int t;
-	struct adi_hal hal[TALISE_DEVICE_ID_MAX];
+	struct adi_hal hal[TALISE_DEVICE_ID_MAX] = {0};
 	taliseDevice_t tal[TALISE_DEVICE_ID_MAX];
 	for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
 		hal[t].extra_gpio= &hal_gpio_param;
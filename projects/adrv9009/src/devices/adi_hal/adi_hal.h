@@ -26,6 +26,12 @@ struct adi_hal {
 	uint8_t			spi_adrv_csn;
 	void 			*extra_gpio;
 	uint8_t			gpio_adrv_resetb_num;
+	/* SPI transfer buffers, allocated by ADIHAL_openHw() if NULL */
+	uint8_t			*spi_buf;
+	struct no_os_spi_msg	*spi_msgs;
+	/* SPI instruction mode of the device, tracked by the HAL */
+	uint8_t			spi_mode;
+	uint8_t			spi_addr_ascend;
 };
 
 /**
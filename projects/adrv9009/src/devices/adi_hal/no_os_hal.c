@@ -41,6 +41,8 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
 #include "adi_hal.h"
 #include "parameters.h"
 #include "no_os_spi.h"
@@ -50,6 +52,27 @@
 #include "no_os_error.h"
 #include "no_os_delay.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ADIHAL_SPI_CONFIG_A			0x0000
+#define ADIHAL_SPI_CONFIG_A_SOFT_RESET		0x81
+#define ADIHAL_SPI_CONFIG_A_ASCEND		0x24
+#define ADIHAL_SPI_CONFIG_B			0x0001
+#define ADIHAL_SPI_CONFIG_B_SINGLE_INSTR	0x80
+#define ADIHAL_SPI_READ				0x80
+#define ADIHAL_SPI_BUF_SIZE			(HAL_SPIWRITEARRAY_BUFFERSIZE * 3)
+
+/* SPI instruction modes of the device */
+enum adi_hal_spi_mode {
+	/* Mode not known yet, one transaction per register */
+	ADIHAL_SPI_MODE_UNKNOWN,
+	/* Each instruction accesses one register, CS may stay asserted */
+	ADIHAL_SPI_MODE_SINGLE_INSTR,
+	/* Instructions access consecutive registers until CS is deasserted */
+	ADIHAL_SPI_MODE_STREAMING,
+};
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
@@ -85,6 +108,23 @@ adiHalErr_t ADIHAL_openHw(void *devHalInfo, uint32_t halTimeout_ms)
 		gpio_adrv_sysref_req_param.extra = dev_hal_data->extra_gpio;
 	}
 
+	dev_hal_data->spi_mode = ADIHAL_SPI_MODE_UNKNOWN;
+	dev_hal_data->spi_addr_ascend = 0;
+	/* Keep the buffers of a previous open, they have a fixed size. */
+	if (!dev_hal_data->spi_buf)
+		dev_hal_data->spi_buf = calloc(ADIHAL_SPI_BUF_SIZE,
+					       sizeof(uint8_t));
+	if (!dev_hal_data->spi_msgs)
+		dev_hal_data->spi_msgs = calloc(HAL_SPIWRITEARRAY_BUFFERSIZE,
+						sizeof(struct no_os_spi_msg));
+	if (!dev_hal_data->spi_buf || !dev_hal_data->spi_msgs) {
+		free(dev_hal_data->spi_buf);
+		dev_hal_data->spi_buf = NULL;
+		free(dev_hal_data->spi_msgs);
+		dev_hal_data->spi_msgs = NULL;
+		return ADIHAL_ERR;
+	}
+
 	status = no_os_gpio_get(&dev_hal_data->gpio_adrv_resetb,
 				&gpio_adrv_resetb_param);
 
@@ -122,6 +162,11 @@ adiHalErr_t ADIHAL_closeHw(void *devHalInfo)
 
 	status |= no_os_spi_remove(dev_hal_data->spi_adrv_desc);
 
+	free(dev_hal_data->spi_buf);
+	dev_hal_data->spi_buf = NULL;
+	free(dev_hal_data->spi_msgs);
+	dev_hal_data->spi_msgs = NULL;
+
 	if (status != 0)
 		return ADIHAL_ERR;
 	else
@@ -139,6 +184,8 @@ adiHalErr_t ADIHAL_resetHw(void *devHalInfo)
 	no_os_gpio_direction_output(devHalData->gpio_adrv_resetb, 1);
 	no_os_mdelay(10);
 
+	devHalData->spi_mode = ADIHAL_SPI_MODE_UNKNOWN;
+
 	return ADIHAL_OK;
 }
 
@@ -161,6 +208,113 @@ adiHalErr_t ADIHAL_sysrefReq(void *devHalInfo, sysrefReqMode_t mode)
 
 }
 
+/* Track the writes to the SPI configuration registers of the device */
+static void ADIHAL_spiTrackConfig(struct adi_hal *devHalData,
+				  uint16_t addr, uint8_t data)
+{
+	if (addr == ADIHAL_SPI_CONFIG_A) {
+		devHalData->spi_addr_ascend = !!(data & ADIHAL_SPI_CONFIG_A_ASCEND);
+		/* The device is back to its default SPI settings */
+		if (data & ADIHAL_SPI_CONFIG_A_SOFT_RESET)
+			devHalData->spi_mode = ADIHAL_SPI_MODE_UNKNOWN;
+	} else if (addr == ADIHAL_SPI_CONFIG_B) {
+		if (data & ADIHAL_SPI_CONFIG_B_SINGLE_INSTR)
+			devHalData->spi_mode = ADIHAL_SPI_MODE_SINGLE_INSTR;
+		else
+			devHalData->spi_mode = ADIHAL_SPI_MODE_STREAMING;
+	}
+}
+
+/* Check if addr[i] needs its own instruction or continues the previous one */
+static bool ADIHAL_spiNewInstr(struct adi_hal *devHalData, uint16_t *addr,
+			       uint32_t i, uint32_t first)
+{
+	uint16_t next;
+
+	if (i == first || devHalData->spi_mode != ADIHAL_SPI_MODE_STREAMING)
+		return true;
+
+	if (devHalData->spi_addr_ascend)
+		next = addr[i - 1] + 1;
+	else
+		next = addr[i - 1] - 1;
+
+	return addr[i] != next;
+}
+
+/*
+ * Access an array of registers with as few SPI transactions as possible.
+ * In streaming mode runs of consecutive addresses share one instruction, in
+ * single instruction mode all the instructions share one chip select
+ * assertion. The resulting messages are sent with a single
+ * no_os_spi_transfer() call for each buffer worth of registers.
+ */
+static adiHalErr_t ADIHAL_spiXferBytes(struct adi_hal *devHalData,
+				       uint16_t *addr, uint8_t *data,
+				       uint32_t count, bool read)
+{
+	struct no_os_spi_msg *msg = NULL;
+	uint8_t *buf = devHalData->spi_buf;
+	uint32_t first, i, j, len, nb_msgs;
+	int32_t status;
+	bool new_instr;
+
+	first = 0;
+	while (first < count) {
+		len = 0;
+		nb_msgs = 0;
+		for (i = first; i < count; i++) {
+			new_instr = ADIHAL_spiNewInstr(devHalData, addr, i, first);
+			if (len + (new_instr ? 3 : 1) > ADIHAL_SPI_BUF_SIZE)
+				break;
+
+			if (new_instr) {
+				if (!nb_msgs ||
+				    devHalData->spi_mode != ADIHAL_SPI_MODE_SINGLE_INSTR) {
+					msg = &devHalData->spi_msgs[nb_msgs++];
+					msg->tx_buff = &buf[len];
+					msg->rx_buff = &buf[len];
+					msg->bytes_number = 0;
+					msg->cs_change = 1;
+				}
+				buf[len++] = (read ? ADIHAL_SPI_READ : 0) |
+					     ((addr[i] >> 8) & 0x7F);
+				buf[len++] = addr[i] & 0xFF;
+				msg->bytes_number += 2;
+			}
+			buf[len++] = read ? 0x00 : data[i];
+			msg->bytes_number++;
+
+			/* The next instructions may have to be packed differently */
+			if (!read && (addr[i] == ADIHAL_SPI_CONFIG_A ||
+				      addr[i] == ADIHAL_SPI_CONFIG_B)) {
+				i++;
+				break;
+			}
+		}
+
+		status = no_os_spi_transfer(devHalData->spi_adrv_desc,
+					    devHalData->spi_msgs, nb_msgs);
+		if (status != 0)
+			return ADIHAL_SPI_FAIL;
+
+		len = 0;
+		for (j = first; j < i; j++) {
+			if (read) {
+				if (ADIHAL_spiNewInstr(devHalData, addr, j, first))
+					len += 2;
+				data[j] = buf[len++];
+			} else {
+				ADIHAL_spiTrackConfig(devHalData, addr[j], data[j]);
+			}
+		}
+
+		first = i;
+	}
+
+	return ADIHAL_OK;
+}
+
 adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo,
 				uint16_t addr, uint8_t data)
 {
@@ -175,23 +329,17 @@ adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo,
 
 	if (status != 0)
 		return ADIHAL_SPI_FAIL;
-	else
-		return ADIHAL_OK;
+
+	ADIHAL_spiTrackConfig(devHalData, addr, data);
+
+	return ADIHAL_OK;
 }
 
 adiHalErr_t ADIHAL_spiWriteBytes(void *devHalInfo,
 				 uint16_t *addr, uint8_t *data, uint32_t count)
 {
-	adiHalErr_t errVal;
-	uint32_t i;
-
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiWriteByte(devHalInfo, addr[i], data[i]);
-		if (errVal)
-			return errVal;
-	}
-
-	return ADIHAL_OK;
+	return ADIHAL_spiXferBytes((struct adi_hal *)devHalInfo, addr, data,
+				   count, false);
 }
 
 adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
@@ -218,16 +366,8 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
 adiHalErr_t ADIHAL_spiReadBytes(void *devHalInfo,
 				uint16_t *addr, uint8_t *readdata, uint32_t count)
 {
-	adiHalErr_t errVal;
-	uint32_t i;
-
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiReadByte(devHalInfo, addr[i], &readdata[i]);
-		if (errVal)
-			return errVal;
-	}
-
-	return ADIHAL_OK;
+	return ADIHAL_spiXferBytes((struct adi_hal *)devHalInfo, addr, readdata,
+				   count, true);
 }
 
 adiHalErr_t ADIHAL_spiWriteField(void *devHalInfo,
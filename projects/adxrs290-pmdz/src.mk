@@ -27,6 +27,8 @@ SRC_DIRS += $(INCLUDE)
 SRCS +=	$(DRIVERS)/api/no_os_irq.c \
 	$(DRIVERS)/api/no_os_gpio.c \
 	$(NO-OS)/util/no_os_list.c \
+	$(NO-OS)/util/no_os_pool.c \
 	$(NO-OS)/util/no_os_fifo.c \
 	$(NO-OS)/util/no_os_util.c \
+	$(NO-OS)/util/no_os_mutex.c \
 	$(DRIVERS)/api/no_os_spi.c
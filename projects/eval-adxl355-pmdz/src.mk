@@ -1,15 +1,19 @@
 SRC_DIRS += $(PROJECT)/src
 
-SRCS +=	$(NO-OS)/util/no_os_util.c
+SRCS +=	$(NO-OS)/util/no_os_util.c \
+	$(NO-OS)/util/no_os_mutex.c \
+	$(NO-OS)/util/no_os_ring.c
 
 INCS +=	$(INCLUDE)/no_os_uart.h \
 	$(INCLUDE)/no_os_spi.h \
 	$(INCLUDE)/no_os_i2c.h \
 	$(INCLUDE)/no_os_util.h \
+	$(INCLUDE)/no_os_mutex.h \
 	$(INCLUDE)/no_os_error.h \
 	$(INCLUDE)/no_os_delay.h \
 	$(INCLUDE)/no_os_timer.h \
 	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_ring.h \
 	$(INCLUDE)/no_os_rtc.h \
     $(INCLUDE)/no_os_util.h \
     $(INCLUDE)/no_os_print_log.h \
@@ -18,6 +22,7 @@ INCS +=	$(INCLUDE)/no_os_uart.h \
 SRCS += $(DRIVERS)/api/no_os_spi.c \
 	$(DRIVERS)/api/no_os_i2c.c \
 	$(DRIVERS)/api/no_os_gpio.c \
+	$(DRIVERS)/api/no_os_irq.c \
 	$(DRIVERS)/accel/adxl355/adxl355.c
 
 INCS += $(DRIVERS)/accel/adxl355/adxl355.h
@@ -0,0 +1,136 @@
+/***************************************************************************//**
+ *   @file   crc8_test.c
+ *   @brief  Known answer tests of the CRC-8 implementation.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_crc8.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_RANDOM_RUNS	100000
+#define MAX_LEN		64
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Bit by bit reference implementation, MSB first */
+static uint8_t crc8_bitwise(uint8_t poly, const uint8_t *data, size_t len,
+			    uint8_t crc)
+{
+	uint8_t bit;
+
+	while (len--) {
+		for (bit = 0x80; bit; bit >>= 1) {
+			if (!!(crc & 0x80) != !!(*data & bit))
+				crc = (crc << 1) ^ poly;
+			else
+				crc <<= 1;
+		}
+		data++;
+	}
+
+	return crc;
+}
+
+int main(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint8_t tables[4][NO_OS_CRC8_TABLE_SIZE];
+	uint8_t table[NO_OS_CRC8_TABLE_SIZE];
+	uint8_t buf[MAX_LEN];
+	uint8_t ref, crc;
+	int errors = 0;
+	size_t len;
+	int i, j;
+
+	/* CRC-8/SMBUS check value */
+	crc = no_os_crc8_slice4(no_os_crc8_poly_0x07, check, 9, 0);
+	if (crc != 0xf4) {
+		printf("check value 0x%02x, expected 0xf4\n", crc);
+		errors++;
+	}
+
+	/* The precomputed tables match the generated ones */
+	no_os_crc8_populate_slice4_msb(tables, 0x07);
+	if (memcmp(tables, no_os_crc8_poly_0x07, sizeof(tables))) {
+		printf("no_os_crc8_poly_0x07 differs from the generated table\n");
+		errors++;
+	}
+
+	no_os_crc8_populate_msb(table, 0x31);
+	no_os_crc8_populate_slice4_msb(tables, 0x31);
+	srand(1);
+	for (i = 0; i < NB_RANDOM_RUNS; i++) {
+		len = rand() % MAX_LEN;
+		for (j = 0; j < (int)len; j++)
+			buf[j] = rand();
+		crc = rand();
+
+		ref = crc8_bitwise(0x07, buf, len, crc);
+		if (no_os_crc8_slice4(no_os_crc8_poly_0x07, buf, len, crc) !=
+		    ref) {
+			printf("slice4 0x07 mismatch, len %zu\n", len);
+			errors++;
+		}
+
+		ref = crc8_bitwise(0x31, buf, len, crc);
+		if (no_os_crc8(table, buf, len, crc) != ref) {
+			printf("bytewise 0x31 mismatch, len %zu\n", len);
+			errors++;
+		}
+		if (no_os_crc8_slice4(tables, buf, len, crc) != ref) {
+			printf("slice4 0x31 mismatch, len %zu\n", len);
+			errors++;
+		}
+
+		if (errors > 10)
+			break;
+	}
+
+	printf("crc8: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
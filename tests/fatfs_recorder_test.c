@@ -0,0 +1,373 @@
+/***************************************************************************//**
+ *   @file   fatfs_recorder_test.c
+ *   @brief  Test and benchmark of the FatFs sample recorder on a RAM disk.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "fatfs_recorder.h"
+#include "iio.h"
+#include "no_os_circular_buffer.h"
+#include "no_os_timer.h"
+#include "no_os_util.h"
+#include "ram_disk.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_CH		4
+#define SCAN_LEN	(NB_CH * sizeof(uint16_t))
+#define TOTAL		(16 * 1024 * 1024)
+#define FILE_SIZE	(4 * 1024 * 1024)
+/* 64 MiB disk */
+#define DISK_SECTORS	(128 * 1024)
+#define CB_SIZE		(4 * 65536)
+/* Scans written to the circular buffer at once */
+#define CB_CHUNK	1000
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct scan_type scan_type = {
+	.sign = 's',
+	.realbits = 16,
+	.storagebits = 16,
+	.is_big_endian = false,
+};
+
+static struct iio_channel channels[NB_CH];
+static char channel_names[NB_CH][16];
+/* Number of scans generated, sample c of scan s is s * NB_CH + c */
+static uint64_t scans;
+/* Block queued by submit(), filled on the next call */
+static void *in_flight;
+static uint16_t data[8192];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+static void generate(void *buff, uint32_t nb_scans)
+{
+	uint16_t *sample = buff;
+	int c;
+
+	while (nb_scans--) {
+		for (c = 0; c < NB_CH; c++)
+			*sample++ = scans * NB_CH + c;
+		scans++;
+	}
+}
+
+static int32_t adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
+{
+	generate(buff, nb_samples);
+
+	return nb_samples;
+}
+
+/* Acts as a DMA completing one block per call */
+static int32_t adc_submit(struct iio_device_data *dev)
+{
+	struct iio_buffer *buffer = dev->buffer;
+	void *addr;
+
+	if (in_flight) {
+		generate(in_flight,
+			 buffer->block_size / buffer->bytes_per_scan);
+		in_flight = NULL;
+		if (iio_buffer_dequeue_block(buffer))
+			return -1;
+	}
+
+	if (!iio_buffer_queue_block(buffer, &addr))
+		in_flight = addr;
+
+	return 0;
+}
+
+static int32_t adc_post_disable(void *dev)
+{
+	in_flight = NULL;
+
+	return 0;
+}
+
+static struct iio_device adc = {
+	.num_ch = NB_CH,
+	.channels = channels,
+	.read_dev = adc_read_dev,
+	.submit = adc_submit,
+	.post_disable = adc_post_disable,
+};
+
+/* Check that the files hold all the scans generated, in order */
+static int verify(uint32_t nb_files)
+{
+	uint64_t expected = 0;
+	char header[512];
+	char path[32];
+	char *offset;
+	uint32_t k;
+	UINT len, i;
+	FIL f;
+
+	for (k = 0; k < nb_files; k++) {
+		snprintf(path, sizeof(path), "0:/cap_%04" PRIu32 ".bin", k);
+		if (f_open(&f, path, FA_READ)) {
+			printf("cannot open %s\n", path);
+			return -1;
+		}
+
+		f_read(&f, header, sizeof(header) - 1, &len);
+		header[len] = '\0';
+		offset = strstr(header, "data ");
+		if (!offset) {
+			printf("no data offset in %s\n", path);
+			goto fail;
+		}
+
+		f_lseek(&f, atoi(offset + 5));
+		do {
+			if (f_read(&f, data, sizeof(data), &len))
+				goto fail;
+			for (i = 0; i < len / sizeof(data[0]); i++) {
+				if (data[i] != (uint16_t)expected++) {
+					printf("bad sample in %s\n", path);
+					goto fail;
+				}
+			}
+		} while (len);
+
+		f_close(&f);
+	}
+
+	if (expected != scans * NB_CH) {
+		printf("%" PRIu64 " samples recorded out of %" PRIu64 "\n",
+		       expected, scans * NB_CH);
+		return -1;
+	}
+
+	return 0;
+fail:
+	f_close(&f);
+
+	return -1;
+}
+
+/* Baseline: 4 KiB read_dev() calls each followed by an f_write() */
+static int run_baseline(void)
+{
+	uint64_t start, stall, max_stall = 0;
+	uint32_t in_file = 0, nb_files = 0;
+	uint8_t buff[4096];
+	char path[32];
+	uint32_t done;
+	UINT len;
+	FIL f;
+
+	scans = 0;
+	start = now_ns();
+	for (done = 0; done < TOTAL; done += sizeof(buff)) {
+		adc_read_dev(NULL, buff, sizeof(buff) / SCAN_LEN);
+
+		stall = now_ns();
+		if (!done || in_file + sizeof(buff) > FILE_SIZE) {
+			if (done)
+				f_close(&f);
+			snprintf(path, sizeof(path), "0:/raw_%04" PRIu32 ".bin",
+				 nb_files++);
+			if (f_open(&f, path, FA_WRITE | FA_CREATE_ALWAYS))
+				return -1;
+			in_file = 0;
+		}
+		if (f_write(&f, buff, sizeof(buff), &len) ||
+		    len != sizeof(buff))
+			return -1;
+		in_file += len;
+		stall = now_ns() - stall;
+		max_stall = no_os_max(max_stall, stall);
+	}
+	f_close(&f);
+
+	printf("  %-9s %7.1f MB/s, max stall %7.1f us\n", "f_write",
+	       TOTAL / 1e6 / ((now_ns() - start) / 1e9), max_stall / 1e3);
+
+	return 0;
+}
+
+static int run(enum fatfs_recorder_source source, const char *name,
+	       struct no_os_timer_desc *timer)
+{
+	struct fatfs_recorder_init_param param = {
+		.path = "0:/cap",
+		.name = "adc",
+		.source = source,
+		.iio_dev = &adc,
+		.ch_mask = NO_OS_GENMASK(NB_CH - 1, 0),
+		.buff_size = 32768,
+		.nb_buffs = 4,
+		.file_size = FILE_SIZE,
+		.timer = timer,
+	};
+	struct no_os_circular_buffer *cb = NULL;
+	struct fatfs_recorder_stats stats;
+	struct fatfs_recorder *rec;
+	uint8_t chunk[CB_CHUNK * SCAN_LEN];
+	unsigned long writes, sectors;
+	uint64_t start;
+	uint32_t used;
+	int ret = -1;
+
+	if (source == FATFS_RECORDER_CB) {
+		if (no_os_cb_init(&cb, CB_SIZE))
+			return -1;
+		param.cb = cb;
+	}
+
+	if (fatfs_recorder_init(&rec, &param))
+		goto free_cb;
+
+	scans = 0;
+	writes = ram_disk_stats.writes;
+	sectors = ram_disk_stats.write_sectors;
+	start = now_ns();
+	if (fatfs_recorder_start(rec))
+		goto remove;
+
+	while (scans * SCAN_LEN < TOTAL) {
+		if (cb) {
+			no_os_cb_size(cb, &used);
+			if (cb->size - used >= sizeof(chunk)) {
+				generate(chunk, CB_CHUNK);
+				no_os_cb_write(cb, chunk, sizeof(chunk));
+			}
+		}
+		if (fatfs_recorder_step(rec))
+			goto remove;
+	}
+
+	if (fatfs_recorder_stop(rec))
+		goto remove;
+
+	fatfs_recorder_get_stats(rec, &stats);
+	writes = ram_disk_stats.writes - writes;
+	sectors = ram_disk_stats.write_sectors - sectors;
+	printf("  %-9s %7.1f MB/s, max stall %7.1f us, %" PRIu32
+	       " files, %.1f sectors per disk write\n", name,
+	       TOTAL / 1e6 / ((now_ns() - start) / 1e9),
+	       stats.max_write_ns / 1e3, stats.files,
+	       (double)sectors / writes);
+
+	if (stats.overruns)
+		printf("%" PRIu32 " overruns\n", stats.overruns);
+	else
+		ret = verify(stats.files);
+remove:
+	fatfs_recorder_remove(rec);
+free_cb:
+	no_os_cb_remove(cb);
+
+	return ret;
+}
+
+int main(void)
+{
+	struct no_os_timer_init_param timer_param = {
+		.freq_hz = 1000000,
+	};
+	MKFS_PARM opt = {
+		.fmt = FM_ANY,
+		.au_size = 16384,
+	};
+	struct no_os_timer_desc *timer;
+	BYTE work[FF_MAX_SS];
+	FATFS fs;
+	int i;
+
+	for (i = 0; i < NB_CH; i++) {
+		snprintf(channel_names[i], sizeof(channel_names[i]),
+			 "voltage%d", i);
+		channels[i] = (struct iio_channel) {
+			.name = channel_names[i],
+			.ch_type = IIO_VOLTAGE,
+			.channel = i,
+			.scan_index = i,
+			.scan_type = &scan_type,
+			.indexed = true,
+		};
+	}
+
+	if (ram_disk_init(DISK_SECTORS) ||
+	    f_mkfs("0:", &opt, work, sizeof(work)) || f_mount(&fs, "0:", 1) ||
+	    no_os_timer_init(&timer, &timer_param) ||
+	    no_os_timer_start(timer))
+		goto fail;
+
+	printf("recording %d MiB of %d channels:\n", TOTAL >> 20, NB_CH);
+	if (run_baseline() ||
+	    run(FATFS_RECORDER_READ_DEV, "read_dev", timer) ||
+	    run(FATFS_RECORDER_SUBMIT, "submit", timer) ||
+	    run(FATFS_RECORDER_CB, "cb", timer))
+		goto fail;
+
+	printf("fatfs_recorder: ok\n");
+
+	return 0;
+fail:
+	printf("fatfs_recorder: FAILED\n");
+
+	return 1;
+}
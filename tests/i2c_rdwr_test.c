@@ -0,0 +1,197 @@
+/***************************************************************************//**
+ *   @file   i2c_rdwr_test.c
+ *   @brief  Tests of the combined I2C_RDWR transfers of the Linux I2C driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "no_os_i2c.h"
+#include "linux_i2c.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_READS	100
+#define SLAVE_ADDRESS	0x1d
+#define REG_ADDRESS	0x10
+/* Any valid descriptor, the i2c-dev calls are redirected to the mocks */
+#define MOCK_FD		3
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Register map of the mocked slave, with an auto incremented pointer */
+static uint8_t regs[256];
+static uint8_t reg_ptr;
+static int nb_syscalls;
+static int nb_slave_ioctls;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static void mock_msg(uint8_t *buf, uint16_t len, bool rd)
+{
+	uint16_t i;
+
+	if (!rd) {
+		reg_ptr = buf[0];
+		return;
+	}
+
+	for (i = 0; i < len; i++)
+		buf[i] = regs[(uint8_t)(reg_ptr + i)];
+}
+
+/* i2c-dev mock, linked with -Wl,--wrap */
+int __wrap_ioctl(int fd, unsigned long req, ...)
+{
+	struct i2c_rdwr_ioctl_data *rdwr;
+	va_list args;
+	uint32_t i;
+
+	nb_syscalls++;
+	if (req == I2C_SLAVE) {
+		nb_slave_ioctls++;
+		return 0;
+	}
+	if (req != I2C_RDWR)
+		return 0;
+
+	va_start(args, req);
+	rdwr = va_arg(args, struct i2c_rdwr_ioctl_data *);
+	va_end(args);
+
+	for (i = 0; i < rdwr->nmsgs; i++)
+		mock_msg(rdwr->msgs[i].buf, rdwr->msgs[i].len,
+			 rdwr->msgs[i].flags & I2C_M_RD);
+
+	return rdwr->nmsgs;
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count)
+{
+	nb_syscalls++;
+	mock_msg((uint8_t *)buf, count, false);
+
+	return count;
+}
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+	nb_syscalls++;
+	mock_msg(buf, count, true);
+
+	return count;
+}
+
+int __wrap_open(const char *path, int flags, ...)
+{
+	return MOCK_FD;
+}
+
+int __wrap_close(int fd)
+{
+	return 0;
+}
+
+int main(void)
+{
+	struct linux_i2c_init_param linux_param = {
+		.device_id = 1,
+	};
+	struct no_os_i2c_init_param param = {
+		.slave_address = SLAVE_ADDRESS,
+		.platform_ops = &linux_i2c_ops,
+		.extra = &linux_param,
+	};
+	uint8_t reg = REG_ADDRESS;
+	uint8_t val[2] = {0};
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buff = &reg, .bytes_number = 1 },
+		{ .buff = val, .bytes_number = 2, .flags = NO_OS_I2C_M_RD },
+	};
+	struct no_os_i2c_desc *desc;
+	int errors = 0;
+	int i;
+
+	for (i = 0; i < 256; i++)
+		regs[i] = i * 3;
+
+	if (no_os_i2c_init(&desc, &param))
+		return 1;
+
+	nb_syscalls = 0;
+	nb_slave_ioctls = 0;
+	for (i = 0; i < NB_READS; i++) {
+		no_os_i2c_write(desc, &reg, 1, 0);
+		no_os_i2c_read(desc, val, 2, 1);
+	}
+	printf("%d register reads, write then read: %d syscalls\n", NB_READS,
+	       nb_syscalls);
+	/* The slave address is selected at most once */
+	if (nb_slave_ioctls > 1 || val[1] != regs[REG_ADDRESS + 1]) {
+		printf("%d I2C_SLAVE ioctls, read 0x%02x\n", nb_slave_ioctls,
+		       val[1]);
+		errors++;
+	}
+
+	val[1] = 0;
+	nb_syscalls = 0;
+	for (i = 0; i < NB_READS; i++)
+		no_os_i2c_transfer(desc, msgs, 2);
+	printf("%d register reads, combined transfer: %d syscalls\n",
+	       NB_READS, nb_syscalls);
+	if (nb_syscalls != NB_READS || val[1] != regs[REG_ADDRESS + 1]) {
+		printf("expected one I2C_RDWR per read, read 0x%02x\n", val[1]);
+		errors++;
+	}
+
+	no_os_i2c_remove(desc);
+	printf("i2c_rdwr: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
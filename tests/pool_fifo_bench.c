@@ -0,0 +1,232 @@
+/***************************************************************************//**
+ *   @file   pool_fifo_bench.c
+ *   @brief  Benchmark of the pooled list and fifo nodes.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "no_os_fifo.h"
+#include "no_os_list.h"
+#include "no_os_pool.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_OPS		200000
+/* Elements in flight in the list */
+#define LIST_DEPTH	64
+#define FIFO_DATA_LEN	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum list_mode {
+	LIST_HEAP,
+	LIST_POOL,
+	LIST_LINK,
+};
+
+struct item {
+	int val;
+	struct no_os_list_elem node;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Queue with LIST_DEPTH elements in flight */
+static int bench_list(enum list_mode mode)
+{
+	static const char * const names[] = {"heap", "pool", "link"};
+	struct no_os_list_desc *list;
+	struct item *items;
+	int errors = 0;
+	uint32_t size;
+	double t0;
+	void *data;
+	long i;
+
+	if (mode == LIST_POOL)
+		no_os_list_init_pool(&list, NO_OS_LIST_QUEUE, NULL,
+				     LIST_DEPTH);
+	else
+		no_os_list_init(&list, NO_OS_LIST_QUEUE, NULL);
+
+	items = calloc(LIST_DEPTH, sizeof(*items));
+	if (!list || !items)
+		return 1;
+
+	t0 = now();
+	for (i = 0; i < NB_OPS; i++) {
+		if (mode == LIST_LINK)
+			no_os_list_link_last(list, &items[i % LIST_DEPTH].node,
+					     &items[i % LIST_DEPTH]);
+		else
+			list->push(list, (void *)i);
+		if (i < LIST_DEPTH - 1)
+			continue;
+
+		list->pop(list, &data);
+		if (mode != LIST_LINK && (long)data != i - LIST_DEPTH + 1)
+			errors++;
+	}
+	no_os_list_get_size(list, &size);
+	printf("list %s: %.1f ns/op\n", names[mode],
+	       (now() - t0) / NB_OPS * 1e9);
+
+	if (size != LIST_DEPTH - 1)
+		errors++;
+
+	no_os_list_remove(list);
+	free(items);
+
+	return errors;
+}
+
+/* More elements than the pool can hold, the rest come from the heap */
+static int test_list_fallback(void)
+{
+	struct no_os_list_desc *list;
+	int errors = 0;
+	void *data;
+	long i;
+
+	no_os_list_init_pool(&list, NO_OS_LIST_QUEUE, NULL, 4);
+	if (!list)
+		return 1;
+
+	for (i = 0; i < 10; i++)
+		list->push(list, (void *)i);
+	for (i = 0; i < 10; i++) {
+		list->pop(list, &data);
+		if ((long)data != i)
+			errors++;
+	}
+	no_os_list_remove(list);
+
+	if (errors)
+		printf("pool exhaustion broke the list order\n");
+
+	return errors;
+}
+
+static int bench_fifo(uint32_t depth)
+{
+	struct no_os_fifo_element *fifo = NULL;
+	char buf[FIFO_DATA_LEN];
+	struct no_os_pool *pool;
+	double heap_ns, pool_ns;
+	int errors = 0;
+	uint32_t i;
+	double t0;
+
+	memset(buf, 0x5a, sizeof(buf));
+
+	t0 = now();
+	for (i = 0; i < NB_OPS; i++) {
+		no_os_fifo_insert(&fifo, buf, FIFO_DATA_LEN);
+		if (i >= depth)
+			fifo = no_os_fifo_remove(fifo);
+	}
+	heap_ns = (now() - t0) / NB_OPS * 1e9;
+	while (fifo)
+		fifo = no_os_fifo_remove(fifo);
+
+	if (no_os_pool_init(&pool, sizeof(*fifo) + FIFO_DATA_LEN, depth + 1))
+		return 1;
+
+	t0 = now();
+	for (i = 0; i < NB_OPS; i++) {
+		no_os_fifo_insert_pool(&fifo, pool, buf, FIFO_DATA_LEN);
+		if (i >= depth) {
+			if (fifo->len != FIFO_DATA_LEN ||
+			    memcmp(fifo->data, buf, FIFO_DATA_LEN))
+				errors++;
+			fifo = no_os_fifo_remove(fifo);
+		}
+	}
+	pool_ns = (now() - t0) / NB_OPS * 1e9;
+	while (fifo)
+		fifo = no_os_fifo_remove(fifo);
+
+	printf("fifo depth %4u: heap %.1f ns/op, pool %.1f ns/op\n", depth,
+	       heap_ns, pool_ns);
+
+	/* All the elements went back to the pool */
+	if (pool->nb_free != pool->nb_objs) {
+		printf("pool leaked %u elements\n",
+		       pool->nb_objs - pool->nb_free);
+		errors++;
+	}
+	no_os_pool_remove(pool);
+
+	return errors;
+}
+
+int main(void)
+{
+	int errors;
+
+	errors = bench_list(LIST_HEAP);
+	errors += bench_list(LIST_POOL);
+	errors += bench_list(LIST_LINK);
+	errors += test_list_fallback();
+	errors += bench_fifo(16);
+	errors += bench_fifo(128);
+	errors += bench_fifo(1024);
+
+	printf("pool_fifo: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+/***************************************************************************//**
+ *   @file   ring_test.c
+ *   @brief  Multi-threaded stress test of the lock-free ring buffer.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "no_os_ring.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_ELEMS_PER_PRODUCER	500000
+#define MAX_THREADS		4
+#define RING_SIZE		1024
+#define READ_BURST		16
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct no_os_ring *ring;
+static int nb_producers, nb_consumers;
+static int producers_done;
+static int order_errors;
+/* Number of times each element was read */
+static uint8_t seen[MAX_THREADS][NB_ELEMS_PER_PRODUCER];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Write producer id << 32 | index, one in three through a write span */
+static void *producer(void *arg)
+{
+	uint64_t id = (uintptr_t)arg;
+	struct no_os_ring_span span;
+	uint64_t val;
+	uint32_t i;
+
+	for (i = 0; i < NB_ELEMS_PER_PRODUCER; i++) {
+		val = id << 32 | i;
+		if (i % 3 == 0) {
+			while (no_os_ring_reserve_write(ring, 1, &span))
+				sched_yield();
+			*(uint64_t *)span.buff = val;
+			no_os_ring_commit_write(ring, &span);
+		} else {
+			while (no_os_ring_push(ring, &val))
+				sched_yield();
+		}
+	}
+
+	__atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	int64_t last[MAX_THREADS] = {-1, -1, -1, -1};
+	struct no_os_ring_span span;
+	uint32_t id, idx, k, size;
+	uint64_t val;
+	int done;
+
+	while (true) {
+		if (no_os_ring_reserve_read(ring, READ_BURST, &span)) {
+			done = __atomic_load_n(&producers_done,
+					       __ATOMIC_ACQUIRE);
+			if (done == nb_producers) {
+				no_os_ring_size(ring, &size);
+				if (!size)
+					break;
+			}
+			sched_yield();
+			continue;
+		}
+
+		for (k = 0; k < span.nb_elems; k++) {
+			val = ((uint64_t *)span.buff)[k];
+			id = val >> 32;
+			idx = (uint32_t)val;
+			if (id >= MAX_THREADS || idx >= NB_ELEMS_PER_PRODUCER) {
+				__atomic_fetch_add(&order_errors, 1,
+						   __ATOMIC_RELAXED);
+				continue;
+			}
+			__atomic_fetch_add(&seen[id][idx], 1,
+					   __ATOMIC_RELAXED);
+			/* A single consumer sees each producer in order */
+			if (nb_consumers == 1 && idx != last[id] + 1)
+				order_errors++;
+			last[id] = idx;
+		}
+		no_os_ring_commit_read(ring, &span);
+	}
+
+	return NULL;
+}
+
+static int run(int producers, int consumers, uint32_t flags)
+{
+	pthread_t threads[2 * MAX_THREADS];
+	int errors = 0;
+	double t0, dt;
+	int i, j;
+
+	nb_producers = producers;
+	nb_consumers = consumers;
+	producers_done = 0;
+	order_errors = 0;
+	for (i = 0; i < MAX_THREADS; i++)
+		for (j = 0; j < NB_ELEMS_PER_PRODUCER; j++)
+			seen[i][j] = 0;
+
+	if (no_os_ring_init(&ring, sizeof(uint64_t), RING_SIZE, flags))
+		return 1;
+
+	t0 = now();
+	for (i = 0; i < producers; i++)
+		pthread_create(&threads[i], NULL, producer,
+			       (void *)(uintptr_t)i);
+	for (i = 0; i < consumers; i++)
+		pthread_create(&threads[producers + i], NULL, consumer, NULL);
+	for (i = 0; i < producers + consumers; i++)
+		pthread_join(threads[i], NULL);
+	dt = now() - t0;
+
+	for (i = 0; i < producers; i++)
+		for (j = 0; j < NB_ELEMS_PER_PRODUCER; j++)
+			if (seen[i][j] != 1)
+				errors++;
+
+	printf("%dP%dC %s: %d lost or duplicated, %d out of order, ",
+	       producers, consumers, flags ? "spsc" : "mpmc", errors,
+	       order_errors);
+	printf("%.1f Mops/s\n",
+	       producers * (double)NB_ELEMS_PER_PRODUCER / dt / 1e6);
+
+	no_os_ring_remove(ring);
+
+	return errors + order_errors;
+}
+
+int main(void)
+{
+	int errors;
+
+	errors = run(1, 1, NO_OS_RING_SPSC);
+	errors += run(1, 1, 0);
+	errors += run(4, 1, 0);
+	errors += run(4, 4, 0);
+
+	printf("ring: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
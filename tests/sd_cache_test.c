@@ -0,0 +1,252 @@
+/***************************************************************************//**
+ *   @file   sd_cache_test.c
+ *   @brief  Test of the SD card block cache on a simulated card.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sd.h"
+#include "sd_sim.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define CARD_BLOCKS	(64 * 1024)
+/* Accesses stay within this many blocks, a few times the cache size */
+#define AREA_BLOCKS	64
+#define NB_ACCESSES	4000
+#define MAX_ACCESS	1500
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint8_t shadow[AREA_BLOCKS * DATA_BLOCK_LEN];
+static uint8_t buf[4 * DATA_BLOCK_LEN];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int open_card(struct sd_desc **sd, struct no_os_spi_desc **spi,
+		     uint32_t cache_blocks, uint32_t read_ahead)
+{
+	struct no_os_spi_init_param spi_param = {
+		.platform_ops = &sd_sim_spi_xfer_ops,
+	};
+	struct sd_init_param sd_param = {
+		.cache_blocks = cache_blocks,
+		.read_ahead = read_ahead,
+		.crc_enable = true,
+	};
+	int ret;
+
+	ret = sd_sim_init(CARD_BLOCKS);
+	if (ret)
+		return ret;
+
+	ret = no_os_spi_init(spi, &spi_param);
+	if (ret)
+		return ret;
+
+	sd_param.spi_desc = *spi;
+
+	return sd_init(sd, &sd_param);
+}
+
+static void close_card(struct sd_desc *sd, struct no_os_spi_desc *spi)
+{
+	sd_remove(sd);
+	no_os_spi_remove(spi);
+	sd_sim_remove();
+}
+
+static unsigned long block_cmds(void)
+{
+	return sd_sim_stats.cmds[17] + sd_sim_stats.cmds[18] +
+	       sd_sim_stats.cmds[24] + sd_sim_stats.cmds[25];
+}
+
+/*
+ * Random unaligned reads and writes, mostly sequential, checked against a
+ * shadow copy of the area. Returns the number of block commands sent or 0
+ * on failure.
+ */
+static unsigned long run_workload(uint32_t cache_blocks, uint32_t read_ahead)
+{
+	struct no_os_spi_desc *spi;
+	struct sd_desc *sd;
+	uint32_t addr = 0;
+	uint32_t len, i, k;
+	unsigned long cmds;
+
+	if (open_card(&sd, &spi, cache_blocks, read_ahead)) {
+		printf("sd_init failed\n");
+		return 0;
+	}
+
+	srand(1);
+	memset(shadow, 0, sizeof(shadow));
+	sd_sim_reset_stats();
+
+	for (i = 0; i < NB_ACCESSES; i++) {
+		len = 1 + rand() % MAX_ACCESS;
+		if (rand() % 4 == 0)
+			addr = rand() % (sizeof(shadow) - MAX_ACCESS);
+		if (addr + len > sizeof(shadow))
+			addr = 0;
+
+		if (rand() % 3 == 0) {
+			for (k = 0; k < len; k++)
+				buf[k] = rand();
+			if (sd_write(sd, buf, addr, len)) {
+				printf("sd_write failed at %u\n", addr);
+				goto fail;
+			}
+			memcpy(shadow + addr, buf, len);
+		} else {
+			if (sd_read(sd, buf, addr, len)) {
+				printf("sd_read failed at %u\n", addr);
+				goto fail;
+			}
+			if (memcmp(buf, shadow + addr, len)) {
+				printf("bad data read at %u\n", addr);
+				goto fail;
+			}
+		}
+		addr += len;
+	}
+
+	if (sd_flush(sd) ||
+	    memcmp(sd_sim_image(), shadow, sizeof(shadow))) {
+		printf("card content differs after sd_flush\n");
+		goto fail;
+	}
+
+	if (sd_sim_stats.crc_errors) {
+		printf("%lu CRC errors on the bus\n", sd_sim_stats.crc_errors);
+		goto fail;
+	}
+
+	cmds = block_cmds();
+	close_card(sd, spi);
+
+	return cmds;
+fail:
+	close_card(sd, spi);
+
+	return 0;
+}
+
+/* A failed write back keeps the dirty blocks and the next flush writes them */
+static int test_flush_failure(void)
+{
+	uint32_t addr = 10 * DATA_BLOCK_LEN + 100;
+	uint32_t len = 4 * DATA_BLOCK_LEN - 200;
+	struct no_os_spi_desc *spi;
+	struct sd_desc *sd;
+	int ret = 1;
+	uint32_t i;
+
+	if (open_card(&sd, &spi, 8, 3)) {
+		printf("sd_init failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < len; i++)
+		buf[i] = i * 7 + 3;
+
+	if (sd_write(sd, buf, addr, len)) {
+		printf("sd_write failed\n");
+		goto out;
+	}
+
+	sd_sim_write_fail = 1;
+	if (!sd_flush(sd)) {
+		printf("sd_flush ignored a rejected block\n");
+		goto out;
+	}
+
+	if (sd_flush(sd)) {
+		printf("sd_flush retry failed\n");
+		goto out;
+	}
+
+	if (memcmp(sd_sim_image() + addr, buf, len)) {
+		printf("dirty blocks lost by the failed sd_flush\n");
+		goto out;
+	}
+
+	ret = 0;
+out:
+	close_card(sd, spi);
+
+	return ret;
+}
+
+int main(void)
+{
+	unsigned long uncached, cached;
+
+	uncached = run_workload(0, 0);
+	cached = run_workload(16, 4);
+	if (!uncached || !cached)
+		goto fail;
+
+	printf("block commands: %lu without cache, %lu with 16 blocks\n",
+	       uncached, cached);
+	if (cached >= uncached / 2) {
+		printf("the cache saves too few commands\n");
+		goto fail;
+	}
+
+	if (test_flush_failure())
+		goto fail;
+
+	printf("sd_cache: ok\n");
+
+	return 0;
+fail:
+	printf("sd_cache: FAILED\n");
+
+	return 1;
+}
@@ -0,0 +1,471 @@
+/***************************************************************************//**
+ *   @file   sd_sim.c
+ *   @brief  SD card simulator, SPI mode, for the host tests.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_delay.h"
+#include "sd_sim.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BLOCK_LEN	512
+/* Bytes of 0xFF sent before a data block */
+#define READ_LATENCY	40
+/* Bytes of busy signal after a data block is written */
+#define WRITE_BUSY	60
+/* Size of the queue of bytes to send, more than a block with its latency */
+#define QUEUE_LEN	2048
+
+#define START_BLOCK		0xFE
+#define START_MULTI_BLOCK	0xFC
+#define STOP_TRAN		0xFD
+#define DATA_ACCEPTED		0xE5
+#define DATA_CRC_ERROR		0xEB
+#define DATA_WRITE_ERROR	0xED
+#define R1_IDLE			0x01
+#define R1_ILLEGAL_CMD		0x04
+#define R1_CRC_ERROR		0x08
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum sd_sim_state {
+	SIM_IDLE,
+	/* CMD18 in progress, blocks are sent until CMD12 */
+	SIM_READ_STREAM,
+	/* Waiting for a data token after CMD24 or CMD25 */
+	SIM_WRITE_TOKEN,
+	SIM_WRITE_DATA,
+};
+
+struct sd_sim {
+	uint8_t *image;
+	uint32_t nb_blocks;
+	/* Bytes to send on the next exchanges */
+	uint8_t queue[QUEUE_LEN];
+	uint32_t q_head;
+	uint32_t q_tail;
+	enum sd_sim_state state;
+	uint8_t cmd[6];
+	uint32_t cmd_idx;
+	uint32_t read_block;
+	/* Block with its CRC-16 being received */
+	uint8_t write_buf[BLOCK_LEN + 2];
+	uint32_t write_idx;
+	uint32_t write_block;
+	bool multi_write;
+	bool app_cmd;
+	bool crc_on;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct sd_sim sim;
+struct sd_sim_stats sd_sim_stats;
+int sd_sim_corrupt;
+int sd_sim_write_fail;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint16_t sim_crc16(const uint8_t *data, uint32_t len)
+{
+	uint16_t crc = 0;
+	int i;
+
+	while (len--) {
+		crc ^= *data++ << 8;
+		for (i = 0; i < 8; i++)
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+
+	return crc;
+}
+
+static uint8_t sim_crc7(const uint8_t *data, uint32_t len)
+{
+	uint8_t crc = 0;
+	uint8_t byte;
+	int i;
+
+	while (len--) {
+		byte = *data++;
+		for (i = 0; i < 8; i++) {
+			crc <<= 1;
+			if (((byte << i) ^ crc) & 0x80)
+				crc ^= 0x09;
+		}
+	}
+
+	return crc & 0x7F;
+}
+
+static void sim_push(uint8_t byte)
+{
+	sim.queue[sim.q_tail++ % QUEUE_LEN] = byte;
+}
+
+static void sim_push_n(uint8_t byte, uint32_t n)
+{
+	while (n--)
+		sim_push(byte);
+}
+
+static uint32_t sim_queued(void)
+{
+	return sim.q_tail - sim.q_head;
+}
+
+/* Queue a data block with its start token and CRC-16 */
+static void sim_push_block(uint32_t block)
+{
+	uint8_t data[BLOCK_LEN];
+	uint16_t crc;
+	uint32_t i;
+
+	if (block < sim.nb_blocks)
+		memcpy(data, sim.image + (size_t)block * BLOCK_LEN, BLOCK_LEN);
+	else
+		memset(data, 0, BLOCK_LEN);
+
+	crc = sim_crc16(data, BLOCK_LEN);
+	if (sd_sim_corrupt) {
+		sd_sim_corrupt--;
+		data[block % BLOCK_LEN] ^= 0x10;
+	}
+
+	sim_push_n(0xFF, READ_LATENCY);
+	sim_push(START_BLOCK);
+	for (i = 0; i < BLOCK_LEN; i++)
+		sim_push(data[i]);
+	sim_push(crc >> 8);
+	sim_push(crc);
+}
+
+static void sim_push_csd(void)
+{
+	uint32_t c_size = sim.nb_blocks / 1024 - 1;
+	uint8_t csd[18] = {0x40};
+	int i;
+
+	/* CSD version 2.0, capacity (c_size + 1) * 512 KiB */
+	csd[7] = (c_size >> 16) & 0x3F;
+	csd[8] = c_size >> 8;
+	csd[9] = c_size;
+
+	sim_push(0x00);
+	sim_push(0xFF);
+	sim_push(START_BLOCK);
+	for (i = 0; i < 18; i++)
+		sim_push(csd[i]);
+}
+
+static void sim_do_cmd(void)
+{
+	uint8_t cmd = sim.cmd[0] & 0x3F;
+	uint32_t arg;
+	bool app;
+
+	arg = (uint32_t)sim.cmd[1] << 24 | sim.cmd[2] << 16 |
+	      sim.cmd[3] << 8 | sim.cmd[4];
+	app = sim.app_cmd;
+	sim.app_cmd = false;
+	sd_sim_stats.cmds[cmd]++;
+
+	/* A command aborts what was queued, the response follows one byte */
+	sim.q_head = 0;
+	sim.q_tail = 0;
+	sim.state = SIM_IDLE;
+	sim_push(0xFF);
+
+	if ((sim.crc_on || cmd == 0 || cmd == 8) &&
+	    ((sim_crc7(sim.cmd, 5) << 1) | 1) != sim.cmd[5]) {
+		sd_sim_stats.crc_errors++;
+		sim_push(R1_CRC_ERROR);
+		return;
+	}
+
+	switch (cmd) {
+	case 0:
+		sim_push(R1_IDLE);
+		break;
+	case 8:
+		sim_push(R1_IDLE);
+		sim_push(0x00);
+		sim_push(0x00);
+		sim_push(0x01);
+		sim_push(0xAA);
+		break;
+	case 9:
+		sim_push_csd();
+		break;
+	case 12:
+		sim_push(0xFF);
+		sim_push(0x00);
+		break;
+	case 17:
+		sim_push(0x00);
+		sim_push_block(arg);
+		break;
+	case 18:
+		sim_push(0x00);
+		sim.read_block = arg;
+		sim_push_block(sim.read_block++);
+		sim.state = SIM_READ_STREAM;
+		break;
+	case 24:
+	case 25:
+		sim_push(0x00);
+		sim.write_block = arg;
+		sim.multi_write = cmd == 25;
+		sim.state = SIM_WRITE_TOKEN;
+		break;
+	case 41:
+		sim_push(app ? 0x00 : R1_ILLEGAL_CMD);
+		break;
+	case 55:
+		sim_push(R1_IDLE);
+		sim.app_cmd = true;
+		break;
+	case 58:
+		/* OCR with CCS set: high capacity card */
+		sim_push(0x00);
+		sim_push(0xC0);
+		sim_push(0xFF);
+		sim_push(0x80);
+		sim_push(0x00);
+		break;
+	case 59:
+		sim.crc_on = arg & 1;
+		sim_push(R1_IDLE);
+		break;
+	default:
+		sim_push(R1_ILLEGAL_CMD);
+		break;
+	}
+}
+
+/* End of a received data block */
+static void sim_write_block(void)
+{
+	uint16_t crc;
+
+	sim.state = sim.multi_write ? SIM_WRITE_TOKEN : SIM_IDLE;
+
+	crc = sim.write_buf[BLOCK_LEN] << 8 | sim.write_buf[BLOCK_LEN + 1];
+	if (sim.crc_on && sim_crc16(sim.write_buf, BLOCK_LEN) != crc) {
+		sd_sim_stats.crc_errors++;
+		sim_push(DATA_CRC_ERROR);
+		sim.state = SIM_IDLE;
+		return;
+	}
+
+	if (sd_sim_write_fail || sim.write_block >= sim.nb_blocks) {
+		if (sd_sim_write_fail)
+			sd_sim_write_fail--;
+		sim_push(DATA_WRITE_ERROR);
+		sim_push_n(0x00, WRITE_BUSY);
+		sim.state = SIM_IDLE;
+		return;
+	}
+
+	memcpy(sim.image + (size_t)sim.write_block++ * BLOCK_LEN,
+	       sim.write_buf, BLOCK_LEN);
+	sim_push(DATA_ACCEPTED);
+	sim_push_n(0x00, WRITE_BUSY);
+}
+
+/* Exchange one byte on the bus */
+static uint8_t sim_exchange(uint8_t in)
+{
+	uint8_t out = 0xFF;
+
+	if (sim_queued())
+		out = sim.queue[sim.q_head++ % QUEUE_LEN];
+	sd_sim_stats.bytes++;
+
+	switch (sim.state) {
+	case SIM_IDLE:
+	case SIM_READ_STREAM:
+		if (sim.cmd_idx || (in & 0xC0) == 0x40) {
+			sim.cmd[sim.cmd_idx++] = in;
+			if (sim.cmd_idx == 6) {
+				sim.cmd_idx = 0;
+				sim_do_cmd();
+			}
+			break;
+		}
+		if (sim.state == SIM_READ_STREAM &&
+		    sim_queued() < BLOCK_LEN + READ_LATENCY + 3)
+			sim_push_block(sim.read_block++);
+		break;
+	case SIM_WRITE_TOKEN:
+		if (in == START_BLOCK || in == START_MULTI_BLOCK) {
+			sim.state = SIM_WRITE_DATA;
+			sim.write_idx = 0;
+		} else if (in == STOP_TRAN && sim.multi_write) {
+			sim_push(0xFF);
+			sim_push_n(0x00, WRITE_BUSY);
+			sim.state = SIM_IDLE;
+		}
+		break;
+	case SIM_WRITE_DATA:
+		sim.write_buf[sim.write_idx++] = in;
+		if (sim.write_idx == sizeof(sim.write_buf))
+			sim_write_block();
+		break;
+	}
+
+	return out;
+}
+
+static int32_t sim_write_and_read(struct no_os_spi_desc *desc, uint8_t *data,
+				  uint16_t bytes_number)
+{
+	uint16_t i;
+
+	sd_sim_stats.xfers++;
+	for (i = 0; i < bytes_number; i++)
+		data[i] = sim_exchange(data[i]);
+
+	return 0;
+}
+
+static int32_t sim_transfer(struct no_os_spi_desc *desc,
+			    struct no_os_spi_msg *msgs, uint32_t len)
+{
+	uint32_t i, k;
+	uint8_t out;
+
+	sd_sim_stats.xfers++;
+	for (k = 0; k < len; k++) {
+		for (i = 0; i < msgs[k].bytes_number; i++) {
+			out = sim_exchange(msgs[k].tx_buff ?
+					   msgs[k].tx_buff[i] : 0x00);
+			if (msgs[k].rx_buff)
+				msgs[k].rx_buff[i] = out;
+		}
+	}
+
+	return 0;
+}
+
+static int32_t sim_spi_init(struct no_os_spi_desc **desc,
+			    const struct no_os_spi_init_param *param)
+{
+	*desc = calloc(1, sizeof(**desc));
+
+	return *desc ? 0 : -1;
+}
+
+static int32_t sim_spi_remove(struct no_os_spi_desc *desc)
+{
+	free(desc);
+
+	return 0;
+}
+
+const struct no_os_spi_platform_ops sd_sim_spi_ops = {
+	.init = sim_spi_init,
+	.write_and_read = sim_write_and_read,
+	.remove = sim_spi_remove,
+};
+
+const struct no_os_spi_platform_ops sd_sim_spi_xfer_ops = {
+	.init = sim_spi_init,
+	.write_and_read = sim_write_and_read,
+	.transfer = sim_transfer,
+	.remove = sim_spi_remove,
+};
+
+/**
+ * @brief Insert a blank card.
+ * @param nb_blocks - Capacity in blocks of 512 bytes, a multiple of 1024.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int sd_sim_init(uint32_t nb_blocks)
+{
+	memset(&sim, 0, sizeof(sim));
+	sim.image = calloc(nb_blocks, BLOCK_LEN);
+	if (!sim.image)
+		return -1;
+
+	sim.nb_blocks = nb_blocks;
+	sd_sim_corrupt = 0;
+	sd_sim_write_fail = 0;
+	sd_sim_reset_stats();
+
+	return 0;
+}
+
+void sd_sim_remove(void)
+{
+	free(sim.image);
+	sim.image = NULL;
+}
+
+uint8_t *sd_sim_image(void)
+{
+	return sim.image;
+}
+
+void sd_sim_reset_stats(void)
+{
+	memset(&sd_sim_stats, 0, sizeof(sd_sim_stats));
+}
+
+/* The card is always ready, only count the waits of the driver */
+void no_os_mdelay(uint32_t msecs)
+{
+	sd_sim_stats.delays++;
+}
+
+void no_os_udelay(uint32_t usecs)
+{
+}
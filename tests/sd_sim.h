@@ -0,0 +1,97 @@
+/***************************************************************************//**
+ *   @file   sd_sim.h
+ *   @brief  SD card simulator, SPI mode, for the host tests.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SD_SIM_H_
+#define SD_SIM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sd_sim_stats
+ * @brief Activity of the simulated card since the last sd_sim_reset_stats()
+ */
+struct sd_sim_stats {
+	/** Number of commands received, indexed by command number */
+	unsigned long cmds[64];
+	/** Bytes exchanged on the bus */
+	unsigned long bytes;
+	/** Calls to the SPI platform ops */
+	unsigned long xfers;
+	/** Calls to no_os_mdelay() */
+	unsigned long delays;
+	/** Commands and data blocks received with a wrong CRC */
+	unsigned long crc_errors;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* SPI ops of a controller with only write_and_read */
+extern const struct no_os_spi_platform_ops sd_sim_spi_ops;
+/* SPI ops of a controller also implementing transfer */
+extern const struct no_os_spi_platform_ops sd_sim_spi_xfer_ops;
+
+extern struct sd_sim_stats sd_sim_stats;
+/* Flip a bit in the data of the next sd_sim_corrupt blocks read */
+extern int sd_sim_corrupt;
+/* Reject the next sd_sim_write_fail blocks written */
+extern int sd_sim_write_fail;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Insert a blank card of nb_blocks blocks of 512 bytes. */
+int sd_sim_init(uint32_t nb_blocks);
+/* Remove the card. */
+void sd_sim_remove(void);
+/* Get the content of the card. */
+uint8_t *sd_sim_image(void);
+/* Clear sd_sim_stats. */
+void sd_sim_reset_stats(void);
+
+#endif // SD_SIM_H_
@@ -0,0 +1,221 @@
+/***************************************************************************//**
+ *   @file   sd_stream_test.c
+ *   @brief  Throughput and CRC test of the SD card streaming API.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "sd.h"
+#include "sd_sim.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define CARD_BLOCKS	(16 * 1024)
+#define TOTAL		(1024 * 1024)
+#define CHUNK		4096
+/* Cost model: 25 MHz SPI clock, 2 us per SPI call and 1 ms per delay */
+#define SPI_HZ		25e6
+#define CALL_SEC	2e-6
+#define DELAY_SEC	1e-3
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint8_t buf[CHUNK];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Estimated MB/s of the traffic seen since the last sd_sim_reset_stats() */
+static double report(const char *name)
+{
+	double sec;
+
+	sec = sd_sim_stats.bytes * 8 / SPI_HZ + sd_sim_stats.xfers * CALL_SEC +
+	      sd_sim_stats.delays * DELAY_SEC;
+	printf("  %-14s %8lu bytes %7lu calls %5.2f MB/s\n", name,
+	       sd_sim_stats.bytes, sd_sim_stats.xfers, TOTAL / sec / 1e6);
+	sd_sim_reset_stats();
+
+	return TOTAL / sec;
+}
+
+static void fill(uint8_t *data, uint32_t addr)
+{
+	uint32_t i;
+
+	for (i = 0; i < CHUNK; i++)
+		data[i] = (addr + i) * 13 + (addr >> 12);
+}
+
+static int check(const uint8_t *data, uint32_t addr)
+{
+	uint8_t ref[CHUNK];
+
+	fill(ref, addr);
+
+	return memcmp(data, ref, CHUNK);
+}
+
+static int run(const struct no_os_spi_platform_ops *ops, bool crc)
+{
+	struct no_os_spi_init_param spi_param = {
+		.platform_ops = ops,
+	};
+	struct sd_init_param sd_param = {
+		.crc_enable = crc,
+	};
+	struct no_os_spi_desc *spi;
+	double blocks, stream;
+	struct sd_desc *sd;
+	uint32_t addr;
+	int ret = 1;
+
+	if (sd_sim_init(CARD_BLOCKS) || no_os_spi_init(&spi, &spi_param))
+		return 1;
+
+	sd_param.spi_desc = spi;
+	if (sd_init(&sd, &sd_param)) {
+		printf("sd_init failed\n");
+		goto free_spi;
+	}
+
+	printf("%s, CRC %s:\n", ops->transfer ? "transfer" : "write_and_read",
+	       crc ? "on" : "off");
+
+	sd_sim_reset_stats();
+	for (addr = 0; addr < TOTAL; addr += CHUNK) {
+		fill(buf, addr);
+		if (sd_write(sd, buf, addr, CHUNK))
+			goto fail;
+	}
+	report("sd_write");
+
+	for (addr = 0; addr < TOTAL; addr += CHUNK) {
+		if (sd_read(sd, buf, addr, CHUNK) || check(buf, addr))
+			goto fail;
+	}
+	blocks = report("sd_read");
+
+	if (sd_stream_write_start(sd, TOTAL))
+		goto fail;
+	for (addr = TOTAL; addr < 2 * TOTAL; addr += CHUNK) {
+		fill(buf, addr);
+		if (sd_stream_write(sd, buf, CHUNK))
+			goto fail;
+	}
+	if (sd_stream_stop(sd))
+		goto fail;
+	report("stream write");
+
+	if (sd_stream_read_start(sd, TOTAL))
+		goto fail;
+	for (addr = TOTAL; addr < 2 * TOTAL; addr += CHUNK) {
+		if (sd_stream_read(sd, buf, CHUNK) || check(buf, addr))
+			goto fail;
+	}
+	if (sd_stream_stop(sd))
+		goto fail;
+	stream = report("stream read");
+
+	if (stream < blocks) {
+		printf("streaming is slower than block reads\n");
+		goto fail;
+	}
+
+	if (sd_read(sd, buf, TOTAL, CHUNK) || check(buf, TOTAL))
+		goto fail;
+
+	if (sd_sim_stats.crc_errors) {
+		printf("%lu CRC errors on the bus\n", sd_sim_stats.crc_errors);
+		goto fail;
+	}
+
+	if (crc) {
+		sd_sim_corrupt = 1;
+		if (!sd_read(sd, buf, 0, CHUNK)) {
+			printf("corrupted block not detected\n");
+			goto fail;
+		}
+		if (sd_read(sd, buf, 0, CHUNK) || check(buf, 0)) {
+			printf("read after a corrupted block failed\n");
+			goto fail;
+		}
+
+		sd_sim_corrupt = 1;
+		if (sd_stream_read_start(sd, 0))
+			goto fail;
+		if (!sd_stream_read(sd, buf, CHUNK)) {
+			printf("corrupted stream block not detected\n");
+			goto fail;
+		}
+		sd_stream_stop(sd);
+	}
+
+	ret = 0;
+	goto out;
+fail:
+	printf("data or command error\n");
+out:
+	sd_remove(sd);
+free_spi:
+	no_os_spi_remove(spi);
+	sd_sim_remove();
+
+	return ret;
+}
+
+int main(void)
+{
+	if (run(&sd_sim_spi_ops, false) || run(&sd_sim_spi_ops, true) ||
+	    run(&sd_sim_spi_xfer_ops, false) ||
+	    run(&sd_sim_spi_xfer_ops, true)) {
+		printf("sd_stream: FAILED\n");
+		return 1;
+	}
+
+	printf("sd_stream: ok\n");
+
+	return 0;
+}
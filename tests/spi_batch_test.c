@@ -0,0 +1,218 @@
+/***************************************************************************//**
+ *   @file   spi_batch_test.c
+ *   @brief  Tests of the batched spidev transfers of the Linux SPI driver.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include "no_os_spi.h"
+#include "no_os_util.h"
+#include "linux_spi.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_WRITES	1000
+#define NB_MSGS		100
+#define BENCH_RUNS	100000
+/* Any valid descriptor, the spidev calls are redirected to the mocks */
+#define MOCK_FD		3
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static int nb_ioctls;
+static int cs_change_errors;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * spidev mock, linked with -Wl,--wrap. The received bytes are the sent ones
+ * inverted, and 0xff when nothing is sent.
+ */
+int __wrap_ioctl(int fd, unsigned long req, ...)
+{
+	struct spi_ioc_transfer *tr;
+	uint8_t *tx, *rx;
+	uint32_t i, j, n;
+	va_list args;
+
+	va_start(args, req);
+	tr = va_arg(args, struct spi_ioc_transfer *);
+	va_end(args);
+
+	if (_IOC_TYPE(req) != SPI_IOC_MAGIC || _IOC_NR(req) != 0 ||
+	    _IOC_DIR(req) != _IOC_WRITE)
+		return 0;
+
+	nb_ioctls++;
+	n = _IOC_SIZE(req) / sizeof(*tr);
+	for (i = 0; i < n; i++) {
+		tx = (uint8_t *)(uintptr_t)tr[i].tx_buf;
+		rx = (uint8_t *)(uintptr_t)tr[i].rx_buf;
+		if (rx)
+			for (j = 0; j < tr[i].len; j++)
+				rx[j] = (tx ? tx[j] : 0) ^ 0xff;
+	}
+	/* The chip select must be released after the message */
+	if (n && tr[n - 1].cs_change)
+		cs_change_errors++;
+
+	return n;
+}
+
+int __wrap_open(const char *path, int flags, ...)
+{
+	return MOCK_FD;
+}
+
+int __wrap_close(int fd)
+{
+	return 0;
+}
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+	struct no_os_spi_init_param param = {
+		.max_speed_hz = 1000000,
+		.platform_ops = &linux_spi_ops,
+	};
+	static uint8_t regs[NB_WRITES][3];
+	struct no_os_spi_msg msgs[NB_MSGS];
+	struct no_os_spi_desc *desc;
+	uint8_t tx[2] = {1, 2};
+	uint8_t rx[2] = {0};
+	int plain_ioctls;
+	int errors = 0;
+	int32_t ret;
+	double t0;
+	int i;
+
+	if (no_os_spi_init(&desc, &param))
+		return 1;
+
+	nb_ioctls = 0;
+	for (i = 0; i < NB_WRITES; i++) {
+		regs[i][0] = i;
+		no_os_spi_write_and_read(desc, regs[i], 3);
+	}
+	plain_ioctls = nb_ioctls;
+
+	nb_ioctls = 0;
+	no_os_spi_batch_begin(desc, NO_OS_SPI_BATCH_READBACK);
+	for (i = 0; i < NB_WRITES; i++) {
+		regs[i][0] = i;
+		regs[i][1] = 1;
+		regs[i][2] = 2;
+		no_os_spi_write_and_read(desc, regs[i], 3);
+	}
+	ret = no_os_spi_batch_commit(desc);
+	printf("%d register writes: %d ioctls, batched %d ioctls\n",
+	       NB_WRITES, plain_ioctls, nb_ioctls);
+	if (ret || nb_ioctls > NB_WRITES / 16) {
+		printf("batch commit %d, too many ioctls\n", ret);
+		errors++;
+	}
+	for (i = 0; i < NB_WRITES; i++)
+		if (regs[i][0] != (uint8_t)(i ^ 0xff) || regs[i][2] != 0xfd)
+			break;
+	if (i < NB_WRITES) {
+		printf("batched readback mismatch at %d\n", i);
+		errors++;
+	}
+
+	msgs[0] = (struct no_os_spi_msg) {
+		.tx_buff = tx, .bytes_number = 2
+	};
+	msgs[1] = (struct no_os_spi_msg) {
+		.rx_buff = rx, .bytes_number = 2
+	};
+	no_os_spi_batch_begin(desc, NO_OS_SPI_BATCH_READBACK);
+	no_os_spi_transfer(desc, msgs, 2);
+	no_os_spi_transfer(desc, msgs, 2);
+	ret = no_os_spi_batch_commit(desc);
+	if (ret || rx[0] != 0xff) {
+		printf("batched transfer %d, rx 0x%02x\n", ret, rx[0]);
+		errors++;
+	}
+
+	for (i = 0; i < NB_MSGS; i++)
+		msgs[i] = msgs[0];
+	nb_ioctls = 0;
+	ret = no_os_spi_transfer(desc, msgs, NB_MSGS);
+	if (ret || nb_ioctls != 1) {
+		printf("%d messages transfer %d, %d ioctls\n", NB_MSGS, ret,
+		       nb_ioctls);
+		errors++;
+	}
+
+	if (cs_change_errors) {
+		printf("cs_change set on %d last transfers\n",
+		       cs_change_errors);
+		errors++;
+	}
+
+	t0 = now();
+	for (i = 0; i < BENCH_RUNS; i++)
+		no_os_spi_transfer(desc, msgs, 2);
+	printf("no_os_spi_transfer: %.1f ns/call\n",
+	       (now() - t0) / BENCH_RUNS * 1e9);
+
+	no_os_spi_remove(desc);
+	printf("spi_batch: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
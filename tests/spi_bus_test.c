@@ -0,0 +1,342 @@
+/***************************************************************************//**
+ *   @file   spi_bus_test.c
+ *   @brief  Tests of the SPI bus sharing and asynchronous transfers.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "no_os_delay.h"
+#include "no_os_spi.h"
+#include "linux_spi.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_DEVS		4
+#define NB_XFERS	500
+#define SMALL_LEN	4
+#define LARGE_LEN	64
+#define HIGH_PRIORITY	10
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct job {
+	struct no_os_spi_async_xfer xfer;
+	struct no_os_spi_msg msg;
+	uint8_t buf[LARGE_LEN];
+	uint64_t start_ns;
+	int dev;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static pthread_mutex_t inflight_lock = PTHREAD_MUTEX_INITIALIZER;
+static int inflight, max_inflight;
+static struct no_os_spi_desc *devs[NB_DEVS];
+static uint64_t latency_ns[NB_DEVS];
+static uint32_t nb_done[NB_DEVS];
+static struct job jobs[NB_DEVS][NB_XFERS];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static int32_t mock_init(struct no_os_spi_desc **desc,
+			 const struct no_os_spi_init_param *param)
+{
+	*desc = calloc(1, sizeof(**desc));
+	if (!*desc)
+		return -1;
+
+	(*desc)->device_id = param->device_id;
+	(*desc)->chip_select = param->chip_select;
+
+	return 0;
+}
+
+static int32_t mock_remove(struct no_os_spi_desc *desc)
+{
+	free(desc);
+
+	return 0;
+}
+
+/* Takes about 1 us per 4 bytes, counts the concurrent users of the bus */
+static int32_t mock_transfer(struct no_os_spi_desc *desc,
+			     struct no_os_spi_msg *msgs, uint32_t len)
+{
+	uint32_t bytes = 0;
+	uint32_t i;
+
+	pthread_mutex_lock(&inflight_lock);
+	if (++inflight > max_inflight)
+		max_inflight = inflight;
+	pthread_mutex_unlock(&inflight_lock);
+
+	for (i = 0; i < len; i++)
+		bytes += msgs[i].bytes_number;
+	no_os_udelay(bytes / 4 + 20);
+
+	pthread_mutex_lock(&inflight_lock);
+	inflight--;
+	pthread_mutex_unlock(&inflight_lock);
+
+	return 0;
+}
+
+static int32_t mock_write_and_read(struct no_os_spi_desc *desc, uint8_t *data,
+				   uint16_t bytes_number)
+{
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+	};
+
+	return mock_transfer(desc, &msg, 1);
+}
+
+static uintptr_t mock_get_bus_id(const struct no_os_spi_init_param *param)
+{
+	return (uintptr_t)param->extra;
+}
+
+static struct no_os_spi_platform_ops mock_ops = {
+	.init = mock_init,
+	.remove = mock_remove,
+	.write_and_read = mock_write_and_read,
+	.transfer = mock_transfer,
+};
+
+static const struct no_os_spi_platform_ops mock_bus_id_ops = {
+	.init = mock_init,
+	.remove = mock_remove,
+	.get_bus_id = mock_get_bus_id,
+};
+
+/* Devices share a bus only with the same controller */
+static int test_bus_sharing(void)
+{
+	struct no_os_spi_init_param param = {
+		.platform_ops = &mock_bus_id_ops,
+	};
+	struct no_os_spi_desc *a, *b, *c;
+	int errors = 0;
+
+	param.extra = (void *)0x44a00000;
+	if (no_os_spi_init(&a, &param))
+		return 1;
+	param.chip_select = 1;
+	if (no_os_spi_init(&b, &param))
+		return 1;
+	param.extra = (void *)0x44a10000;
+	if (no_os_spi_init(&c, &param))
+		return 1;
+
+	if (a->bus != b->bus || a->bus->slave_number != 2) {
+		printf("devices on the same controller don't share a bus\n");
+		errors++;
+	}
+	if (a->bus == c->bus) {
+		printf("devices on different controllers share a bus\n");
+		errors++;
+	}
+
+	no_os_spi_remove(a);
+	no_os_spi_remove(b);
+	no_os_spi_remove(c);
+
+	return errors;
+}
+
+static void *sync_thread(void *arg)
+{
+	long dev = (long)arg;
+	uint8_t buf[LARGE_LEN];
+	uint64_t start;
+	int i;
+
+	for (i = 0; i < NB_XFERS; i++) {
+		start = now_ns();
+		no_os_spi_write_and_read(devs[dev], buf,
+					 dev ? LARGE_LEN : SMALL_LEN);
+		latency_ns[dev] += now_ns() - start;
+		nb_done[dev]++;
+	}
+
+	return NULL;
+}
+
+static void async_callback(struct no_os_spi_async_xfer *xfer)
+{
+	struct job *job = xfer->ctx;
+
+	latency_ns[job->dev] += now_ns() - job->start_ns;
+	nb_done[job->dev]++;
+}
+
+static void print_latencies(void)
+{
+	int i;
+
+	for (i = 0; i < NB_DEVS; i++) {
+		printf("  dev%d mean latency %.1f us\n", i,
+		       latency_ns[i] / 1e3 / nb_done[i]);
+		latency_ns[i] = 0;
+		nb_done[i] = 0;
+	}
+}
+
+/* Threads doing blocking transfers on devices of the same bus */
+static int test_sync(void)
+{
+	pthread_t threads[NB_DEVS];
+	uint64_t start;
+	long i;
+
+	max_inflight = 0;
+	start = now_ns();
+	for (i = 0; i < NB_DEVS; i++)
+		pthread_create(&threads[i], NULL, sync_thread, (void *)i);
+	for (i = 0; i < NB_DEVS; i++)
+		pthread_join(threads[i], NULL);
+
+	printf("sync, %d threads: %.1f ms, max concurrent bus users %d\n",
+	       NB_DEVS, (now_ns() - start) / 1e6, max_inflight);
+	print_latencies();
+
+	return max_inflight != 1;
+}
+
+/* Queued transfers, the small ones of dev0 with a higher priority */
+static int test_async(void)
+{
+	struct job *job;
+	uint64_t start;
+	int errors = 0;
+	int dev, i;
+
+	mock_ops.async_start = linux_spi_ops.async_start;
+	mock_ops.async_notify = linux_spi_ops.async_notify;
+	mock_ops.async_stop = linux_spi_ops.async_stop;
+
+	max_inflight = 0;
+	start = now_ns();
+	for (i = 0; i < NB_XFERS; i++) {
+		for (dev = 0; dev < NB_DEVS; dev++) {
+			job = &jobs[dev][i];
+			job->dev = dev;
+			job->msg.tx_buff = job->buf;
+			job->msg.rx_buff = job->buf;
+			job->msg.bytes_number = dev ? LARGE_LEN : SMALL_LEN;
+			job->xfer.msgs = &job->msg;
+			job->xfer.len = 1;
+			job->xfer.priority = dev ? 0 : HIGH_PRIORITY;
+			job->xfer.callback = async_callback;
+			job->xfer.ctx = job;
+			job->start_ns = now_ns();
+			if (no_os_spi_transfer_async(devs[dev], &job->xfer))
+				return 1;
+		}
+	}
+
+	for (dev = 0; dev < NB_DEVS; dev++) {
+		for (i = 0; i < NB_XFERS; i++) {
+			while (!jobs[dev][i].xfer.done)
+				usleep(10);
+			if (jobs[dev][i].xfer.status)
+				errors++;
+		}
+	}
+
+	printf("async, %d transfers: %.1f ms, max concurrent bus users %d\n",
+	       NB_DEVS * NB_XFERS, (now_ns() - start) / 1e6, max_inflight);
+	if (latency_ns[0] / nb_done[0] >= latency_ns[1] / nb_done[1]) {
+		printf("high priority transfers were not served first\n");
+		errors++;
+	}
+	print_latencies();
+
+	return errors + (max_inflight != 1);
+}
+
+int main(void)
+{
+	struct no_os_spi_init_param param = {
+		.platform_ops = &mock_ops,
+	};
+	int errors;
+	int i;
+
+	errors = test_bus_sharing();
+
+	for (i = 0; i < NB_DEVS; i++) {
+		param.chip_select = i;
+		if (no_os_spi_init(&devs[i], &param))
+			return 1;
+	}
+
+	errors += test_sync();
+	errors += test_async();
+
+	for (i = 0; i < NB_DEVS; i++)
+		no_os_spi_remove(devs[i]);
+
+	printf("spi_bus: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/***************************************************************************//**
+ *   @file   timer_test.c
+ *   @brief  Accuracy tests of the Linux delay and timer backends.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+#include "no_os_delay.h"
+#include "no_os_irq.h"
+#include "no_os_util.h"
+#include "linux_irq.h"
+#include "linux_timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_DELAYS	200
+#define TIMER_PERIOD_NS	1000000
+#define TIMER_RUN_MS	500
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint64_t last_ns, worst_ns, sum_ns;
+static uint32_t nb_periods;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/* Record the jitter of the timer expiries */
+static void timer_callback(void *ctx, uint32_t event, void *extra)
+{
+	uint64_t t = now_ns();
+	int64_t jitter;
+
+	if (last_ns) {
+		jitter = (int64_t)(t - last_ns) - TIMER_PERIOD_NS;
+		if (jitter < 0)
+			jitter = -jitter;
+		if ((uint64_t)jitter > worst_ns)
+			worst_ns = jitter;
+		sum_ns += jitter;
+		nb_periods++;
+	}
+	last_ns = t;
+}
+
+/* no_os_udelay() must never return early */
+static int test_udelay(void)
+{
+	static const uint32_t delays_us[] = {1, 5, 20, 100, 1000};
+	uint64_t start, elapsed, worst, sum;
+	uint32_t i, j;
+	int early = 0;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(delays_us); i++) {
+		worst = 0;
+		sum = 0;
+		for (j = 0; j < NB_DELAYS; j++) {
+			start = now_ns();
+			no_os_udelay(delays_us[i]);
+			elapsed = now_ns() - start;
+			if (elapsed < delays_us[i] * 1000ULL) {
+				early++;
+				continue;
+			}
+			elapsed -= delays_us[i] * 1000ULL;
+			sum += elapsed;
+			worst = no_os_max(worst, elapsed);
+		}
+		printf("udelay %4u us: mean overshoot %6llu ns, max %6llu ns\n",
+		       delays_us[i], (unsigned long long)(sum / NB_DELAYS),
+		       (unsigned long long)worst);
+	}
+
+	if (early)
+		printf("udelay returned early %d times\n", early);
+
+	return early;
+}
+
+/* A 1 ms periodic timer, delivered through the IRQ layer */
+static int test_timer(void)
+{
+	struct linux_timer_init_param linux_timer_ip = {
+		.period_ns = TIMER_PERIOD_NS,
+	};
+	struct no_os_timer_init_param timer_ip = {
+		.freq_hz = 1000000,
+		.extra = &linux_timer_ip,
+	};
+	struct no_os_irq_init_param irq_ip = {
+		.platform_ops = &linux_irq_ops,
+	};
+	struct linux_irq_config irq_config = {
+		.source = LINUX_IRQ_SOURCE_TIMER,
+	};
+	struct no_os_callback_desc callback = {
+		.callback = timer_callback,
+		.config = &irq_config,
+	};
+	struct no_os_irq_ctrl_desc *irq;
+	struct no_os_timer_desc *timer;
+	uint64_t elapsed;
+	int errors = 0;
+	int32_t ret;
+
+	ret = no_os_irq_ctrl_init(&irq, &irq_ip);
+	if (ret)
+		return 1;
+
+	ret = no_os_timer_init(&timer, &timer_ip);
+	if (ret)
+		goto remove_irq;
+
+	irq_config.timer = timer;
+	ret = no_os_irq_register_callback(irq, 0, &callback);
+	if (ret)
+		goto remove_timer;
+
+	ret = no_os_irq_enable(irq, 0);
+	if (!ret)
+		ret = no_os_timer_start(timer);
+	if (ret)
+		goto unregister;
+
+	no_os_mdelay(TIMER_RUN_MS);
+	no_os_timer_stop(timer);
+	no_os_timer_get_elapsed_time_nsec(timer, &elapsed);
+
+	printf("1 ms timer: %u periods, mean jitter %llu ns, max %llu ns\n",
+	       nb_periods,
+	       nb_periods ? (unsigned long long)(sum_ns / nb_periods) : 0,
+	       (unsigned long long)worst_ns);
+	printf("elapsed %llu ns\n", (unsigned long long)elapsed);
+
+	/* Leave room for a loaded host */
+	if (nb_periods < TIMER_RUN_MS * 9 / 10 || nb_periods > TIMER_RUN_MS) {
+		printf("unexpected number of periods\n");
+		errors++;
+	}
+	if (elapsed < TIMER_RUN_MS * 1000000ULL) {
+		printf("elapsed time shorter than the delay\n");
+		errors++;
+	}
+
+unregister:
+	no_os_irq_unregister(irq, 0);
+remove_timer:
+	no_os_timer_remove(timer);
+remove_irq:
+	no_os_irq_ctrl_remove(irq);
+
+	return ret ? 1 : errors;
+}
+
+int main(void)
+{
+	int errors;
+
+	errors = test_udelay();
+	errors += test_timer();
+	printf("timer: %s\n", errors ? "FAILED" : "ok");
+
+	return errors ? 1 : 0;
+}
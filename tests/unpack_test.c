@@ -0,0 +1,177 @@
+/***************************************************************************//**
+ *   @file   unpack_test.c
+ *   @brief  Bit exactness tests and benchmark of the sample unpacking.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "no_os_crc16.h"
+#include "no_os_unpack.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NB_RANDOM_RUNS	20000
+#define MAX_SAMPLES	40
+/* AD7606 frame: 8 channels of 18 bits */
+#define BENCH_SAMPLES	8
+#define BENCH_BITS	18
+#define BENCH_RUNS	5000000
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+NO_OS_DECLARE_CRC16_TABLE(crc_table);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Bit by bit reference, sample i is at bits [i * bits, (i + 1) * bits) */
+static uint32_t unpack_bitwise(const uint8_t *src, uint32_t i, uint8_t bits,
+			       uint32_t flags)
+{
+	uint32_t pos = i * bits;
+	uint32_t val = 0;
+	uint8_t b;
+
+	for (b = 0; b < bits; b++, pos++)
+		val = (val << 1) | ((src[pos / 8] >> (7 - pos % 8)) & 1);
+
+	if ((flags & NO_OS_UNPACK_SIGN_EXTEND) && bits < 32 &&
+	    (val >> (bits - 1)))
+		val |= 0xFFFFFFFF << bits;
+
+	return val;
+}
+
+static double now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+	uint8_t src[MAX_SAMPLES * 4];
+	uint32_t dst[MAX_SAMPLES];
+	volatile uint32_t sink = 0;
+	uint32_t nb_samples, i;
+	uint16_t crc, ref_crc;
+	uint32_t flags;
+	int errors = 0;
+	uint8_t bits;
+	double t0;
+	int run;
+
+	no_os_crc16_populate_msb(crc_table, 0x755b);
+	srand(1);
+	for (run = 0; run < NB_RANDOM_RUNS && errors < 10; run++) {
+		for (i = 0; i < sizeof(src); i++)
+			src[i] = rand();
+		bits = 1 + run % 32;
+		nb_samples = rand() % MAX_SAMPLES;
+		flags = rand() % 2 ? NO_OS_UNPACK_SIGN_EXTEND : 0;
+
+		if (no_os_unpack_be(src, nb_samples, bits, flags, dst)) {
+			printf("no_os_unpack_be failed, %u bits\n", bits);
+			errors++;
+			continue;
+		}
+		for (i = 0; i < nb_samples; i++)
+			if (dst[i] != unpack_bitwise(src, i, bits, flags))
+				break;
+		if (i < nb_samples) {
+			printf("%u bits, %u samples: sample %u mismatch\n",
+			       bits, nb_samples, i);
+			errors++;
+		}
+
+		crc = rand();
+		ref_crc = no_os_crc16(crc_table, src,
+				      (nb_samples * bits + 7) / 8, crc);
+		if (no_os_unpack_be_crc16(src, nb_samples, bits, flags, dst,
+					  crc_table, &crc)) {
+			printf("no_os_unpack_be_crc16 failed, %u bits\n", bits);
+			errors++;
+			continue;
+		}
+		for (i = 0; i < nb_samples; i++)
+			if (dst[i] != unpack_bitwise(src, i, bits, flags))
+				break;
+		if (i < nb_samples || crc != ref_crc) {
+			printf("%u bits, %u samples: crc16 variant mismatch\n",
+			       bits, nb_samples);
+			errors++;
+		}
+	}
+
+	printf("unpack: %s\n", errors ? "FAILED" : "ok");
+	if (errors)
+		return 1;
+
+	t0 = now();
+	for (run = 0; run < BENCH_RUNS; run++) {
+		src[0] = run;
+		no_os_unpack_be(src, BENCH_SAMPLES, BENCH_BITS, 0, dst);
+		sink += dst[3];
+	}
+	printf("%u x %u bits: %.1f ns/frame", BENCH_SAMPLES, BENCH_BITS,
+	       (now() - t0) / BENCH_RUNS * 1e9);
+
+	t0 = now();
+	for (run = 0; run < BENCH_RUNS; run++) {
+		src[0] = run;
+		crc = 0;
+		no_os_unpack_be_crc16(src, BENCH_SAMPLES, BENCH_BITS, 0, dst,
+				      crc_table, &crc);
+		sink += dst[3] + crc;
+	}
+	printf(", with CRC-16 %.1f ns/frame\n",
+	       (now() - t0) / BENCH_RUNS * 1e9);
+
+	return 0;
+}
@@ -44,6 +44,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "no_os_fifo.h"
+#include "no_os_pool.h"
 #include "no_os_error.h"
 
 /******************************************************************************/
@@ -51,43 +52,57 @@
 /******************************************************************************/
 
 /**
- * @brief Create new fifo element
+ * @brief Create new fifo element. The element and its data are allocated
+ * together, from the pool if it is given, not exhausted and its objects are
+ * large enough, from the heap otherwise.
+ * @param pool - Pool of elements, may be NULL.
  * @param buff - Data to be saved in fifo.
  * @param len - Length of the data.
  * @return fifo element in case of success, NULL otherwise
  */
-static struct no_os_fifo_element * fifo_new_element(char *buff, uint32_t len)
+static struct no_os_fifo_element *fifo_new_element(struct no_os_pool *pool,
+		char *buff, uint32_t len)
 {
-	struct no_os_fifo_element *q = calloc(1, sizeof(struct no_os_fifo_element));
-	if (!q)
-		return NULL;
+	struct no_os_fifo_element *q = NULL;
 
-	q->len = len;
-	q->data = calloc(1, len);
-	if (!(q->data)) {
-		free(q);
-		return NULL;
+	if (pool && sizeof(*q) + len <= pool->obj_size)
+		q = no_os_pool_alloc(pool);
+	if (q) {
+		q->pool = pool;
+	} else {
+		q = malloc(sizeof(*q) + len);
+		if (!q)
+			return NULL;
+		q->pool = NULL;
 	}
+
+	q->next = NULL;
+	q->last = q;
+	q->user_owned = 0;
+	q->len = len;
+	q->data = (char *)(q + 1);
 	memcpy(q->data, buff, len);
 
 	return q;
 }
 
 /**
- * @brief Get last element in fifo
- * @param p_fifo - pointer to fifo
- * @return fifo last element if exists, NULL otherwise
+ * @brief Append an element to the fifo.
+ * @param p_fifo - Pointer to fifo.
+ * @param q - The element.
  */
-static struct no_os_fifo_element *no_os_fifo_get_last(struct no_os_fifo_element
-		*p_fifo)
+static void no_os_fifo_append(struct no_os_fifo_element **p_fifo,
+			      struct no_os_fifo_element *q)
 {
-	if(p_fifo == NULL)
-		return NULL;
-	while (p_fifo->next) {
-		p_fifo = p_fifo->next;
-	}
+	q->next = NULL;
+	q->last = q;
 
-	return p_fifo;
+	if (!(*p_fifo)) {
+		*p_fifo = q;
+	} else {
+		(*p_fifo)->last->next = q;
+		(*p_fifo)->last = q;
+	}
 }
 
 /**
@@ -100,21 +115,56 @@ static struct no_os_fifo_element *no_os_fifo_get_last(struct no_os_fifo_element
 int32_t no_os_fifo_insert(struct no_os_fifo_element **p_fifo, char *buff,
 			  uint32_t len)
 {
-	struct no_os_fifo_element *p, *q;
+	return no_os_fifo_insert_pool(p_fifo, NULL, buff, len);
+}
+
+/**
+ * @brief Insert element to fifo, in the last position. The element is taken
+ * from the pool when possible, see no_os_pool_init(), which avoids the heap
+ * allocation. The pool objects should be sizeof(struct no_os_fifo_element)
+ * plus the largest data length.
+ * @param p_fifo - Pointer to fifo.
+ * @param pool - Pool of elements, may be NULL.
+ * @param buff - Data to be saved in fifo.
+ * @param len - Length of the data.
+ * @return 0 in case of success, -1 otherwise
+ */
+int32_t no_os_fifo_insert_pool(struct no_os_fifo_element **p_fifo,
+			       struct no_os_pool *pool, char *buff,
+			       uint32_t len)
+{
+	struct no_os_fifo_element *q;
 
 	if (len <= 0)
 		return -1;
 
-	q = fifo_new_element(buff, len);
+	q = fifo_new_element(pool, buff, len);
 	if (!q)
 		return -1;
 
-	if (!(*p_fifo)) {
-		*p_fifo = q;
-	} else {
-		p = no_os_fifo_get_last(*p_fifo);
-		p->next = q;
-	}
+	no_os_fifo_append(p_fifo, q);
+
+	return 0;
+}
+
+/**
+ * @brief Insert an element provided by the user to fifo, in the last position.
+ * No memory is allocated and no data is copied: elem->data and elem->len must
+ * be set by the caller. The element is not freed by no_os_fifo_remove() and
+ * must stay valid until then.
+ * @param p_fifo - Pointer to fifo.
+ * @param elem - The element.
+ * @return 0 in case of success, -1 otherwise
+ */
+int32_t no_os_fifo_link(struct no_os_fifo_element **p_fifo,
+			struct no_os_fifo_element *elem)
+{
+	if (!p_fifo || !elem)
+		return -1;
+
+	elem->pool = NULL;
+	elem->user_owned = 1;
+	no_os_fifo_append(p_fifo, elem);
 
 	return 0;
 }
@@ -130,8 +180,14 @@ struct no_os_fifo_element * no_os_fifo_remove(struct no_os_fifo_element *p_fifo)
 
 	if (p_fifo != NULL) {
 		p_fifo = p_fifo->next;
-		free(p->data);
-		free(p);
+		if (p_fifo)
+			p_fifo->last = p->last;
+		if (p->user_owned)
+			return p_fifo;
+		if (p->pool)
+			no_os_pool_free(p->pool, p);
+		else
+			free(p);
 	}
 
 	return p_fifo;
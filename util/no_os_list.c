@@ -42,6 +42,7 @@
 /******************************************************************************/
 
 #include "no_os_list.h"
+#include "no_os_pool.h"
 #include "no_os_error.h"
 #include <stdlib.h>
 
@@ -49,19 +50,6 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
-/**
- * @struct no_os_list_elem
- * @brief Format of each element of the list
- */
-struct no_os_list_elem {
-	/** User data */
-	void			*data;
-	/** Reference to previous element */
-	struct no_os_list_elem	*prev;
-	/** Reference to next element */
-	struct no_os_list_elem	*next;
-};
-
 /**
  * @struct list_iterator
  * @brief Structure used to iterate through the list
@@ -90,6 +78,8 @@ struct _list_desc {
 	uint32_t		nb_iterators;
 	/** Internal list iterator */
 	struct no_os_iterator		l_it;
+	/** Pool of elements, NULL if they are allocated on the heap */
+	struct no_os_pool	*pool;
 };
 
 /** @brief Default function used to compare element in the list ( \ref f_cmp) */
@@ -100,27 +90,53 @@ static int32_t no_os_default_comparator(void *data1, void *data2)
 
 /**
  * @brief Creates a new list elements an configure its value
+ *
+ * The element is taken from the list pool, if any, or from the heap when the
+ * pool is exhausted.
+ * @param list - List reference
  * @param data - To set list_elem.data
  * @param prev - To set list_elem.prev
  * @param next - To set list_elem.next
  * @return Address of the new element or NULL if allocation fails.
  */
-static inline struct no_os_list_elem *create_element(void *data,
+static inline struct no_os_list_elem *create_element(struct _list_desc *list,
+		void *data,
 		struct no_os_list_elem *prev,
 		struct no_os_list_elem *next)
 {
 	struct no_os_list_elem *elem;
 
-	elem = (struct no_os_list_elem *)calloc(1, sizeof(*elem));
-	if (!elem)
-		return NULL;
+	elem = no_os_pool_alloc(list->pool);
+	if (!elem) {
+		elem = (struct no_os_list_elem *)calloc(1, sizeof(*elem));
+		if (!elem)
+			return NULL;
+	}
 	elem->data = data;
 	elem->prev = prev;
 	elem->next = next;
+	elem->user_owned = false;
 
 	return (elem);
 }
 
+/**
+ * @brief Free an element removed from the list, unless it is owned by the user
+ * @param list - List reference
+ * @param elem - The element
+ */
+static inline void release_element(struct _list_desc *list,
+				   struct no_os_list_elem *elem)
+{
+	if (elem->user_owned)
+		return;
+
+	if (no_os_pool_owns(list->pool, elem))
+		no_os_pool_free(list->pool, elem);
+	else
+		free(elem);
+}
+
 /**
  * @brief Updates the necesary link on the list elements to add or remove one
  * @param prev - Low element
@@ -237,6 +253,44 @@ int32_t no_os_list_init(struct no_os_list_desc **list_desc,
 	return 0;
 }
 
+/**
+ * @brief Create a new empty list, with a pool of preallocated elements.
+ *
+ * Adding and removing elements takes them from and gives them back to the
+ * pool, avoiding heap allocations and fragmentation. When more than
+ * nb_elements are in the list, the extra ones are allocated on the heap.
+ * @param list_desc - Where to store the reference of the new created list
+ * @param type - Type of adapter to use.
+ * @param comparator - Used to compare item when using an ordered list or when
+ * using the \em find functions.
+ * @param nb_elements - Number of preallocated elements.
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t no_os_list_init_pool(struct no_os_list_desc **list_desc,
+			     enum no_os_adapter_type type,
+			     f_cmp comparator,
+			     uint32_t nb_elements)
+{
+	struct _list_desc	*list;
+	int32_t			ret;
+
+	ret = no_os_list_init(list_desc, type, comparator);
+	if (ret)
+		return ret;
+
+	list = (*list_desc)->priv_desc;
+	ret = no_os_pool_init(&list->pool, sizeof(struct no_os_list_elem),
+			      nb_elements);
+	if (ret) {
+		no_os_list_remove(*list_desc);
+		return -1;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Remove the created list.
  *
@@ -262,6 +316,8 @@ int32_t no_os_list_remove(struct no_os_list_desc *list_desc)
 	/* Remove all the elements */
 	while (0 == no_os_list_get_first(list_desc, &data))
 		;
+	if (list->pool)
+		no_os_pool_remove(list->pool);
 	free(list_desc->priv_desc);
 	free(list_desc);
 
@@ -290,11 +346,35 @@ int32_t no_os_list_get_size(struct no_os_list_desc *list_desc,
 	return 0;
 }
 
+/**
+ * @brief Insert an element at the begining of the list
+ * @param list - List reference
+ * @param elem - The element
+ */
+static inline void no_os_insert_first(struct _list_desc *list,
+				      struct no_os_list_elem *elem)
+{
+	no_os_update_links(NULL, elem, list->first);
+	no_os_update_desc(list, elem, list->last);
+	list->nb_elements++;
+}
+
+/**
+ * @brief Insert an element at the end of the list
+ * @param list - List reference
+ * @param elem - The element
+ */
+static inline void no_os_insert_last(struct _list_desc *list,
+				     struct no_os_list_elem *elem)
+{
+	no_os_update_links(list->last, elem, NULL);
+	no_os_update_desc(list, list->first, elem);
+	list->nb_elements++;
+}
+
 /** @brief Add element at the begining of the list. Refer to \ref f_add */
 int32_t no_os_list_add_first(struct no_os_list_desc *list_desc, void *data)
 {
-	struct no_os_list_elem	*prev;
-	struct no_os_list_elem	*next;
 	struct no_os_list_elem	*elem;
 	struct _list_desc	*list;
 
@@ -303,17 +383,11 @@ int32_t no_os_list_add_first(struct no_os_list_desc *list_desc, void *data)
 
 	list = list_desc->priv_desc;
 
-	prev = NULL;
-	next = list->first;
-	elem = create_element(data, prev, next);
+	elem = create_element(list, data, NULL, list->first);
 	if (!elem)
 		return -1;
 
-	no_os_update_links(prev, elem, next);
-
-	no_os_update_desc(list, elem, list->last);
-
-	list->nb_elements++;
+	no_os_insert_first(list, elem);
 
 	return 0;
 }
@@ -321,8 +395,6 @@ int32_t no_os_list_add_first(struct no_os_list_desc *list_desc, void *data)
 /** @brief Add element at the end of the list. Refer to \ref f_add */
 int32_t no_os_list_add_last(struct no_os_list_desc *list_desc, void *data)
 {
-	struct no_os_list_elem	*prev;
-	struct no_os_list_elem	*next;
 	struct no_os_list_elem	*elem;
 	struct _list_desc	*list;
 
@@ -330,17 +402,61 @@ int32_t no_os_list_add_last(struct no_os_list_desc *list_desc, void *data)
 		return -1;
 	list = list_desc->priv_desc;
 
-	prev = list->last;
-	next = NULL;
-	elem = create_element(data, prev, next);
+	elem = create_element(list, data, list->last, NULL);
 	if (!elem)
 		return -1;
 
-	no_os_update_links(prev, elem, next);
+	no_os_insert_last(list, elem);
 
-	no_os_update_desc(list, list->first, elem);
+	return 0;
+}
 
-	list->nb_elements++;
+/**
+ * @brief Add an element provided by the user at the begining of the list.
+ *
+ * No memory is allocated. The element is not freed when it is removed from
+ * the list, and must stay valid until then.
+ * @param list_desc - List reference
+ * @param elem - The element, usually embedded in the structure data points to
+ * @param data - Data to store in the element
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t no_os_list_link_first(struct no_os_list_desc *list_desc,
+			      struct no_os_list_elem *elem, void *data)
+{
+	if (!list_desc || !elem)
+		return -1;
+
+	elem->data = data;
+	elem->user_owned = true;
+	no_os_insert_first(list_desc->priv_desc, elem);
+
+	return 0;
+}
+
+/**
+ * @brief Add an element provided by the user at the end of the list.
+ *
+ * No memory is allocated. The element is not freed when it is removed from
+ * the list, and must stay valid until then.
+ * @param list_desc - List reference
+ * @param elem - The element, usually embedded in the structure data points to
+ * @param data - Data to store in the element
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t no_os_list_link_last(struct no_os_list_desc *list_desc,
+			     struct no_os_list_elem *elem, void *data)
+{
+	if (!list_desc || !elem)
+		return -1;
+
+	elem->data = data;
+	elem->user_owned = true;
+	no_os_insert_last(list_desc->priv_desc, elem);
 
 	return 0;
 }
@@ -565,7 +681,7 @@ int32_t no_os_list_get_first(struct no_os_list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	release_element(list, elem);
 
 	return 0;
 }
@@ -595,7 +711,7 @@ int32_t no_os_list_get_last(struct no_os_list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	release_element(list, elem);
 
 	return 0;
 }
@@ -825,7 +941,7 @@ int32_t no_os_iterator_get(struct no_os_iterator *iter, void **data)
 		next = it->elem->prev;
 	else
 		next = it->elem->next;
-	free(it->elem);
+	release_element(it->list, it->elem);
 	it->elem = next;
 
 	return 0;
@@ -870,9 +986,9 @@ int32_t no_os_iterator_insert(struct no_os_iterator *iter, void *data,
 		return no_os_list_add_first(&list_desc, data);
 
 	if (after)
-		elem = create_element(data, it->elem, it->elem->next);
+		elem = create_element(it->list, data, it->elem, it->elem->next);
 	else
-		elem = create_element(data, it->elem->prev, it->elem);
+		elem = create_element(it->list, data, it->elem->prev, it->elem);
 	if (!elem)
 		return -1;
 
@@ -0,0 +1,199 @@
+/***************************************************************************//**
+ *   @file   no_os_pool.c
+ *   @brief  Implementation of the fixed size object pool.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_pool.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Configure a pool in the given memory, without allocation.
+ *
+ * Taking and giving back objects is O(1) and does not fragment the heap. The
+ * pool is not thread safe, concurrent users must serialize the accesses.
+ * @param pool - The pool.
+ * @param buff - Pool memory, nb_objs * NO_OS_POOL_OBJ_SIZE(obj_size) bytes,
+ * aligned for the objects.
+ * @param obj_size - Size of an object in bytes.
+ * @param nb_objs - Number of objects.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_pool_cfg(struct no_os_pool *pool, void *buff, uint32_t obj_size,
+		       uint32_t nb_objs)
+{
+	uint8_t *obj;
+	uint32_t i;
+
+	if (!pool || !buff || !obj_size || !nb_objs)
+		return -EINVAL;
+
+	memset(pool, 0, sizeof(*pool));
+	pool->obj_size = NO_OS_POOL_OBJ_SIZE(obj_size);
+	pool->nb_objs = nb_objs;
+	pool->nb_free = nb_objs;
+	pool->buff = buff;
+
+	/* Chain the objects in address order */
+	obj = pool->buff;
+	for (i = 0; i < nb_objs - 1; i++, obj += pool->obj_size)
+		*(void **)obj = obj + pool->obj_size;
+	*(void **)obj = NULL;
+	pool->free_list = pool->buff;
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a pool of nb_objs objects of obj_size bytes.
+ * @param pool - Where to store the pool reference.
+ * @param obj_size - Size of an object in bytes.
+ * @param nb_objs - Number of objects.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_pool_init(struct no_os_pool **pool, uint32_t obj_size,
+			uint32_t nb_objs)
+{
+	struct no_os_pool *p;
+	void *buff;
+	int32_t ret;
+
+	if (!pool || !obj_size || !nb_objs)
+		return -EINVAL;
+
+	p = calloc(1, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	buff = calloc(nb_objs, NO_OS_POOL_OBJ_SIZE(obj_size));
+	if (!buff) {
+		free(p);
+		return -ENOMEM;
+	}
+
+	ret = no_os_pool_cfg(p, buff, obj_size, nb_objs);
+	if (ret) {
+		free(buff);
+		free(p);
+		return ret;
+	}
+	p->own_buff = true;
+	*pool = p;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_pool_init().
+ * @param pool - The pool.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_pool_remove(struct no_os_pool *pool)
+{
+	if (!pool)
+		return -EINVAL;
+
+	if (pool->own_buff) {
+		free(pool->buff);
+		free(pool);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Take an object from the pool. The content of the object is undefined.
+ * @param pool - The pool.
+ * @return The object, NULL if the pool is empty.
+ */
+void *no_os_pool_alloc(struct no_os_pool *pool)
+{
+	void *obj;
+
+	if (!pool || !pool->free_list)
+		return NULL;
+
+	obj = pool->free_list;
+	pool->free_list = *(void **)obj;
+	pool->nb_free--;
+
+	return obj;
+}
+
+/**
+ * @brief Give an object taken with no_os_pool_alloc() back to the pool.
+ * @param pool - The pool.
+ * @param obj - The object.
+ * @return 0 in case of success, -EINVAL if the object is not from the pool.
+ */
+int32_t no_os_pool_free(struct no_os_pool *pool, void *obj)
+{
+	if (!no_os_pool_owns(pool, obj))
+		return -EINVAL;
+
+	*(void **)obj = pool->free_list;
+	pool->free_list = obj;
+	pool->nb_free++;
+
+	return 0;
+}
+
+/**
+ * @brief Check if an object belongs to the pool.
+ * @param pool - The pool.
+ * @param obj - The object.
+ * @return true if obj is an object of the pool, false otherwise.
+ */
+bool no_os_pool_owns(struct no_os_pool *pool, const void *obj)
+{
+	const uint8_t *p = obj;
+
+	if (!pool || !p || p < pool->buff)
+		return false;
+	if (p >= pool->buff + pool->obj_size * pool->nb_objs)
+		return false;
+
+	return !((p - pool->buff) % pool->obj_size);
+}
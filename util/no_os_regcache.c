@@ -0,0 +1,413 @@
+/***************************************************************************//**
+ *   @file   no_os_regcache.c
+ *   @brief  Implementation of the register cache.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_regcache.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NO_OS_REGCACHE_WORD(reg)	((reg) >> 5)
+#define NO_OS_REGCACHE_MASK(reg)	((uint32_t)1 << ((reg) & 0x1F))
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Test a register bit in one of the cache bitmaps.
+ * @param map - The bitmap.
+ * @param reg - The register address.
+ * @return true if the bit is set, false otherwise.
+ */
+static inline bool regcache_test(const uint32_t *map, uint32_t reg)
+{
+	return map[NO_OS_REGCACHE_WORD(reg)] & NO_OS_REGCACHE_MASK(reg);
+}
+
+/**
+ * @brief Set a register bit in one of the cache bitmaps.
+ * @param map - The bitmap.
+ * @param reg - The register address.
+ * @return None.
+ */
+static inline void regcache_set(uint32_t *map, uint32_t reg)
+{
+	map[NO_OS_REGCACHE_WORD(reg)] |= NO_OS_REGCACHE_MASK(reg);
+}
+
+/**
+ * @brief Clear a register bit in one of the cache bitmaps.
+ * @param map - The bitmap.
+ * @param reg - The register address.
+ * @return None.
+ */
+static inline void regcache_clear(uint32_t *map, uint32_t reg)
+{
+	map[NO_OS_REGCACHE_WORD(reg)] &= ~NO_OS_REGCACHE_MASK(reg);
+}
+
+/**
+ * @brief Initialize the register cache.
+ *
+ * All the memory used by the cache is allocated here, so that accessing the
+ * registers afterwards does not need any dynamic allocation.
+ * @param cache - The register cache descriptor.
+ * @param param - The structure that contains the initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_init(struct no_os_regcache **cache,
+			    const struct no_os_regcache_init_param *param)
+{
+	const struct no_os_regcache_range *range;
+	struct no_os_regcache *desc;
+	uint32_t nb_words;
+	uint32_t i, reg;
+
+	if (!cache || !param || !param->hw_read || !param->hw_write)
+		return -EINVAL;
+
+	if (param->num_volatile_ranges && !param->volatile_ranges)
+		return -EINVAL;
+
+	nb_words = NO_OS_DIV_ROUND_UP(param->max_reg + 1, 32);
+
+	desc = calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->volatile_map = calloc(3 * nb_words, sizeof(uint32_t));
+	if (!desc->volatile_map)
+		goto error_desc;
+	desc->valid_map = desc->volatile_map + nb_words;
+	desc->dirty_map = desc->valid_map + nb_words;
+
+	desc->vals = calloc(param->max_reg + 1, sizeof(uint8_t));
+	if (!desc->vals)
+		goto error_maps;
+
+	for (i = 0; i < param->num_volatile_ranges; i++) {
+		range = &param->volatile_ranges[i];
+		for (reg = range->min;
+		     reg <= no_os_min(range->max, param->max_reg); reg++)
+			regcache_set(desc->volatile_map, reg);
+	}
+
+	desc->max_reg = param->max_reg;
+	desc->hw_read = param->hw_read;
+	desc->hw_write = param->hw_write;
+	desc->ctx = param->ctx;
+
+	*cache = desc;
+
+	return 0;
+
+error_maps:
+	free(desc->volatile_map);
+error_desc:
+	free(desc);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_regcache_init().
+ * @param cache - The register cache descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_remove(struct no_os_regcache *cache)
+{
+	if (!cache)
+		return -EINVAL;
+
+	free(cache->vals);
+	free(cache->volatile_map);
+	free(cache);
+
+	return 0;
+}
+
+/**
+ * @brief Check if a register is volatile.
+ *
+ * Volatile registers are never cached, they are always read from the device.
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @return true if the register is volatile or out of range, false otherwise.
+ */
+bool no_os_regcache_is_volatile(struct no_os_regcache *cache, uint32_t reg)
+{
+	if (reg > cache->max_reg)
+		return true;
+
+	return regcache_test(cache->volatile_map, reg);
+}
+
+/**
+ * @brief Get the shadow copy of a register, without accessing the device.
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @param val - The cached value.
+ * @return 0 in case of success, -ENOENT if the register is not cached.
+ */
+int32_t no_os_regcache_get(struct no_os_regcache *cache, uint32_t reg,
+			   uint8_t *val)
+{
+	if (cache->bypass || no_os_regcache_is_volatile(cache, reg) ||
+	    !regcache_test(cache->valid_map, reg))
+		return -ENOENT;
+
+	*val = cache->vals[reg];
+
+	return 0;
+}
+
+/**
+ * @brief Record a value that was read from or written to the device.
+ *
+ * Used by drivers which access the device directly, e.g. with burst
+ * transfers, to keep the cache coherent. In bypass mode the shadow copy of
+ * the register is invalidated instead.
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @param val - The value of the register.
+ * @return None.
+ */
+void no_os_regcache_set(struct no_os_regcache *cache, uint32_t reg,
+			uint8_t val)
+{
+	if (no_os_regcache_is_volatile(cache, reg))
+		return;
+
+	regcache_clear(cache->dirty_map, reg);
+	if (cache->bypass) {
+		regcache_clear(cache->valid_map, reg);
+		return;
+	}
+
+	cache->vals[reg] = val;
+	regcache_set(cache->valid_map, reg);
+}
+
+/**
+ * @brief Read a register, from the cache if possible.
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_read(struct no_os_regcache *cache, uint32_t reg,
+			    uint8_t *val)
+{
+	int32_t ret;
+
+	if (!no_os_regcache_get(cache, reg, val))
+		return 0;
+
+	if (cache->cache_only && !cache->bypass)
+		return -EBUSY;
+
+	ret = cache->hw_read(cache->ctx, reg, val);
+	if (ret)
+		return ret;
+
+	no_os_regcache_set(cache, reg, *val);
+
+	return 0;
+}
+
+/**
+ * @brief Write a register through the cache.
+ *
+ * The value is written to the device and then recorded in the cache. In cache
+ * only mode the device is not accessed and the register is marked dirty, to be
+ * written by no_os_regcache_sync().
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_write(struct no_os_regcache *cache, uint32_t reg,
+			     uint8_t val)
+{
+	int32_t ret;
+
+	if (cache->cache_only && !cache->bypass) {
+		if (no_os_regcache_is_volatile(cache, reg))
+			return -EBUSY;
+
+		cache->vals[reg] = val;
+		regcache_set(cache->valid_map, reg);
+		regcache_set(cache->dirty_map, reg);
+
+		return 0;
+	}
+
+	ret = cache->hw_write(cache->ctx, reg, val);
+	if (ret)
+		return ret;
+
+	no_os_regcache_set(cache, reg, val);
+
+	return 0;
+}
+
+/**
+ * @brief Update the bits of a register selected by mask.
+ *
+ * The current value is taken from the cache when possible, so only the write
+ * reaches the device. The register is written even if its value does not
+ * change, in order to preserve the side effects of the write.
+ * @param cache - The register cache descriptor.
+ * @param reg - The register address.
+ * @param mask - The bits to be updated.
+ * @param val - The new value of the bits selected by mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_update_bits(struct no_os_regcache *cache, uint32_t reg,
+				   uint8_t mask, uint8_t val)
+{
+	uint8_t tmp;
+	int32_t ret;
+
+	ret = no_os_regcache_read(cache, reg, &tmp);
+	if (ret)
+		return ret;
+
+	tmp &= ~mask;
+	tmp |= val & mask;
+
+	return no_os_regcache_write(cache, reg, tmp);
+}
+
+/**
+ * @brief Write the registers changed in cache only mode to the device.
+ * @param cache - The register cache descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regcache_sync(struct no_os_regcache *cache)
+{
+	uint32_t nb_words = NO_OS_DIV_ROUND_UP(cache->max_reg + 1, 32);
+	uint32_t i, reg, pending;
+	int32_t ret;
+
+	for (i = 0; i < nb_words; i++) {
+		pending = cache->dirty_map[i];
+		while (pending) {
+			reg = i * 32 + no_os_find_first_set_bit(pending);
+			pending &= pending - 1;
+
+			ret = cache->hw_write(cache->ctx, reg, cache->vals[reg]);
+			if (ret)
+				return ret;
+
+			regcache_clear(cache->dirty_map, reg);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Invalidate the shadow copy of a range of registers.
+ *
+ * Pending cache only writes to these registers are discarded.
+ * @param cache - The register cache descriptor.
+ * @param min - The first register of the range.
+ * @param max - The last register of the range.
+ * @return None.
+ */
+void no_os_regcache_drop(struct no_os_regcache *cache, uint32_t min,
+			 uint32_t max)
+{
+	uint32_t reg;
+
+	for (reg = min; reg <= no_os_min(max, cache->max_reg); reg++) {
+		regcache_clear(cache->valid_map, reg);
+		regcache_clear(cache->dirty_map, reg);
+	}
+}
+
+/**
+ * @brief Invalidate the whole cache, e.g. after a device reset.
+ * @param cache - The register cache descriptor.
+ * @return None.
+ */
+void no_os_regcache_invalidate(struct no_os_regcache *cache)
+{
+	uint32_t nb_words = NO_OS_DIV_ROUND_UP(cache->max_reg + 1, 32);
+
+	memset(cache->valid_map, 0, nb_words * sizeof(uint32_t));
+	memset(cache->dirty_map, 0, nb_words * sizeof(uint32_t));
+}
+
+/**
+ * @brief Enable or disable the cache bypass mode.
+ *
+ * In bypass mode all the accesses go directly to the device. Registers
+ * written meanwhile are invalidated, so the cache stays coherent.
+ * @param cache - The register cache descriptor.
+ * @param enable - true to bypass the cache, false to use it.
+ * @return None.
+ */
+void no_os_regcache_set_bypass(struct no_os_regcache *cache, bool enable)
+{
+	cache->bypass = enable;
+}
+
+/**
+ * @brief Enable or disable the cache only mode.
+ *
+ * In cache only mode writes are kept in the cache and reads of registers which
+ * are not cached fail with -EBUSY, the device is not accessed at all.
+ * @param cache - The register cache descriptor.
+ * @param enable - true to enable cache only mode, false to disable it.
+ * @return None.
+ */
+void no_os_regcache_set_cache_only(struct no_os_regcache *cache, bool enable)
+{
+	cache->cache_only = enable;
+}
@@ -0,0 +1,448 @@
+/***************************************************************************//**
+ *   @file   no_os_ring.c
+ *   @brief  Implementation of the lock-free ring buffer.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_ring.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+	!defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+typedef _Atomic uint32_t no_os_ring_atomic_t;
+
+#define NO_OS_RING_RELAXED	memory_order_relaxed
+#define NO_OS_RING_ACQUIRE	memory_order_acquire
+#define NO_OS_RING_RELEASE	memory_order_release
+
+#define no_os_ring_load(p, order)	atomic_load_explicit(p, order)
+#define no_os_ring_store(p, v, order)	atomic_store_explicit(p, v, order)
+#define no_os_ring_cas(p, expected, v) \
+	atomic_compare_exchange_weak_explicit(p, expected, v, \
+					      memory_order_relaxed, \
+					      memory_order_relaxed)
+#else
+/* Compilers without C11 atomics, GCC compatible builtins */
+typedef uint32_t no_os_ring_atomic_t;
+
+#define NO_OS_RING_RELAXED	__ATOMIC_RELAXED
+#define NO_OS_RING_ACQUIRE	__ATOMIC_ACQUIRE
+#define NO_OS_RING_RELEASE	__ATOMIC_RELEASE
+
+#define no_os_ring_load(p, order)	__atomic_load_n(p, order)
+#define no_os_ring_store(p, v, order)	__atomic_store_n(p, v, order)
+#define no_os_ring_cas(p, expected, v) \
+	__atomic_compare_exchange_n(p, expected, v, true, \
+				    __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+/* Keeps the producer and consumer positions in different cache lines */
+#define NO_OS_RING_CACHE_LINE	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_ring
+ * @brief Lock-free ring buffer descriptor
+ *
+ * Positions are free running and are reduced to an element index with mask.
+ * In multi producer/consumer mode, seq holds for each element the position at
+ * which it can next be written (seq == pos) or read (seq == pos + 1), so that
+ * producers and consumers only contend on their own position.
+ */
+struct no_os_ring {
+	/** Size of an element in bytes */
+	uint32_t		elem_size;
+	/** Number of elements - 1 */
+	uint32_t		mask;
+	/** NO_OS_RING_SPSC or 0 */
+	uint32_t		flags;
+	/** Elements */
+	uint8_t			*buff;
+	/** Sequence number of each element, multi producer/consumer only */
+	no_os_ring_atomic_t	*seq;
+	uint8_t			pad0[NO_OS_RING_CACHE_LINE];
+	/** Next position to write */
+	no_os_ring_atomic_t	tail;
+	uint8_t			pad1[NO_OS_RING_CACHE_LINE];
+	/** Next position to read */
+	no_os_ring_atomic_t	head;
+	uint8_t			pad2[NO_OS_RING_CACHE_LINE];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a ring buffer.
+ *
+ * The ring is lock-free for any number of producers and consumers, which may
+ * be threads or interrupt handlers. With NO_OS_RING_SPSC it must only be used
+ * by one producer and one consumer and is then wait-free.
+ * @param ring - Where to store the ring reference.
+ * @param elem_size - Size of an element in bytes.
+ * @param nb_elems - Number of elements, a power of 2.
+ * @param flags - NO_OS_RING_SPSC or 0.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_ring_init(struct no_os_ring **ring, uint32_t elem_size,
+			uint32_t nb_elems, uint32_t flags)
+{
+	struct no_os_ring *r;
+	uint32_t i;
+
+	if (!ring || !elem_size || !nb_elems || (nb_elems & (nb_elems - 1)) ||
+	    nb_elems > 0x80000000u)
+		return -EINVAL;
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return -ENOMEM;
+
+	r->buff = calloc(nb_elems, elem_size);
+	if (!r->buff)
+		goto error;
+
+	if (!(flags & NO_OS_RING_SPSC)) {
+		r->seq = calloc(nb_elems, sizeof(*r->seq));
+		if (!r->seq)
+			goto error;
+		for (i = 0; i < nb_elems; i++)
+			no_os_ring_store(&r->seq[i], i, NO_OS_RING_RELAXED);
+	}
+
+	r->elem_size = elem_size;
+	r->mask = nb_elems - 1;
+	r->flags = flags;
+	*ring = r;
+
+	return 0;
+error:
+	free(r->buff);
+	free(r);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_ring_init().
+ * @param ring - The ring.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_ring_remove(struct no_os_ring *ring)
+{
+	if (!ring)
+		return -EINVAL;
+
+	free(ring->seq);
+	free(ring->buff);
+	free(ring);
+
+	return 0;
+}
+
+/**
+ * @brief Get the number of elements written and not yet read. Elements being
+ * written or read are included, so the result is only a hint while the ring
+ * is in use.
+ * @param ring - The ring.
+ * @param nb_elems - Where to store the number of elements.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_ring_size(struct no_os_ring *ring, uint32_t *nb_elems)
+{
+	if (!ring || !nb_elems)
+		return -EINVAL;
+
+	*nb_elems = no_os_ring_load(&ring->tail, NO_OS_RING_ACQUIRE) -
+		    no_os_ring_load(&ring->head, NO_OS_RING_ACQUIRE);
+
+	return 0;
+}
+
+/**
+ * @brief Claim up to nb_elems contiguous elements for a producer or a
+ * consumer, in multi producer/consumer mode.
+ * @param ring - The ring.
+ * @param pos_p - tail for a producer, head for a consumer.
+ * @param ready - 0 for a producer, 1 for a consumer: an element at pos is
+ * available when its sequence number is pos + ready.
+ * @param nb_elems - Maximum number of elements.
+ * @param span - Where to store the claimed elements.
+ * @return 0 in case of success, -EAGAIN if the ring is full (producer) or
+ * empty (consumer).
+ */
+static int32_t no_os_ring_claim(struct no_os_ring *ring,
+				no_os_ring_atomic_t *pos_p, uint32_t ready,
+				uint32_t nb_elems, struct no_os_ring_span *span)
+{
+	uint32_t pos, idx, nb, i;
+	int32_t diff = 0;
+
+	pos = no_os_ring_load(pos_p, NO_OS_RING_RELAXED);
+	while (true) {
+		idx = pos & ring->mask;
+		nb = no_os_min(nb_elems, ring->mask + 1 - idx);
+
+		for (i = 0; i < nb; i++) {
+			diff = (int32_t)(no_os_ring_load(&ring->seq[idx + i],
+							 NO_OS_RING_ACQUIRE) -
+					 (pos + i + ready));
+			if (diff)
+				break;
+		}
+
+		if (!i) {
+			/* The element is still in use by the other side */
+			if (diff < 0)
+				return -EAGAIN;
+			/* Claimed by another producer/consumer meanwhile */
+			pos = no_os_ring_load(pos_p, NO_OS_RING_RELAXED);
+			continue;
+		}
+
+		/* On failure pos is reloaded */
+		if (no_os_ring_cas(pos_p, &pos, pos + i))
+			break;
+	}
+
+	span->buff = ring->buff + idx * ring->elem_size;
+	span->nb_elems = i;
+	span->pos = pos;
+
+	return 0;
+}
+
+/**
+ * @brief Hand the elements of a span over to the other side, in multi
+ * producer/consumer mode.
+ * @param ring - The ring.
+ * @param span - The claimed elements.
+ * @param next - 1 after writing, ring size after reading: sequence number
+ * increment of the elements.
+ */
+static void no_os_ring_release(struct no_os_ring *ring,
+			       struct no_os_ring_span *span, uint32_t next)
+{
+	uint32_t idx = span->pos & ring->mask;
+	uint32_t i;
+
+	for (i = 0; i < span->nb_elems; i++)
+		no_os_ring_store(&ring->seq[idx + i], span->pos + i + next,
+				 NO_OS_RING_RELEASE);
+}
+
+/**
+ * @brief Reserve up to nb_elems contiguous free elements for writing, without
+ * copying. Fewer elements are reserved when the ring is almost full or when
+ * the free elements wrap around the end of the buffer. Several producers may
+ * hold reservations at the same time and commit them in any order.
+ * @param ring - The ring.
+ * @param nb_elems - Maximum number of elements.
+ * @param span - Where to store the reserved elements.
+ * @return 0 in case of success, -EAGAIN if the ring is full, -EINVAL for
+ * invalid parameters.
+ */
+int32_t no_os_ring_reserve_write(struct no_os_ring *ring, uint32_t nb_elems,
+				 struct no_os_ring_span *span)
+{
+	uint32_t tail, nb;
+
+	if (!ring || !nb_elems || !span)
+		return -EINVAL;
+
+	if (!(ring->flags & NO_OS_RING_SPSC))
+		return no_os_ring_claim(ring, &ring->tail, 0, nb_elems, span);
+
+	tail = no_os_ring_load(&ring->tail, NO_OS_RING_RELAXED);
+	nb = ring->mask + 1 - (tail -
+			       no_os_ring_load(&ring->head, NO_OS_RING_ACQUIRE));
+	if (!nb)
+		return -EAGAIN;
+
+	nb = no_os_min(nb, nb_elems);
+	nb = no_os_min(nb, ring->mask + 1 - (tail & ring->mask));
+
+	span->buff = ring->buff + (tail & ring->mask) * ring->elem_size;
+	span->nb_elems = nb;
+	span->pos = tail;
+
+	return 0;
+}
+
+/**
+ * @brief Make the elements of a span returned by no_os_ring_reserve_write()
+ * available to the consumers.
+ * @param ring - The ring.
+ * @param span - The written elements.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_ring_commit_write(struct no_os_ring *ring,
+				struct no_os_ring_span *span)
+{
+	if (!ring || !span)
+		return -EINVAL;
+
+	if (ring->flags & NO_OS_RING_SPSC)
+		no_os_ring_store(&ring->tail, span->pos + span->nb_elems,
+				 NO_OS_RING_RELEASE);
+	else
+		no_os_ring_release(ring, span, 1);
+
+	return 0;
+}
+
+/**
+ * @brief Reserve up to nb_elems contiguous written elements for reading,
+ * without copying. Fewer elements are reserved when fewer are available or
+ * when they wrap around the end of the buffer.
+ * @param ring - The ring.
+ * @param nb_elems - Maximum number of elements.
+ * @param span - Where to store the reserved elements.
+ * @return 0 in case of success, -EAGAIN if the ring is empty, -EINVAL for
+ * invalid parameters.
+ */
+int32_t no_os_ring_reserve_read(struct no_os_ring *ring, uint32_t nb_elems,
+				struct no_os_ring_span *span)
+{
+	uint32_t head, nb;
+
+	if (!ring || !nb_elems || !span)
+		return -EINVAL;
+
+	if (!(ring->flags & NO_OS_RING_SPSC))
+		return no_os_ring_claim(ring, &ring->head, 1, nb_elems, span);
+
+	head = no_os_ring_load(&ring->head, NO_OS_RING_RELAXED);
+	nb = no_os_ring_load(&ring->tail, NO_OS_RING_ACQUIRE) - head;
+	if (!nb)
+		return -EAGAIN;
+
+	nb = no_os_min(nb, nb_elems);
+	nb = no_os_min(nb, ring->mask + 1 - (head & ring->mask));
+
+	span->buff = ring->buff + (head & ring->mask) * ring->elem_size;
+	span->nb_elems = nb;
+	span->pos = head;
+
+	return 0;
+}
+
+/**
+ * @brief Give the elements of a span returned by no_os_ring_reserve_read()
+ * back to the producers.
+ * @param ring - The ring.
+ * @param span - The read elements.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_ring_commit_read(struct no_os_ring *ring,
+			       struct no_os_ring_span *span)
+{
+	if (!ring || !span)
+		return -EINVAL;
+
+	if (ring->flags & NO_OS_RING_SPSC)
+		no_os_ring_store(&ring->head, span->pos + span->nb_elems,
+				 NO_OS_RING_RELEASE);
+	else
+		no_os_ring_release(ring, span, ring->mask + 1);
+
+	return 0;
+}
+
+/**
+ * @brief Copy an element into the ring.
+ * @param ring - The ring.
+ * @param elem - The element.
+ * @return 0 in case of success, -EAGAIN if the ring is full, -EINVAL for
+ * invalid parameters.
+ */
+int32_t no_os_ring_push(struct no_os_ring *ring, const void *elem)
+{
+	struct no_os_ring_span span;
+	int32_t ret;
+
+	if (!elem)
+		return -EINVAL;
+
+	ret = no_os_ring_reserve_write(ring, 1, &span);
+	if (ret)
+		return ret;
+
+	memcpy(span.buff, elem, ring->elem_size);
+
+	return no_os_ring_commit_write(ring, &span);
+}
+
+/**
+ * @brief Copy the oldest element out of the ring.
+ * @param ring - The ring.
+ * @param elem - Where to store the element.
+ * @return 0 in case of success, -EAGAIN if the ring is empty, -EINVAL for
+ * invalid parameters.
+ */
+int32_t no_os_ring_pop(struct no_os_ring *ring, void *elem)
+{
+	struct no_os_ring_span span;
+	int32_t ret;
+
+	if (!elem)
+		return -EINVAL;
+
+	ret = no_os_ring_reserve_read(ring, 1, &span);
+	if (ret)
+		return ret;
+
+	memcpy(elem, span.buff, ring->elem_size);
+
+	return no_os_ring_commit_read(ring, &span);
+}
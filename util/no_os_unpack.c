@@ -0,0 +1,272 @@
+/***************************************************************************//**
+ *   @file   no_os_unpack.c
+ *   @brief  Implementation of the packed sample unpacking functions.
+********************************************************************************
+ * Copyright 2022(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include "no_os_unpack.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Update a CRC-16 with one byte, same as no_os_crc16() does.
+ * @param crc_table - CRC-16 lookup table.
+ * @param crc - Current CRC-16 value.
+ * @param byte - Next byte.
+ * @return The updated CRC-16 value.
+ */
+static inline uint16_t no_os_unpack_crc16_byte(const uint16_t *crc_table,
+		uint16_t crc, uint8_t byte)
+{
+	return crc_table[(crc >> 8) ^ byte] ^ (uint16_t)(crc << 8);
+}
+
+/**
+ * @brief Extract one sample at a known bit offset.
+ * @param src - The packed samples.
+ * @param pos - Bit offset of the sample, from the most significant bit of
+ * 		src[0].
+ * @param bits - Number of bits per sample, up to 32.
+ * @param sign - Sign bit of a sample or 0 to zero extend the samples.
+ * @return The unpacked sample.
+ */
+static inline uint32_t no_os_unpack_be_extract(const uint8_t *src,
+		const uint32_t pos, const uint8_t bits, uint32_t sign)
+{
+	const uint32_t off = pos % 8;
+	const uint32_t nb_bytes = (off + bits + 7) / 8;
+	const uint32_t mask = 0xFFFFFFFF >> (32 - bits);
+	uint64_t acc = 0;
+	uint32_t i, val;
+
+	src += pos / 8;
+	for (i = 0; i < nb_bytes; i++)
+		acc = (acc << 8) | src[i];
+
+	val = (uint32_t)(acc >> (nb_bytes * 8 - off - bits)) & mask;
+
+	return (val ^ sign) - sign;
+}
+
+/**
+ * @brief Unpack a group of 4 samples.
+ *
+ * 4 samples of an even width always end on a byte boundary. When called with a
+ * constant width all the offsets and shifts are resolved at compile time, which
+ * is what makes the fast paths below match hand written kernels.
+ * @param src - The group, bits / 2 bytes.
+ * @param dst - The 4 unpacked samples.
+ * @param bits - Number of bits per sample, even, up to 32.
+ * @param sign - Sign bit of a sample or 0 to zero extend the samples.
+ */
+static inline void no_os_unpack_be_group4(const uint8_t *src, uint32_t *dst,
+		const uint8_t bits, uint32_t sign)
+{
+	dst[0] = no_os_unpack_be_extract(src, 0, bits, sign);
+	dst[1] = no_os_unpack_be_extract(src, bits, bits, sign);
+	dst[2] = no_os_unpack_be_extract(src, 2 * bits, bits, sign);
+	dst[3] = no_os_unpack_be_extract(src, 3 * bits, bits, sign);
+}
+
+/**
+ * @brief Unpack the samples in groups of 4, for a constant sample width.
+ * @param src - The packed samples.
+ * @param nb_groups - Number of 4 sample groups to unpack.
+ * @param dst - The unpacked samples.
+ * @param bits - Number of bits per sample, even, up to 32.
+ * @param sign - Sign bit of a sample or 0 to zero extend the samples.
+ * @param crc_table - CRC-16 lookup table or NULL.
+ * @param crc - Current CRC-16 value, updated with the group bytes.
+ */
+static inline void no_os_unpack_be_groups(const uint8_t *src,
+		uint32_t nb_groups, uint32_t *dst, const uint8_t bits,
+		uint32_t sign, const uint16_t *crc_table, uint16_t *crc)
+{
+	const uint32_t group_size = bits / 2;
+	uint32_t i, j;
+
+	for (i = 0; i < nb_groups; i++) {
+		if (crc_table)
+			for (j = 0; j < group_size; j++)
+				*crc = no_os_unpack_crc16_byte(crc_table, *crc,
+							       src[j]);
+		no_os_unpack_be_group4(src, dst, bits, sign);
+		src += group_size;
+		dst += 4;
+	}
+}
+
+/**
+ * @brief Common part of the unpacking functions.
+ *
+ * The common ADC sample widths are unpacked 4 samples at a time by kernels
+ * specialized for the width. Any other width, and the samples left over after
+ * the groups, go through a generic path: the source bytes are shifted into a
+ * 64-bit accumulator and each sample is extracted from it with a single shift
+ * and mask. When crc_table is provided, the CRC-16 is updated with the source
+ * bytes while they are being unpacked, so the source is only traversed once.
+ * @param src - The packed samples, most significant bit first.
+ * @param nb_samples - Number of samples to unpack.
+ * @param bits - Number of bits per sample, 1 to 32.
+ * @param flags - NO_OS_UNPACK_SIGN_EXTEND or 0.
+ * @param dst - The unpacked samples.
+ * @param crc_table - CRC-16 lookup table or NULL.
+ * @param crc - Initial CRC-16 value, updated with the computed one.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+static int32_t no_os_unpack_be_common(const uint8_t *src, uint32_t nb_samples,
+				      uint8_t bits, uint32_t flags,
+				      uint32_t *dst, const uint16_t *crc_table,
+				      uint16_t *crc)
+{
+	uint32_t mask, sign, val, nb_groups, i;
+	uint16_t crc_val = 0;
+	uint32_t nb_bits = 0;
+	uint64_t acc = 0;
+	uint8_t byte;
+
+	if (!src || !dst || !bits || bits > 32)
+		return -EINVAL;
+
+	if (crc_table) {
+		if (!crc)
+			return -EINVAL;
+		crc_val = *crc;
+	}
+
+	mask = 0xFFFFFFFF >> (32 - bits);
+	sign = (flags & NO_OS_UNPACK_SIGN_EXTEND) ? (1UL << (bits - 1)) : 0;
+
+	nb_groups = nb_samples / 4;
+	switch (bits) {
+	case 16:
+		no_os_unpack_be_groups(src, nb_groups, dst, 16, sign,
+				       crc_table, &crc_val);
+		break;
+	case 18:
+		no_os_unpack_be_groups(src, nb_groups, dst, 18, sign,
+				       crc_table, &crc_val);
+		break;
+	case 24:
+		no_os_unpack_be_groups(src, nb_groups, dst, 24, sign,
+				       crc_table, &crc_val);
+		break;
+	case 26:
+		no_os_unpack_be_groups(src, nb_groups, dst, 26, sign,
+				       crc_table, &crc_val);
+		break;
+	default:
+		nb_groups = 0;
+		break;
+	}
+	src += nb_groups * bits / 2;
+	i = nb_groups * 4;
+
+	for (; i < nb_samples; i++) {
+		while (nb_bits < bits) {
+			byte = *src++;
+			if (crc_table)
+				crc_val = no_os_unpack_crc16_byte(crc_table,
+								  crc_val,
+								  byte);
+			acc = (acc << 8) | byte;
+			nb_bits += 8;
+		}
+
+		nb_bits -= bits;
+		val = (uint32_t)(acc >> nb_bits) & mask;
+		dst[i] = (val ^ sign) - sign;
+	}
+
+	if (crc_table)
+		*crc = crc_val;
+
+	return 0;
+}
+
+/**
+ * @brief Unpack big endian, bit packed samples into 32-bit words.
+ *
+ * Sample i occupies bits [i * bits, (i + 1) * bits) of the source, counting
+ * from the most significant bit of src[0]. The source must hold at least
+ * NO_OS_DIV_ROUND_UP(nb_samples * bits, 8) bytes.
+ * @param src - The packed samples.
+ * @param nb_samples - Number of samples to unpack.
+ * @param bits - Number of bits per sample, 1 to 32.
+ * @param flags - NO_OS_UNPACK_SIGN_EXTEND to treat the samples as two's
+ * 		  complement, 0 to zero extend them.
+ * @param dst - The unpacked samples.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_unpack_be(const uint8_t *src, uint32_t nb_samples, uint8_t bits,
+			uint32_t flags, uint32_t *dst)
+{
+	return no_os_unpack_be_common(src, nb_samples, bits, flags, dst, NULL,
+				      NULL);
+}
+
+/**
+ * @brief Unpack big endian, bit packed samples and compute the CRC-16 of the
+ * source bytes in the same pass.
+ *
+ * The CRC is computed as with no_os_crc16(), over all the source bytes holding
+ * the samples.
+ * @param src - The packed samples.
+ * @param nb_samples - Number of samples to unpack.
+ * @param bits - Number of bits per sample, 1 to 32.
+ * @param flags - NO_OS_UNPACK_SIGN_EXTEND or 0.
+ * @param dst - The unpacked samples.
+ * @param crc_table - CRC-16 lookup table, see no_os_crc16_populate_msb().
+ * @param crc - Initial CRC-16 value, replaced with the computed CRC-16.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_unpack_be_crc16(const uint8_t *src, uint32_t nb_samples,
+			      uint8_t bits, uint32_t flags, uint32_t *dst,
+			      const uint16_t *crc_table, uint16_t *crc)
+{
+	if (!crc_table)
+		return -EINVAL;
+
+	return no_os_unpack_be_common(src, nb_samples, bits, flags, dst,
+				      crc_table, crc);
+}